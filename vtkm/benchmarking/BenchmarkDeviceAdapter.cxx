@@ -66,18 +66,25 @@ enum BenchmarkName
   REDUCE = 1 << 3,
   REDUCE_BY_KEY = 1 << 4,
   SCAN_INCLUSIVE = 1 << 5,
-  SCAN_EXCLUSIVE = 1 << 6,
-  SORT = 1 << 7,
-  SORT_BY_KEY = 1 << 8,
-  STABLE_SORT_INDICES = 1 << 9,
-  STABLE_SORT_INDICES_UNIQUE = 1 << 10,
-  UNIQUE = 1 << 11,
-  UPPER_BOUNDS = 1 << 12,
-  ALL = COPY | COPY_IF | LOWER_BOUNDS | REDUCE | REDUCE_BY_KEY | SCAN_INCLUSIVE | SCAN_EXCLUSIVE |
+  SCAN_INCLUSIVE_BY_KEY = 1 << 6,
+  SCAN_EXCLUSIVE = 1 << 7,
+  SCAN_EXCLUSIVE_BY_KEY = 1 << 8,
+  SORT = 1 << 9,
+  SORT_BY_KEY = 1 << 10,
+  STABLE_SORT_INDICES = 1 << 11,
+  STABLE_SORT_INDICES_UNIQUE = 1 << 12,
+  TRANSFORM = 1 << 13,
+  UNIQUE = 1 << 14,
+  UPPER_BOUNDS = 1 << 15,
+  ALL = COPY | COPY_IF | LOWER_BOUNDS | REDUCE | REDUCE_BY_KEY | SCAN_INCLUSIVE |
+    SCAN_INCLUSIVE_BY_KEY |
+    SCAN_EXCLUSIVE |
+    SCAN_EXCLUSIVE_BY_KEY |
     SORT |
     SORT_BY_KEY |
     STABLE_SORT_INDICES |
     STABLE_SORT_INDICES_UNIQUE |
+    TRANSFORM |
     UNIQUE |
     UPPER_BOUNDS
 };
@@ -88,8 +95,9 @@ struct BenchDevAlgoConfig
 {
   /// Benchmarks to run. Possible values:
   /// Copy, CopyIf, LowerBounds, Reduce, ReduceByKey, ScanInclusive,
-  /// ScanExclusive, Sort, SortByKey, StableSortIndices, StableSortIndicesUnique,
-  /// Unique, UpperBounds, or All. (Default: All).
+  /// ScanInclusiveByKey, ScanExclusive, ScanExclusiveByKey, Sort, SortByKey,
+  /// StableSortIndices, StableSortIndicesUnique, Transform, Unique,
+  /// UpperBounds, or All. (Default: All).
   // Zero is for parsing, will change to 'all' in main if needed.
   int BenchmarkFlags{ 0 };
 
@@ -550,6 +558,63 @@ private:
   };
   VTKM_MAKE_BENCHMARK(ScanInclusive, BenchScanInclusive);
 
+  template <typename Value>
+  struct BenchScanInclusiveByKey
+  {
+    typedef vtkm::cont::ArrayHandle<Value, StorageTag> ValueArrayHandle;
+
+    const vtkm::Id N_KEYS;
+    const vtkm::Id PERCENT_KEYS;
+    ValueArrayHandle ValueHandle, OutHandle;
+    IdArrayHandle KeyHandle;
+
+    VTKM_CONT
+    BenchScanInclusiveByKey(vtkm::Id key_percent)
+      : N_KEYS((Config.ComputeSize<Value>() * key_percent) / 100)
+      , PERCENT_KEYS(key_percent)
+    {
+      vtkm::Id arraySize = Config.ComputeSize<Value>();
+      Algorithm::Schedule(
+        FillTestValueKernel<Value>(ValueHandle.PrepareForOutput(arraySize, DeviceAdapterTag())),
+        arraySize);
+      Algorithm::Schedule(FillModuloTestValueKernel<vtkm::Id>(
+                            N_KEYS, KeyHandle.PrepareForOutput(arraySize, DeviceAdapterTag())),
+                          arraySize);
+      Algorithm::SortByKey(KeyHandle, ValueHandle);
+    }
+
+    VTKM_CONT
+    vtkm::Float64 operator()()
+    {
+      Timer timer;
+      Algorithm::ScanInclusiveByKey(KeyHandle, ValueHandle, OutHandle);
+      return timer.GetElapsedTime();
+    }
+
+    VTKM_CONT
+    std::string Description() const
+    {
+      vtkm::Id arraySize = Config.ComputeSize<Value>();
+      std::stringstream description;
+      description << "ScanInclusiveByKey on " << arraySize << " values ("
+                  << HumanSize(static_cast<vtkm::UInt64>(arraySize) * sizeof(Value)) << ") with "
+                  << N_KEYS << " (" << PERCENT_KEYS << "%) distinct vtkm::Id keys";
+      return description.str();
+    }
+  };
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey5, BenchScanInclusiveByKey, 5);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey10, BenchScanInclusiveByKey, 10);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey15, BenchScanInclusiveByKey, 15);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey20, BenchScanInclusiveByKey, 20);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey25, BenchScanInclusiveByKey, 25);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey30, BenchScanInclusiveByKey, 30);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey35, BenchScanInclusiveByKey, 35);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey40, BenchScanInclusiveByKey, 40);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey45, BenchScanInclusiveByKey, 45);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey50, BenchScanInclusiveByKey, 50);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey75, BenchScanInclusiveByKey, 75);
+  VTKM_MAKE_BENCHMARK(ScanInclusiveByKey100, BenchScanInclusiveByKey, 100);
+
   template <typename Value>
   struct BenchScanExclusive
   {
@@ -586,6 +651,63 @@ private:
   };
   VTKM_MAKE_BENCHMARK(ScanExclusive, BenchScanExclusive);
 
+  template <typename Value>
+  struct BenchScanExclusiveByKey
+  {
+    typedef vtkm::cont::ArrayHandle<Value, StorageTag> ValueArrayHandle;
+
+    const vtkm::Id N_KEYS;
+    const vtkm::Id PERCENT_KEYS;
+    ValueArrayHandle ValueHandle, OutHandle;
+    IdArrayHandle KeyHandle;
+
+    VTKM_CONT
+    BenchScanExclusiveByKey(vtkm::Id key_percent)
+      : N_KEYS((Config.ComputeSize<Value>() * key_percent) / 100)
+      , PERCENT_KEYS(key_percent)
+    {
+      vtkm::Id arraySize = Config.ComputeSize<Value>();
+      Algorithm::Schedule(
+        FillTestValueKernel<Value>(ValueHandle.PrepareForOutput(arraySize, DeviceAdapterTag())),
+        arraySize);
+      Algorithm::Schedule(FillModuloTestValueKernel<vtkm::Id>(
+                            N_KEYS, KeyHandle.PrepareForOutput(arraySize, DeviceAdapterTag())),
+                          arraySize);
+      Algorithm::SortByKey(KeyHandle, ValueHandle);
+    }
+
+    VTKM_CONT
+    vtkm::Float64 operator()()
+    {
+      Timer timer;
+      Algorithm::ScanExclusiveByKey(KeyHandle, ValueHandle, OutHandle);
+      return timer.GetElapsedTime();
+    }
+
+    VTKM_CONT
+    std::string Description() const
+    {
+      vtkm::Id arraySize = Config.ComputeSize<Value>();
+      std::stringstream description;
+      description << "ScanExclusiveByKey on " << arraySize << " values ("
+                  << HumanSize(static_cast<vtkm::UInt64>(arraySize) * sizeof(Value)) << ") with "
+                  << N_KEYS << " (" << PERCENT_KEYS << "%) distinct vtkm::Id keys";
+      return description.str();
+    }
+  };
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey5, BenchScanExclusiveByKey, 5);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey10, BenchScanExclusiveByKey, 10);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey15, BenchScanExclusiveByKey, 15);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey20, BenchScanExclusiveByKey, 20);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey25, BenchScanExclusiveByKey, 25);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey30, BenchScanExclusiveByKey, 30);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey35, BenchScanExclusiveByKey, 35);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey40, BenchScanExclusiveByKey, 40);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey45, BenchScanExclusiveByKey, 45);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey50, BenchScanExclusiveByKey, 50);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey75, BenchScanExclusiveByKey, 75);
+  VTKM_MAKE_BENCHMARK(ScanExclusiveByKey100, BenchScanExclusiveByKey, 100);
+
   template <typename Value>
   struct BenchSort
   {
@@ -794,6 +916,45 @@ private:
   VTKM_MAKE_BENCHMARK(StableSortIndicesUnique75, BenchStableSortIndicesUnique, 75);
   VTKM_MAKE_BENCHMARK(StableSortIndicesUnique100, BenchStableSortIndicesUnique, 100);
 
+  template <typename Value>
+  struct BenchTransform
+  {
+    typedef vtkm::cont::ArrayHandle<Value, StorageTag> ValueArrayHandle;
+
+    ValueArrayHandle Input1Handle, Input2Handle, OutHandle;
+
+    VTKM_CONT
+    BenchTransform()
+    {
+      vtkm::Id arraySize = Config.ComputeSize<Value>();
+      Algorithm::Schedule(
+        FillTestValueKernel<Value>(Input1Handle.PrepareForOutput(arraySize, DeviceAdapterTag())),
+        arraySize);
+      Algorithm::Schedule(FillScaledTestValueKernel<Value>(
+                            2, Input2Handle.PrepareForOutput(arraySize, DeviceAdapterTag())),
+                          arraySize);
+    }
+
+    VTKM_CONT
+    vtkm::Float64 operator()()
+    {
+      Timer timer;
+      Algorithm::Transform(Input1Handle, Input2Handle, OutHandle, vtkm::Add());
+      return timer.GetElapsedTime();
+    }
+
+    VTKM_CONT
+    std::string Description() const
+    {
+      vtkm::Id arraySize = Config.ComputeSize<Value>();
+      std::stringstream description;
+      description << "Transform on " << arraySize << " values ("
+                  << HumanSize(static_cast<vtkm::UInt64>(arraySize) * sizeof(Value)) << ")";
+      return description.str();
+    }
+  };
+  VTKM_MAKE_BENCHMARK(Transform, BenchTransform);
+
   template <typename Value>
   struct BenchUnique
   {
@@ -1050,12 +1211,68 @@ public:
       VTKM_RUN_BENCHMARK(ScanInclusive, ValueTypes());
     }
 
+    if (Config.BenchmarkFlags & SCAN_INCLUSIVE_BY_KEY)
+    {
+      std::cout << "\n" << DIVIDER << "\nBenchmarking ScanInclusiveByKey\n";
+      if (Config.DetailedOutputRangeScaling)
+      {
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey5, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey10, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey15, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey20, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey25, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey30, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey35, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey40, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey45, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey50, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey75, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey100, ValueTypes());
+      }
+      else
+      {
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey5, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey25, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey50, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey75, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanInclusiveByKey100, ValueTypes());
+      }
+    }
+
     if (Config.BenchmarkFlags & SCAN_EXCLUSIVE)
     {
       std::cout << "\n" << DIVIDER << "\nBenchmarking ScanExclusive\n";
       VTKM_RUN_BENCHMARK(ScanExclusive, ValueTypes());
     }
 
+    if (Config.BenchmarkFlags & SCAN_EXCLUSIVE_BY_KEY)
+    {
+      std::cout << "\n" << DIVIDER << "\nBenchmarking ScanExclusiveByKey\n";
+      if (Config.DetailedOutputRangeScaling)
+      {
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey5, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey10, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey15, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey20, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey25, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey30, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey35, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey40, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey45, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey50, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey75, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey100, ValueTypes());
+      }
+      else
+      {
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey5, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey25, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey50, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey75, ValueTypes());
+        VTKM_RUN_BENCHMARK(ScanExclusiveByKey100, ValueTypes());
+      }
+    }
+
     if (Config.BenchmarkFlags & SORT)
     {
       std::cout << "\n" << DIVIDER << "\nBenchmarking Sort\n";
@@ -1124,6 +1341,12 @@ public:
       }
     }
 
+    if (Config.BenchmarkFlags & TRANSFORM)
+    {
+      std::cout << "\n" << DIVIDER << "\nBenchmarking Transform\n";
+      VTKM_RUN_BENCHMARK(Transform, ValueTypes());
+    }
+
     if (Config.BenchmarkFlags & UNIQUE)
     {
       std::cout << "\n" << DIVIDER << "\nBenchmarking Unique\n";
@@ -1224,10 +1447,18 @@ int main(int argc, char* argv[])
     {
       config.BenchmarkFlags |= vtkm::benchmarking::SCAN_INCLUSIVE;
     }
+    else if (arg == "scaninclusivebykey")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::SCAN_INCLUSIVE_BY_KEY;
+    }
     else if (arg == "scanexclusive")
     {
       config.BenchmarkFlags |= vtkm::benchmarking::SCAN_EXCLUSIVE;
     }
+    else if (arg == "scanexclusivebykey")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::SCAN_EXCLUSIVE_BY_KEY;
+    }
     else if (arg == "sort")
     {
       config.BenchmarkFlags |= vtkm::benchmarking::SORT;
@@ -1244,6 +1475,10 @@ int main(int argc, char* argv[])
     {
       config.BenchmarkFlags |= vtkm::benchmarking::STABLE_SORT_INDICES_UNIQUE;
     }
+    else if (arg == "transform")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::TRANSFORM;
+    }
     else if (arg == "unique")
     {
       config.BenchmarkFlags |= vtkm::benchmarking::UNIQUE;
@@ -0,0 +1,572 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/Math.h>
+#include <vtkm/benchmarking/Benchmarker.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/DataSetBuilderRectilinear.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
+#include <vtkm/cont/Error.h>
+#include <vtkm/cont/ImplicitFunctionHandle.h>
+#include <vtkm/cont/StorageBasicMemoryPool.h>
+#include <vtkm/cont/Timer.h>
+#include <vtkm/cont/testing/Testing.h>
+
+#include <vtkm/filter/CleanGrid.h>
+#include <vtkm/filter/ClipWithField.h>
+#include <vtkm/filter/ClipWithImplicitFunction.h>
+#include <vtkm/filter/ExternalFaces.h>
+#include <vtkm/filter/Gradient.h>
+#include <vtkm/filter/MarchingCubes.h>
+#include <vtkm/filter/PolicyBase.h>
+#include <vtkm/filter/Probe.h>
+#include <vtkm/filter/Streamline.h>
+#include <vtkm/filter/Tetrahedralize.h>
+#include <vtkm/filter/Threshold.h>
+#include <vtkm/filter/VertexClustering.h>
+
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if VTKM_DEVICE_ADAPTER == VTKM_DEVICE_ADAPTER_TBB
+#include <tbb/task_scheduler_init.h>
+#endif // TBB
+
+// This benchmark times complete filter executions on generated data sets.
+// See the BenchFilterConfig documentation for the commandline options. For
+// the TBB implementation, the number of threads can be customized using a
+// "NumThreads [numThreads]" argument.
+
+namespace vtkm
+{
+namespace benchmarking
+{
+
+const static std::string DIVIDER(40, '-');
+
+enum BenchmarkName
+{
+  MARCHING_CUBES = 1 << 0,
+  CLIP_WITH_FIELD = 1 << 1,
+  CLIP_WITH_IMPLICIT_FUNCTION = 1 << 2,
+  EXTERNAL_FACES = 1 << 3,
+  THRESHOLD = 1 << 4,
+  CLEAN_GRID = 1 << 5,
+  GRADIENT = 1 << 6,
+  VERTEX_CLUSTERING = 1 << 7,
+  STREAMLINE = 1 << 8,
+  TETRAHEDRALIZE = 1 << 9,
+  PROBE = 1 << 10,
+  ALL = MARCHING_CUBES | CLIP_WITH_FIELD | CLIP_WITH_IMPLICIT_FUNCTION | EXTERNAL_FACES |
+    THRESHOLD | CLEAN_GRID | GRADIENT | VERTEX_CLUSTERING | STREAMLINE | TETRAHEDRALIZE | PROBE
+};
+
+enum DataSetKind
+{
+  UNIFORM = 1 << 0,
+  RECTILINEAR = 1 << 1,
+  EXPLICIT = 1 << 2,
+  ALL_DATA_SETS = UNIFORM | RECTILINEAR | EXPLICIT
+};
+
+struct BenchFilterConfig
+{
+  /// Filters to run. Possible values:
+  /// MarchingCubes, ClipWithField, ClipWithImplicitFunction, ExternalFaces,
+  /// Threshold, CleanGrid, Gradient, VertexClustering, Streamline,
+  /// Tetrahedralize, Probe. (Default: all).
+  // Zero is for parsing, will change to 'all' in main if needed.
+  int BenchmarkFlags{ 0 };
+
+  /// Data sets to run the filters on. Possible values:
+  /// Uniform, Rectilinear, Explicit. (Default: all).
+  // Zero is for parsing, will change to 'all' in main if needed.
+  int DataSetFlags{ 0 };
+
+  /// The number of points along each axis of the generated data sets.
+  /// CLI arg: "Size [n]" (Default: 128).
+  vtkm::Id Size{ 128 };
+
+  /// The maximum time in seconds spent gathering samples for one filter on
+  /// one data set. CLI arg: "MaxRuntime [s]" (Default: 10).
+  vtkm::Float64 MaxRuntime{ 10.0 };
+};
+
+static BenchFilterConfig Config = BenchFilterConfig();
+
+/// Runs the filters only on the device being benchmarked.
+template <typename DeviceAdapterTag>
+struct BenchFilterPolicy : vtkm::filter::PolicyBase<BenchFilterPolicy<DeviceAdapterTag>>
+{
+  typedef vtkm::ListTagBase<DeviceAdapterTag> DeviceAdapterList;
+};
+
+/// This class runs the filters of vtkm::filter end to end and reports their
+/// throughput in input cells per second along with the peak array memory
+/// allocated while they run.
+template <class DeviceAdapterTag>
+class BenchmarkFilters
+{
+  typedef vtkm::cont::Timer<DeviceAdapterTag> Timer;
+  typedef BenchFilterPolicy<DeviceAdapterTag> Policy;
+  typedef vtkm::Vec<vtkm::FloatDefault, 3> Vec3;
+
+  // Times one execution of a filter. The execute functor takes the input data
+  // set and returns the filter result.
+  template <typename ExecuteFunctor>
+  struct BenchFilter
+  {
+    std::string Name;
+    std::string DataSetName;
+    vtkm::cont::DataSet Input;
+    ExecuteFunctor Execute;
+
+    VTKM_CONT
+    vtkm::Float64 operator()()
+    {
+      Timer timer;
+      vtkm::filter::Result result = this->Execute(this->Input);
+      return timer.GetElapsedTime();
+    }
+
+    VTKM_CONT
+    std::string Description() const
+    {
+      std::stringstream description;
+      description << this->Name << " on the " << this->DataSetName << " data set with "
+                  << this->Input.GetCellSet().GetNumberOfCells() << " cells";
+      return description.str();
+    }
+  };
+
+  // Fills the "scalar" and "vector" point fields from the point coordinates.
+  // The scalar field has several lobes so contours and clips produce a
+  // nontrivial amount of output, and the vector field swirls around the
+  // z axis so streamlines stay inside the domain for a while.
+  static VTKM_CONT void AddFields(vtkm::cont::DataSet& dataSet)
+  {
+    auto coords = dataSet.GetCoordinateSystem().GetData().GetPortalConstControl();
+    const vtkm::Id numberOfPoints = coords.GetNumberOfValues();
+
+    std::vector<vtkm::Float32> scalars(static_cast<std::size_t>(numberOfPoints));
+    std::vector<Vec3> vectors(static_cast<std::size_t>(numberOfPoints));
+    const vtkm::FloatDefault frequency = static_cast<vtkm::FloatDefault>(4.0 * vtkm::Pi());
+    for (vtkm::Id index = 0; index < numberOfPoints; ++index)
+    {
+      const Vec3 point = coords.Get(index);
+      const std::size_t i = static_cast<std::size_t>(index);
+      scalars[i] = static_cast<vtkm::Float32>(vtkm::Sin(frequency * point[0]) *
+                                              vtkm::Sin(frequency * point[1]) *
+                                              vtkm::Sin(frequency * point[2]));
+      vectors[i] = Vec3(0.5f - point[1], point[0] - 0.5f, 0.1f);
+    }
+
+    vtkm::cont::DataSetFieldAdd::AddPointField(dataSet, "scalar", scalars);
+    vtkm::cont::DataSetFieldAdd::AddPointField(dataSet, "vector", vectors);
+  }
+
+  // All the data sets cover the unit cube with Config.Size points per axis.
+  static VTKM_CONT vtkm::cont::DataSet MakeDataSet(DataSetKind kind)
+  {
+    const vtkm::Id size = Config.Size;
+    const vtkm::FloatDefault spacing = 1.0f / static_cast<vtkm::FloatDefault>(size - 1);
+
+    vtkm::cont::DataSet dataSet;
+    if (kind == RECTILINEAR)
+    {
+      // Points get closer together towards the origin.
+      std::vector<vtkm::FloatDefault> axis(static_cast<std::size_t>(size));
+      for (vtkm::Id i = 0; i < size; ++i)
+      {
+        const vtkm::FloatDefault t = static_cast<vtkm::FloatDefault>(i) * spacing;
+        axis[static_cast<std::size_t>(i)] = 0.5f * t * (1.0f + t);
+      }
+      dataSet = vtkm::cont::DataSetBuilderRectilinear::Create(axis, axis, axis);
+    }
+    else
+    {
+      dataSet = vtkm::cont::DataSetBuilderUniform::Create(
+        vtkm::Id3(size, size, size), Vec3(0.0f, 0.0f, 0.0f), Vec3(spacing, spacing, spacing));
+      if (kind == EXPLICIT)
+      {
+        vtkm::filter::CleanGrid clean;
+        dataSet = clean.Execute(dataSet, Policy()).GetDataSet();
+      }
+    }
+
+    AddFields(dataSet);
+    return dataSet;
+  }
+
+  static VTKM_CONT std::string GetDataSetName(DataSetKind kind)
+  {
+    switch (kind)
+    {
+      case UNIFORM:
+        return "uniform";
+      case RECTILINEAR:
+        return "rectilinear";
+      default:
+        return "explicit";
+    }
+  }
+
+  // Runs a filter once to check that it supports the data set and to measure
+  // its peak memory, then gathers timing samples. The peak memory counts the
+  // arrays allocated through the StorageBasic memory pool, including the
+  // output of the filter, so it is only reported while the pool is enabled.
+  template <typename ExecuteFunctor>
+  static VTKM_CONT void RunFilter(const std::string& name,
+                                  DataSetKind kind,
+                                  const vtkm::cont::DataSet& input,
+                                  ExecuteFunctor execute)
+  {
+    const std::string dataSetName = GetDataSetName(kind);
+
+    vtkm::cont::StorageBasicMemoryPool::Trim();
+    vtkm::cont::StorageBasicMemoryPool::ResetStatistics();
+    const vtkm::UInt64 initialBytes =
+      vtkm::cont::StorageBasicMemoryPool::GetStatistics().BytesInUse;
+
+    vtkm::UInt64 peakBytes = 0;
+    try
+    {
+      vtkm::filter::Result result = execute(input);
+      if (!result.IsValid())
+      {
+        std::cout << "Skipping " << name << " on the " << dataSetName
+                  << " data set: the filter does not support it.\n";
+        return;
+      }
+      peakBytes = vtkm::cont::StorageBasicMemoryPool::GetStatistics().PeakBytes - initialBytes;
+    }
+    catch (vtkm::cont::Error& error)
+    {
+      std::cout << "Skipping " << name << " on the " << dataSetName
+                << " data set: " << error.GetMessage() << "\n";
+      return;
+    }
+
+    BenchFilter<ExecuteFunctor> functor{ name, dataSetName, input, execute };
+    Benchmarker bench(Config.MaxRuntime);
+    bench(functor);
+
+    const vtkm::Float64 median = stats::PercentileValue(bench.GetSamples(), 50.0);
+    const vtkm::Float64 numberOfCells =
+      static_cast<vtkm::Float64>(input.GetCellSet().GetNumberOfCells());
+    std::cout << "\tthroughput = " << (numberOfCells / median) << " cells/s\n";
+    if (vtkm::cont::StorageBasicMemoryPool::GetEnabled())
+    {
+      std::cout << "\tpeak array memory = " << HumanSize(peakBytes) << "\n";
+    }
+  }
+
+  static VTKM_CONT void RunDataSet(DataSetKind kind)
+  {
+    const vtkm::cont::DataSet input = MakeDataSet(kind);
+    std::cout << DIVIDER << "\nBenchmarking filters on the " << GetDataSetName(kind)
+              << " data set of " << Config.Size << "^3 points\n";
+
+    if (Config.BenchmarkFlags & MARCHING_CUBES)
+    {
+      vtkm::filter::MarchingCubes filter;
+      filter.SetIsoValue(0.25);
+      RunFilter("MarchingCubes", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+        vtkm::filter::Result result = filter.Execute(in, "scalar", Policy());
+        filter.MapFieldOntoOutput(result, in.GetField("scalar"), Policy());
+        return result;
+      });
+    }
+
+    if (Config.BenchmarkFlags & CLIP_WITH_FIELD)
+    {
+      vtkm::filter::ClipWithField filter;
+      filter.SetClipValue(0.0);
+      RunFilter("ClipWithField", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+        vtkm::filter::Result result = filter.Execute(in, "scalar", Policy());
+        filter.MapFieldOntoOutput(result, in.GetField("scalar"), Policy());
+        return result;
+      });
+    }
+
+    if (Config.BenchmarkFlags & CLIP_WITH_IMPLICIT_FUNCTION)
+    {
+      vtkm::filter::ClipWithImplicitFunction filter;
+      filter.SetImplicitFunction(
+        vtkm::cont::make_ImplicitFunctionHandle(vtkm::Sphere(Vec3(0.5f, 0.5f, 0.5f), 0.4f)));
+      RunFilter(
+        "ClipWithImplicitFunction", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+          vtkm::filter::Result result = filter.Execute(in, Policy());
+          filter.MapFieldOntoOutput(result, in.GetField("scalar"), Policy());
+          return result;
+        });
+    }
+
+    if (Config.BenchmarkFlags & EXTERNAL_FACES)
+    {
+      vtkm::filter::ExternalFaces filter;
+      RunFilter("ExternalFaces", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+        vtkm::filter::Result result = filter.Execute(in, Policy());
+        filter.MapFieldOntoOutput(result, in.GetField("scalar"), Policy());
+        return result;
+      });
+    }
+
+    if (Config.BenchmarkFlags & THRESHOLD)
+    {
+      vtkm::filter::Threshold filter;
+      filter.SetLowerThreshold(0.0);
+      filter.SetUpperThreshold(0.5);
+      RunFilter("Threshold", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+        vtkm::filter::Result result = filter.Execute(in, "scalar", Policy());
+        filter.MapFieldOntoOutput(result, in.GetField("scalar"), Policy());
+        return result;
+      });
+    }
+
+    if (Config.BenchmarkFlags & CLEAN_GRID)
+    {
+      vtkm::filter::CleanGrid filter;
+      RunFilter("CleanGrid", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+        vtkm::filter::Result result = filter.Execute(in, Policy());
+        filter.MapFieldOntoOutput(result, in.GetField("scalar"), Policy());
+        return result;
+      });
+    }
+
+    if (Config.BenchmarkFlags & GRADIENT)
+    {
+      vtkm::filter::Gradient filter;
+      RunFilter("Gradient", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+        return filter.Execute(in, "scalar", Policy());
+      });
+    }
+
+    if (Config.BenchmarkFlags & VERTEX_CLUSTERING)
+    {
+      // Vertex clustering simplifies triangle meshes, so it runs on the
+      // contour of the data set.
+      vtkm::filter::MarchingCubes contour;
+      contour.SetIsoValue(0.25);
+      const vtkm::cont::DataSet surface = contour.Execute(input, "scalar", Policy()).GetDataSet();
+
+      vtkm::filter::VertexClustering filter;
+      const vtkm::Id divisions = std::max(vtkm::Id(2), Config.Size / 4);
+      filter.SetNumberOfDivisions(vtkm::Id3(divisions, divisions, divisions));
+      RunFilter("VertexClustering", kind, surface, [=](const vtkm::cont::DataSet& in) mutable {
+        return filter.Execute(in, Policy());
+      });
+    }
+
+    if (Config.BenchmarkFlags & STREAMLINE)
+    {
+      std::mt19937 rng;
+      std::uniform_real_distribution<vtkm::FloatDefault> distribution(0.2f, 0.8f);
+      std::vector<Vec3> seeds(1000);
+      for (Vec3& seed : seeds)
+      {
+        seed = Vec3(distribution(rng), distribution(rng), distribution(rng));
+      }
+      vtkm::cont::ArrayHandle<Vec3> seedArray;
+      vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapterTag>::Copy(
+        vtkm::cont::make_ArrayHandle(seeds), seedArray);
+
+      vtkm::filter::Streamline filter;
+      filter.SetStepSize(0.25 / static_cast<vtkm::Float64>(Config.Size));
+      filter.SetNumberOfSteps(100);
+      filter.SetSeeds(seedArray);
+      RunFilter("Streamline", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+        return filter.Execute(in, "vector", Policy());
+      });
+    }
+
+    if (Config.BenchmarkFlags & TETRAHEDRALIZE)
+    {
+      vtkm::filter::Tetrahedralize filter;
+      RunFilter("Tetrahedralize", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+        vtkm::filter::Result result = filter.Execute(in, Policy());
+        filter.MapFieldOntoOutput(result, in.GetField("scalar"), Policy());
+        return result;
+      });
+    }
+
+    if (Config.BenchmarkFlags & PROBE)
+    {
+      // Probe the data set with a coarser grid that is not aligned with it.
+      const vtkm::Id size = std::max(vtkm::Id(2), Config.Size / 2);
+      const vtkm::FloatDefault spacing = 0.9f / static_cast<vtkm::FloatDefault>(size - 1);
+      vtkm::filter::Probe filter;
+      filter.SetGeometry(vtkm::cont::DataSetBuilderUniform::Create(
+        vtkm::Id3(size, size, size), Vec3(0.05f, 0.05f, 0.05f), Vec3(spacing, spacing, spacing)));
+      RunFilter("Probe", kind, input, [=](const vtkm::cont::DataSet& in) mutable {
+        vtkm::filter::Result result = filter.Execute(in, Policy());
+        filter.MapFieldOntoOutput(result, in.GetField("scalar"), Policy());
+        return result;
+      });
+    }
+  }
+
+public:
+  static VTKM_CONT int Run()
+  {
+    std::cout << DIVIDER << "\nRunning Filter benchmarks\n";
+
+    for (DataSetKind kind : { UNIFORM, RECTILINEAR, EXPLICIT })
+    {
+      if (Config.DataSetFlags & kind)
+      {
+        RunDataSet(kind);
+      }
+    }
+
+    return 0;
+  }
+};
+}
+} // namespace vtkm::benchmarking
+
+int main(int argc, char* argv[])
+{
+#if VTKM_DEVICE_ADAPTER == VTKM_DEVICE_ADAPTER_TBB
+  int numThreads = tbb::task_scheduler_init::automatic;
+#endif // TBB
+
+  vtkm::benchmarking::BenchFilterConfig& config = vtkm::benchmarking::Config;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    std::transform(arg.begin(), arg.end(), arg.begin(), [](char c) {
+      return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+    if (arg == "marchingcubes")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::MARCHING_CUBES;
+    }
+    else if (arg == "clipwithfield")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::CLIP_WITH_FIELD;
+    }
+    else if (arg == "clipwithimplicitfunction")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::CLIP_WITH_IMPLICIT_FUNCTION;
+    }
+    else if (arg == "externalfaces")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::EXTERNAL_FACES;
+    }
+    else if (arg == "threshold")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::THRESHOLD;
+    }
+    else if (arg == "cleangrid")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::CLEAN_GRID;
+    }
+    else if (arg == "gradient")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::GRADIENT;
+    }
+    else if (arg == "vertexclustering")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::VERTEX_CLUSTERING;
+    }
+    else if (arg == "streamline")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::STREAMLINE;
+    }
+    else if (arg == "tetrahedralize")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::TETRAHEDRALIZE;
+    }
+    else if (arg == "probe")
+    {
+      config.BenchmarkFlags |= vtkm::benchmarking::PROBE;
+    }
+    else if (arg == "uniform")
+    {
+      config.DataSetFlags |= vtkm::benchmarking::UNIFORM;
+    }
+    else if (arg == "rectilinear")
+    {
+      config.DataSetFlags |= vtkm::benchmarking::RECTILINEAR;
+    }
+    else if (arg == "explicit")
+    {
+      config.DataSetFlags |= vtkm::benchmarking::EXPLICIT;
+    }
+    else if (arg == "size" && i + 1 < argc)
+    {
+      ++i;
+      std::istringstream parse(argv[i]);
+      parse >> config.Size;
+      if (config.Size < 2)
+      {
+        std::cerr << "Size must be at least 2." << std::endl;
+        return 1;
+      }
+    }
+    else if (arg == "maxruntime" && i + 1 < argc)
+    {
+      ++i;
+      std::istringstream parse(argv[i]);
+      parse >> config.MaxRuntime;
+    }
+    else if (arg == "numthreads" && i + 1 < argc)
+    {
+      ++i;
+#if VTKM_DEVICE_ADAPTER == VTKM_DEVICE_ADAPTER_TBB
+      std::istringstream parse(argv[i]);
+      parse >> numThreads;
+      std::cout << "Selected " << numThreads << " TBB threads." << std::endl;
+#else
+      std::cerr << "NumThreads valid only on TBB. Ignoring." << std::endl;
+#endif // TBB
+    }
+    else
+    {
+      std::cerr << "Unrecognized benchmark: " << argv[i] << std::endl;
+      return 1;
+    }
+  }
+
+#if VTKM_DEVICE_ADAPTER == VTKM_DEVICE_ADAPTER_TBB
+  // Must not be destroyed as long as benchmarks are running:
+  tbb::task_scheduler_init init(numThreads);
+#endif // TBB
+
+  if (config.BenchmarkFlags == 0)
+  {
+    config.BenchmarkFlags = vtkm::benchmarking::ALL;
+  }
+  if (config.DataSetFlags == 0)
+  {
+    config.DataSetFlags = vtkm::benchmarking::ALL_DATA_SETS;
+  }
+
+  //now actually execute the benchmarks
+  return vtkm::benchmarking::BenchmarkFilters<VTKM_DEFAULT_DEVICE_ADAPTER_TAG>::Run();
+}
@@ -0,0 +1,257 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_cont_ArrayHandleMemoryMapped_h
+#define vtk_m_cont_ArrayHandleMemoryMapped_h
+
+#include <vtkm/VecTraits.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/internal/IteratorFromArrayPortal.h>
+#include <vtkm/cont/internal/MemoryMappedFile.h>
+
+#include <memory>
+
+namespace vtkm
+{
+namespace cont
+{
+
+/// A tag for read-only storage of values in a memory mapped file.
+struct VTKM_ALWAYS_EXPORT StorageTagMemoryMapped
+{
+};
+
+namespace internal
+{
+
+/// \brief A read-only portal to values stored in a block of raw memory.
+///
+/// The values may be at any alignment. When \c SwapBytes is set the bytes of
+/// each component are reversed as the values are read, which allows data
+/// stored with the opposite endianness to be used in place.
+///
+template <typename T>
+class VTKM_ALWAYS_EXPORT ArrayPortalMemoryMapped
+{
+public:
+  using ValueType = T;
+
+  VTKM_EXEC_CONT
+  ArrayPortalMemoryMapped()
+    : Data(nullptr)
+    , NumberOfValues(0)
+    , SwapBytes(false)
+  {
+  }
+
+  VTKM_EXEC_CONT
+  ArrayPortalMemoryMapped(const vtkm::UInt8* data, vtkm::Id numberOfValues, bool swapBytes)
+    : Data(data)
+    , NumberOfValues(numberOfValues)
+    , SwapBytes(swapBytes)
+  {
+  }
+
+  VTKM_EXEC_CONT
+  vtkm::Id GetNumberOfValues() const { return this->NumberOfValues; }
+
+  VTKM_EXEC_CONT
+  ValueType Get(vtkm::Id index) const
+  {
+    // Copy byte by byte, as the value may be unaligned. memcpy and
+    // std::reverse are not available in device code.
+    ValueType value;
+    vtkm::UInt8* bytes = reinterpret_cast<vtkm::UInt8*>(&value);
+    const vtkm::UInt8* source = this->Data + static_cast<std::size_t>(index) * sizeof(ValueType);
+    if (this->SwapBytes)
+    {
+      const std::size_t componentSize = sizeof(typename vtkm::VecTraits<ValueType>::ComponentType);
+      for (std::size_t offset = 0; offset < sizeof(ValueType); offset += componentSize)
+      {
+        for (std::size_t byte = 0; byte < componentSize; ++byte)
+        {
+          bytes[offset + byte] = source[offset + componentSize - 1 - byte];
+        }
+      }
+    }
+    else
+    {
+      for (std::size_t byte = 0; byte < sizeof(ValueType); ++byte)
+      {
+        bytes[byte] = source[byte];
+      }
+    }
+    return value;
+  }
+
+  VTKM_EXEC_CONT
+  void Set(vtkm::Id vtkmNotUsed(index), const ValueType& vtkmNotUsed(value)) const
+  {
+#if !(defined(VTKM_MSVC) && defined(VTKM_CUDA))
+    VTKM_ASSERT(false && "Cannot write to read-only memory mapped array.");
+#endif
+  }
+
+  using IteratorType = vtkm::cont::internal::IteratorFromArrayPortal<ArrayPortalMemoryMapped<T>>;
+
+  VTKM_CONT
+  IteratorType GetIteratorBegin() const { return IteratorType(*this); }
+
+  VTKM_CONT
+  IteratorType GetIteratorEnd() const { return IteratorType(*this, this->NumberOfValues); }
+
+private:
+  const vtkm::UInt8* Data;
+  vtkm::Id NumberOfValues;
+  bool SwapBytes;
+};
+
+/// Memory mapped storage keeps the file mapped for as long as any array
+/// refers to it. The arrays are read-only.
+template <typename T>
+class VTKM_ALWAYS_EXPORT Storage<T, vtkm::cont::StorageTagMemoryMapped>
+{
+public:
+  using ValueType = T;
+  using PortalConstType = ArrayPortalMemoryMapped<T>;
+  using PortalType = PortalConstType;
+
+  VTKM_CONT
+  Storage()
+    : Portal()
+  {
+  }
+
+  VTKM_CONT
+  Storage(const std::shared_ptr<vtkm::cont::internal::MemoryMappedFile>& file,
+          vtkm::UInt64 offset,
+          vtkm::Id numberOfValues,
+          bool swapBytes)
+    : File(file)
+  {
+    const vtkm::UInt64 numberOfBytes =
+      static_cast<vtkm::UInt64>(numberOfValues) * static_cast<vtkm::UInt64>(sizeof(T));
+    if ((numberOfValues < 0) || (offset > file->GetSize()) ||
+        (numberOfBytes > file->GetSize() - offset))
+    {
+      throw vtkm::cont::ErrorBadValue("Array extends past the end of file " +
+                                      file->GetFileName());
+    }
+    this->Portal = PortalConstType(file->GetData() + offset, numberOfValues, swapBytes);
+  }
+
+  VTKM_CONT
+  PortalType GetPortal()
+  {
+    throw vtkm::cont::ErrorBadValue("Memory mapped arrays are read-only.");
+  }
+
+  VTKM_CONT
+  PortalConstType GetPortalConst() const { return this->Portal; }
+
+  VTKM_CONT
+  vtkm::Id GetNumberOfValues() const { return this->Portal.GetNumberOfValues(); }
+
+  VTKM_CONT
+  void Allocate(vtkm::Id vtkmNotUsed(numberOfValues))
+  {
+    throw vtkm::cont::ErrorBadValue("Memory mapped arrays are read-only.");
+  }
+
+  VTKM_CONT
+  void Shrink(vtkm::Id vtkmNotUsed(numberOfValues))
+  {
+    throw vtkm::cont::ErrorBadValue("Memory mapped arrays are read-only.");
+  }
+
+  VTKM_CONT
+  void ReleaseResources() {}
+
+private:
+  std::shared_ptr<vtkm::cont::internal::MemoryMappedFile> File;
+  PortalConstType Portal;
+};
+
+} // namespace internal
+
+/// \brief An \c ArrayHandle of values read in place from a file.
+///
+/// \c ArrayHandleMemoryMapped exposes \c numberOfValues values of type \c T
+/// stored at \c offset bytes into a file without reading them into an array
+/// first. The file is mapped into memory, so values are only loaded from disk
+/// when they are accessed and no second copy is made. If the file stores the
+/// values with the opposite endianness, set \c swapBytes and the bytes are
+/// swapped as the values are read.
+///
+/// The array is read-only. Several arrays can share one file by passing the
+/// same \c MemoryMappedFile.
+///
+/// Note that the default storage lists only contain basic storage, so a \c
+/// DynamicArrayHandle or \c Field holding a memory mapped array must be cast
+/// with a storage list that includes \c StorageTagMemoryMapped.
+///
+template <typename T>
+class ArrayHandleMemoryMapped
+  : public vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagMemoryMapped>
+{
+public:
+  VTKM_ARRAY_HANDLE_SUBCLASS(ArrayHandleMemoryMapped,
+                             (ArrayHandleMemoryMapped<T>),
+                             (vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagMemoryMapped>));
+
+private:
+  using StorageType = vtkm::cont::internal::Storage<T, StorageTag>;
+
+public:
+  VTKM_CONT
+  ArrayHandleMemoryMapped(const std::shared_ptr<vtkm::cont::internal::MemoryMappedFile>& file,
+                          vtkm::UInt64 offset,
+                          vtkm::Id numberOfValues,
+                          bool swapBytes = false)
+    : Superclass(StorageType(file, offset, numberOfValues, swapBytes))
+  {
+  }
+
+  VTKM_CONT
+  ArrayHandleMemoryMapped(const std::string& fileName,
+                          vtkm::UInt64 offset,
+                          vtkm::Id numberOfValues,
+                          bool swapBytes = false)
+    : Superclass(StorageType(std::make_shared<vtkm::cont::internal::MemoryMappedFile>(fileName),
+                             offset,
+                             numberOfValues,
+                             swapBytes))
+  {
+  }
+};
+
+template <typename T>
+VTKM_CONT vtkm::cont::ArrayHandleMemoryMapped<T> make_ArrayHandleMemoryMapped(
+  const std::string& fileName,
+  vtkm::UInt64 offset,
+  vtkm::Id numberOfValues,
+  bool swapBytes = false)
+{
+  return ArrayHandleMemoryMapped<T>(fileName, offset, numberOfValues, swapBytes);
+}
+}
+} // namespace vtkm::cont
+
+#endif //vtk_m_cont_ArrayHandleMemoryMapped_h
@@ -23,6 +23,7 @@
 #include <vtkm/cont/ArrayRangeCompute.h>
 
 #include <vtkm/BinaryOperators.h>
+#include <vtkm/Math.h>
 #include <vtkm/VecTraits.h>
 
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
@@ -36,6 +37,56 @@ namespace cont
 namespace detail
 {
 
+// Like vtkm::MinAndMax, but compares each component of Vec values on its
+// own, and skips NaN values so that they do not hide the range of the rest
+// of the array. The range of a component with only NaN values is NaN.
+template <typename T>
+struct MinAndMaxSkipNan
+{
+  using VecTraits = vtkm::VecTraits<T>;
+  using ComponentType = typename VecTraits::ComponentType;
+
+  VTKM_EXEC_CONT
+  vtkm::Vec<T, 2> operator()(const vtkm::Vec<T, 2>& a, const vtkm::Vec<T, 2>& b) const
+  {
+    vtkm::Vec<T, 2> result = a;
+    for (vtkm::IdComponent i = 0; i < VecTraits::NUM_COMPONENTS; ++i)
+    {
+      ComponentType minA = VecTraits::GetComponent(a[0], i);
+      ComponentType minB = VecTraits::GetComponent(b[0], i);
+      if (vtkm::IsNan(minA) || (minB < minA))
+      {
+        VecTraits::SetComponent(result[0], i, minB);
+      }
+      ComponentType maxA = VecTraits::GetComponent(a[1], i);
+      ComponentType maxB = VecTraits::GetComponent(b[1], i);
+      if (vtkm::IsNan(maxA) || (maxB > maxA))
+      {
+        VecTraits::SetComponent(result[1], i, maxB);
+      }
+    }
+    return result;
+  }
+
+  VTKM_EXEC_CONT
+  vtkm::Vec<T, 2> operator()(const T& a, const T& b) const
+  {
+    return (*this)(vtkm::Vec<T, 2>(a), vtkm::Vec<T, 2>(b));
+  }
+
+  VTKM_EXEC_CONT
+  vtkm::Vec<T, 2> operator()(const T& a, const vtkm::Vec<T, 2>& b) const
+  {
+    return (*this)(vtkm::Vec<T, 2>(a), b);
+  }
+
+  VTKM_EXEC_CONT
+  vtkm::Vec<T, 2> operator()(const vtkm::Vec<T, 2>& a, const T& b) const
+  {
+    return (*this)(a, vtkm::Vec<T, 2>(b));
+  }
+};
+
 template <typename ArrayHandleType>
 struct ArrayRangeComputeFunctor
 {
@@ -74,14 +125,16 @@ struct ArrayRangeComputeFunctor
 
     vtkm::Vec<ValueType, 2> initial(this->InputArray.GetPortalConstControl().Get(0));
 
+    // All the components are reduced together in a single pass.
     vtkm::Vec<ValueType, 2> result =
-      Algorithm::Reduce(this->InputArray, initial, vtkm::MinAndMax<ValueType>());
+      Algorithm::Reduce(this->InputArray, initial, MinAndMaxSkipNan<ValueType>());
 
     for (vtkm::IdComponent i = 0; i < NumberOfComponents; ++i)
     {
+      vtkm::Range range(VecTraits::GetComponent(result[0], i),
+                        VecTraits::GetComponent(result[1], i));
       this->RangeArray.GetPortalControl().Set(
-        i,
-        vtkm::Range(VecTraits::GetComponent(result[0], i), VecTraits::GetComponent(result[1], i)));
+        i, vtkm::IsNan(range.Min) ? vtkm::Range() : range);
     }
 
     return true;
@@ -620,6 +620,72 @@ public:
     ArrayPortalConst<vtkm::Id> CellStartIndex;
     ArrayPortalConst<vtkm::Id> CellCount;
     ArrayPortalConst<vtkm::Id> CellIds;
+
+    /// Returns true if \c point is inside cell \c cellId of \c cellSet and sets
+    /// the parametric coordinates of the point in that cell.
+    ///
+    template <typename CellSetType, typename CoordsPortalType>
+    VTKM_EXEC bool IsPointInCell(const FloatVec3& point,
+                                 vtkm::Id cellId,
+                                 const CellSetType& cellSet,
+                                 const CoordsPortalType& coords,
+                                 const vtkm::exec::FunctorBase& worklet,
+                                 FloatVec3& parametricCoordinates) const
+    {
+      auto indices = cellSet.GetIndices(cellId);
+      vtkm::VecFromPortalPermute<decltype(indices), CoordsPortalType> pts(&indices, coords);
+      return PointInsideCell(
+        point, cellSet.GetCellShape(cellId), pts, worklet, parametricCoordinates);
+    }
+
+    /// Returns the id of the cell of \c cellSet containing \c point, or -1 if
+    /// no cell is found, and sets the parametric coordinates of the point in
+    /// that cell.
+    ///
+    template <typename CellSetType, typename CoordsPortalType>
+    VTKM_EXEC vtkm::Id FindCell(const FloatVec3& point,
+                                const CellSetType& cellSet,
+                                const CoordsPortalType& coords,
+                                const vtkm::exec::FunctorBase& worklet,
+                                FloatVec3& parametricCoordinates) const
+    {
+      const Grid& topLevelGrid = this->TopLevel;
+
+      DimVec3 binId3 = static_cast<DimVec3>((point - topLevelGrid.Origin) / topLevelGrid.BinSize);
+      if (binId3[0] >= 0 && binId3[0] < topLevelGrid.Dimensions[0] && binId3[1] >= 0 &&
+          binId3[1] < topLevelGrid.Dimensions[1] && binId3[2] >= 0 &&
+          binId3[2] < topLevelGrid.Dimensions[2])
+      {
+        vtkm::Id binId = ComputeFlatIndex(binId3, topLevelGrid.Dimensions);
+
+        auto ldim = this->LeafDimensions.Get(binId);
+        if (!ldim[0] || !ldim[1] || !ldim[2])
+        {
+          return -1;
+        }
+
+        auto leafGrid = ComputeLeafGrid(binId3, ldim, topLevelGrid);
+
+        DimVec3 leafId3 = static_cast<DimVec3>((point - leafGrid.Origin) / leafGrid.BinSize);
+        // precision issues may cause leafId3 to be out of range so clamp it
+        leafId3 = vtkm::Max(DimVec3(0), vtkm::Min(ldim - DimVec3(1), leafId3));
+
+        vtkm::Id leafStart = this->LeafStartIndex.Get(binId);
+        vtkm::Id leafId = leafStart + ComputeFlatIndex(leafId3, leafGrid.Dimensions);
+
+        vtkm::Id start = this->CellStartIndex.Get(leafId);
+        vtkm::Id end = start + this->CellCount.Get(leafId);
+        for (vtkm::Id i = start; i < end; ++i)
+        {
+          vtkm::Id cid = this->CellIds.Get(i);
+          if (this->IsPointInCell(point, cid, cellSet, coords, worklet, parametricCoordinates))
+          {
+            return cid;
+          }
+        }
+      }
+      return -1;
+    }
   };
 
   class FindCellWorklet : public vtkm::worklet::WorkletMapField
@@ -646,51 +712,10 @@ public:
                               vtkm::Id& cellId,
                               FloatVec3& parametricCoordinates) const
     {
-      cellId = -1;
       FloatVec3 p(static_cast<FloatDefault>(point[0]),
                   static_cast<FloatDefault>(point[1]),
                   static_cast<FloatDefault>(point[2]));
-
-      const Grid& topLevelGrid = lookupStruct.TopLevel;
-
-      DimVec3 binId3 = static_cast<DimVec3>((p - topLevelGrid.Origin) / topLevelGrid.BinSize);
-      if (binId3[0] >= 0 && binId3[0] < topLevelGrid.Dimensions[0] && binId3[1] >= 0 &&
-          binId3[1] < topLevelGrid.Dimensions[1] && binId3[2] >= 0 &&
-          binId3[2] < topLevelGrid.Dimensions[2])
-      {
-        vtkm::Id binId = ComputeFlatIndex(binId3, topLevelGrid.Dimensions);
-
-        auto ldim = lookupStruct.LeafDimensions.Get(binId);
-        if (!ldim[0] || !ldim[1] || !ldim[2])
-        {
-          return;
-        }
-
-        auto leafGrid = ComputeLeafGrid(binId3, ldim, topLevelGrid);
-
-        DimVec3 leafId3 = static_cast<DimVec3>((p - leafGrid.Origin) / leafGrid.BinSize);
-        // precision issues may cause leafId3 to be out of range so clamp it
-        leafId3 = vtkm::Max(DimVec3(0), vtkm::Min(ldim - DimVec3(1), leafId3));
-
-        vtkm::Id leafStart = lookupStruct.LeafStartIndex.Get(binId);
-        vtkm::Id leafId = leafStart + ComputeFlatIndex(leafId3, leafGrid.Dimensions);
-
-        vtkm::Id start = lookupStruct.CellStartIndex.Get(leafId);
-        vtkm::Id end = start + lookupStruct.CellCount.Get(leafId);
-        for (vtkm::Id i = start; i < end; ++i)
-        {
-          vtkm::Id cid = lookupStruct.CellIds.Get(i);
-          auto indices = cellSet.GetIndices(cid);
-          vtkm::VecFromPortalPermute<decltype(indices), CoordsPortalType> pts(&indices, coords);
-          FloatVec3 pc;
-          if (PointInsideCell(p, cellSet.GetCellShape(cid), pts, *this, pc))
-          {
-            cellId = cid;
-            parametricCoordinates = pc;
-            break;
-          }
-        }
-      }
+      cellId = lookupStruct.FindCell(p, cellSet, coords, *this, parametricCoordinates);
     }
   };
 
@@ -720,7 +745,10 @@ public:
       parametricCoords);
   }
 
-private:
+  /// Returns the lookup structure in the execution environment of \c device,
+  /// for finding cells from within a worklet with its \c FindCell method.
+  /// The locator must have been built and must outlive the returned object.
+  ///
   template <typename DeviceAdapter>
   TwoLevelUniformGridExecution<DeviceAdapter> PrepareForDevice(DeviceAdapter device) const
   {
@@ -734,6 +762,7 @@ private:
     return deviceObject;
   }
 
+private:
   vtkm::FloatDefault DensityL1, DensityL2;
 
   vtkm::cont::DynamicCellSet CellSet;
@@ -72,7 +72,8 @@ const vtkm::cont::DynamicArrayHandle& Field::GetData() const
 VTKM_CONT
 vtkm::cont::DynamicArrayHandle& Field::GetData()
 {
-  this->ModifiedFlag = true;
+  // The data may be modified in place, which all the copies sharing it see.
+  this->RangeCache->ModifiedFlag = true;
   return this->Data;
 }
 
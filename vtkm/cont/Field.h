@@ -30,6 +30,8 @@
 #include <vtkm/cont/ArrayRangeCompute.h>
 #include <vtkm/cont/DynamicArrayHandle.h>
 
+#include <memory>
+
 namespace vtkm
 {
 namespace cont
@@ -56,6 +58,17 @@ private:
   vtkm::cont::ArrayHandle<vtkm::Range>* Range;
 };
 
+/// The cached range of the data of a \c Field. Copies of a field share it
+/// along with the data, so that copying a field (or the \c DataSet holding
+/// it) does not cause the range to be computed again. Getting the data for
+/// modification marks the shared range as modified, and replacing the data
+/// gives the field a cache of its own.
+struct FieldRangeCache
+{
+  vtkm::cont::ArrayHandle<vtkm::Range> Range;
+  bool ModifiedFlag = true;
+};
+
 } // namespace internal
 
 /// A \c Field encapsulates an array on some piece of the mesh, such as
@@ -81,8 +94,7 @@ public:
     , AssocCellSetName()
     , AssocLogicalDim(-1)
     , Data(data)
-    , Range()
-    , ModifiedFlag(true)
+    , RangeCache(std::make_shared<internal::FieldRangeCache>())
   {
     VTKM_ASSERT(this->Association == ASSOC_WHOLE_MESH || this->Association == ASSOC_POINTS);
   }
@@ -96,8 +108,7 @@ public:
     , AssocCellSetName()
     , AssocLogicalDim(-1)
     , Data(data)
-    , Range()
-    , ModifiedFlag(true)
+    , RangeCache(std::make_shared<internal::FieldRangeCache>())
   {
     VTKM_ASSERT((this->Association == ASSOC_WHOLE_MESH) || (this->Association == ASSOC_POINTS));
   }
@@ -113,8 +124,7 @@ public:
     , AssocCellSetName(cellSetName)
     , AssocLogicalDim(-1)
     , Data(data)
-    , Range()
-    , ModifiedFlag(true)
+    , RangeCache(std::make_shared<internal::FieldRangeCache>())
   {
     VTKM_ASSERT(this->Association == ASSOC_CELL_SET);
   }
@@ -129,8 +139,7 @@ public:
     , AssocCellSetName(cellSetName)
     , AssocLogicalDim(-1)
     , Data(data)
-    , Range()
-    , ModifiedFlag(true)
+    , RangeCache(std::make_shared<internal::FieldRangeCache>())
   {
     VTKM_ASSERT(this->Association == ASSOC_CELL_SET);
   }
@@ -146,8 +155,7 @@ public:
     , AssocCellSetName()
     , AssocLogicalDim(logicalDim)
     , Data(data)
-    , Range()
-    , ModifiedFlag(true)
+    , RangeCache(std::make_shared<internal::FieldRangeCache>())
   {
     VTKM_ASSERT(this->Association == ASSOC_LOGICAL_DIM);
   }
@@ -161,8 +169,7 @@ public:
     , Association(association)
     , AssocLogicalDim(logicalDim)
     , Data(data)
-    , Range()
-    , ModifiedFlag(true)
+    , RangeCache(std::make_shared<internal::FieldRangeCache>())
   {
     VTKM_ASSERT(this->Association == ASSOC_LOGICAL_DIM);
   }
@@ -174,8 +181,7 @@ public:
     , AssocCellSetName()
     , AssocLogicalDim()
     , Data()
-    , Range()
-    , ModifiedFlag(true)
+    , RangeCache(std::make_shared<internal::FieldRangeCache>())
   {
     //Generate an empty field
   }
@@ -214,12 +220,13 @@ public:
     VTKM_IS_LIST_TAG(TypeList);
     VTKM_IS_LIST_TAG(StorageList);
 
-    this->GetRange(TypeList(), StorageList());
+    const vtkm::cont::ArrayHandle<vtkm::Range>& ranges =
+      this->GetRange(TypeList(), StorageList());
 
-    vtkm::Id length = this->Range.GetNumberOfValues();
+    vtkm::Id length = ranges.GetNumberOfValues();
     for (vtkm::Id i = 0; i < length; ++i)
     {
-      range[i] = this->Range.GetPortalConstControl().Get(i);
+      range[i] = ranges.GetPortalConstControl().Get(i);
     }
   }
 
@@ -253,21 +260,21 @@ public:
   VTKM_CONT void SetData(const vtkm::cont::ArrayHandle<T, StorageTag>& newdata)
   {
     this->Data = newdata;
-    this->ModifiedFlag = true;
+    this->RangeCache = std::make_shared<internal::FieldRangeCache>();
   }
 
   VTKM_CONT
   void SetData(const vtkm::cont::DynamicArrayHandle& newdata)
   {
     this->Data = newdata;
-    this->ModifiedFlag = true;
+    this->RangeCache = std::make_shared<internal::FieldRangeCache>();
   }
 
   template <typename T>
   VTKM_CONT void CopyData(const T* ptr, vtkm::Id nvals)
   {
     this->Data = vtkm::cont::make_ArrayHandle(ptr, nvals, true);
-    this->ModifiedFlag = true;
+    this->RangeCache = std::make_shared<internal::FieldRangeCache>();
   }
 
   VTKM_CONT
@@ -281,8 +288,7 @@ private:
   vtkm::IdComponent AssocLogicalDim; ///< only populate if assoc is logical dim
 
   vtkm::cont::DynamicArrayHandle Data;
-  mutable vtkm::cont::ArrayHandle<vtkm::Range> Range;
-  mutable bool ModifiedFlag;
+  std::shared_ptr<internal::FieldRangeCache> RangeCache;
 
   template <typename TypeList, typename StorageList>
   VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::Range>& GetRangeImpl(TypeList, StorageList) const
@@ -290,14 +296,15 @@ private:
     VTKM_IS_LIST_TAG(TypeList);
     VTKM_IS_LIST_TAG(StorageList);
 
-    if (this->ModifiedFlag)
+    internal::FieldRangeCache& cache = *this->RangeCache;
+    if (cache.ModifiedFlag)
     {
-      internal::ComputeRange computeRange(this->Range);
+      internal::ComputeRange computeRange(cache.Range);
       this->Data.ResetTypeAndStorageLists(TypeList(), StorageList()).CastAndCall(computeRange);
-      this->ModifiedFlag = false;
+      cache.ModifiedFlag = false;
     }
 
-    return this->Range;
+    return cache.Range;
   }
 };
 
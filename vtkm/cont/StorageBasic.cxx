@@ -33,6 +33,9 @@
 
 #if defined(VTKM_MEMALIGN_POSIX)
 #include <stdlib.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 #elif defined(VTKM_MEMALIGN_WIN)
 #include <malloc.h>
 #elif defined(VTKM_MEMALIGN_SSE)
@@ -41,8 +44,10 @@
 #include <malloc.h>
 #endif
 
+#include <atomic>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 
 namespace vtkm
 {
@@ -51,18 +56,76 @@ namespace cont
 namespace internal
 {
 
+namespace
+{
+
+bool GetEnvironmentFlag(const char* name)
+{
+  const char* value = std::getenv(name);
+  return (value == nullptr) || ((std::strcmp(value, "0") != 0) && (std::strcmp(value, "off") != 0));
+}
+
+std::atomic<bool>& UseHugePagesFlag()
+{
+  static std::atomic<bool> flag(GetEnvironmentFlag("VTKM_HUGE_PAGES"));
+  return flag;
+}
+
+std::atomic<bool>& UseFirstTouchFlag()
+{
+  static std::atomic<bool> flag(GetEnvironmentFlag("VTKM_FIRST_TOUCH"));
+  return flag;
+}
+
+} // anonymous namespace
+
 StorageBasicBase::~StorageBasicBase()
 {
 }
 
+bool GetUseHugePages()
+{
+  return UseHugePagesFlag().load();
+}
+
+void SetUseHugePages(bool useHugePages)
+{
+  UseHugePagesFlag().store(useHugePages);
+}
+
+bool GetUseFirstTouch()
+{
+  return UseFirstTouchFlag().load();
+}
+
+void SetUseFirstTouch(bool useFirstTouch)
+{
+  UseFirstTouchFlag().store(useFirstTouch);
+}
+
 void* alloc_aligned(size_t size, size_t align)
 {
 #if defined(VTKM_MEMALIGN_POSIX)
+  const bool useHugePages = (size >= VTKM_HUGE_PAGE_SIZE) && GetUseHugePages();
+  if (useHugePages && (align < VTKM_HUGE_PAGE_SIZE))
+  {
+    align = VTKM_HUGE_PAGE_SIZE;
+  }
+
   void* mem = nullptr;
   if (posix_memalign(&mem, align, size) != 0)
   {
     mem = nullptr;
   }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  else if (useHugePages)
+  {
+    // Only whole huge pages can be advised. This is just a hint, so failures
+    // (for example when transparent huge pages are disabled) are ignored.
+    const size_t hugeSize = size - (size % VTKM_HUGE_PAGE_SIZE);
+    madvise(mem, hugeSize, MADV_HUGEPAGE);
+  }
+#endif
 #elif defined(VTKM_MEMALIGN_WIN)
   void* mem = _aligned_malloc(size, align);
 #elif defined(VTKM_MEMALIGN_SSE)
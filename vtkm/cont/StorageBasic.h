@@ -25,6 +25,7 @@
 #include <vtkm/cont/ErrorBadAllocation.h>
 #include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/Storage.h>
+#include <vtkm/cont/StorageBasicMemoryPool.h>
 
 #include <vtkm/cont/internal/ArrayPortalFromIterators.h>
 
@@ -33,6 +34,11 @@
 #define VTKM_CACHE_LINE_SIZE 64
 #endif
 
+// Defines the size in bytes of the huge pages used for large allocations
+#ifndef VTKM_HUGE_PAGE_SIZE
+#define VTKM_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
 namespace vtkm
 {
 namespace cont
@@ -52,6 +58,35 @@ void* alloc_aligned(size_t size, size_t align);
 VTKM_CONT_EXPORT
 void free_aligned(void* mem);
 
+/// \brief Controls whether large allocations use transparent huge pages.
+///
+/// When enabled, \c alloc_aligned aligns allocations of at least \c
+/// VTKM_HUGE_PAGE_SIZE bytes to huge page boundaries and, where the system
+/// supports it (Linux), advises the kernel to back them with huge pages. This
+/// cuts the TLB misses of streaming through large arrays. Enabled by default;
+/// setting the \c VTKM_HUGE_PAGES environment variable to \c 0 or \c off
+/// disables it.
+VTKM_CONT_EXPORT
+bool GetUseHugePages();
+VTKM_CONT_EXPORT
+void SetUseHugePages(bool useHugePages);
+
+/// \brief Controls the first touch placement of large output arrays.
+///
+/// Operating systems place a page of memory on the NUMA node of the thread
+/// that first writes it. When enabled, multithreaded devices that share memory
+/// with the control environment (TBB) write every page of a newly allocated
+/// output array of at least \c VTKM_HUGE_PAGE_SIZE bytes in parallel,
+/// partitioned the way their \c Schedule is, so that the pages end up local
+/// to the threads that process them. Memory reused from the \c
+/// StorageBasicMemoryPool is already placed and is not touched. Enabled by
+/// default; setting the \c VTKM_FIRST_TOUCH environment variable to \c 0 or
+/// \c off disables it.
+VTKM_CONT_EXPORT
+bool GetUseFirstTouch();
+VTKM_CONT_EXPORT
+void SetUseFirstTouch(bool useFirstTouch);
+
 /// \brief an aligned allocator
 /// A simple aligned allocator type that will align allocations to `Alignment` bytes
 /// TODO: Once C++11 std::allocator_traits is better used by STL and we want to drop
@@ -166,6 +201,13 @@ public:
   /// array's allocated memory buffer.
   VTKM_CONT
   virtual void* GetCapacityPointer() const = 0;
+
+  /// Returns whether the last allocation got new memory from the system, as
+  /// opposed to keeping the current buffer or reusing a block of the memory
+  /// pool. The pages of new memory have not been written yet, so first touch
+  /// decides where they are placed.
+  VTKM_CONT
+  virtual bool GetAllocationIsFresh() const = 0;
 };
 
 /// A basic implementation of an Storage object.
@@ -274,6 +316,16 @@ public:
   VTKM_CONT
   bool WillDeallocate() const { return this->DeallocateOnRelease; }
 
+  /// \brief Sets whether allocations draw from the \c StorageBasicMemoryPool.
+  ///
+  /// By default arrays take their memory from the pool and give it back when
+  /// released. Arrays whose memory should be returned directly to the system
+  /// (for example a very large array that is not going to be allocated again)
+  /// can opt out. The setting takes effect on the next allocation.
+  VTKM_CONT
+  void SetUseMemoryPool(bool useMemoryPool) { this->UseMemoryPool = useMemoryPool; }
+  VTKM_CONT
+  bool GetUseMemoryPool() const { return this->UseMemoryPool; }
 
   VTKM_CONT
   void* GetBasePointer() const final { return static_cast<void*>(this->Array); }
@@ -290,11 +342,17 @@ public:
     return static_cast<void*>(this->Array + this->AllocatedSize);
   }
 
+  VTKM_CONT
+  bool GetAllocationIsFresh() const final { return this->AllocationIsFresh; }
+
 private:
   ValueType* Array;
   vtkm::Id NumberOfValues;
   vtkm::Id AllocatedSize;
   bool DeallocateOnRelease;
+  bool UseMemoryPool;
+  bool AllocatedFromPool;
+  bool AllocationIsFresh;
 };
 
 } // namespace internal
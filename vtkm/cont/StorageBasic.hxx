@@ -35,6 +35,9 @@ Storage<T, vtkm::cont::StorageTagBasic>::Storage()
   , NumberOfValues(0)
   , AllocatedSize(0)
   , DeallocateOnRelease(true)
+  , UseMemoryPool(true)
+  , AllocatedFromPool(false)
+  , AllocationIsFresh(false)
 {
 }
 
@@ -44,6 +47,9 @@ Storage<T, vtkm::cont::StorageTagBasic>::Storage(const T* array, vtkm::Id number
   , NumberOfValues(numberOfValues)
   , AllocatedSize(numberOfValues)
   , DeallocateOnRelease(array == nullptr ? true : false)
+  , UseMemoryPool(true)
+  , AllocatedFromPool(false)
+  , AllocationIsFresh(false)
 {
 }
 
@@ -59,6 +65,9 @@ Storage<T, vtkm::cont::StorageTagBasic>::Storage(const Storage<T, StorageTagBasi
   , NumberOfValues(src.NumberOfValues)
   , AllocatedSize(src.AllocatedSize)
   , DeallocateOnRelease(src.DeallocateOnRelease)
+  , UseMemoryPool(src.UseMemoryPool)
+  , AllocatedFromPool(false)
+  , AllocationIsFresh(false)
 {
   if (src.DeallocateOnRelease)
   {
@@ -84,6 +93,9 @@ Storage<T, vtkm::cont::StorageTagBasic>& Storage<T, vtkm::cont::StorageTagBasic>
   this->NumberOfValues = src.NumberOfValues;
   this->AllocatedSize = src.AllocatedSize;
   this->DeallocateOnRelease = src.DeallocateOnRelease;
+  this->UseMemoryPool = src.UseMemoryPool;
+  this->AllocatedFromPool = false;
+  this->AllocationIsFresh = false;
 
   return *this;
 }
@@ -96,10 +108,20 @@ void Storage<T, vtkm::cont::StorageTagBasic>::ReleaseResources()
     VTKM_ASSERT(this->Array != nullptr);
     if (this->DeallocateOnRelease)
     {
-      AllocatorType allocator;
-      allocator.deallocate(this->Array, static_cast<std::size_t>(this->AllocatedSize));
+      if (this->AllocatedFromPool)
+      {
+        vtkm::cont::StorageBasicMemoryPool::Free(
+          this->Array,
+          static_cast<vtkm::UInt64>(this->AllocatedSize) * static_cast<vtkm::UInt64>(sizeof(T)));
+      }
+      else
+      {
+        AllocatorType allocator;
+        allocator.deallocate(this->Array, static_cast<std::size_t>(this->AllocatedSize));
+      }
     }
     this->Array = nullptr;
+    this->AllocatedFromPool = false;
     this->NumberOfValues = 0;
     this->AllocatedSize = 0;
   }
@@ -133,6 +155,8 @@ void Storage<T, vtkm::cont::StorageTagBasic>::AllocateBytes(vtkm::UInt64 numberO
   const vtkm::Id numberOfValues =
     static_cast<vtkm::Id>(numberOfBytes / static_cast<vtkm::UInt64>(sizeof(T)));
 
+  this->AllocationIsFresh = false;
+
   // If we are allocating less data, just shrink the array.
   // (If allocation empty, drop down so we can deallocate memory.)
   if ((numberOfValues <= this->AllocatedSize) && (numberOfValues > 0))
@@ -151,8 +175,23 @@ void Storage<T, vtkm::cont::StorageTagBasic>::AllocateBytes(vtkm::UInt64 numberO
   {
     if (numberOfValues > 0)
     {
-      AllocatorType allocator;
-      this->Array = allocator.allocate(static_cast<std::size_t>(numberOfValues));
+      if (this->UseMemoryPool)
+      {
+        // Memory released by other arrays is reused through the pool, which
+        // avoids the allocation and the page faults of touching fresh memory.
+        bool reused;
+        this->Array = static_cast<T*>(vtkm::cont::StorageBasicMemoryPool::Allocate(
+          static_cast<vtkm::UInt64>(numberOfValues) * static_cast<vtkm::UInt64>(sizeof(T)),
+          this->AllocatedFromPool,
+          reused));
+        this->AllocationIsFresh = !reused;
+      }
+      else
+      {
+        AllocatorType allocator;
+        this->Array = allocator.allocate(static_cast<std::size_t>(numberOfValues));
+        this->AllocationIsFresh = true;
+      }
       this->AllocatedSize = numberOfValues;
       this->NumberOfValues = numberOfValues;
     }
@@ -168,6 +207,7 @@ void Storage<T, vtkm::cont::StorageTagBasic>::AllocateBytes(vtkm::UInt64 numberO
     this->Array = nullptr;
     this->NumberOfValues = 0;
     this->AllocatedSize = 0;
+    this->AllocatedFromPool = false;
     throw vtkm::cont::ErrorBadAllocation("Could not allocate basic control array.");
   }
 
@@ -196,6 +236,13 @@ void Storage<T, vtkm::cont::StorageTagBasic>::ShrinkBytes(vtkm::UInt64 numberOfB
 template <typename T>
 T* Storage<T, vtkm::cont::StorageTagBasic>::StealArray()
 {
+  if (this->DeallocateOnRelease && this->AllocatedFromPool)
+  {
+    // The caller now owns the memory, so the pool no longer accounts for it.
+    vtkm::cont::StorageBasicMemoryPool::Detach(static_cast<vtkm::UInt64>(this->AllocatedSize) *
+                                               static_cast<vtkm::UInt64>(sizeof(T)));
+    this->AllocatedFromPool = false;
+  }
   this->DeallocateOnRelease = false;
   return this->Array;
 }
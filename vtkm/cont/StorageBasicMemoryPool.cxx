@@ -0,0 +1,300 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#include <vtkm/cont/StorageBasicMemoryPool.h>
+
+#include <vtkm/cont/StorageBasic.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#if defined(VTKM_POSIX)
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <vtkm/internal/Windows.h>
+#endif
+
+namespace vtkm
+{
+namespace cont
+{
+
+namespace
+{
+
+const vtkm::UInt64 MINIMUM_DEFAULT_MAXIMUM_CACHED_BYTES = vtkm::UInt64(1) << 30;
+
+// Returns 0 when the size of the physical memory is unknown.
+vtkm::UInt64 GetPhysicalMemoryBytes()
+{
+#if defined(VTKM_POSIX) && defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+  const long pages = sysconf(_SC_PHYS_PAGES);
+  const long pageSize = sysconf(_SC_PAGESIZE);
+  if ((pages > 0) && (pageSize > 0))
+  {
+    return static_cast<vtkm::UInt64>(pages) * static_cast<vtkm::UInt64>(pageSize);
+  }
+#elif defined(_WIN32)
+  MEMORYSTATUSEX status;
+  status.dwLength = sizeof(status);
+  if (GlobalMemoryStatusEx(&status))
+  {
+    return static_cast<vtkm::UInt64>(status.ullTotalPhys);
+  }
+#endif
+  return 0;
+}
+
+struct MemoryPoolState
+{
+  std::mutex Mutex;
+  bool Enabled;
+  vtkm::UInt64 MaximumCachedBytes;
+
+  // Free blocks by block size.
+  std::map<vtkm::UInt64, std::vector<void*>> CachedBlocks;
+
+  StorageBasicMemoryPoolStatistics Statistics;
+
+  MemoryPoolState()
+    : Enabled(true)
+    , MaximumCachedBytes(StorageBasicMemoryPool::GetDefaultMaximumCachedBytes())
+  {
+    std::memset(&this->Statistics, 0, sizeof(this->Statistics));
+
+    const char* enabled = std::getenv("VTKM_MEMORY_POOL");
+    if ((enabled != nullptr) && ((std::strcmp(enabled, "0") == 0) ||
+                                 (std::strcmp(enabled, "off") == 0)))
+    {
+      this->Enabled = false;
+    }
+
+    const char* maximum = std::getenv("VTKM_MEMORY_POOL_MAX_CACHED_BYTES");
+    if (maximum != nullptr)
+    {
+      this->MaximumCachedBytes = static_cast<vtkm::UInt64>(std::strtoull(maximum, nullptr, 10));
+    }
+  }
+
+  // Must be called with the mutex locked. Releases the largest blocks first,
+  // as they hold the most memory for the fewest future allocations.
+  void Trim(vtkm::UInt64 cachedBytes)
+  {
+    while ((this->Statistics.BytesCached > cachedBytes) && !this->CachedBlocks.empty())
+    {
+      auto largest = std::prev(this->CachedBlocks.end());
+      vtkm::cont::internal::free_aligned(largest->second.back());
+      largest->second.pop_back();
+      this->Statistics.BytesCached -= largest->first;
+      if (largest->second.empty())
+      {
+        this->CachedBlocks.erase(largest);
+      }
+    }
+  }
+
+  void UpdatePeak()
+  {
+    this->Statistics.PeakBytes = std::max(this->Statistics.PeakBytes,
+                                          this->Statistics.BytesInUse +
+                                            this->Statistics.BytesCached);
+  }
+};
+
+// The state is never destroyed, because arrays in static storage can release
+// their memory to the pool after the destructors of function statics ran. The
+// system reclaims the cached blocks at exit.
+MemoryPoolState& GetState()
+{
+  static MemoryPoolState* state = new MemoryPoolState;
+  return *state;
+}
+
+} // anonymous namespace
+
+vtkm::UInt64 StorageBasicMemoryPool::GetDefaultMaximumCachedBytes()
+{
+  return std::max(GetPhysicalMemoryBytes() / 4, MINIMUM_DEFAULT_MAXIMUM_CACHED_BYTES);
+}
+
+vtkm::UInt64 StorageBasicMemoryPool::GetBlockSize(vtkm::UInt64 numberOfBytes)
+{
+  const vtkm::UInt64 minimumBlockSize = VTKM_CACHE_LINE_SIZE;
+  if (numberOfBytes <= minimumBlockSize)
+  {
+    return minimumBlockSize;
+  }
+
+  // Find the power of two just below numberOfBytes.
+  vtkm::UInt64 lowerPower = minimumBlockSize;
+  while (lowerPower * 2 < numberOfBytes)
+  {
+    lowerPower *= 2;
+  }
+  if (lowerPower < 4096)
+  {
+    return lowerPower * 2;
+  }
+
+  const vtkm::UInt64 step = lowerPower / 4;
+  return ((numberOfBytes + step - 1) / step) * step;
+}
+
+void* StorageBasicMemoryPool::Allocate(vtkm::UInt64 numberOfBytes, bool& allocatedFromPool)
+{
+  bool reused;
+  return Allocate(numberOfBytes, allocatedFromPool, reused);
+}
+
+void* StorageBasicMemoryPool::Allocate(vtkm::UInt64 numberOfBytes,
+                                       bool& allocatedFromPool,
+                                       bool& reused)
+{
+  reused = false;
+  MemoryPoolState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+
+  if (!state.Enabled)
+  {
+    lock.unlock();
+    allocatedFromPool = false;
+    return vtkm::cont::internal::alloc_aligned(static_cast<std::size_t>(numberOfBytes),
+                                               VTKM_CACHE_LINE_SIZE);
+  }
+
+  const vtkm::UInt64 blockSize = GetBlockSize(numberOfBytes);
+  ++state.Statistics.NumberOfAllocations;
+  allocatedFromPool = true;
+
+  auto cached = state.CachedBlocks.find(blockSize);
+  if (cached != state.CachedBlocks.end())
+  {
+    void* memory = cached->second.back();
+    cached->second.pop_back();
+    if (cached->second.empty())
+    {
+      state.CachedBlocks.erase(cached);
+    }
+    ++state.Statistics.NumberOfReuses;
+    reused = true;
+    state.Statistics.BytesCached -= blockSize;
+    state.Statistics.BytesInUse += blockSize;
+    return memory;
+  }
+
+  // Do not hold the lock during the system allocation.
+  lock.unlock();
+  void* memory =
+    vtkm::cont::internal::alloc_aligned(static_cast<std::size_t>(blockSize), VTKM_CACHE_LINE_SIZE);
+  lock.lock();
+  state.Statistics.BytesInUse += blockSize;
+  state.UpdatePeak();
+  return memory;
+}
+
+void StorageBasicMemoryPool::Free(void* memory, vtkm::UInt64 numberOfBytes)
+{
+  const vtkm::UInt64 blockSize = GetBlockSize(numberOfBytes);
+
+  MemoryPoolState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  state.Statistics.BytesInUse -= std::min(blockSize, state.Statistics.BytesInUse);
+
+  if (!state.Enabled || (blockSize > state.MaximumCachedBytes))
+  {
+    lock.unlock();
+    vtkm::cont::internal::free_aligned(memory);
+    return;
+  }
+
+  state.Trim(state.MaximumCachedBytes - blockSize);
+  state.CachedBlocks[blockSize].push_back(memory);
+  state.Statistics.BytesCached += blockSize;
+}
+
+void StorageBasicMemoryPool::Detach(vtkm::UInt64 numberOfBytes)
+{
+  const vtkm::UInt64 blockSize = GetBlockSize(numberOfBytes);
+
+  MemoryPoolState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Statistics.BytesInUse -= std::min(blockSize, state.Statistics.BytesInUse);
+}
+
+bool StorageBasicMemoryPool::GetEnabled()
+{
+  MemoryPoolState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.Enabled;
+}
+
+void StorageBasicMemoryPool::SetEnabled(bool enabled)
+{
+  MemoryPoolState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Enabled = enabled;
+  if (!enabled)
+  {
+    state.Trim(0);
+  }
+}
+
+vtkm::UInt64 StorageBasicMemoryPool::GetMaximumCachedBytes()
+{
+  MemoryPoolState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.MaximumCachedBytes;
+}
+
+void StorageBasicMemoryPool::SetMaximumCachedBytes(vtkm::UInt64 maximumCachedBytes)
+{
+  MemoryPoolState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.MaximumCachedBytes = maximumCachedBytes;
+  state.Trim(maximumCachedBytes);
+}
+
+void StorageBasicMemoryPool::Trim(vtkm::UInt64 cachedBytes)
+{
+  MemoryPoolState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Trim(cachedBytes);
+}
+
+StorageBasicMemoryPoolStatistics StorageBasicMemoryPool::GetStatistics()
+{
+  MemoryPoolState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.Statistics;
+}
+
+void StorageBasicMemoryPool::ResetStatistics()
+{
+  MemoryPoolState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Statistics.NumberOfAllocations = 0;
+  state.Statistics.NumberOfReuses = 0;
+  state.Statistics.PeakBytes = state.Statistics.BytesInUse + state.Statistics.BytesCached;
+}
+}
+} // namespace vtkm::cont
@@ -0,0 +1,127 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_cont_StorageBasicMemoryPool_h
+#define vtk_m_cont_StorageBasicMemoryPool_h
+
+#include <vtkm/Types.h>
+#include <vtkm/cont/vtkm_cont_export.h>
+
+namespace vtkm
+{
+namespace cont
+{
+
+/// Counters describing the use of the \c StorageBasicMemoryPool. All sizes
+/// are in bytes and count whole pool blocks.
+struct StorageBasicMemoryPoolStatistics
+{
+  /// The number of blocks requested from the pool.
+  vtkm::UInt64 NumberOfAllocations;
+  /// The number of requests served from a cached block.
+  vtkm::UInt64 NumberOfReuses;
+  /// The memory in blocks currently held by arrays.
+  vtkm::UInt64 BytesInUse;
+  /// The memory in free blocks held by the pool for reuse.
+  vtkm::UInt64 BytesCached;
+  /// The largest value of BytesInUse + BytesCached seen so far.
+  vtkm::UInt64 PeakBytes;
+};
+
+/// \brief A caching memory pool for the arrays of \c StorageBasic.
+///
+/// Filters allocate and release many temporary arrays, and running the same
+/// filters again (for example every time step of a simulation) repeats the
+/// same allocations. Rather than returning the memory of a released array to
+/// the system, \c StorageBasic gives it back to this pool, which hands it out
+/// again to the next allocation of a similar size. This avoids both the
+/// allocation call and the page faults of touching fresh memory.
+///
+/// Requests are rounded up to a size class: powers of two up to 4 KiB and
+/// quarter steps between powers of two above that, so at most a quarter of a
+/// block is wasted. The memory of free blocks held by the pool is bounded by
+/// the maximum cached bytes. When a released block would go over that bound,
+/// the largest cached blocks are returned to the system first.
+///
+/// The pool is configured from the environment when first used:
+///
+///   - \c VTKM_MEMORY_POOL set to \c 0 or \c off disables the pool.
+///   - \c VTKM_MEMORY_POOL_MAX_CACHED_BYTES sets the maximum cached bytes.
+///
+/// An individual array can opt out of the pool with \c
+/// Storage<T, StorageTagBasic>::SetUseMemoryPool(false), for example through
+/// <tt>arrayHandle.GetStorage().SetUseMemoryPool(false)</tt>.
+///
+/// All the methods are thread safe.
+///
+class VTKM_CONT_EXPORT StorageBasicMemoryPool
+{
+public:
+  /// The default bound on the memory held in free blocks: a quarter of the
+  /// physical memory, and at least 1 GiB, so that the temporaries of filters
+  /// on large data sets are cached as well.
+  VTKM_CONT static vtkm::UInt64 GetDefaultMaximumCachedBytes();
+
+  /// Returns aligned memory for at least \c numberOfBytes bytes. If the pool
+  /// is disabled, the memory is allocated directly with exactly the size
+  /// requested. Throws \c std::bad_alloc if the memory cannot be allocated.
+  /// \c allocatedFromPool is set to whether the memory must be given back
+  /// with \c Free.
+  VTKM_CONT static void* Allocate(vtkm::UInt64 numberOfBytes, bool& allocatedFromPool);
+
+  /// Like \c Allocate, and also sets \c reused to whether the memory is a
+  /// cached block, whose pages have already been written.
+  VTKM_CONT static void* Allocate(vtkm::UInt64 numberOfBytes,
+                                  bool& allocatedFromPool,
+                                  bool& reused);
+
+  /// Gives back memory obtained from \c Allocate with \c allocatedFromPool
+  /// set. \c numberOfBytes must be the size given to \c Allocate.
+  VTKM_CONT static void Free(void* memory, vtkm::UInt64 numberOfBytes);
+
+  /// Stops tracking memory obtained from \c Allocate whose ownership has been
+  /// passed outside of VTK-m (see \c StorageBasic::StealArray). The memory
+  /// can still be freed with \c free_aligned.
+  VTKM_CONT static void Detach(vtkm::UInt64 numberOfBytes);
+
+  /// Returns the size of the block used for a request of \c numberOfBytes.
+  VTKM_CONT static vtkm::UInt64 GetBlockSize(vtkm::UInt64 numberOfBytes);
+
+  VTKM_CONT static bool GetEnabled();
+  /// Disabling the pool releases all the cached blocks. Blocks still in use
+  /// are returned to the system when their arrays release them.
+  VTKM_CONT static void SetEnabled(bool enabled);
+
+  VTKM_CONT static vtkm::UInt64 GetMaximumCachedBytes();
+  /// Setting a lower bound releases cached blocks as needed to meet it.
+  VTKM_CONT static void SetMaximumCachedBytes(vtkm::UInt64 maximumCachedBytes);
+
+  /// Returns cached blocks to the system until at most \c cachedBytes bytes
+  /// remain cached. By default all cached blocks are released.
+  VTKM_CONT static void Trim(vtkm::UInt64 cachedBytes = 0);
+
+  VTKM_CONT static StorageBasicMemoryPoolStatistics GetStatistics();
+
+  /// Resets the allocation counters, and the peak to the current usage.
+  VTKM_CONT static void ResetStatistics();
+};
+}
+} // namespace vtkm::cont
+
+#endif //vtk_m_cont_StorageBasicMemoryPool_h
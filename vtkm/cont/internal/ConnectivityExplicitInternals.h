@@ -24,7 +24,6 @@
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/ArrayHandleCast.h>
 #include <vtkm/cont/ArrayHandleConstant.h>
-#include <vtkm/cont/ArrayHandleCounting.h>
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
 #include <vtkm/cont/internal/DeviceAdapterError.h>
 #include <vtkm/exec/ExecutionWholeArray.h>
@@ -172,46 +171,145 @@ struct ConnectivityExplicitInternals
 };
 
 
-// Worklet to expand the PointToCell numIndices array by repeating cell index
-class ExpandIndices : public vtkm::worklet::WorkletMapField
+// Worklet to count the number of cells using each point
+class CountPointIncidences : public vtkm::worklet::WorkletMapField
 {
 public:
-  typedef void ControlSignature(FieldIn<> cellIndex,
-                                FieldIn<> offset,
+  typedef void ControlSignature(FieldIn<IdType> pointIndex, AtomicArrayInOut<> numIndices);
+  typedef void ExecutionSignature(_1, _2);
+  using InputDomain = _1;
+
+  template <typename AtomicPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& pointIndex, const AtomicPortalType& numIndices) const
+  {
+    numIndices.Add(pointIndex, 1);
+  }
+};
+
+// Worklet to write the index of each cell into the lists of its points. Each
+// point has a cursor into its list that is advanced atomically.
+class ScatterCellIndices : public vtkm::worklet::WorkletMapField
+{
+public:
+  typedef void ControlSignature(FieldIn<> offset,
                                 FieldIn<> numIndices,
+                                WholeArrayIn<IdType> pointIndices,
+                                AtomicArrayInOut<> cursors,
                                 WholeArrayOut<> cellIndices);
-  typedef void ExecutionSignature(_1, _2, _3, _4);
+  typedef void ExecutionSignature(WorkIndex, _1, _2, _3, _4, _5);
   using InputDomain = _1;
 
-  VTKM_CONT
-  ExpandIndices() {}
-
-  template <typename PortalType>
-  VTKM_EXEC void operator()(const vtkm::Id& cellIndex,
-                            const vtkm::Id& offset,
-                            const vtkm::Id& numIndices,
-                            const PortalType& cellIndices) const
+  template <typename InPortalType, typename AtomicPortalType, typename OutPortalType>
+  VTKM_EXEC void operator()(vtkm::Id cellIndex,
+                            vtkm::Id offset,
+                            vtkm::IdComponent numIndices,
+                            const InPortalType& pointIndices,
+                            const AtomicPortalType& cursors,
+                            const OutPortalType& cellIndices) const
   {
-    VTKM_ASSERT(cellIndices.GetNumberOfValues() >= offset + numIndices);
-    vtkm::Id startIndex = offset;
-    for (vtkm::Id i = 0; i < numIndices; i++)
+    for (vtkm::IdComponent i = 0; i < numIndices; i++)
     {
-      cellIndices.Set(startIndex++, cellIndex);
+      vtkm::Id pointIndex = pointIndices.Get(offset + i);
+      cellIndices.Set(cursors.Add(pointIndex, 1), cellIndex);
     }
   }
 };
 
-class ScatterValues : public vtkm::worklet::WorkletMapField
+// Worklet to sort the cell indices of each point, so that the result does not
+// depend on the order in which the cells were scattered.
+class SortCellIndices : public vtkm::worklet::WorkletMapField
 {
 public:
-  typedef void ControlSignature(FieldIn<> index, FieldIn<> value, WholeArrayOut<> output);
+  typedef void ControlSignature(FieldIn<> offset,
+                                FieldIn<> numIndices,
+                                WholeArrayInOut<IdType> cellIndices);
   typedef void ExecutionSignature(_1, _2, _3);
   using InputDomain = _1;
 
-  template <typename T, typename PortalType>
-  VTKM_EXEC void operator()(const vtkm::Id& index, const T& value, const PortalType& output) const
+  // Lists up to this long are sorted with insertion sort, longer ones with
+  // heap sort.
+  static const vtkm::IdComponent MAX_INSERTION_SORT_SIZE = 16;
+
+  template <typename PortalType>
+  VTKM_EXEC void operator()(vtkm::Id offset,
+                            vtkm::IdComponent numIndices,
+                            const PortalType& cellIndices) const
+  {
+    // Most points are used by few cells, and the scattered lists are often
+    // nearly sorted already, so insertion sort is the right choice for them.
+    // Points used by many cells, such as the center of a fan, would make it
+    // quadratic.
+    if (numIndices <= MAX_INSERTION_SORT_SIZE)
+    {
+      this->InsertionSort(offset, numIndices, cellIndices);
+    }
+    else
+    {
+      this->HeapSort(offset, numIndices, cellIndices);
+    }
+  }
+
+private:
+  template <typename PortalType>
+  VTKM_EXEC void InsertionSort(vtkm::Id offset,
+                               vtkm::IdComponent numIndices,
+                               const PortalType& cellIndices) const
   {
-    output.Set(index, value);
+    for (vtkm::IdComponent i = 1; i < numIndices; i++)
+    {
+      vtkm::Id cellIndex = cellIndices.Get(offset + i);
+      vtkm::IdComponent j = i;
+      for (; (j > 0) && (cellIndices.Get(offset + j - 1) > cellIndex); j--)
+      {
+        cellIndices.Set(offset + j, cellIndices.Get(offset + j - 1));
+      }
+      cellIndices.Set(offset + j, cellIndex);
+    }
+  }
+
+  template <typename PortalType>
+  VTKM_EXEC void HeapSort(vtkm::Id offset,
+                          vtkm::IdComponent numIndices,
+                          const PortalType& cellIndices) const
+  {
+    for (vtkm::IdComponent i = numIndices / 2; i > 0; i--)
+    {
+      this->SiftDown(offset, i - 1, numIndices, cellIndices);
+    }
+    for (vtkm::IdComponent end = numIndices - 1; end > 0; end--)
+    {
+      vtkm::Id largest = cellIndices.Get(offset);
+      cellIndices.Set(offset, cellIndices.Get(offset + end));
+      cellIndices.Set(offset + end, largest);
+      this->SiftDown(offset, 0, end, cellIndices);
+    }
+  }
+
+  // Moves the element at root down the max heap of the first size elements.
+  template <typename PortalType>
+  VTKM_EXEC void SiftDown(vtkm::Id offset,
+                          vtkm::IdComponent root,
+                          vtkm::IdComponent size,
+                          const PortalType& cellIndices) const
+  {
+    vtkm::Id cellIndex = cellIndices.Get(offset + root);
+    vtkm::IdComponent child = 2 * root + 1;
+    while (child < size)
+    {
+      if ((child + 1 < size) &&
+          (cellIndices.Get(offset + child) < cellIndices.Get(offset + child + 1)))
+      {
+        child++;
+      }
+      if (cellIndices.Get(offset + child) <= cellIndex)
+      {
+        break;
+      }
+      cellIndices.Set(offset + root, cellIndices.Get(offset + child));
+      root = child;
+      child = 2 * root + 1;
+    }
+    cellIndices.Set(offset + root, cellIndex);
   }
 };
 
@@ -221,11 +319,20 @@ void ComputeCellToPointConnectivity(ConnectivityExplicitInternals<C2PShapeStorag
                                     vtkm::Id numberOfPoints,
                                     Device)
 {
-  // PointToCell connectivity array (point indices) will be
-  // transformed into the CellToPoint numIndices array using reduction
+  // The CellToPoint connectivity is built with a counting sort of the
+  // PointToCell connectivity array (point indices):
   //
-  // PointToCell numIndices array using expansion will be
-  // transformed into the CellToPoint connectivity array
+  // 1. The number of cells using each point becomes the CellToPoint
+  //    numIndices array.
+  // 2. An exclusive scan of those counts gives the CellToPoint index offsets.
+  // 3. Each cell writes its index into the lists of its points, at positions
+  //    claimed from an atomic cursor per point.
+  // 4. Each list is sorted so that cells appear in increasing order.
+  //
+  // Apart from the sort, this takes linear time. Sorting the list of a point
+  // used by d cells takes O(d log d) time, using insertion sort for the short
+  // lists of most points. Only temporary arrays the size of the number of
+  // points are needed.
 
   if (cell2Point.ElementsValid)
   {
@@ -235,49 +342,43 @@ void ComputeCellToPointConnectivity(ConnectivityExplicitInternals<C2PShapeStorag
   using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<Device>;
 
   // Sizes of the PointToCell information
-  vtkm::Id numberOfCells = point2Cell.NumIndices.GetNumberOfValues();
   vtkm::Id connectivityLength = point2Cell.Connectivity.GetNumberOfValues();
 
-  // PointToCell connectivity will be basis of CellToPoint numIndices
-  vtkm::cont::ArrayHandle<vtkm::Id> pointIndices;
-  Algorithm::Copy(point2Cell.Connectivity, pointIndices);
-
-  // PointToCell numIndices will be basis of CellToPoint connectivity
-
-  cell2Point.Connectivity.Allocate(connectivityLength);
-  vtkm::cont::ArrayHandleCounting<vtkm::Id> index(0, 1, numberOfCells);
-
-  vtkm::worklet::DispatcherMapField<ExpandIndices, Device> expandDispatcher;
-  expandDispatcher.Invoke(
-    index, point2Cell.IndexOffsets, point2Cell.NumIndices, cell2Point.Connectivity);
-
-  // SortByKey where key is PointToCell connectivity and value is the expanded cellIndex
-  Algorithm::SortByKey(pointIndices, cell2Point.Connectivity);
-
-  // CellToPoint numIndices from the now sorted PointToCell connectivity
-  vtkm::cont::ArrayHandleConstant<vtkm::IdComponent> numArray(1, connectivityLength);
-  vtkm::cont::ArrayHandle<vtkm::Id> uniquePoints;
+  // Count the cells of each point. Points not used by any cell keep a count
+  // of 0.
   vtkm::cont::ArrayHandle<vtkm::IdComponent> numIndices;
-  Algorithm::ReduceByKey(pointIndices, numArray, uniquePoints, numIndices, vtkm::Add());
+  Algorithm::Copy(vtkm::cont::ArrayHandleConstant<vtkm::IdComponent>(0, numberOfPoints),
+                  numIndices);
+  vtkm::worklet::DispatcherMapField<CountPointIncidences, Device>().Invoke(
+    point2Cell.Connectivity, numIndices);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> indexOffsets;
+  Algorithm::ScanExclusive(vtkm::cont::make_ArrayHandleCast(numIndices, vtkm::Id()),
+                           indexOffsets);
+
+  // Scatter the cell indices into the lists of their points
+  vtkm::cont::ArrayHandle<vtkm::Id> cursors;
+  Algorithm::Copy(indexOffsets, cursors);
+  cell2Point.Connectivity.Allocate(connectivityLength);
+  vtkm::worklet::DispatcherMapField<ScatterCellIndices, Device>().Invoke(
+    point2Cell.IndexOffsets,
+    point2Cell.NumIndices,
+    point2Cell.Connectivity,
+    cursors,
+    cell2Point.Connectivity);
+  cursors.ReleaseResources();
 
-  // if not all the points have a cell
-  if (uniquePoints.GetNumberOfValues() < numberOfPoints)
-  {
-    vtkm::cont::ArrayHandle<vtkm::IdComponent> fullNumIndices;
-    Algorithm::Copy(vtkm::cont::ArrayHandleConstant<vtkm::IdComponent>(0, numberOfPoints),
-                    fullNumIndices);
-    vtkm::worklet::DispatcherMapField<ScatterValues, Device>().Invoke(
-      uniquePoints, numIndices, fullNumIndices);
-    numIndices = fullNumIndices;
-  }
+  vtkm::worklet::DispatcherMapField<SortCellIndices, Device>().Invoke(
+    indexOffsets, numIndices, cell2Point.Connectivity);
 
   // Set the CellToPoint information
   cell2Point.Shapes = vtkm::cont::make_ArrayHandleConstant(
     static_cast<vtkm::UInt8>(CELL_SHAPE_VERTEX), numberOfPoints);
   cell2Point.NumIndices = numIndices;
+  cell2Point.IndexOffsets = indexOffsets;
 
   cell2Point.ElementsValid = true;
-  cell2Point.IndexOffsetsValid = false;
+  cell2Point.IndexOffsetsValid = true;
 }
 }
 }
@@ -0,0 +1,115 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#include <vtkm/cont/internal/MemoryMappedFile.h>
+
+#include <vtkm/cont/ErrorBadValue.h>
+
+#if defined(VTKM_POSIX)
+#define VTKM_MEMORY_MAP_POSIX
+#endif
+
+#if defined(VTKM_MEMORY_MAP_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <fstream>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+MemoryMappedFile::MemoryMappedFile(const std::string& fileName)
+  : FileName(fileName)
+  , Data(nullptr)
+  , Size(0)
+  , Mapped(false)
+{
+#if defined(VTKM_MEMORY_MAP_POSIX)
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw vtkm::cont::ErrorBadValue("Could not open file: " + fileName);
+  }
+
+  struct stat fileStatus;
+  if (fstat(fd, &fileStatus) != 0)
+  {
+    close(fd);
+    throw vtkm::cont::ErrorBadValue("Could not get the size of file: " + fileName);
+  }
+  this->Size = static_cast<vtkm::UInt64>(fileStatus.st_size);
+
+  if (this->Size > 0)
+  {
+    void* data =
+      mmap(nullptr, static_cast<std::size_t>(this->Size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+    {
+      this->Data = static_cast<vtkm::UInt8*>(data);
+      this->Mapped = true;
+    }
+  }
+  // The mapping stays valid after the file is closed.
+  close(fd);
+
+  if (this->Mapped || (this->Size == 0))
+  {
+    return;
+  }
+#endif
+
+  // Fall back to reading the whole file.
+  std::ifstream stream(fileName.c_str(), std::ios_base::in | std::ios_base::binary);
+  if (!stream)
+  {
+    throw vtkm::cont::ErrorBadValue("Could not open file: " + fileName);
+  }
+  stream.seekg(0, std::ios_base::end);
+  this->Size = static_cast<vtkm::UInt64>(stream.tellg());
+  stream.seekg(0, std::ios_base::beg);
+  this->Data = new vtkm::UInt8[static_cast<std::size_t>(this->Size)];
+  stream.read(reinterpret_cast<char*>(this->Data), static_cast<std::streamsize>(this->Size));
+  if (!stream)
+  {
+    delete[] this->Data;
+    throw vtkm::cont::ErrorBadValue("Could not read file: " + fileName);
+  }
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+#if defined(VTKM_MEMORY_MAP_POSIX)
+  if (this->Mapped)
+  {
+    munmap(this->Data, static_cast<std::size_t>(this->Size));
+    return;
+  }
+#endif
+  delete[] this->Data;
+}
+}
+}
+} // namespace vtkm::cont::internal
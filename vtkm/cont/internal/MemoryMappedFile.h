@@ -0,0 +1,78 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_cont_internal_MemoryMappedFile_h
+#define vtk_m_cont_internal_MemoryMappedFile_h
+
+#include <vtkm/Types.h>
+#include <vtkm/cont/vtkm_cont_export.h>
+
+#include <string>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+/// \brief A read-only view of the contents of a file.
+///
+/// Where the system supports it (POSIX), the file is mapped into memory, so
+/// pages are only read from disk when accessed and are shared with the
+/// operating system's file cache rather than copied. Otherwise the file is
+/// read into memory. Throws \c vtkm::cont::ErrorBadValue if the file cannot
+/// be opened.
+///
+class VTKM_CONT_EXPORT MemoryMappedFile
+{
+public:
+  VTKM_CONT
+  explicit MemoryMappedFile(const std::string& fileName);
+
+  VTKM_CONT
+  ~MemoryMappedFile();
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+  VTKM_CONT
+  const std::string& GetFileName() const { return this->FileName; }
+
+  VTKM_CONT
+  const vtkm::UInt8* GetData() const { return this->Data; }
+
+  VTKM_CONT
+  vtkm::UInt64 GetSize() const { return this->Size; }
+
+  /// Returns true if the file is mapped, false if it was read into memory.
+  VTKM_CONT
+  bool IsMapped() const { return this->Mapped; }
+
+private:
+  std::string FileName;
+  vtkm::UInt8* Data;
+  vtkm::UInt64 Size;
+  bool Mapped;
+};
+}
+}
+} // namespace vtkm::cont::internal
+
+#endif //vtk_m_cont_internal_MemoryMappedFile_h
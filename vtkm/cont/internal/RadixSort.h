@@ -0,0 +1,413 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_cont_internal_RadixSort_h
+#define vtk_m_cont_internal_RadixSort_h
+
+#include <vtkm/BinaryPredicates.h>
+#include <vtkm/Math.h>
+#include <vtkm/Types.h>
+#include <vtkm/cont/StorageBasic.h>
+#include <vtkm/cont/internal/FunctorsGeneral.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+/// Maps a key type to an unsigned integer whose ordering matches \c
+/// std::less on the keys. Only the types with a specialization can be radix
+/// sorted.
+template <typename T>
+struct RadixSortKeyTraits
+{
+  static const bool IsSortable = false;
+};
+
+template <>
+struct RadixSortKeyTraits<vtkm::UInt32>
+{
+  static const bool IsSortable = true;
+  using BitsType = vtkm::UInt32;
+  static BitsType ToBits(vtkm::UInt32 key) { return key; }
+  static vtkm::UInt32 FromBits(BitsType bits) { return bits; }
+};
+
+template <>
+struct RadixSortKeyTraits<vtkm::UInt64>
+{
+  static const bool IsSortable = true;
+  using BitsType = vtkm::UInt64;
+  static BitsType ToBits(vtkm::UInt64 key) { return key; }
+  static vtkm::UInt64 FromBits(BitsType bits) { return bits; }
+};
+
+// Signed integers just need the sign bit flipped.
+template <>
+struct RadixSortKeyTraits<vtkm::Int32>
+{
+  static const bool IsSortable = true;
+  using BitsType = vtkm::UInt32;
+  static BitsType ToBits(vtkm::Int32 key) { return static_cast<BitsType>(key) ^ 0x80000000u; }
+  static vtkm::Int32 FromBits(BitsType bits)
+  {
+    return static_cast<vtkm::Int32>(bits ^ 0x80000000u);
+  }
+};
+
+template <>
+struct RadixSortKeyTraits<vtkm::Int64>
+{
+  static const bool IsSortable = true;
+  using BitsType = vtkm::UInt64;
+  static BitsType ToBits(vtkm::Int64 key)
+  {
+    return static_cast<BitsType>(key) ^ 0x8000000000000000ull;
+  }
+  static vtkm::Int64 FromBits(BitsType bits)
+  {
+    return static_cast<vtkm::Int64>(bits ^ 0x8000000000000000ull);
+  }
+};
+
+// Floating point numbers flip all the bits of negative values (so that larger
+// magnitudes sort first) and only the sign bit of positive values. NaNs end up
+// at either end, which is as good as anything since they are unordered.
+template <>
+struct RadixSortKeyTraits<vtkm::Float32>
+{
+  static const bool IsSortable = true;
+  using BitsType = vtkm::UInt32;
+  static BitsType ToBits(vtkm::Float32 key)
+  {
+    vtkm::detail::IEEE754Bits32 value;
+    value.scalar = key;
+    const BitsType mask = (value.bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u;
+    return value.bits ^ mask;
+  }
+  static vtkm::Float32 FromBits(BitsType bits)
+  {
+    const BitsType mask = (bits & 0x80000000u) ? 0x80000000u : 0xFFFFFFFFu;
+    vtkm::detail::IEEE754Bits32 value;
+    value.bits = bits ^ mask;
+    return value.scalar;
+  }
+};
+
+template <>
+struct RadixSortKeyTraits<vtkm::Float64>
+{
+  static const bool IsSortable = true;
+  using BitsType = vtkm::UInt64;
+  static BitsType ToBits(vtkm::Float64 key)
+  {
+    vtkm::detail::IEEE754Bits64 value;
+    value.scalar = key;
+    const BitsType mask =
+      (value.bits & 0x8000000000000000ull) ? 0xFFFFFFFFFFFFFFFFull : 0x8000000000000000ull;
+    return value.bits ^ mask;
+  }
+  static vtkm::Float64 FromBits(BitsType bits)
+  {
+    const BitsType mask =
+      (bits & 0x8000000000000000ull) ? 0x8000000000000000ull : 0xFFFFFFFFFFFFFFFFull;
+    vtkm::detail::IEEE754Bits64 value;
+    value.bits = bits ^ mask;
+    return value.scalar;
+  }
+};
+
+/// True if sorting with \c Compare gives the same order as a radix sort of \c
+/// T (that is, \c Compare is an ascending less-than).
+template <typename T, typename Compare>
+struct IsRadixSortLess : std::false_type
+{
+};
+template <typename T>
+struct IsRadixSortLess<T, std::less<T>> : std::true_type
+{
+};
+template <typename T>
+struct IsRadixSortLess<T, vtkm::SortLess> : std::true_type
+{
+};
+template <typename T, typename Compare>
+struct IsRadixSortLess<T, WrappedBinaryOperator<bool, Compare>> : IsRadixSortLess<T, Compare>
+{
+};
+
+/// Selects the radix sort path of \c Sort and \c SortByKey. The keys must be
+/// of a radix sortable type, held in basic storage (so that their memory can
+/// be accessed directly), and sorted in ascending order.
+template <typename T, typename Storage, typename Compare>
+struct UseRadixSort
+  : std::integral_constant<bool,
+                           RadixSortKeyTraits<T>::IsSortable &&
+                             std::is_same<Storage, vtkm::cont::StorageTagBasic>::value &&
+                             IsRadixSortLess<T, Compare>::value>
+{
+};
+
+/// Arrays shorter than this are sorted with a comparison sort. The cost of a
+/// radix sort is dominated by its histograms for small arrays.
+static const vtkm::Id RADIX_SORT_MIN_SIZE = 1024;
+
+/// Marker for a radix sort with no values attached to the keys.
+struct RadixSortNoValues
+{
+};
+
+/// \brief LSD radix sort of keys, optionally carrying values along.
+///
+/// The keys are converted to order-preserving unsigned integers, sorted 8 bits
+/// at a time from the least significant digit, and converted back. Digits that
+/// are the same for every key are skipped, so sorting small integers (cell
+/// ids, bin ids) or Morton codes that use only part of the key takes fewer
+/// passes. Each pass splits the array into \c numBlocks contiguous blocks that
+/// are histogrammed and scattered independently, which is how the passes are
+/// parallelized.
+///
+/// \c executor is called as <tt>executor(numBlocks, functor)</tt> and must call
+/// <tt>functor(block)</tt> once for every block in [0, numBlocks), in any order
+/// and possibly concurrently.
+///
+template <typename KeyType, typename ValueType>
+class RadixSorter
+{
+  using Traits = RadixSortKeyTraits<KeyType>;
+  using BitsType = typename Traits::BitsType;
+  static const bool HasValues = !std::is_same<ValueType, RadixSortNoValues>::value;
+
+  static const int NUM_BUCKETS = 256;
+  static const int NUM_PASSES = static_cast<int>(sizeof(BitsType));
+
+public:
+  template <typename Executor>
+  VTKM_CONT static void Sort(KeyType* keys,
+                             ValueType* values,
+                             vtkm::Id numValues,
+                             vtkm::Id numBlocks,
+                             const Executor& executor)
+  {
+    if (numValues < 2)
+    {
+      return;
+    }
+    numBlocks = vtkm::Max(vtkm::Min(numBlocks, numValues), vtkm::Id(1));
+    const vtkm::Id blockSize = (numValues + numBlocks - 1) / numBlocks;
+    numBlocks = (numValues + blockSize - 1) / blockSize;
+
+    const std::size_t bufferSize = static_cast<std::size_t>(numValues);
+    std::unique_ptr<BitsType[]> bitsBuffers[2];
+    bitsBuffers[0].reset(new BitsType[bufferSize]);
+    bitsBuffers[1].reset(new BitsType[bufferSize]);
+    std::unique_ptr<ValueType[]> valuesBuffer;
+    if (HasValues)
+    {
+      valuesBuffer.reset(new ValueType[bufferSize]);
+    }
+    ValueType* valuesBuffers[2] = { values, valuesBuffer.get() };
+
+    // counts[(pass * numBlocks + block) * NUM_BUCKETS + bucket]
+    std::vector<vtkm::Id> counts(
+      static_cast<std::size_t>(NUM_PASSES * numBlocks * NUM_BUCKETS), 0);
+
+    // Convert the keys and histogram every digit. The histograms of all the
+    // digits are independent of the order, so they tell which passes can be
+    // skipped, and the block histograms are valid for the first pass.
+    {
+      BitsType* bits = bitsBuffers[0].get();
+      vtkm::Id* countsData = counts.data();
+      executor(numBlocks, [=](vtkm::Id block) {
+        const vtkm::Id begin = block * blockSize;
+        const vtkm::Id end = vtkm::Min(begin + blockSize, numValues);
+        for (vtkm::Id index = begin; index < end; ++index)
+        {
+          const BitsType keyBits = Traits::ToBits(keys[index]);
+          bits[index] = keyBits;
+          for (int pass = 0; pass < NUM_PASSES; ++pass)
+          {
+            ++countsData[(pass * numBlocks + block) * NUM_BUCKETS + Digit(keyBits, pass)];
+          }
+        }
+      });
+    }
+
+    int source = 0;
+    bool firstPass = true;
+    for (int pass = 0; pass < NUM_PASSES; ++pass)
+    {
+      vtkm::Id* passCounts = counts.data() + pass * numBlocks * NUM_BUCKETS;
+      if (!firstPass)
+      {
+        std::fill(passCounts, passCounts + numBlocks * NUM_BUCKETS, vtkm::Id(0));
+        const BitsType* bits = bitsBuffers[source].get();
+        executor(numBlocks, [=](vtkm::Id block) {
+          vtkm::Id* blockCounts = passCounts + block * NUM_BUCKETS;
+          const vtkm::Id begin = block * blockSize;
+          const vtkm::Id end = vtkm::Min(begin + blockSize, numValues);
+          for (vtkm::Id index = begin; index < end; ++index)
+          {
+            ++blockCounts[Digit(bits[index], pass)];
+          }
+        });
+      }
+
+      if (!ComputeOffsets(passCounts, numBlocks, numValues))
+      {
+        // Every key has the same digit, so this pass would not move anything.
+        continue;
+      }
+      firstPass = false;
+
+      const BitsType* inBits = bitsBuffers[source].get();
+      BitsType* outBits = bitsBuffers[1 - source].get();
+      const ValueType* inValues = valuesBuffers[source];
+      ValueType* outValues = valuesBuffers[1 - source];
+      executor(numBlocks, [=](vtkm::Id block) {
+        vtkm::Id offsets[NUM_BUCKETS];
+        std::copy(
+          passCounts + block * NUM_BUCKETS, passCounts + (block + 1) * NUM_BUCKETS, offsets);
+        const vtkm::Id begin = block * blockSize;
+        const vtkm::Id end = vtkm::Min(begin + blockSize, numValues);
+        for (vtkm::Id index = begin; index < end; ++index)
+        {
+          const vtkm::Id outIndex = offsets[Digit(inBits[index], pass)]++;
+          outBits[outIndex] = inBits[index];
+          MoveValue(inValues, outValues, index, outIndex);
+        }
+      });
+      source = 1 - source;
+    }
+
+    // Convert the keys back, and move the values back if they ended up in the
+    // temporary buffer.
+    {
+      const BitsType* bits = bitsBuffers[source].get();
+      const ValueType* sortedValues = valuesBuffers[source];
+      const bool copyValues = (source != 0);
+      executor(numBlocks, [=](vtkm::Id block) {
+        const vtkm::Id begin = block * blockSize;
+        const vtkm::Id end = vtkm::Min(begin + blockSize, numValues);
+        for (vtkm::Id index = begin; index < end; ++index)
+        {
+          keys[index] = Traits::FromBits(bits[index]);
+        }
+        if (copyValues)
+        {
+          for (vtkm::Id index = begin; index < end; ++index)
+          {
+            MoveValue(sortedValues, values, index, index);
+          }
+        }
+      });
+    }
+  }
+
+private:
+  VTKM_CONT static vtkm::Id Digit(BitsType bits, int pass)
+  {
+    return static_cast<vtkm::Id>((bits >> (8 * pass)) & 0xFF);
+  }
+
+  template <typename V>
+  VTKM_CONT static void MoveValue(const V* in, V* out, vtkm::Id inIndex, vtkm::Id outIndex)
+  {
+    out[outIndex] = in[inIndex];
+  }
+
+  VTKM_CONT static void MoveValue(const RadixSortNoValues*, RadixSortNoValues*, vtkm::Id, vtkm::Id)
+  {
+  }
+
+  // Replaces the block histograms of a pass with the offset at which each
+  // block writes each bucket. Returns false if all the values fall in one
+  // bucket.
+  VTKM_CONT static bool ComputeOffsets(vtkm::Id* passCounts, vtkm::Id numBlocks, vtkm::Id numValues)
+  {
+    vtkm::Id offset = 0;
+    for (int bucket = 0; bucket < NUM_BUCKETS; ++bucket)
+    {
+      vtkm::Id bucketTotal = 0;
+      for (vtkm::Id block = 0; block < numBlocks; ++block)
+      {
+        bucketTotal += passCounts[block * NUM_BUCKETS + bucket];
+      }
+      if (bucketTotal == numValues)
+      {
+        return false;
+      }
+      for (vtkm::Id block = 0; block < numBlocks; ++block)
+      {
+        const vtkm::Id count = passCounts[block * NUM_BUCKETS + bucket];
+        passCounts[block * NUM_BUCKETS + bucket] = offset;
+        offset += count;
+      }
+    }
+    return true;
+  }
+};
+
+/// Runs the blocks of a radix sort one after the other.
+struct RadixSortSerialExecutor
+{
+  template <typename Functor>
+  VTKM_CONT void operator()(vtkm::Id numBlocks, const Functor& functor) const
+  {
+    for (vtkm::Id block = 0; block < numBlocks; ++block)
+    {
+      functor(block);
+    }
+  }
+};
+
+/// Sorts \c numValues keys in ascending order.
+template <typename KeyType, typename Executor>
+VTKM_CONT void RadixSort(KeyType* keys,
+                         vtkm::Id numValues,
+                         vtkm::Id numBlocks,
+                         const Executor& executor)
+{
+  RadixSorter<KeyType, RadixSortNoValues>::Sort(keys, nullptr, numValues, numBlocks, executor);
+}
+
+/// Sorts \c numValues keys in ascending order, applying the same permutation
+/// to \c values.
+template <typename KeyType, typename ValueType, typename Executor>
+VTKM_CONT void RadixSortByKey(KeyType* keys,
+                              ValueType* values,
+                              vtkm::Id numValues,
+                              vtkm::Id numBlocks,
+                              const Executor& executor)
+{
+  RadixSorter<KeyType, ValueType>::Sort(keys, values, numValues, numBlocks, executor);
+}
+}
+}
+} // namespace vtkm::cont::internal
+
+#endif //vtk_m_cont_internal_RadixSort_h
@@ -26,6 +26,7 @@
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
 #include <vtkm/cont/ErrorExecution.h>
 #include <vtkm/cont/internal/DeviceAdapterAlgorithmGeneral.h>
+#include <vtkm/cont/internal/RadixSort.h>
 #include <vtkm/cont/serial/internal/DeviceAdapterTagSerial.h>
 
 #include <vtkm/BinaryOperators.h>
@@ -410,6 +411,19 @@ private:
   VTKM_CONT static void SortByKeyDirect(vtkm::cont::ArrayHandle<T, StorageT>& keys,
                                         vtkm::cont::ArrayHandle<U, StorageU>& values,
                                         BinaryCompare binary_compare)
+  {
+    using UseRadixSort = std::integral_constant<
+      bool,
+      internal::UseRadixSort<T, StorageT, BinaryCompare>::value &&
+        std::is_same<StorageU, vtkm::cont::StorageTagBasic>::value>;
+    SortByKeyDirect(keys, values, binary_compare, UseRadixSort());
+  }
+
+  template <typename T, typename U, class StorageT, class StorageU, class BinaryCompare>
+  VTKM_CONT static void SortByKeyDirect(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                                        vtkm::cont::ArrayHandle<U, StorageU>& values,
+                                        BinaryCompare binary_compare,
+                                        std::false_type)
   {
     //combine the keys and values into a ZipArrayHandle
     //we than need to specify a custom compare function wrapper
@@ -419,6 +433,26 @@ private:
     Sort(zipHandle, internal::KeyCompare<T, U, BinaryCompare>(binary_compare));
   }
 
+  template <typename T, typename U, class StorageT, class StorageU, class BinaryCompare>
+  VTKM_CONT static void SortByKeyDirect(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                                        vtkm::cont::ArrayHandle<U, StorageU>& values,
+                                        BinaryCompare binary_compare,
+                                        std::true_type)
+  {
+    const vtkm::Id numValues = keys.GetNumberOfValues();
+    if (numValues < internal::RADIX_SORT_MIN_SIZE)
+    {
+      SortByKeyDirect(keys, values, binary_compare, std::false_type());
+      return;
+    }
+
+    internal::RadixSortByKey(keys.PrepareForInPlace(Device()).GetIteratorBegin(),
+                             values.PrepareForInPlace(Device()).GetIteratorBegin(),
+                             numValues,
+                             1,
+                             internal::RadixSortSerialExecutor());
+  }
+
 public:
   template <typename T, typename U, class StorageT, class StorageU>
   VTKM_CONT static void SortByKey(vtkm::cont::ArrayHandle<T, StorageT>& keys,
@@ -462,11 +496,10 @@ public:
   VTKM_CONT static void Sort(vtkm::cont::ArrayHandle<T, Storage>& values,
                              BinaryCompare binary_compare)
   {
-    auto arrayPortal = values.PrepareForInPlace(Device());
-    vtkm::cont::ArrayPortalToIterators<decltype(arrayPortal)> iterators(arrayPortal);
-
-    internal::WrappedBinaryOperator<bool, BinaryCompare> wrappedCompare(binary_compare);
-    std::sort(iterators.GetBegin(), iterators.GetEnd(), wrappedCompare);
+    // Ascending sorts of basic arrays of scalars use a radix sort.
+    SortInternal(values,
+                 binary_compare,
+                 typename internal::UseRadixSort<T, Storage, BinaryCompare>::type());
   }
 
   template <typename T, class Storage>
@@ -491,6 +524,37 @@ public:
   {
     // Nothing to do. This device is serial and has no asynchronous operations.
   }
+
+private:
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static void SortInternal(vtkm::cont::ArrayHandle<T, Storage>& values,
+                                     BinaryCompare binary_compare,
+                                     std::false_type)
+  {
+    auto arrayPortal = values.PrepareForInPlace(Device());
+    vtkm::cont::ArrayPortalToIterators<decltype(arrayPortal)> iterators(arrayPortal);
+
+    internal::WrappedBinaryOperator<bool, BinaryCompare> wrappedCompare(binary_compare);
+    std::sort(iterators.GetBegin(), iterators.GetEnd(), wrappedCompare);
+  }
+
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static void SortInternal(vtkm::cont::ArrayHandle<T, Storage>& values,
+                                     BinaryCompare binary_compare,
+                                     std::true_type)
+  {
+    const vtkm::Id numValues = values.GetNumberOfValues();
+    if (numValues < internal::RADIX_SORT_MIN_SIZE)
+    {
+      SortInternal(values, binary_compare, std::false_type());
+      return;
+    }
+
+    internal::RadixSort(values.PrepareForInPlace(Device()).GetIteratorBegin(),
+                        numValues,
+                        1,
+                        internal::RadixSortSerialExecutor());
+  }
 };
 
 template <>
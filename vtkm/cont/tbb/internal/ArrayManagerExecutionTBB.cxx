@@ -22,6 +22,9 @@
 
 #include <vtkm/cont/tbb/internal/ArrayManagerExecutionTBB.h>
 
+#include <vtkm/cont/StorageBasic.h>
+#include <vtkm/cont/tbb/internal/FunctorsTBB.h>
+
 namespace vtkm
 {
 namespace cont
@@ -35,6 +38,61 @@ ExecutionArrayInterfaceBasic<DeviceAdapterTagTBB>::ExecutionArrayInterfaceBasic(
 {
 }
 
+void ExecutionArrayInterfaceBasic<DeviceAdapterTagTBB>::Allocate(TypelessExecutionArray& execArray,
+                                                                vtkm::UInt64 numBytes) const
+{
+  this->Superclass::Allocate(execArray, numBytes);
+
+  // Memory that was already written (a kept buffer or a block reused from the
+  // memory pool) has been placed, so touching it again would not move it.
+  if ((numBytes < VTKM_HUGE_PAGE_SIZE) || !vtkm::cont::internal::GetUseFirstTouch() ||
+      !this->ControlStorage.GetAllocationIsFresh())
+  {
+    return;
+  }
+
+  // Write one byte of every page with the partitioner configured for
+  // Schedule, so each page is first touched by a thread that will later
+  // process it. Huge pages are only advised, so every small page is written
+  // in case the system did not back the array with huge pages. The chunks
+  // split among the threads are whole huge pages when they are enabled.
+  const vtkm::Id pageSize = 4096;
+  const vtkm::Id chunkSize =
+    vtkm::cont::internal::GetUseHugePages() ? VTKM_HUGE_PAGE_SIZE : pageSize;
+  const vtkm::Id size = static_cast<vtkm::Id>(numBytes);
+  const vtkm::Id numChunks = (size + chunkSize - 1) / chunkSize;
+  vtkm::UInt8* bytes = static_cast<vtkm::UInt8*>(execArray.Array);
+
+  ::tbb::blocked_range<vtkm::Id> range(0, numChunks, 1);
+  auto body = [bytes, size, chunkSize](const ::tbb::blocked_range<vtkm::Id>& r) {
+    const vtkm::Id end = vtkm::Min(r.end() * chunkSize, size);
+    for (vtkm::Id offset = r.begin() * chunkSize; offset < end; offset += pageSize)
+    {
+      bytes[offset] = 0;
+    }
+  };
+  switch (
+    vtkm::cont::tbb::SchedulingPolicyTBB::GetOptions(vtkm::cont::tbb::TBBAlgorithm::Schedule)
+      .Partitioner)
+  {
+    case vtkm::cont::tbb::TBBPartitioner::Simple:
+      ::tbb::parallel_for(range, body, ::tbb::simple_partitioner());
+      break;
+    case vtkm::cont::tbb::TBBPartitioner::Affinity:
+    {
+      // Not the partitioner of Schedule, whose recorded affinity must match
+      // the loops of Schedule rather than this one.
+      static thread_local ::tbb::affinity_partitioner partitioner;
+      ::tbb::parallel_for(range, body, partitioner);
+      break;
+    }
+    case vtkm::cont::tbb::TBBPartitioner::Auto:
+    default:
+      ::tbb::parallel_for(range, body, ::tbb::auto_partitioner());
+      break;
+  }
+}
+
 } // end namespace internal
 
 VTKM_INSTANTIATE_ARRAYHANDLES_FOR_DEVICE_ADAPTER(DeviceAdapterTagTBB)
@@ -97,6 +97,12 @@ struct VTKM_CONT_EXPORT ExecutionArrayInterfaceBasic<DeviceAdapterTagTBB>
 
   VTKM_CONT
   virtual DeviceAdapterId GetDeviceId() const final { return VTKM_DEVICE_ADAPTER_TBB; }
+
+  /// Allocates in the shared control storage, then writes the pages of large
+  /// new arrays in parallel so that they are placed local to the TBB threads
+  /// (see \c vtkm::cont::internal::SetUseFirstTouch).
+  VTKM_CONT
+  void Allocate(TypelessExecutionArray& execArray, vtkm::UInt64 numBytes) const final;
 };
 
 } // namespace internal
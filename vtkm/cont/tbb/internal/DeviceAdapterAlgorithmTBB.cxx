@@ -35,10 +35,34 @@ void DeviceAdapterAlgorithm<vtkm::cont::DeviceAdapterTagTBB>::ScheduleTask(
   vtkm::exec::internal::ErrorMessageBuffer errorMessage(errorString, MESSAGE_SIZE);
   functor.SetErrorMessageBuffer(errorMessage);
 
-  ::tbb::blocked_range<vtkm::Id> range(0, size, tbb::TBB_GRAIN_SIZE);
+  tbb::TBBSchedulingOptions options =
+    tbb::SchedulingPolicyTBB::GetOptions(tbb::TBBAlgorithm::Schedule);
 
-  ::tbb::parallel_for(
-    range, [&](const ::tbb::blocked_range<vtkm::Id>& r) { functor(r.begin(), r.end()); });
+  // When auto-tuning, the first invocation of a worklet runs a sample of the
+  // range serially to measure its cost and derive a grain size from it.
+  vtkm::Id start = 0;
+  if (tbb::SchedulingPolicyTBB::GetAutoTune())
+  {
+    const auto key = functor.GetExecuteFunction();
+    const vtkm::Id sampleSize = tbb::SchedulingPolicyTBB::AUTO_TUNE_SAMPLE_SIZE;
+    if (tbb::SchedulingPolicyTBB::GetTunedGrainSize(key, options.GrainSize))
+    {
+      // Already tuned.
+    }
+    else if (size >= 4 * sampleSize)
+    {
+      ::tbb::tick_count startTime = ::tbb::tick_count::now();
+      functor(0, sampleSize);
+      ::tbb::tick_count::interval_t elapsedTime = ::tbb::tick_count::now() - startTime;
+      options.GrainSize =
+        tbb::SchedulingPolicyTBB::TuneGrainSize(key, elapsedTime.seconds(), sampleSize);
+      start = sampleSize;
+    }
+  }
+
+  ::tbb::blocked_range<vtkm::Id> range(start, size, options.GrainSize);
+  auto body = [&](const ::tbb::blocked_range<vtkm::Id>& r) { functor(r.begin(), r.end()); };
+  tbb::internal::ParallelFor(tbb::TBBAlgorithm::Schedule, options.Partitioner, range, body);
 
   if (errorMessage.IsErrorRaised())
   {
@@ -50,7 +74,9 @@ void DeviceAdapterAlgorithm<vtkm::cont::DeviceAdapterTagTBB>::ScheduleTask(
   vtkm::exec::tbb::internal::TaskTiling3D& functor,
   vtkm::Id3 size)
 {
-  static const vtkm::UInt32 TBB_GRAIN_SIZE_3D[3] = { 1, 4, 256 };
+  const tbb::TBBSchedulingOptions options =
+    tbb::SchedulingPolicyTBB::GetOptions(tbb::TBBAlgorithm::Schedule3D);
+  const vtkm::Id grainSize3D[3] = { 1, 4, options.GrainSize };
   const vtkm::Id MESSAGE_SIZE = 1024;
   char errorString[MESSAGE_SIZE];
   errorString[0] = '\0';
@@ -61,14 +87,14 @@ void DeviceAdapterAlgorithm<vtkm::cont::DeviceAdapterTagTBB>::ScheduleTask(
   //in the tightest loop has the best cache coherence.
   ::tbb::blocked_range3d<vtkm::Id> range(0,
                                          size[2],
-                                         TBB_GRAIN_SIZE_3D[0],
+                                         grainSize3D[0],
                                          0,
                                          size[1],
-                                         TBB_GRAIN_SIZE_3D[1],
+                                         grainSize3D[1],
                                          0,
                                          size[0],
-                                         TBB_GRAIN_SIZE_3D[2]);
-  ::tbb::parallel_for(range, [&](const ::tbb::blocked_range3d<vtkm::Id>& r) {
+                                         grainSize3D[2]);
+  auto body = [&](const ::tbb::blocked_range3d<vtkm::Id>& r) {
     for (vtkm::Id k = r.pages().begin(); k != r.pages().end(); ++k)
     {
       for (vtkm::Id j = r.rows().begin(); j != r.rows().end(); ++j)
@@ -78,7 +104,8 @@ void DeviceAdapterAlgorithm<vtkm::cont::DeviceAdapterTagTBB>::ScheduleTask(
         functor(start, end, j, k);
       }
     }
-  });
+  };
+  tbb::internal::ParallelFor(tbb::TBBAlgorithm::Schedule3D, options.Partitioner, range, body);
 
   if (errorMessage.IsErrorRaised())
   {
@@ -138,6 +138,39 @@ public:
     return true;
   }
 
+  template <typename T, class CIn, class CVal, class COut>
+  VTKM_CONT static void LowerBounds(const vtkm::cont::ArrayHandle<T, CIn>& input,
+                                    const vtkm::cont::ArrayHandle<T, CVal>& values,
+                                    vtkm::cont::ArrayHandle<vtkm::Id, COut>& output)
+  {
+    LowerBounds(input, values, output, std::less<T>());
+  }
+
+  template <typename T, class CIn, class CVal, class COut, class BinaryCompare>
+  VTKM_CONT static void LowerBounds(const vtkm::cont::ArrayHandle<T, CIn>& input,
+                                    const vtkm::cont::ArrayHandle<T, CVal>& values,
+                                    vtkm::cont::ArrayHandle<vtkm::Id, COut>& output,
+                                    BinaryCompare binary_compare)
+  {
+    const vtkm::Id arraySize = values.GetNumberOfValues();
+    tbb::BoundsPortals<false>(input.PrepareForInput(DeviceAdapterTagTBB()),
+                              values.PrepareForInput(DeviceAdapterTagTBB()),
+                              output.PrepareForOutput(arraySize, DeviceAdapterTagTBB()),
+                              binary_compare);
+  }
+
+  template <class CIn, class COut>
+  VTKM_CONT static void LowerBounds(const vtkm::cont::ArrayHandle<vtkm::Id, CIn>& input,
+                                    vtkm::cont::ArrayHandle<vtkm::Id, COut>& values_output)
+  {
+    // The values are replaced by their bounds, so use one in-place portal for both.
+    auto valuesOutputPortal = values_output.PrepareForInPlace(DeviceAdapterTagTBB());
+    tbb::BoundsPortals<false>(input.PrepareForInput(DeviceAdapterTagTBB()),
+                              valuesOutputPortal,
+                              valuesOutputPortal,
+                              std::less<vtkm::Id>());
+  }
+
   template <typename T, typename U, class CIn>
   VTKM_CONT static U Reduce(const vtkm::cont::ArrayHandle<T, CIn>& input, U initialValue)
   {
@@ -199,6 +232,31 @@ public:
       binary_functor);
   }
 
+  template <typename KeyT, typename ValueT, class KIn, class VIn, class VOut>
+  VTKM_CONT static void ScanInclusiveByKey(const vtkm::cont::ArrayHandle<KeyT, KIn>& keys,
+                                           const vtkm::cont::ArrayHandle<ValueT, VIn>& values,
+                                           vtkm::cont::ArrayHandle<ValueT, VOut>& values_output)
+  {
+    ScanInclusiveByKey(keys, values, values_output, vtkm::Add());
+  }
+
+  template <typename KeyT, typename ValueT, class KIn, class VIn, class VOut, class BinaryFunctor>
+  VTKM_CONT static void ScanInclusiveByKey(const vtkm::cont::ArrayHandle<KeyT, KIn>& keys,
+                                           const vtkm::cont::ArrayHandle<ValueT, VIn>& values,
+                                           vtkm::cont::ArrayHandle<ValueT, VOut>& values_output,
+                                           BinaryFunctor binary_functor)
+  {
+    const vtkm::Id numberOfKeys = keys.GetNumberOfValues();
+    VTKM_ASSERT(numberOfKeys == values.GetNumberOfValues());
+
+    tbb::ScanByKeyPortals<false>(
+      keys.PrepareForInput(DeviceAdapterTagTBB()),
+      values.PrepareForInput(DeviceAdapterTagTBB()),
+      values_output.PrepareForOutput(numberOfKeys, DeviceAdapterTagTBB()),
+      binary_functor,
+      vtkm::TypeTraits<ValueT>::ZeroInitialization());
+  }
+
   template <typename T, class CIn, class COut>
   VTKM_CONT static T ScanExclusive(const vtkm::cont::ArrayHandle<T, CIn>& input,
                                    vtkm::cont::ArrayHandle<T, COut>& output)
@@ -223,6 +281,41 @@ public:
       initialValue);
   }
 
+  template <typename KeyT,
+            typename ValueT,
+            typename KIn,
+            typename VIn,
+            typename VOut,
+            class BinaryFunctor>
+  VTKM_CONT static void ScanExclusiveByKey(const vtkm::cont::ArrayHandle<KeyT, KIn>& keys,
+                                           const vtkm::cont::ArrayHandle<ValueT, VIn>& values,
+                                           vtkm::cont::ArrayHandle<ValueT, VOut>& output,
+                                           const ValueT& initialValue,
+                                           BinaryFunctor binaryFunctor)
+  {
+    const vtkm::Id numberOfKeys = keys.GetNumberOfValues();
+    VTKM_ASSERT(numberOfKeys == values.GetNumberOfValues());
+    if (numberOfKeys == 0)
+    {
+      return;
+    }
+
+    tbb::ScanByKeyPortals<true>(keys.PrepareForInput(DeviceAdapterTagTBB()),
+                                values.PrepareForInput(DeviceAdapterTagTBB()),
+                                output.PrepareForOutput(numberOfKeys, DeviceAdapterTagTBB()),
+                                binaryFunctor,
+                                initialValue);
+  }
+
+  template <typename KeyT, typename ValueT, class KIn, typename VIn, typename VOut>
+  VTKM_CONT static void ScanExclusiveByKey(const vtkm::cont::ArrayHandle<KeyT, KIn>& keys,
+                                           const vtkm::cont::ArrayHandle<ValueT, VIn>& values,
+                                           vtkm::cont::ArrayHandle<ValueT, VOut>& output)
+  {
+    ScanExclusiveByKey(
+      keys, values, output, vtkm::TypeTraits<ValueT>::ZeroInitialization(), vtkm::Sum());
+  }
+
   VTKM_CONT_EXPORT static void ScheduleTask(vtkm::exec::tbb::internal::TaskTiling1D& functor,
                                             vtkm::Id size);
   VTKM_CONT_EXPORT static void ScheduleTask(vtkm::exec::tbb::internal::TaskTiling3D& functor,
@@ -254,15 +347,9 @@ public:
   VTKM_CONT static void Sort(vtkm::cont::ArrayHandle<T, Container>& values,
                              BinaryCompare binary_compare)
   {
-    using PortalType = typename vtkm::cont::ArrayHandle<T, Container>::template ExecutionTypes<
-      vtkm::cont::DeviceAdapterTagTBB>::Portal;
-    PortalType arrayPortal = values.PrepareForInPlace(vtkm::cont::DeviceAdapterTagTBB());
-
-    using IteratorsType = vtkm::cont::ArrayPortalToIterators<PortalType>;
-    IteratorsType iterators(arrayPortal);
-
-    internal::WrappedBinaryOperator<bool, BinaryCompare> wrappedCompare(binary_compare);
-    ::tbb::parallel_sort(iterators.GetBegin(), iterators.GetEnd(), wrappedCompare);
+    SortInternal(values,
+                 binary_compare,
+                 typename vtkm::cont::internal::UseRadixSort<T, Container, BinaryCompare>::type());
   }
 
   template <typename T, typename U, class StorageT, class StorageU>
@@ -277,7 +364,6 @@ public:
                                   vtkm::cont::ArrayHandle<U, StorageU>& values,
                                   Compare comp)
   {
-    using KeyType = vtkm::cont::ArrayHandle<T, StorageT>;
     VTKM_CONSTEXPR bool larger_than_64bits = sizeof(U) > sizeof(vtkm::Int64);
     if (larger_than_64bits)
     {
@@ -286,7 +372,6 @@ public:
 
       using ValueType = vtkm::cont::ArrayHandle<U, StorageU>;
       using IndexType = vtkm::cont::ArrayHandle<vtkm::Id>;
-      using ZipHandleType = vtkm::cont::ArrayHandleZip<KeyType, IndexType>;
 
       IndexType indexArray;
       ValueType valuesScattered;
@@ -294,8 +379,7 @@ public:
 
       Copy(ArrayHandleIndex(keys.GetNumberOfValues()), indexArray);
 
-      ZipHandleType zipHandle = vtkm::cont::make_ArrayHandleZip(keys, indexArray);
-      Sort(zipHandle, vtkm::cont::internal::KeyCompare<T, vtkm::Id, Compare>(comp));
+      SortByKeyDirect(keys, indexArray, comp);
 
       tbb::ScatterPortal(values.PrepareForInput(vtkm::cont::DeviceAdapterTagTBB()),
                          indexArray.PrepareForInput(vtkm::cont::DeviceAdapterTagTBB()),
@@ -305,12 +389,33 @@ public:
     }
     else
     {
-      using ValueType = vtkm::cont::ArrayHandle<U, StorageU>;
-      using ZipHandleType = vtkm::cont::ArrayHandleZip<KeyType, ValueType>;
+      SortByKeyDirect(keys, values, comp);
+    }
+  }
 
-      ZipHandleType zipHandle = vtkm::cont::make_ArrayHandleZip(keys, values);
-      Sort(zipHandle, vtkm::cont::internal::KeyCompare<T, U, Compare>(comp));
+  template <typename T,
+            typename U,
+            typename V,
+            typename StorageT,
+            typename StorageU,
+            typename StorageV,
+            typename BinaryFunctor>
+  VTKM_CONT static void Transform(const vtkm::cont::ArrayHandle<T, StorageT>& input1,
+                                  const vtkm::cont::ArrayHandle<U, StorageU>& input2,
+                                  vtkm::cont::ArrayHandle<V, StorageV>& output,
+                                  BinaryFunctor binaryFunctor)
+  {
+    const vtkm::Id numValues = vtkm::Min(input1.GetNumberOfValues(), input2.GetNumberOfValues());
+    if (numValues <= 0)
+    {
+      return;
     }
+
+    tbb::TransformPortals(input1.PrepareForInput(DeviceAdapterTagTBB()),
+                          input2.PrepareForInput(DeviceAdapterTagTBB()),
+                          output.PrepareForOutput(numValues, DeviceAdapterTagTBB()),
+                          binaryFunctor,
+                          numValues);
   }
 
   template <typename T, class Storage>
@@ -328,6 +433,39 @@ public:
     values.Shrink(outputSize);
   }
 
+  template <typename T, class CIn, class CVal, class COut>
+  VTKM_CONT static void UpperBounds(const vtkm::cont::ArrayHandle<T, CIn>& input,
+                                    const vtkm::cont::ArrayHandle<T, CVal>& values,
+                                    vtkm::cont::ArrayHandle<vtkm::Id, COut>& output)
+  {
+    UpperBounds(input, values, output, std::less<T>());
+  }
+
+  template <typename T, class CIn, class CVal, class COut, class BinaryCompare>
+  VTKM_CONT static void UpperBounds(const vtkm::cont::ArrayHandle<T, CIn>& input,
+                                    const vtkm::cont::ArrayHandle<T, CVal>& values,
+                                    vtkm::cont::ArrayHandle<vtkm::Id, COut>& output,
+                                    BinaryCompare binary_compare)
+  {
+    const vtkm::Id arraySize = values.GetNumberOfValues();
+    tbb::BoundsPortals<true>(input.PrepareForInput(DeviceAdapterTagTBB()),
+                             values.PrepareForInput(DeviceAdapterTagTBB()),
+                             output.PrepareForOutput(arraySize, DeviceAdapterTagTBB()),
+                             binary_compare);
+  }
+
+  template <class CIn, class COut>
+  VTKM_CONT static void UpperBounds(const vtkm::cont::ArrayHandle<vtkm::Id, CIn>& input,
+                                    vtkm::cont::ArrayHandle<vtkm::Id, COut>& values_output)
+  {
+    // The values are replaced by their bounds, so use one in-place portal for both.
+    auto valuesOutputPortal = values_output.PrepareForInPlace(DeviceAdapterTagTBB());
+    tbb::BoundsPortals<true>(input.PrepareForInput(DeviceAdapterTagTBB()),
+                             valuesOutputPortal,
+                             valuesOutputPortal,
+                             std::less<vtkm::Id>());
+  }
+
   VTKM_CONT static void Synchronize()
   {
     // Nothing to do. This device schedules all of its operations using a
@@ -335,6 +473,85 @@ public:
     // calling this method, then nothing should be running in the execution
     // environment.
   }
+
+private:
+  template <typename T, class Container, class BinaryCompare>
+  VTKM_CONT static void SortInternal(vtkm::cont::ArrayHandle<T, Container>& values,
+                                     BinaryCompare binary_compare,
+                                     std::false_type)
+  {
+    using PortalType = typename vtkm::cont::ArrayHandle<T, Container>::template ExecutionTypes<
+      vtkm::cont::DeviceAdapterTagTBB>::Portal;
+    PortalType arrayPortal = values.PrepareForInPlace(vtkm::cont::DeviceAdapterTagTBB());
+
+    using IteratorsType = vtkm::cont::ArrayPortalToIterators<PortalType>;
+    IteratorsType iterators(arrayPortal);
+
+    internal::WrappedBinaryOperator<bool, BinaryCompare> wrappedCompare(binary_compare);
+    ::tbb::parallel_sort(iterators.GetBegin(), iterators.GetEnd(), wrappedCompare);
+  }
+
+  template <typename T, class Container, class BinaryCompare>
+  VTKM_CONT static void SortInternal(vtkm::cont::ArrayHandle<T, Container>& values,
+                                     BinaryCompare binary_compare,
+                                     std::true_type)
+  {
+    const vtkm::Id numValues = values.GetNumberOfValues();
+    if (numValues < vtkm::cont::internal::RADIX_SORT_MIN_SIZE)
+    {
+      SortInternal(values, binary_compare, std::false_type());
+      return;
+    }
+
+    vtkm::cont::internal::RadixSort(
+      values.PrepareForInPlace(vtkm::cont::DeviceAdapterTagTBB()).GetIteratorBegin(),
+      numValues,
+      tbb::RadixSortExecutorTBB::NumberOfBlocks(numValues),
+      tbb::RadixSortExecutorTBB());
+  }
+
+  template <typename T, typename U, class StorageT, class StorageU, class Compare>
+  VTKM_CONT static void SortByKeyDirect(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                                        vtkm::cont::ArrayHandle<U, StorageU>& values,
+                                        Compare comp)
+  {
+    using UseRadixSort = std::integral_constant<
+      bool,
+      vtkm::cont::internal::UseRadixSort<T, StorageT, Compare>::value &&
+        std::is_same<StorageU, vtkm::cont::StorageTagBasic>::value>;
+    SortByKeyDirect(keys, values, comp, UseRadixSort());
+  }
+
+  template <typename T, typename U, class StorageT, class StorageU, class Compare>
+  VTKM_CONT static void SortByKeyDirect(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                                        vtkm::cont::ArrayHandle<U, StorageU>& values,
+                                        Compare comp,
+                                        std::false_type)
+  {
+    auto zipHandle = vtkm::cont::make_ArrayHandleZip(keys, values);
+    Sort(zipHandle, vtkm::cont::internal::KeyCompare<T, U, Compare>(comp));
+  }
+
+  template <typename T, typename U, class StorageT, class StorageU, class Compare>
+  VTKM_CONT static void SortByKeyDirect(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                                        vtkm::cont::ArrayHandle<U, StorageU>& values,
+                                        Compare comp,
+                                        std::true_type)
+  {
+    const vtkm::Id numValues = keys.GetNumberOfValues();
+    if (numValues < vtkm::cont::internal::RADIX_SORT_MIN_SIZE)
+    {
+      SortByKeyDirect(keys, values, comp, std::false_type());
+      return;
+    }
+
+    vtkm::cont::internal::RadixSortByKey(
+      keys.PrepareForInPlace(vtkm::cont::DeviceAdapterTagTBB()).GetIteratorBegin(),
+      values.PrepareForInPlace(vtkm::cont::DeviceAdapterTagTBB()).GetIteratorBegin(),
+      numValues,
+      tbb::RadixSortExecutorTBB::NumberOfBlocks(numValues),
+      tbb::RadixSortExecutorTBB());
+  }
 };
 
 /// TBB contains its own high resolution timer.
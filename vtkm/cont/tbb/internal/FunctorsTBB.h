@@ -25,6 +25,8 @@
 #include <vtkm/cont/ArrayPortalToIterators.h>
 #include <vtkm/cont/Error.h>
 #include <vtkm/cont/internal/FunctorsGeneral.h>
+#include <vtkm/cont/internal/RadixSort.h>
+#include <vtkm/cont/tbb/internal/SchedulingPolicyTBB.h>
 #include <vtkm/exec/internal/ErrorMessageBuffer.h>
 
 #include <algorithm>
@@ -84,11 +86,89 @@ namespace internal
 {
 template <typename ResultType, typename Function>
 using WrappedBinaryOperator = vtkm::cont::internal::WrappedBinaryOperator<ResultType, Function>;
+
+// Affinity partitioners record which thread ran which part of a loop, so they
+// must persist between calls and must not be shared by concurrent loops. Each
+// thread keeps one per algorithm.
+inline ::tbb::affinity_partitioner& GetAffinityPartitioner(TBBAlgorithm algorithm)
+{
+  static thread_local ::tbb::affinity_partitioner
+    partitioners[static_cast<std::size_t>(TBBAlgorithm::NumberOfAlgorithms)];
+  return partitioners[static_cast<std::size_t>(algorithm)];
+}
+
+template <typename RangeType, typename BodyType>
+void ParallelFor(TBBAlgorithm algorithm,
+                 TBBPartitioner partitioner,
+                 const RangeType& range,
+                 const BodyType& body)
+{
+  switch (partitioner)
+  {
+    case TBBPartitioner::Simple:
+      ::tbb::parallel_for(range, body, ::tbb::simple_partitioner());
+      break;
+    case TBBPartitioner::Affinity:
+      ::tbb::parallel_for(range, body, GetAffinityPartitioner(algorithm));
+      break;
+    case TBBPartitioner::Auto:
+    default:
+      ::tbb::parallel_for(range, body, ::tbb::auto_partitioner());
+      break;
+  }
+}
+
+template <typename BodyType>
+void ParallelFor(TBBAlgorithm algorithm, vtkm::Id size, const BodyType& body)
+{
+  const TBBSchedulingOptions options = SchedulingPolicyTBB::GetOptions(algorithm);
+  ::tbb::blocked_range<vtkm::Id> range(0, size, options.GrainSize);
+  ParallelFor(algorithm, options.Partitioner, range, body);
 }
 
-// The "grain size" of scheduling with TBB.  Not a lot of thought has gone
-// into picking this size.
-static const vtkm::Id TBB_GRAIN_SIZE = 1024;
+// Some reduce bodies cannot handle ranges smaller than a certain size. Ranges
+// are only split when larger than the grain size, and then into halves, so a
+// grain size of 2n-1 guarantees subranges of at least n values.
+template <typename BodyType>
+void ParallelReduce(TBBAlgorithm algorithm,
+                    vtkm::Id size,
+                    BodyType& body,
+                    vtkm::Id minRangeSize = 1)
+{
+  const TBBSchedulingOptions options = SchedulingPolicyTBB::GetOptions(algorithm);
+  const vtkm::Id grainSize = std::max(options.GrainSize, 2 * minRangeSize - 1);
+  ::tbb::blocked_range<vtkm::Id> range(0, size, grainSize);
+  switch (options.Partitioner)
+  {
+    case TBBPartitioner::Simple:
+      ::tbb::parallel_reduce(range, body, ::tbb::simple_partitioner());
+      break;
+    case TBBPartitioner::Affinity:
+      ::tbb::parallel_reduce(range, body, GetAffinityPartitioner(algorithm));
+      break;
+    case TBBPartitioner::Auto:
+    default:
+      ::tbb::parallel_reduce(range, body, ::tbb::auto_partitioner());
+      break;
+  }
+}
+
+// parallel_scan has no affinity partitioner, so it falls back to auto.
+template <typename BodyType>
+void ParallelScan(TBBAlgorithm algorithm, vtkm::Id size, BodyType& body)
+{
+  const TBBSchedulingOptions options = SchedulingPolicyTBB::GetOptions(algorithm);
+  ::tbb::blocked_range<vtkm::Id> range(0, size, options.GrainSize);
+  if (options.Partitioner == TBBPartitioner::Simple)
+  {
+    ::tbb::parallel_scan(range, body, ::tbb::simple_partitioner());
+  }
+  else
+  {
+    ::tbb::parallel_scan(range, body, ::tbb::auto_partitioner());
+  }
+}
+}
 
 template <typename InputPortalType, typename OutputPortalType>
 struct CopyBody
@@ -164,8 +244,7 @@ void CopyPortals(const InputPortalType& inPortal,
 {
   using Kernel = CopyBody<InputPortalType, OutputPortalType>;
   Kernel kernel(inPortal, outPortal, inOffset, outOffset);
-  ::tbb::blocked_range<vtkm::Id> range(0, numValues, TBB_GRAIN_SIZE);
-  ::tbb::parallel_for(range, kernel);
+  internal::ParallelFor(TBBAlgorithm::Copy, numValues, kernel);
 }
 
 template <typename InputPortalType,
@@ -372,9 +451,7 @@ VTKM_CONT vtkm::Id CopyIfPortals(InputPortalType inputPortal,
 
   CopyIfBody<InputPortalType, StencilPortalType, OutputPortalType, UnaryPredicateType> body(
     inputPortal, stencilPortal, outputPortal, unaryPredicate);
-  ::tbb::blocked_range<vtkm::Id> range(0, inputLength, TBB_GRAIN_SIZE);
-
-  ::tbb::parallel_reduce(range, body);
+  internal::ParallelReduce(TBBAlgorithm::CopyIf, inputLength, body);
 
   body.Ranges.AssertSane();
   VTKM_ASSERT(body.Ranges.InputBegin == 0 && body.Ranges.InputEnd == inputLength &&
@@ -477,8 +554,8 @@ VTKM_CONT static T ReducePortals(InputPortalType inputPortal,
 
   if (arrayLength > 1)
   {
-    ::tbb::blocked_range<vtkm::Id> range(0, arrayLength, TBB_GRAIN_SIZE);
-    ::tbb::parallel_reduce(range, body);
+    // ReduceBody needs at least two values in each range.
+    internal::ParallelReduce(TBBAlgorithm::Reduce, arrayLength, body, 2);
     return body.Sum;
   }
   else if (arrayLength == 1)
@@ -818,13 +895,11 @@ VTKM_CONT vtkm::Id ReduceByKeyPortals(KeysInPortalType keysInPortal,
                   ValuesOutPortalType,
                   WrappedBinaryOp>
     body(keysInPortal, valuesInPortal, keysOutPortal, valuesOutPortal, wrappedBinaryOp);
-  ::tbb::blocked_range<vtkm::Id> range(0, inputLength, TBB_GRAIN_SIZE);
-
 #ifdef _VTKM_DEBUG_TBB_RBK
   std::cerr << "\n\nTBB ReduceByKey:\n";
 #endif
 
-  ::tbb::parallel_reduce(range, body);
+  internal::ParallelReduce(TBBAlgorithm::ReduceByKey, inputLength, body);
 
 #ifdef _VTKM_DEBUG_TBB_RBK
   std::cerr << "Total reduce time: " << body.ReduceTime << "s\n";
@@ -1054,8 +1129,7 @@ ScanInclusivePortals(InputPortalType inputPortal,
     inputPortal, outputPortal, wrappedBinaryOp);
   vtkm::Id arrayLength = inputPortal.GetNumberOfValues();
 
-  ::tbb::blocked_range<vtkm::Id> range(0, arrayLength, TBB_GRAIN_SIZE);
-  ::tbb::parallel_scan(range, body);
+  internal::ParallelScan(TBBAlgorithm::Scan, arrayLength, body);
   return body.Sum;
 }
 
@@ -1077,14 +1151,399 @@ ScanExclusivePortals(
     inputPortal, outputPortal, wrappedBinaryOp, initialValue);
   vtkm::Id arrayLength = inputPortal.GetNumberOfValues();
 
-  ::tbb::blocked_range<vtkm::Id> range(0, arrayLength, TBB_GRAIN_SIZE);
-  ::tbb::parallel_scan(range, body);
+  internal::ParallelScan(TBBAlgorithm::Scan, arrayLength, body);
 
   // Seems a little weird to me that we would return the last value in the
   // array rather than the sum, but that is how the function is specified.
   return body.Sum;
 }
 
+/// Segmented scan used for \c ScanInclusiveByKey and \c ScanExclusiveByKey.
+/// Unlike the general implementation, which computes key states and then
+/// scans zipped (value, state) pairs, this runs as a single parallel_scan
+/// directly over the keys and values.
+///
+/// The body summarizes a contiguous span of the input with the first and last
+/// key of the span, whether all its keys are the same, and the running sum of
+/// its trailing segment. For the exclusive scan the initial value is applied
+/// at the start of each segment, so a span that does not start at index 0 and
+/// contains no segment boundary keeps a "raw" sum without the initial value
+/// until it is joined with whatever is to its left.
+template <class KeysPortalType,
+          class InputPortalType,
+          class OutputPortalType,
+          class BinaryOperationType,
+          bool Exclusive>
+struct ScanByKeyBody
+{
+  using KeyType = typename std::remove_const<typename KeysPortalType::ValueType>::type;
+  using ValueType = typename std::remove_reference<typename OutputPortalType::ValueType>::type;
+
+  KeysPortalType KeysPortal;
+  InputPortalType InputPortal;
+  OutputPortalType OutputPortal;
+  BinaryOperationType BinaryOperation;
+  ValueType InitialValue;
+
+  bool HasPrefix;
+  bool AllSameKey;
+  bool Raw;
+  KeyType FirstKey;
+  KeyType LastKey;
+  ValueType Sum;
+
+  VTKM_CONT
+  ScanByKeyBody(const KeysPortalType& keysPortal,
+                const InputPortalType& inputPortal,
+                const OutputPortalType& outputPortal,
+                BinaryOperationType binaryOperation,
+                const ValueType& initialValue)
+    : KeysPortal(keysPortal)
+    , InputPortal(inputPortal)
+    , OutputPortal(outputPortal)
+    , BinaryOperation(binaryOperation)
+    , InitialValue(initialValue)
+    , HasPrefix(false)
+    , AllSameKey(true)
+    , Raw(false)
+    , FirstKey()
+    , LastKey()
+    , Sum(initialValue)
+  {
+  }
+
+  VTKM_EXEC_CONT
+  ScanByKeyBody(const ScanByKeyBody& body, ::tbb::split)
+    : KeysPortal(body.KeysPortal)
+    , InputPortal(body.InputPortal)
+    , OutputPortal(body.OutputPortal)
+    , BinaryOperation(body.BinaryOperation)
+    , InitialValue(body.InitialValue)
+    , HasPrefix(false)
+    , AllSameKey(true)
+    , Raw(false)
+    , FirstKey()
+    , LastKey()
+    , Sum(body.InitialValue)
+  {
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC
+  ValueType StartSegment(const ValueType& value) const
+  {
+    return Exclusive ? this->BinaryOperation(this->InitialValue, value) : value;
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  template <bool IsFinalScan>
+  VTKM_EXEC void Scan(const ::tbb::blocked_range<vtkm::Id>& range)
+  {
+    //use temps instead of member variables to reduce false sharing
+    vtkm::Id index = range.begin();
+    KeyType lastKey = this->LastKey;
+    ValueType sum = this->Sum;
+    bool allSameKey = this->AllSameKey;
+    bool raw = this->Raw;
+
+    if (!this->HasPrefix)
+    {
+      // The body only lacks a prefix at the start of a pre-scan, or when the
+      // range starts the whole array.
+      lastKey = this->KeysPortal.Get(index);
+      const ValueType value = this->InputPortal.Get(index);
+      this->FirstKey = lastKey;
+      this->HasPrefix = true;
+      if (IsFinalScan)
+      {
+        this->OutputPortal.Set(index, Exclusive ? this->InitialValue : value);
+      }
+      // The segment containing the first value of a range other than the first
+      // may continue from the left, so the initial value cannot be applied yet.
+      raw = Exclusive && (index != 0);
+      sum = raw ? value : this->StartSegment(value);
+      ++index;
+    }
+
+    for (; index != range.end(); ++index)
+    {
+      const KeyType key = this->KeysPortal.Get(index);
+      const ValueType value = this->InputPortal.Get(index);
+      if (key != lastKey)
+      {
+        if (IsFinalScan && Exclusive)
+        {
+          this->OutputPortal.Set(index, this->InitialValue);
+        }
+        sum = this->StartSegment(value);
+        allSameKey = false;
+        raw = false;
+        lastKey = key;
+      }
+      else
+      {
+        if (IsFinalScan && Exclusive)
+        {
+          this->OutputPortal.Set(index, sum);
+        }
+        sum = this->BinaryOperation(sum, value);
+      }
+      if (IsFinalScan && !Exclusive)
+      {
+        this->OutputPortal.Set(index, sum);
+      }
+    }
+
+    this->LastKey = lastKey;
+    this->Sum = sum;
+    this->AllSameKey = allSameKey;
+    this->Raw = raw;
+  }
+
+  VTKM_EXEC
+  void operator()(const ::tbb::blocked_range<vtkm::Id>& range, ::tbb::pre_scan_tag)
+  {
+    this->Scan<false>(range);
+  }
+
+  VTKM_EXEC
+  void operator()(const ::tbb::blocked_range<vtkm::Id>& range, ::tbb::final_scan_tag)
+  {
+    // A final scan always has everything to its left as prefix, which starts
+    // at index 0, so the prefix sum must be complete.
+    VTKM_ASSERT(!this->Raw);
+    this->Scan<true>(range);
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT
+  void reverse_join(const ScanByKeyBody& left)
+  {
+    if (!left.HasPrefix)
+    {
+      return;
+    }
+    if (!this->HasPrefix)
+    {
+      this->assign(left);
+      return;
+    }
+
+    if (this->AllSameKey && (this->FirstKey == left.LastKey))
+    {
+      this->Sum = this->BinaryOperation(left.Sum, this->Sum);
+      this->Raw = left.Raw;
+    }
+    else if (this->Raw)
+    {
+      // Our leading segment did not continue from the left after all.
+      this->Sum = this->BinaryOperation(this->InitialValue, this->Sum);
+      this->Raw = false;
+    }
+    this->AllSameKey = left.AllSameKey && this->AllSameKey && (left.LastKey == this->FirstKey);
+    this->FirstKey = left.FirstKey;
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT
+  void assign(const ScanByKeyBody& src)
+  {
+    this->HasPrefix = src.HasPrefix;
+    this->AllSameKey = src.AllSameKey;
+    this->Raw = src.Raw;
+    this->FirstKey = src.FirstKey;
+    this->LastKey = src.LastKey;
+    this->Sum = src.Sum;
+  }
+};
+
+VTKM_SUPPRESS_EXEC_WARNINGS
+template <bool Exclusive,
+          class KeysPortalType,
+          class InputPortalType,
+          class OutputPortalType,
+          class BinaryOperationType>
+VTKM_CONT static void ScanByKeyPortals(
+  KeysPortalType keysPortal,
+  InputPortalType inputPortal,
+  OutputPortalType outputPortal,
+  BinaryOperationType binaryOperation,
+  typename std::remove_reference<typename OutputPortalType::ValueType>::type initialValue)
+{
+  using ValueType = typename std::remove_reference<typename OutputPortalType::ValueType>::type;
+
+  using WrappedBinaryOp = internal::WrappedBinaryOperator<ValueType, BinaryOperationType>;
+
+  WrappedBinaryOp wrappedBinaryOp(binaryOperation);
+  ScanByKeyBody<KeysPortalType, InputPortalType, OutputPortalType, WrappedBinaryOp, Exclusive> body(
+    keysPortal, inputPortal, outputPortal, wrappedBinaryOp, initialValue);
+  vtkm::Id arrayLength = inputPortal.GetNumberOfValues();
+
+  internal::ParallelScan(TBBAlgorithm::ScanByKey, arrayLength, body);
+}
+
+/// Finds the lower (or upper) bound of each value in a sorted array. Each task
+/// handles a contiguous run of values, and when consecutive values are
+/// ascending (the common case of looking up a sorted array) the search for a
+/// value gallops forward from the bound of the previous value instead of
+/// bisecting the whole array. This keeps the memory accesses of a task local.
+template <class InputPortalType,
+          class ValuesPortalType,
+          class OutputPortalType,
+          class BinaryCompare,
+          bool UpperBound>
+struct BoundsBody
+{
+  using ValueType = typename std::remove_const<typename ValuesPortalType::ValueType>::type;
+
+  InputPortalType InputPortal;
+  ValuesPortalType ValuesPortal;
+  OutputPortalType OutputPortal;
+  BinaryCompare Compare;
+
+  VTKM_CONT
+  BoundsBody(const InputPortalType& inputPortal,
+             const ValuesPortalType& valuesPortal,
+             const OutputPortalType& outputPortal,
+             BinaryCompare compare)
+    : InputPortal(inputPortal)
+    , ValuesPortal(valuesPortal)
+    , OutputPortal(outputPortal)
+    , Compare(compare)
+  {
+  }
+
+  // True if the input at index comes before the position of value.
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC
+  bool Before(vtkm::Id index, const ValueType& value) const
+  {
+    return UpperBound ? !this->Compare(value, this->InputPortal.Get(index))
+                      : this->Compare(this->InputPortal.Get(index), value);
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC
+  void operator()(const ::tbb::blocked_range<vtkm::Id>& range) const
+  {
+    const vtkm::Id inputSize = this->InputPortal.GetNumberOfValues();
+
+    ValueType previousValue = ValueType();
+    vtkm::Id previousResult = 0;
+    for (vtkm::Id index = range.begin(); index != range.end(); ++index)
+    {
+      // Read the value before writing the output, as they may be the same array.
+      const ValueType value = this->ValuesPortal.Get(index);
+
+      vtkm::Id low = 0;
+      vtkm::Id high = inputSize;
+      if ((index != range.begin()) && !this->Compare(value, previousValue))
+      {
+        low = previousResult;
+        high = low;
+        vtkm::Id step = 1;
+        while ((high < inputSize) && this->Before(high, value))
+        {
+          low = high + 1;
+          high = low + step;
+          step *= 2;
+        }
+        high = std::min(high, inputSize);
+      }
+
+      while (low < high)
+      {
+        const vtkm::Id middle = low + (high - low) / 2;
+        if (this->Before(middle, value))
+        {
+          low = middle + 1;
+        }
+        else
+        {
+          high = middle;
+        }
+      }
+
+      this->OutputPortal.Set(index, low);
+      previousValue = value;
+      previousResult = low;
+    }
+  }
+};
+
+VTKM_SUPPRESS_EXEC_WARNINGS
+template <bool UpperBound,
+          class InputPortalType,
+          class ValuesPortalType,
+          class OutputPortalType,
+          class BinaryCompare>
+VTKM_CONT static void BoundsPortals(InputPortalType inputPortal,
+                                    ValuesPortalType valuesPortal,
+                                    OutputPortalType outputPortal,
+                                    BinaryCompare binaryCompare)
+{
+  using WrappedCompare = internal::WrappedBinaryOperator<bool, BinaryCompare>;
+
+  BoundsBody<InputPortalType, ValuesPortalType, OutputPortalType, WrappedCompare, UpperBound> body(
+    inputPortal, valuesPortal, outputPortal, WrappedCompare(binaryCompare));
+
+  internal::ParallelFor(TBBAlgorithm::Bounds, valuesPortal.GetNumberOfValues(), body);
+}
+
+template <class Input1PortalType,
+          class Input2PortalType,
+          class OutputPortalType,
+          class BinaryFunctor>
+struct TransformBody
+{
+  Input1PortalType Input1Portal;
+  Input2PortalType Input2Portal;
+  OutputPortalType OutputPortal;
+  BinaryFunctor BinaryOperator;
+
+  VTKM_CONT
+  TransformBody(const Input1PortalType& input1Portal,
+                const Input2PortalType& input2Portal,
+                const OutputPortalType& outputPortal,
+                BinaryFunctor binaryOperator)
+    : Input1Portal(input1Portal)
+    , Input2Portal(input2Portal)
+    , OutputPortal(outputPortal)
+    , BinaryOperator(binaryOperator)
+  {
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC
+  void operator()(const ::tbb::blocked_range<vtkm::Id>& range) const
+  {
+    VTKM_VECTORIZATION_PRE_LOOP
+    for (vtkm::Id index = range.begin(); index != range.end(); ++index)
+    {
+      VTKM_VECTORIZATION_IN_LOOP
+      this->OutputPortal.Set(
+        index, this->BinaryOperator(this->Input1Portal.Get(index), this->Input2Portal.Get(index)));
+    }
+  }
+};
+
+VTKM_SUPPRESS_EXEC_WARNINGS
+template <class Input1PortalType,
+          class Input2PortalType,
+          class OutputPortalType,
+          class BinaryFunctor>
+VTKM_CONT static void TransformPortals(Input1PortalType input1Portal,
+                                       Input2PortalType input2Portal,
+                                       OutputPortalType outputPortal,
+                                       BinaryFunctor binaryFunctor,
+                                       vtkm::Id numValues)
+{
+  TransformBody<Input1PortalType, Input2PortalType, OutputPortalType, BinaryFunctor> body(
+    input1Portal, input2Portal, outputPortal, binaryFunctor);
+
+  internal::ParallelFor(TBBAlgorithm::Transform, numValues, body);
+}
+
 template <typename InputPortalType, typename IndexPortalType, typename OutputPortalType>
 class ScatterKernel
 {
@@ -1145,10 +1604,38 @@ VTKM_CONT static void ScatterPortal(InputPortalType inputPortal,
   ScatterKernel<InputPortalType, IndexPortalType, OutputPortalType> scatter(
     inputPortal, indexPortal, outputPortal);
 
-  ::tbb::blocked_range<vtkm::Id> range(0, size, TBB_GRAIN_SIZE);
-  ::tbb::parallel_for(range, scatter);
+  internal::ParallelFor(TBBAlgorithm::Scatter, size, scatter);
 }
 
+/// Runs the blocks of a radix sort as TBB tasks. Blocks hold at least \c
+/// RADIX_SORT_BLOCK_SIZE values so that the cost of histogramming a block
+/// stays small relative to its contents, and there are at most \c
+/// RADIX_SORT_MAX_BLOCKS blocks to bound the size of the histograms.
+struct RadixSortExecutorTBB
+{
+  static const vtkm::Id RADIX_SORT_BLOCK_SIZE = 1 << 16;
+  static const vtkm::Id RADIX_SORT_MAX_BLOCKS = 64;
+
+  VTKM_CONT static vtkm::Id NumberOfBlocks(vtkm::Id numValues)
+  {
+    return vtkm::Min((numValues + RADIX_SORT_BLOCK_SIZE - 1) / RADIX_SORT_BLOCK_SIZE,
+                     RADIX_SORT_MAX_BLOCKS);
+  }
+
+  template <typename Functor>
+  VTKM_CONT void operator()(vtkm::Id numBlocks, const Functor& functor) const
+  {
+    ::tbb::parallel_for(::tbb::blocked_range<vtkm::Id>(0, numBlocks, 1),
+                        [&](const ::tbb::blocked_range<vtkm::Id>& range) {
+                          for (vtkm::Id block = range.begin(); block != range.end(); ++block)
+                          {
+                            functor(block);
+                          }
+                        },
+                        ::tbb::simple_partitioner());
+  }
+};
+
 template <typename PortalType, typename BinaryOperationType>
 struct UniqueBody
 {
@@ -1383,9 +1870,7 @@ VTKM_CONT vtkm::Id UniquePortals(PortalType portal, BinaryOperationType binaryOp
   WrappedBinaryOp wrappedBinaryOp(binaryOperation);
 
   UniqueBody<PortalType, WrappedBinaryOp> body(portal, wrappedBinaryOp);
-  ::tbb::blocked_range<vtkm::Id> range(0, inputLength, TBB_GRAIN_SIZE);
-
-  ::tbb::parallel_reduce(range, body);
+  internal::ParallelReduce(TBBAlgorithm::Unique, inputLength, body);
 
   body.Ranges.AssertSane();
   VTKM_ASSERT(body.Ranges.InputBegin == 0 && body.Ranges.InputEnd == inputLength &&
@@ -0,0 +1,234 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#include <vtkm/cont/tbb/internal/SchedulingPolicyTBB.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace tbb
+{
+
+namespace
+{
+
+const std::size_t NUMBER_OF_ALGORITHMS =
+  static_cast<std::size_t>(TBBAlgorithm::NumberOfAlgorithms);
+
+// Used for the VTKM_TBB_GRAIN_SIZE_<ALGORITHM> environment variables. The order
+// must match TBBAlgorithm.
+const char* const ALGORITHM_NAMES[NUMBER_OF_ALGORITHMS] = {
+  "SCHEDULE", "SCHEDULE3D", "COPY",   "COPYIF",    "REDUCE", "REDUCEBYKEY",
+  "SCAN",     "SCATTER",    "UNIQUE", "SCANBYKEY", "BOUNDS", "TRANSFORM"
+};
+
+bool ReadEnvironmentGrainSize(const std::string& variable, vtkm::Id& grainSize)
+{
+  const char* value = std::getenv(variable.c_str());
+  if (value == nullptr)
+  {
+    return false;
+  }
+  const long long parsed = std::strtoll(value, nullptr, 10);
+  if (parsed < 1)
+  {
+    return false;
+  }
+  grainSize = static_cast<vtkm::Id>(parsed);
+  return true;
+}
+
+TBBPartitioner ReadEnvironmentPartitioner()
+{
+  const char* value = std::getenv("VTKM_TBB_PARTITIONER");
+  if (value != nullptr)
+  {
+    if (std::strcmp(value, "simple") == 0)
+    {
+      return TBBPartitioner::Simple;
+    }
+    if (std::strcmp(value, "affinity") == 0)
+    {
+      return TBBPartitioner::Affinity;
+    }
+  }
+  return TBBPartitioner::Auto;
+}
+
+// The options of an algorithm packed into one word, so that algorithms can
+// read them with a single atomic load: the grain size in the high bits and
+// the partitioner in the low PARTITIONER_BITS bits.
+const int PARTITIONER_BITS = 2;
+
+vtkm::UInt64 PackOptions(const TBBSchedulingOptions& options)
+{
+  return (static_cast<vtkm::UInt64>(std::max(options.GrainSize, vtkm::Id(1)))
+          << PARTITIONER_BITS) |
+    static_cast<vtkm::UInt64>(options.Partitioner);
+}
+
+TBBSchedulingOptions UnpackOptions(vtkm::UInt64 packed)
+{
+  TBBSchedulingOptions options;
+  options.GrainSize = static_cast<vtkm::Id>(packed >> PARTITIONER_BITS);
+  options.Partitioner =
+    static_cast<TBBPartitioner>(packed & ((vtkm::UInt64(1) << PARTITIONER_BITS) - 1));
+  return options;
+}
+
+using TunedGrainSizeMap = std::map<SchedulingPolicyTBB::TaskKey, vtkm::Id>;
+
+// Every algorithm call reads the options, so reads never lock: the options
+// and the auto-tune flag are atomics, and the tuned grain sizes are an
+// immutable map that writers replace (copy on write). The mutex only
+// serializes the writers.
+struct SchedulingPolicyState
+{
+  std::mutex Mutex;
+  std::atomic<vtkm::UInt64> Options[NUMBER_OF_ALGORITHMS];
+  std::atomic<bool> AutoTune;
+  std::shared_ptr<const TunedGrainSizeMap> TunedGrainSizes;
+
+  SchedulingPolicyState() { this->Reset(); }
+
+  // Must be called with the mutex locked (or during construction).
+  void Reset()
+  {
+    vtkm::Id grainSize = TBB_GRAIN_SIZE;
+    const bool haveGrainSize = ReadEnvironmentGrainSize("VTKM_TBB_GRAIN_SIZE", grainSize);
+    const TBBPartitioner partitioner = ReadEnvironmentPartitioner();
+
+    for (std::size_t index = 0; index < NUMBER_OF_ALGORITHMS; ++index)
+    {
+      TBBSchedulingOptions options;
+      options.GrainSize = grainSize;
+      options.Partitioner = partitioner;
+      if (!haveGrainSize && (static_cast<TBBAlgorithm>(index) == TBBAlgorithm::Schedule3D))
+      {
+        // Each 3D task covers at least 4 rows, so use a shorter row length.
+        options.GrainSize = TBB_GRAIN_SIZE_3D;
+      }
+      ReadEnvironmentGrainSize(std::string("VTKM_TBB_GRAIN_SIZE_") + ALGORITHM_NAMES[index],
+                               options.GrainSize);
+      this->Options[index].store(PackOptions(options));
+    }
+
+    const char* autoTune = std::getenv("VTKM_TBB_AUTO_TUNE");
+    this->AutoTune.store((autoTune != nullptr) && (std::strcmp(autoTune, "1") == 0));
+
+    std::atomic_store(&this->TunedGrainSizes,
+                      std::shared_ptr<const TunedGrainSizeMap>(new TunedGrainSizeMap));
+  }
+};
+
+SchedulingPolicyState& GetState()
+{
+  static SchedulingPolicyState state;
+  return state;
+}
+
+} // anonymous namespace
+
+TBBSchedulingOptions SchedulingPolicyTBB::GetOptions(TBBAlgorithm algorithm)
+{
+  return UnpackOptions(GetState().Options[static_cast<std::size_t>(algorithm)].load());
+}
+
+void SchedulingPolicyTBB::SetOptions(TBBAlgorithm algorithm, const TBBSchedulingOptions& options)
+{
+  GetState().Options[static_cast<std::size_t>(algorithm)].store(PackOptions(options));
+}
+
+void SchedulingPolicyTBB::SetOptions(const TBBSchedulingOptions& options)
+{
+  for (std::size_t index = 0; index < NUMBER_OF_ALGORITHMS; ++index)
+  {
+    SetOptions(static_cast<TBBAlgorithm>(index), options);
+  }
+}
+
+void SchedulingPolicyTBB::ResetOptions()
+{
+  SchedulingPolicyState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Reset();
+}
+
+bool SchedulingPolicyTBB::GetAutoTune()
+{
+  return GetState().AutoTune.load();
+}
+
+void SchedulingPolicyTBB::SetAutoTune(bool autoTune)
+{
+  GetState().AutoTune.store(autoTune);
+}
+
+bool SchedulingPolicyTBB::GetTunedGrainSize(TaskKey key, vtkm::Id& grainSize)
+{
+  const std::shared_ptr<const TunedGrainSizeMap> tunedGrainSizes =
+    std::atomic_load(&GetState().TunedGrainSizes);
+  auto entry = tunedGrainSizes->find(key);
+  if (entry == tunedGrainSizes->end())
+  {
+    return false;
+  }
+  grainSize = entry->second;
+  return true;
+}
+
+vtkm::Id SchedulingPolicyTBB::TuneGrainSize(TaskKey key,
+                                            vtkm::Float64 elapsedSeconds,
+                                            vtkm::Id numValues)
+{
+  const vtkm::Float64 targetSeconds = AUTO_TUNE_TASK_SECONDS;
+  const vtkm::Float64 secondsPerValue =
+    elapsedSeconds / static_cast<vtkm::Float64>(std::max(numValues, vtkm::Id(1)));
+
+  // Cap the grain so that a single measurement glitch cannot serialize a loop.
+  const vtkm::Float64 maxGrainSize = 1 << 20;
+  vtkm::Id grainSize = static_cast<vtkm::Id>(maxGrainSize);
+  if (secondsPerValue > 0)
+  {
+    grainSize = static_cast<vtkm::Id>(std::min(targetSeconds / secondsPerValue, maxGrainSize));
+  }
+  grainSize = std::max(grainSize, vtkm::Id(1));
+
+  SchedulingPolicyState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  std::shared_ptr<TunedGrainSizeMap> tunedGrainSizes(
+    new TunedGrainSizeMap(*std::atomic_load(&state.TunedGrainSizes)));
+  (*tunedGrainSizes)[key] = grainSize;
+  std::atomic_store(&state.TunedGrainSizes,
+                    std::shared_ptr<const TunedGrainSizeMap>(tunedGrainSizes));
+  return grainSize;
+}
+}
+}
+} // namespace vtkm::cont::tbb
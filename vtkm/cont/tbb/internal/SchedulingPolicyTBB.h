@@ -0,0 +1,149 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_cont_tbb_internal_SchedulingPolicyTBB_h
+#define vtk_m_cont_tbb_internal_SchedulingPolicyTBB_h
+
+#include <vtkm/Types.h>
+#include <vtkm/cont/vtkm_cont_export.h>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace tbb
+{
+
+/// The default "grain size" of scheduling with TBB. This is the minimum
+/// number of values a TBB task processes unless overridden by the \c
+/// SchedulingPolicyTBB.
+static const vtkm::Id TBB_GRAIN_SIZE = 1024;
+
+/// The default grain size along the first dimension of 3D scheduling.
+static const vtkm::Id TBB_GRAIN_SIZE_3D = 256;
+
+/// The device adapter algorithms whose TBB scheduling can be configured
+/// independently of each other.
+enum class TBBAlgorithm
+{
+  Schedule = 0,
+  Schedule3D,
+  Copy,
+  CopyIf,
+  Reduce,
+  ReduceByKey,
+  Scan,
+  Scatter,
+  Unique,
+  ScanByKey,
+  Bounds,
+  Transform,
+  NumberOfAlgorithms
+};
+
+/// The TBB partitioner used to split the range of an algorithm into tasks.
+/// The \c Simple partitioner splits all the way down to the grain size, the
+/// \c Auto partitioner stops splitting once there is enough parallelism, and
+/// the \c Affinity partitioner is like \c Auto but also replays the previous
+/// task-to-thread mapping so that repeated loops over the same data hit warm
+/// caches. TBB scans do not support the affinity partitioner, so scans fall
+/// back to \c Auto.
+enum class TBBPartitioner
+{
+  Auto = 0,
+  Simple,
+  Affinity
+};
+
+struct TBBSchedulingOptions
+{
+  /// The minimum number of values processed by a task. For \c Schedule3D this
+  /// is the grain along the first (fastest varying) dimension.
+  vtkm::Id GrainSize;
+  TBBPartitioner Partitioner;
+};
+
+/// \brief Runtime control of how the TBB device adapter partitions work.
+///
+/// Every algorithm of \c DeviceAdapterAlgorithm<DeviceAdapterTagTBB> reads its
+/// grain size and partitioner from this policy when it is called. The initial
+/// options come from the environment:
+///
+///   - \c VTKM_TBB_GRAIN_SIZE sets the grain size of all algorithms.
+///   - \c VTKM_TBB_GRAIN_SIZE_<ALGORITHM> (for example \c
+///     VTKM_TBB_GRAIN_SIZE_SCAN) overrides the grain size of one algorithm.
+///     The algorithm names are the upper-case names of \c TBBAlgorithm.
+///   - \c VTKM_TBB_PARTITIONER is one of \c auto, \c simple or \c affinity.
+///   - \c VTKM_TBB_AUTO_TUNE set to \c 1 enables auto-tuning.
+///
+/// When auto-tuning is on, the first time a worklet is scheduled its cost per
+/// value is measured by running a small slice of the range serially. The
+/// grain size for that worklet is then chosen so that each task runs for
+/// roughly \c AUTO_TUNE_TASK_SECONDS, and is reused by later invocations of
+/// the same worklet. This trades a little overhead on first use for coarse
+/// tasks on cheap worklets and fine tasks on expensive ones.
+///
+/// All the methods are thread safe. Reading the options and tuned grain sizes
+/// does not lock, so concurrent and nested algorithm calls do not contend on
+/// the policy.
+///
+class VTKM_CONT_EXPORT SchedulingPolicyTBB
+{
+public:
+  /// The target run time of a single task when auto-tuning grain sizes.
+  static constexpr vtkm::Float64 AUTO_TUNE_TASK_SECONDS = 5e-5;
+
+  /// The number of values used to measure the cost of a worklet when
+  /// auto-tuning grain sizes.
+  static const vtkm::Id AUTO_TUNE_SAMPLE_SIZE = 1024;
+
+  VTKM_CONT static TBBSchedulingOptions GetOptions(TBBAlgorithm algorithm);
+
+  /// Set the options of a single algorithm.
+  VTKM_CONT static void SetOptions(TBBAlgorithm algorithm, const TBBSchedulingOptions& options);
+
+  /// Set the options of all algorithms.
+  VTKM_CONT static void SetOptions(const TBBSchedulingOptions& options);
+
+  /// Restore the options read from the environment and clear the auto-tuned
+  /// grain sizes.
+  VTKM_CONT static void ResetOptions();
+
+  VTKM_CONT static bool GetAutoTune();
+  VTKM_CONT static void SetAutoTune(bool autoTune);
+
+  /// Key identifying the type of a scheduled task. Tasks for the same worklet
+  /// and invocation type share a key.
+  using TaskKey = void (*)(void*, void* const, vtkm::Id, vtkm::Id, vtkm::Id);
+
+  /// Looks up the grain size tuned for a task. Returns false if the task has
+  /// not been tuned yet.
+  VTKM_CONT static bool GetTunedGrainSize(TaskKey key, vtkm::Id& grainSize);
+
+  /// Computes and records the grain size for a task from the time it took to
+  /// process \c numValues values. Returns the new grain size.
+  VTKM_CONT static vtkm::Id TuneGrainSize(TaskKey key,
+                                          vtkm::Float64 elapsedSeconds,
+                                          vtkm::Id numValues);
+};
+}
+}
+} // namespace vtkm::cont::tbb
+
+#endif //vtk_m_cont_tbb_internal_SchedulingPolicyTBB_h
@@ -0,0 +1,88 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#define VTKM_DEVICE_ADAPTER VTKM_DEVICE_ADAPTER_ERROR
+
+#include <vtkm/cont/tbb/DeviceAdapterTBB.h>
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/StorageBasicMemoryPool.h>
+#include <vtkm/cont/testing/Testing.h>
+
+namespace
+{
+
+using Device = vtkm::cont::DeviceAdapterTagTBB;
+using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<Device>;
+
+const vtkm::Id LARGE_SIZE = 4 * VTKM_HUGE_PAGE_SIZE / static_cast<vtkm::Id>(sizeof(vtkm::Id));
+
+void CheckIndices(const vtkm::cont::ArrayHandle<vtkm::Id>& array, const char* message)
+{
+  auto portal = array.GetPortalConstControl();
+  for (vtkm::Id i = 0; i < LARGE_SIZE; ++i)
+  {
+    VTKM_TEST_ASSERT(portal.Get(i) == i, message);
+  }
+}
+
+void TestFirstTouch()
+{
+  vtkm::cont::ArrayHandleIndex index(LARGE_SIZE);
+
+  for (bool hugePages : { true, false })
+  {
+    vtkm::cont::internal::SetUseHugePages(hugePages);
+    for (bool firstTouch : { true, false })
+    {
+      std::cout << "First touch " << firstTouch << ", huge pages " << hugePages << std::endl;
+      vtkm::cont::internal::SetUseFirstTouch(firstTouch);
+      vtkm::cont::StorageBasicMemoryPool::Trim();
+
+      vtkm::cont::ArrayHandle<vtkm::Id> copy;
+      Algorithm::Copy(index, copy);
+      VTKM_TEST_ASSERT(copy.GetStorage().GetAllocationIsFresh(), "Expected new memory.");
+      CheckIndices(copy, "Bad copy of large array.");
+
+      // Keeping the buffer does not touch it again.
+      copy.PrepareForOutput(LARGE_SIZE, Device());
+      VTKM_TEST_ASSERT(!copy.GetStorage().GetAllocationIsFresh(), "Buffer was not kept.");
+      CheckIndices(copy, "Buffer changed when kept.");
+
+      // A block reused from the pool is not touched either.
+      copy.ReleaseResources();
+      vtkm::cont::ArrayHandle<vtkm::Id> reused;
+      reused.PrepareForOutput(LARGE_SIZE, Device());
+      VTKM_TEST_ASSERT(!vtkm::cont::StorageBasicMemoryPool::GetEnabled() ||
+                         !reused.GetStorage().GetAllocationIsFresh(),
+                       "Pool block not reused.");
+    }
+  }
+  vtkm::cont::internal::SetUseHugePages(true);
+  vtkm::cont::internal::SetUseFirstTouch(true);
+}
+
+} // anonymous namespace
+
+int UnitTestTBBArrayManagerExecution(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestFirstTouch);
+}
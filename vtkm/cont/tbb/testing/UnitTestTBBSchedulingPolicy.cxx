@@ -0,0 +1,178 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#define VTKM_DEVICE_ADAPTER VTKM_DEVICE_ADAPTER_ERROR
+
+#include <vtkm/cont/tbb/DeviceAdapterTBB.h>
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace
+{
+
+using Device = vtkm::cont::DeviceAdapterTagTBB;
+using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<Device>;
+using Policy = vtkm::cont::tbb::SchedulingPolicyTBB;
+using Options = vtkm::cont::tbb::TBBSchedulingOptions;
+using Partitioner = vtkm::cont::tbb::TBBPartitioner;
+using TBBAlgorithm = vtkm::cont::tbb::TBBAlgorithm;
+
+static const vtkm::Id ARRAY_SIZE = 50000;
+
+struct Square : public vtkm::worklet::WorkletMapField
+{
+  typedef void ControlSignature(FieldIn<>, FieldOut<>);
+  typedef _2 ExecutionSignature(_1);
+
+  VTKM_EXEC
+  vtkm::Id operator()(vtkm::Id value) const { return value * value; }
+};
+
+void RunAlgorithms()
+{
+  vtkm::cont::ArrayHandleIndex index(ARRAY_SIZE);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> copy;
+  Algorithm::Copy(index, copy);
+  for (vtkm::Id i = 0; i < ARRAY_SIZE; ++i)
+  {
+    VTKM_TEST_ASSERT(copy.GetPortalConstControl().Get(i) == i, "Bad copy.");
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> squares;
+  vtkm::worklet::DispatcherMapField<Square, Device>().Invoke(index, squares);
+  for (vtkm::Id i = 0; i < ARRAY_SIZE; ++i)
+  {
+    VTKM_TEST_ASSERT(squares.GetPortalConstControl().Get(i) == i * i, "Bad schedule.");
+  }
+
+  vtkm::Id sum = Algorithm::Reduce(index, vtkm::Id(0));
+  VTKM_TEST_ASSERT(sum == ARRAY_SIZE * (ARRAY_SIZE - 1) / 2, "Bad reduce.");
+
+  vtkm::cont::ArrayHandle<vtkm::Id> scan;
+  vtkm::Id total = Algorithm::ScanInclusive(index, scan);
+  VTKM_TEST_ASSERT(total == sum, "Bad scan total.");
+  VTKM_TEST_ASSERT(scan.GetPortalConstControl().Get(ARRAY_SIZE - 1) == sum, "Bad scan.");
+
+  vtkm::cont::ArrayHandle<vtkm::Id> keys;
+  Algorithm::Copy(vtkm::cont::ArrayHandleCounting<vtkm::Id>(0, 1, ARRAY_SIZE), keys);
+  auto keysPortal = keys.GetPortalControl();
+  for (vtkm::Id i = 0; i < ARRAY_SIZE; ++i)
+  {
+    keysPortal.Set(i, i / 10);
+  }
+  vtkm::cont::ArrayHandle<vtkm::Id> uniqueKeys;
+  vtkm::cont::ArrayHandle<vtkm::Id> counts;
+  Algorithm::ReduceByKey(keys,
+                         vtkm::cont::ArrayHandleConstant<vtkm::Id>(1, ARRAY_SIZE),
+                         uniqueKeys,
+                         counts,
+                         vtkm::Sum());
+  VTKM_TEST_ASSERT(uniqueKeys.GetNumberOfValues() == ARRAY_SIZE / 10, "Bad reduce by key.");
+  for (vtkm::Id i = 0; i < ARRAY_SIZE / 10; ++i)
+  {
+    VTKM_TEST_ASSERT(uniqueKeys.GetPortalConstControl().Get(i) == i, "Bad unique key.");
+    VTKM_TEST_ASSERT(counts.GetPortalConstControl().Get(i) == 10, "Bad key count.");
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> inclusiveByKey;
+  Algorithm::ScanInclusiveByKey(keys, index, inclusiveByKey);
+  vtkm::cont::ArrayHandle<vtkm::Id> exclusiveByKey;
+  Algorithm::ScanExclusiveByKey(keys, index, exclusiveByKey, vtkm::Id(1), vtkm::Add());
+  for (vtkm::Id i = 0; i < ARRAY_SIZE; ++i)
+  {
+    const vtkm::Id segmentStart = (i / 10) * 10;
+    const vtkm::Id expected = (i - segmentStart + 1) * (segmentStart + i) / 2;
+    VTKM_TEST_ASSERT(inclusiveByKey.GetPortalConstControl().Get(i) == expected,
+                     "Bad inclusive scan by key.");
+    VTKM_TEST_ASSERT(exclusiveByKey.GetPortalConstControl().Get(i) == expected - i + 1,
+                     "Bad exclusive scan by key.");
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> lowerBounds;
+  vtkm::cont::ArrayHandle<vtkm::Id> upperBounds;
+  Algorithm::LowerBounds(keys, index, lowerBounds);
+  Algorithm::UpperBounds(keys, index, upperBounds);
+  for (vtkm::Id i = 0; i < ARRAY_SIZE; ++i)
+  {
+    const vtkm::Id lower = vtkm::Min(i * 10, ARRAY_SIZE);
+    const vtkm::Id upper = vtkm::Min(lower + 10, ARRAY_SIZE);
+    VTKM_TEST_ASSERT(lowerBounds.GetPortalConstControl().Get(i) == lower, "Bad lower bounds.");
+    VTKM_TEST_ASSERT(upperBounds.GetPortalConstControl().Get(i) == upper, "Bad upper bounds.");
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> transform;
+  Algorithm::Transform(index, squares, transform, vtkm::Add());
+  for (vtkm::Id i = 0; i < ARRAY_SIZE; ++i)
+  {
+    VTKM_TEST_ASSERT(transform.GetPortalConstControl().Get(i) == i + i * i, "Bad transform.");
+  }
+
+  Algorithm::Unique(keys);
+  VTKM_TEST_ASSERT(keys.GetNumberOfValues() == ARRAY_SIZE / 10, "Bad unique.");
+}
+
+void TestSchedulingPolicy()
+{
+  std::cout << "Default options" << std::endl;
+  Policy::ResetOptions();
+  RunAlgorithms();
+
+  std::cout << "Simple partitioner with tiny grain" << std::endl;
+  Policy::SetOptions(Options{ 1, Partitioner::Simple });
+  VTKM_TEST_ASSERT(Policy::GetOptions(TBBAlgorithm::Scan).GrainSize == 1, "Options not set.");
+  RunAlgorithms();
+
+  std::cout << "Affinity partitioner" << std::endl;
+  Policy::SetOptions(Options{ 100, Partitioner::Affinity });
+  RunAlgorithms();
+  RunAlgorithms();
+
+  std::cout << "Per-algorithm override" << std::endl;
+  Policy::ResetOptions();
+  Policy::SetOptions(TBBAlgorithm::Reduce, Options{ 0, Partitioner::Simple });
+  VTKM_TEST_ASSERT(Policy::GetOptions(TBBAlgorithm::Reduce).GrainSize == 1,
+                   "Grain size not clamped.");
+  VTKM_TEST_ASSERT(Policy::GetOptions(TBBAlgorithm::Copy).GrainSize ==
+                     Policy::GetOptions(TBBAlgorithm::Scan).GrainSize,
+                   "Override leaked to other algorithms.");
+  RunAlgorithms();
+
+  std::cout << "Auto-tuning" << std::endl;
+  Policy::ResetOptions();
+  Policy::SetAutoTune(true);
+  RunAlgorithms();
+  RunAlgorithms();
+  Policy::SetAutoTune(false);
+  Policy::ResetOptions();
+}
+
+} // anonymous namespace
+
+int UnitTestTBBSchedulingPolicy(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestSchedulingPolicy);
+}
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 namespace vtkm
 {
@@ -97,6 +98,60 @@ private:
     }
   }
 
+  template <typename T>
+  static void TestNanField()
+  {
+    const vtkm::Id nvals = 11;
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    T data[nvals] = { nan, 2, 3, 4, 5, -5, -4, nan, -2, -1, nan };
+    auto field = vtkm::cont::make_Field("TestField", vtkm::cont::Field::ASSOC_POINTS, data, nvals);
+
+    vtkm::Range result;
+    field.GetRange(&result);
+
+    std::cout << result << std::endl;
+    VTKM_TEST_ASSERT((test_equal(result.Min, -5.0) && test_equal(result.Max, 5.0)),
+                     "NaN values should not be part of the range.");
+
+    T allNan[3] = { nan, nan, nan };
+    field = vtkm::cont::make_Field("TestField", vtkm::cont::Field::ASSOC_POINTS, allNan, 3);
+    field.GetRange(&result);
+    VTKM_TEST_ASSERT(!result.IsNonEmpty(), "Range of only NaN values should be empty.");
+  }
+
+  static void TestSharedRange()
+  {
+    const vtkm::Id nvals = 11;
+    vtkm::Float32 data[nvals] = { 1, 2, 3, 4, 5, -5, -4, -3, -2, -1, 0 };
+    auto field = vtkm::cont::make_Field("TestField", vtkm::cont::Field::ASSOC_POINTS, data, nvals);
+
+    // Copies made before and after the range is computed share it.
+    vtkm::cont::Field copy = field;
+    vtkm::cont::ArrayHandle<vtkm::Range> range = copy.GetRange();
+    VTKM_TEST_ASSERT(field.GetRange() == range, "Field copy does not share range.");
+    vtkm::cont::Field laterCopy = field;
+    VTKM_TEST_ASSERT(laterCopy.GetRange() == range, "Field copy does not share range.");
+
+    // New data gets a range of its own.
+    vtkm::Float32 newData[2] = { 10, 20 };
+    copy.SetData(vtkm::cont::make_ArrayHandle(newData, 2));
+    vtkm::Range newRange;
+    copy.GetRange(&newRange);
+    VTKM_TEST_ASSERT(test_equal(newRange, vtkm::Range(10, 20)), "Range of new data is wrong.");
+    vtkm::Range oldRange;
+    field.GetRange(&oldRange);
+    VTKM_TEST_ASSERT(test_equal(oldRange, vtkm::Range(-5, 5)), "Range of copy has changed.");
+
+    // Writing through the data of one copy changes the range of the others.
+    laterCopy.GetData()
+      .CastToTypeStorage<vtkm::Float32, vtkm::cont::StorageTagBasic>()
+      .GetPortalControl()
+      .Set(0, 100);
+    field.GetRange(&newRange);
+    VTKM_TEST_ASSERT(test_equal(newRange, vtkm::Range(-5, 100)),
+                     "Range of copy not updated after modification.");
+  }
+
   static void TestUniformCoordinateField()
   {
     vtkm::cont::CoordinateSystem field("TestField",
@@ -145,6 +200,14 @@ private:
       std::cout << "Testing (Float64, 9)..." << std::endl;
       TestingComputeRange::TestVecField<vtkm::Float64, 9>();
 
+      std::cout << "Testing (Float32, 1) with NaN..." << std::endl;
+      TestingComputeRange::TestNanField<vtkm::Float32>();
+      std::cout << "Testing (Float64, 1) with NaN..." << std::endl;
+      TestingComputeRange::TestNanField<vtkm::Float64>();
+
+      std::cout << "Testing shared range of field copies..." << std::endl;
+      TestingComputeRange::TestSharedRange();
+
       std::cout << "Testing UniformPointCoords..." << std::endl;
       TestingComputeRange::TestUniformCoordinateField();
     }
@@ -951,6 +951,63 @@ private:
     }
   }
 
+  template <typename KeyType>
+  static VTKM_CONT void TestSortKeyType()
+  {
+    // Pseudo-random keys spread over the full range of the type, including
+    // negative values, so that every digit of a radix sort is exercised.
+    std::vector<KeyType> testKeys(ARRAY_SIZE);
+    vtkm::UInt64 state = 12345;
+    for (std::size_t i = 0; i < ARRAY_SIZE; ++i)
+    {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      // Centering the 48 random bits on zero makes about half the keys negative.
+      const vtkm::Int64 bits =
+        static_cast<vtkm::Int64>(state >> 16) - (static_cast<vtkm::Int64>(1) << 47);
+      testKeys[i] = static_cast<KeyType>(bits / static_cast<vtkm::Int64>((i % 7) * 1000 + 1));
+    }
+    std::vector<KeyType> expectedKeys(testKeys);
+    std::sort(expectedKeys.begin(), expectedKeys.end());
+
+    vtkm::cont::ArrayHandle<KeyType> sorted;
+    Algorithm::Copy(vtkm::cont::make_ArrayHandle(testKeys), sorted);
+    Algorithm::Sort(sorted);
+    for (vtkm::Id i = 0; i < ARRAY_SIZE; ++i)
+    {
+      VTKM_TEST_ASSERT(sorted.GetPortalConstControl().Get(i) ==
+                         expectedKeys[static_cast<std::size_t>(i)],
+                       "Got bad sort value");
+    }
+
+    vtkm::cont::ArrayHandle<KeyType> keys;
+    Algorithm::Copy(vtkm::cont::make_ArrayHandle(testKeys), keys);
+    IdArrayHandle values;
+    Algorithm::Copy(vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), values);
+    Algorithm::SortByKey(keys, values);
+    for (vtkm::Id i = 0; i < ARRAY_SIZE; ++i)
+    {
+      const KeyType key = keys.GetPortalConstControl().Get(i);
+      const vtkm::Id value = values.GetPortalConstControl().Get(i);
+      VTKM_TEST_ASSERT(key == expectedKeys[static_cast<std::size_t>(i)],
+                       "Got bad SortByKeys key");
+      VTKM_TEST_ASSERT(key == testKeys[static_cast<std::size_t>(value)],
+                       "Got bad SortByKeys value");
+    }
+  }
+
+  static VTKM_CONT void TestSortKeyTypes()
+  {
+    std::cout << "-------------------------------------------------" << std::endl;
+    std::cout << "Sort and sort by keys of scalar types" << std::endl;
+
+    TestSortKeyType<vtkm::Int32>();
+    TestSortKeyType<vtkm::UInt32>();
+    TestSortKeyType<vtkm::Int64>();
+    TestSortKeyType<vtkm::UInt64>();
+    TestSortKeyType<vtkm::Float32>();
+    TestSortKeyType<vtkm::Float64>();
+  }
+
   static VTKM_CONT void TestLowerBoundsWithComparisonObject()
   {
     std::cout << "-------------------------------------------------" << std::endl;
@@ -2160,6 +2217,7 @@ private:
       TestSortWithComparisonObject();
       TestSortWithFancyArrays();
       TestSortByKey();
+      TestSortKeyTypes();
 
       TestLowerBoundsWithComparisonObject();
 
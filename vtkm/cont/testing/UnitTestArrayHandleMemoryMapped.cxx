@@ -0,0 +1,190 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/ArrayHandleMemoryMapped.h>
+
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/serial/DeviceAdapterSerial.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace UnitTestArrayHandleMemoryMappedNamespace
+{
+
+const vtkm::Id ARRAY_SIZE = 100;
+const vtkm::UInt64 HEADER_SIZE = 13;
+const char* FILE_NAME = "UnitTestArrayHandleMemoryMapped.bin";
+
+// Writes a header of odd size followed by the test values, with the bytes of
+// each component reversed when swapBytes is set.
+template <typename T>
+void WriteTestFile(bool swapBytes)
+{
+  using ComponentType = typename vtkm::VecTraits<T>::ComponentType;
+
+  std::vector<T> values(static_cast<std::size_t>(ARRAY_SIZE));
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    values[static_cast<std::size_t>(index)] = TestValue(index, T());
+  }
+  if (swapBytes)
+  {
+    vtkm::UInt8* bytes = reinterpret_cast<vtkm::UInt8*>(&values[0]);
+    const std::size_t numBytes = values.size() * sizeof(T);
+    for (std::size_t offset = 0; offset < numBytes; offset += sizeof(ComponentType))
+    {
+      std::reverse(bytes + offset, bytes + offset + sizeof(ComponentType));
+    }
+  }
+
+  std::ofstream file(FILE_NAME, std::ios_base::binary);
+  const std::vector<char> header(static_cast<std::size_t>(HEADER_SIZE), 'x');
+  file.write(&header[0], static_cast<std::streamsize>(header.size()));
+  file.write(reinterpret_cast<const char*>(&values[0]),
+             static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename ArrayHandleType>
+void CheckValues(const ArrayHandleType& array)
+{
+  using ValueType = typename ArrayHandleType::ValueType;
+
+  VTKM_TEST_ASSERT(array.GetNumberOfValues() == ARRAY_SIZE, "Bad size.");
+  auto portal = array.GetPortalConstControl();
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    VTKM_TEST_ASSERT(test_equal(portal.Get(index), TestValue(index, ValueType())),
+                     "Memory mapped array has unexpected value.");
+  }
+}
+
+struct TestMemoryMappedFunctor
+{
+  template <typename T>
+  void operator()(T) const
+  {
+    for (bool swapBytes : { false, true })
+    {
+      WriteTestFile<T>(swapBytes);
+
+      {
+        vtkm::cont::ArrayHandleMemoryMapped<T> array(FILE_NAME, HEADER_SIZE, ARRAY_SIZE, swapBytes);
+        CheckValues(array);
+
+        std::cout << "  Copy on the device" << std::endl;
+        vtkm::cont::ArrayHandle<T> copy;
+        vtkm::cont::DeviceAdapterAlgorithm<vtkm::cont::DeviceAdapterTagSerial>::Copy(array, copy);
+        CheckValues(copy);
+      }
+
+      std::remove(FILE_NAME);
+    }
+  }
+};
+
+void TestSharedFile()
+{
+  std::cout << "Two arrays in one file" << std::endl;
+  WriteTestFile<vtkm::Float32>(false);
+  {
+    auto file = std::make_shared<vtkm::cont::internal::MemoryMappedFile>(FILE_NAME);
+    VTKM_TEST_ASSERT(file->GetSize() == HEADER_SIZE + ARRAY_SIZE * sizeof(vtkm::Float32),
+                     "Bad file size.");
+
+    vtkm::cont::ArrayHandleMemoryMapped<vtkm::Float32> first(
+      file, HEADER_SIZE, ARRAY_SIZE / 2);
+    vtkm::cont::ArrayHandleMemoryMapped<vtkm::Float32> second(
+      file, HEADER_SIZE + (ARRAY_SIZE / 2) * sizeof(vtkm::Float32), ARRAY_SIZE / 2);
+    file.reset();
+
+    for (vtkm::Id index = 0; index < ARRAY_SIZE / 2; ++index)
+    {
+      VTKM_TEST_ASSERT(
+        test_equal(first.GetPortalConstControl().Get(index), TestValue(index, vtkm::Float32())),
+        "Bad value in first array.");
+      VTKM_TEST_ASSERT(test_equal(second.GetPortalConstControl().Get(index),
+                                  TestValue(index + ARRAY_SIZE / 2, vtkm::Float32())),
+                       "Bad value in second array.");
+    }
+  }
+  std::remove(FILE_NAME);
+}
+
+void TestErrors()
+{
+  std::cout << "Errors" << std::endl;
+  WriteTestFile<vtkm::Float32>(false);
+  {
+    vtkm::cont::ArrayHandleMemoryMapped<vtkm::Float32> array(FILE_NAME, HEADER_SIZE, ARRAY_SIZE);
+    try
+    {
+      array.Allocate(ARRAY_SIZE * 2);
+      VTKM_TEST_FAIL("Memory mapped array did not fail to allocate.");
+    }
+    catch (vtkm::cont::ErrorBadValue&)
+    {
+      std::cout << "  Got expected error for Allocate." << std::endl;
+    }
+
+    try
+    {
+      vtkm::cont::ArrayHandleMemoryMapped<vtkm::Float32> tooLong(
+        FILE_NAME, HEADER_SIZE, ARRAY_SIZE + 1);
+      VTKM_TEST_FAIL("Array past the end of file did not fail.");
+    }
+    catch (vtkm::cont::ErrorBadValue&)
+    {
+      std::cout << "  Got expected error for array past the end of file." << std::endl;
+    }
+  }
+  std::remove(FILE_NAME);
+
+  try
+  {
+    vtkm::cont::ArrayHandleMemoryMapped<vtkm::Float32> missing(FILE_NAME, 0, 1);
+    VTKM_TEST_FAIL("Mapping missing file did not fail.");
+  }
+  catch (vtkm::cont::ErrorBadValue&)
+  {
+    std::cout << "  Got expected error for missing file." << std::endl;
+  }
+}
+
+void TestArrayHandleMemoryMapped()
+{
+  vtkm::testing::Testing::TryTypes(
+    TestMemoryMappedFunctor(),
+    vtkm::ListTagBase<vtkm::UInt8, vtkm::Int32, vtkm::Float64, vtkm::Vec<vtkm::Float32, 3>>());
+  TestSharedFile();
+  TestErrors();
+}
+
+} // namespace UnitTestArrayHandleMemoryMappedNamespace
+
+int UnitTestArrayHandleMemoryMapped(int, char* [])
+{
+  using namespace UnitTestArrayHandleMemoryMappedNamespace;
+  return vtkm::cont::testing::Testing::Run(TestArrayHandleMemoryMapped);
+}
@@ -19,8 +19,11 @@
 //============================================================================
 #include <vtkm/cont/CellSetExplicit.h>
 
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/CellSetSingleType.h>
 #include <vtkm/cont/testing/Testing.h>
+#include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/DispatcherMapTopology.h>
 #include <vtkm/worklet/WorkletMapTopology.h>
 
@@ -129,6 +132,20 @@ void TestCellSetExplicit()
     VTKM_TEST_ASSERT(result.GetPortalConstControl().Get(i) == expected1[i], "incorrect result");
   }
 
+  std::cout << "\tTesting CellToPoint connectivity\n";
+  // the cells of each point, in increasing order
+  vtkm::Id expectedCells[] = { 0, 0, 1, 0, 1, 0, 0, 3, 0, 1, 2, 3,
+                               0, 1, 2, 3, 0, 3, 1, 2, 3, 2, 3 };
+  auto cellIndices =
+    cellset.GetConnectivityArray(vtkm::TopologyElementTagCell(), vtkm::TopologyElementTagPoint());
+  VTKM_TEST_ASSERT(cellIndices.GetNumberOfValues() == ArrayLength(expectedCells),
+                   "wrong CellToPoint connectivity length");
+  for (vtkm::Id i = 0; i < cellIndices.GetNumberOfValues(); ++i)
+  {
+    VTKM_TEST_ASSERT(cellIndices.GetPortalConstControl().Get(i) == expectedCells[i],
+                     "incorrect CellToPoint connectivity");
+  }
+
   std::cout << "----------------------------------------------------\n";
   std::cout << "Testing Case 2 (some points are not part of any cell): \n";
   cellset = MakeTestCellSet2();
@@ -153,6 +170,60 @@ void TestCellSetExplicit()
   {
     VTKM_TEST_ASSERT(result.GetPortalConstControl().Get(i) == expected2[i], "incorrect result");
   }
+
+  std::cout << "----------------------------------------------------\n";
+  std::cout << "Testing Case 3 (a point used by many cells): \n";
+  // A fan of triangles around point 0.
+  const vtkm::Id numberOfFanCells = 100;
+  std::vector<vtkm::Id> fanConnectivity;
+  for (vtkm::Id i = 0; i < numberOfFanCells; ++i)
+  {
+    fanConnectivity.push_back(0);
+    fanConnectivity.push_back(i + 1);
+    fanConnectivity.push_back(i + 2);
+  }
+  vtkm::cont::CellSetSingleType<> fan;
+  fan.Fill(numberOfFanCells + 2,
+           vtkm::CELL_SHAPE_TRIANGLE,
+           3,
+           vtkm::cont::make_ArrayHandle(fanConnectivity, vtkm::CopyFlag::On));
+  vtkm::worklet::DispatcherMapTopology<WorkletCellToPoint>().Invoke(fan, result);
+  VTKM_TEST_ASSERT(result.GetPortalConstControl().Get(0) == numberOfFanCells,
+                   "incorrect number of cells of the fan center");
+  auto fanCells =
+    fan.GetConnectivityArray(vtkm::TopologyElementTagCell(), vtkm::TopologyElementTagPoint())
+      .GetPortalConstControl();
+  for (vtkm::Id i = 0; i < numberOfFanCells; ++i)
+  {
+    VTKM_TEST_ASSERT(fanCells.Get(i) == i, "incorrect cells of the fan center");
+  }
+
+  std::cout << "\tTesting sorting long lists of cells\n";
+  // Each list is shuffled, as cells may be scattered in any order.
+  std::vector<vtkm::Id> lists;
+  vtkm::Id listOffsets[] = { 0, 17, 117 };
+  vtkm::IdComponent listSizes[] = { 17, 100, 0 };
+  for (vtkm::IdComponent size : listSizes)
+  {
+    for (vtkm::Id i = 0; i < size; ++i)
+    {
+      lists.push_back((i * 37 + 11) % size);
+    }
+  }
+  vtkm::cont::ArrayHandle<vtkm::Id> listsArray;
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(lists), listsArray);
+  vtkm::worklet::DispatcherMapField<vtkm::cont::internal::SortCellIndices>().Invoke(
+    vtkm::cont::make_ArrayHandle(listOffsets, 3),
+    vtkm::cont::make_ArrayHandle(listSizes, 3),
+    listsArray);
+  for (vtkm::Id list = 0; list < 3; ++list)
+  {
+    for (vtkm::Id i = 0; i < listSizes[list]; ++i)
+    {
+      VTKM_TEST_ASSERT(listsArray.GetPortalConstControl().Get(listOffsets[list] + i) == i,
+                       "cells not sorted");
+    }
+  }
 }
 
 } // anonymous namespace
@@ -215,9 +215,38 @@ struct TestFunctor
   }
 };
 
+void TestHugePages()
+{
+  std::cout << "Testing huge page allocations" << std::endl;
+  using StorageType = vtkm::cont::internal::Storage<vtkm::UInt8, vtkm::cont::StorageTagBasic>;
+
+  for (bool useHugePages : { true, false })
+  {
+    // A block pooled by the previous iteration would be reused instead of
+    // allocating with the new setting.
+    vtkm::cont::StorageBasicMemoryPool::Trim();
+    vtkm::cont::internal::SetUseHugePages(useHugePages);
+    VTKM_TEST_ASSERT(vtkm::cont::internal::GetUseHugePages() == useHugePages,
+                     "Huge pages not set.");
+
+    StorageType storage;
+    storage.Allocate(VTKM_HUGE_PAGE_SIZE + 1);
+    const std::size_t address = reinterpret_cast<std::size_t>(storage.GetArray());
+    VTKM_TEST_ASSERT(address % VTKM_CACHE_LINE_SIZE == 0, "Large array not aligned.");
+#if defined(VTKM_POSIX)
+    VTKM_TEST_ASSERT(!useHugePages || (address % VTKM_HUGE_PAGE_SIZE == 0),
+                     "Large array not aligned to huge pages.");
+#endif
+    storage.GetPortal().Set(VTKM_HUGE_PAGE_SIZE, 1);
+  }
+  vtkm::cont::StorageBasicMemoryPool::Trim();
+  vtkm::cont::internal::SetUseHugePages(true);
+}
+
 void TestStorageBasic()
 {
   vtkm::testing::Testing::TryTypes(TestFunctor());
+  TestHugePages();
 }
 
 } // Anonymous namespace
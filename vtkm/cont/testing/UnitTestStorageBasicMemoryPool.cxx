@@ -0,0 +1,201 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/StorageBasic.h>
+#include <vtkm/cont/StorageBasicMemoryPool.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+namespace
+{
+
+using Pool = vtkm::cont::StorageBasicMemoryPool;
+using StorageType = vtkm::cont::internal::Storage<vtkm::Float64, vtkm::cont::StorageTagBasic>;
+
+const vtkm::Id ARRAY_SIZE = 10000;
+
+void TestBlockSizes()
+{
+  std::cout << "Testing block sizes" << std::endl;
+  VTKM_TEST_ASSERT(Pool::GetBlockSize(1) == 64, "Bad minimum block size.");
+  VTKM_TEST_ASSERT(Pool::GetBlockSize(64) == 64, "Bad block size.");
+  VTKM_TEST_ASSERT(Pool::GetBlockSize(65) == 128, "Bad block size.");
+  VTKM_TEST_ASSERT(Pool::GetBlockSize(4096) == 4096, "Bad block size.");
+  VTKM_TEST_ASSERT(Pool::GetBlockSize(4097) == 5120, "Bad block size.");
+  VTKM_TEST_ASSERT(Pool::GetBlockSize(8192) == 8192, "Bad block size.");
+  VTKM_TEST_ASSERT(Pool::GetBlockSize(8193) == 10240, "Bad block size.");
+
+  for (vtkm::UInt64 size = 1; size < (1 << 20); size = size * 3 + 1)
+  {
+    const vtkm::UInt64 blockSize = Pool::GetBlockSize(size);
+    VTKM_TEST_ASSERT(blockSize >= size, "Block too small.");
+    VTKM_TEST_ASSERT(blockSize <= ((size <= 4096) ? vtkm::Max(2 * size, vtkm::UInt64(64))
+                                                  : size + size / 4),
+                     "Block too large.");
+    VTKM_TEST_ASSERT(Pool::GetBlockSize(blockSize) == blockSize, "Block size not stable.");
+  }
+}
+
+void TestReuse()
+{
+  std::cout << "Testing reuse" << std::endl;
+  Pool::Trim();
+  Pool::ResetStatistics();
+
+  const vtkm::UInt64 blockSize =
+    Pool::GetBlockSize(static_cast<vtkm::UInt64>(ARRAY_SIZE) * sizeof(vtkm::Float64));
+
+  const vtkm::Float64* firstArray;
+  {
+    StorageType storage;
+    storage.Allocate(ARRAY_SIZE);
+    firstArray = storage.GetArray();
+    VTKM_TEST_ASSERT(Pool::GetStatistics().BytesInUse == blockSize, "Block not in use.");
+    VTKM_TEST_ASSERT(storage.GetAllocationIsFresh(), "New block not reported fresh.");
+    storage.Allocate(ARRAY_SIZE / 2);
+    VTKM_TEST_ASSERT(!storage.GetAllocationIsFresh(), "Kept buffer reported fresh.");
+  }
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesInUse == 0, "Block still in use.");
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesCached == blockSize, "Block not cached.");
+
+  {
+    // A slightly smaller array falls in the same size class.
+    StorageType storage;
+    storage.Allocate(ARRAY_SIZE - 1);
+    VTKM_TEST_ASSERT(storage.GetArray() == firstArray, "Block not reused.");
+    VTKM_TEST_ASSERT(storage.GetNumberOfValues() == ARRAY_SIZE - 1, "Bad array size.");
+    VTKM_TEST_ASSERT(!storage.GetAllocationIsFresh(), "Reused block reported fresh.");
+  }
+
+  {
+    vtkm::cont::ArrayHandle<vtkm::Float64> handle;
+    handle.Allocate(ARRAY_SIZE);
+    VTKM_TEST_ASSERT(handle.GetStorage().GetArray() == firstArray, "Block not reused.");
+    handle.ReleaseResources();
+  }
+
+  vtkm::cont::StorageBasicMemoryPoolStatistics stats = Pool::GetStatistics();
+  VTKM_TEST_ASSERT(stats.NumberOfAllocations == 3, "Bad allocation count.");
+  VTKM_TEST_ASSERT(stats.NumberOfReuses == 2, "Bad reuse count.");
+  VTKM_TEST_ASSERT(stats.PeakBytes == blockSize, "Bad peak.");
+
+  Pool::Trim();
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesCached == 0, "Pool not trimmed.");
+}
+
+void TestSteal()
+{
+  std::cout << "Testing steal" << std::endl;
+  Pool::Trim();
+
+  StorageType storage;
+  storage.Allocate(ARRAY_SIZE);
+  vtkm::Float64* stolen = storage.StealArray();
+  storage.ReleaseResources();
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesInUse == 0, "Stolen block still tracked.");
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesCached == 0, "Stolen block cached.");
+
+  StorageType::AllocatorType allocator;
+  allocator.deallocate(stolen, static_cast<std::size_t>(ARRAY_SIZE));
+}
+
+void TestMaximumCachedBytes()
+{
+  std::cout << "Testing maximum cached bytes" << std::endl;
+  Pool::Trim();
+
+  const vtkm::UInt64 smallBlock =
+    Pool::GetBlockSize(static_cast<vtkm::UInt64>(ARRAY_SIZE) * sizeof(vtkm::Float64));
+  const vtkm::UInt64 largeBlock =
+    Pool::GetBlockSize(static_cast<vtkm::UInt64>(4 * ARRAY_SIZE) * sizeof(vtkm::Float64));
+  Pool::SetMaximumCachedBytes(largeBlock + smallBlock);
+
+  {
+    StorageType small1;
+    StorageType small2;
+    StorageType large;
+    small1.Allocate(ARRAY_SIZE);
+    small2.Allocate(ARRAY_SIZE);
+    large.Allocate(4 * ARRAY_SIZE);
+    large.ReleaseResources();
+    small1.ReleaseResources();
+    VTKM_TEST_ASSERT(Pool::GetStatistics().BytesCached == largeBlock + smallBlock,
+                     "Blocks not cached.");
+  }
+  // Releasing the second small block goes over the bound, so the large block
+  // is evicted.
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesCached == 2 * smallBlock,
+                   "Largest block not evicted.");
+
+  Pool::SetMaximumCachedBytes(smallBlock);
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesCached == smallBlock, "Bound not applied.");
+
+  Pool::SetMaximumCachedBytes(Pool::GetDefaultMaximumCachedBytes());
+  Pool::Trim();
+}
+
+void TestOptOut()
+{
+  std::cout << "Testing opt out" << std::endl;
+  Pool::Trim();
+  Pool::ResetStatistics();
+
+  StorageType storage;
+  storage.SetUseMemoryPool(false);
+  VTKM_TEST_ASSERT(!storage.GetUseMemoryPool(), "Opt out not set.");
+  storage.Allocate(ARRAY_SIZE);
+  VTKM_TEST_ASSERT(Pool::GetStatistics().NumberOfAllocations == 0, "Pool used after opt out.");
+  storage.ReleaseResources();
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesCached == 0, "Opted out block cached.");
+
+  std::cout << "Testing disabled pool" << std::endl;
+  StorageType pooled;
+  pooled.Allocate(ARRAY_SIZE);
+  Pool::SetEnabled(false);
+  VTKM_TEST_ASSERT(!Pool::GetEnabled(), "Pool not disabled.");
+
+  // A block allocated before disabling is returned to the system.
+  pooled.ReleaseResources();
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesCached == 0, "Block cached by disabled pool.");
+
+  pooled.Allocate(ARRAY_SIZE);
+  VTKM_TEST_ASSERT(Pool::GetStatistics().NumberOfAllocations == 1, "Disabled pool used.");
+  pooled.ReleaseResources();
+  VTKM_TEST_ASSERT(Pool::GetStatistics().BytesCached == 0, "Block cached by disabled pool.");
+
+  Pool::SetEnabled(true);
+}
+
+void TestStorageBasicMemoryPool()
+{
+  TestBlockSizes();
+  TestReuse();
+  TestSteal();
+  TestMaximumCachedBytes();
+  TestOptOut();
+}
+
+} // anonymous namespace
+
+int UnitTestStorageBasicMemoryPool(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestStorageBasicMemoryPool);
+}
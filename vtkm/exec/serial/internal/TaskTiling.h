@@ -212,11 +212,16 @@ public:
     this->ExecuteFunction(this->Worklet, this->Invocation, this->GlobalIndexOffset, start, end);
   }
 
+  using ExecuteSignature = void (*)(void*, void* const, vtkm::Id, vtkm::Id, vtkm::Id);
+
+  /// The function executing the worklet. It is unique to the worklet and
+  /// invocation types, so it identifies which kind of work a task does.
+  ExecuteSignature GetExecuteFunction() const { return this->ExecuteFunction; }
+
 protected:
   void* Worklet;
   void* Invocation;
 
-  using ExecuteSignature = void (*)(void*, void* const, vtkm::Id, vtkm::Id, vtkm::Id);
   ExecuteSignature ExecuteFunction;
 
   using SetErrorBufferSignature = void (*)(void*, const vtkm::exec::internal::ErrorMessageBuffer&);
@@ -67,6 +67,13 @@ public:
   VTKM_CONT
   const vtkm::cont::RuntimeDeviceTracker& GetRuntimeDeviceTracker() const { return this->Tracker; }
 
+  /// See \c FilterField::SetRunBlocksConcurrently.
+  VTKM_CONT
+  void SetRunBlocksConcurrently(bool concurrent) { this->RunBlocksConcurrently = concurrent; }
+
+  VTKM_CONT
+  bool GetRunBlocksConcurrently() const { return this->RunBlocksConcurrently; }
+
   VTKM_CONT
   Result Execute(const vtkm::cont::DataSet& input, const std::string& inFieldName);
 
@@ -131,6 +138,7 @@ private:
   vtkm::Id CellSetIndex;
   vtkm::Id CoordinateSystemIndex;
   vtkm::cont::RuntimeDeviceTracker Tracker;
+  bool RunBlocksConcurrently;
 };
 }
 } // namespace vtkm::filter
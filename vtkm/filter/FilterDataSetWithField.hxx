@@ -22,6 +22,7 @@
 #include <vtkm/filter/FilterTraits.h>
 #include <vtkm/filter/PolicyDefault.h>
 
+#include <vtkm/filter/internal/ExecuteMultiBlock.h>
 #include <vtkm/filter/internal/ResolveFieldTypeAndExecute.h>
 #include <vtkm/filter/internal/ResolveFieldTypeAndMap.h>
 
@@ -44,6 +45,7 @@ inline VTKM_CONT FilterDataSetWithField<Derived>::FilterDataSetWithField()
   , CellSetIndex(0)
   , CoordinateSystemIndex(0)
   , Tracker(vtkm::cont::GetGlobalRuntimeDeviceTracker())
+  , RunBlocksConcurrently(false)
 {
 }
 
@@ -84,16 +86,7 @@ inline VTKM_CONT std::vector<vtkm::filter::Result> FilterDataSetWithField<Derive
   const vtkm::cont::MultiBlock& input,
   const std::string& inFieldName)
 {
-  std::vector<vtkm::filter::Result> results;
-
-  for (vtkm::Id j = 0; j < input.GetNumberOfBlocks(); j++)
-  {
-    vtkm::filter::Result result = this->Execute(
-      input.GetBlock(j), input.GetBlock(j).GetField(inFieldName), vtkm::filter::PolicyDefault());
-    results.push_back(result);
-  }
-
-  return results;
+  return this->Execute(input, inFieldName, vtkm::filter::PolicyDefault());
 }
 //-----------------------------------------------------------------------------
 template <typename Derived>
@@ -103,16 +96,19 @@ inline VTKM_CONT std::vector<vtkm::filter::Result> FilterDataSetWithField<Derive
   const std::string& inFieldName,
   const vtkm::filter::PolicyBase<DerivedPolicy>& policy)
 {
-  std::vector<vtkm::filter::Result> results;
-
-  for (vtkm::Id j = 0; j < input.GetNumberOfBlocks(); j++)
-  {
-    vtkm::filter::Result result =
-      this->Execute(input.GetBlock(j), input.GetBlock(j).GetField(inFieldName), policy);
-    results.push_back(result);
-  }
-
-  return results;
+  const bool concurrent = this->RunBlocksConcurrently;
+  Derived* self = static_cast<Derived*>(this);
+  return vtkm::filter::internal::ExecuteMultiBlock(
+    input, concurrent, [&](vtkm::Id j) -> vtkm::filter::Result {
+      const vtkm::cont::DataSet& block = input.GetBlock(j);
+      if (concurrent)
+      {
+        Derived filter(*self);
+        return static_cast<FilterDataSetWithField<Derived>&>(filter).Execute(
+          block, block.GetField(inFieldName), policy);
+      }
+      return this->Execute(block, block.GetField(inFieldName), policy);
+    });
 }
 
 //-----------------------------------------------------------------------------
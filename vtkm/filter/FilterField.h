@@ -60,6 +60,24 @@ public:
   VTKM_CONT
   const vtkm::cont::RuntimeDeviceTracker& GetRuntimeDeviceTracker() const { return this->Tracker; }
 
+  /// When enabled, the blocks of a \c MultiBlock are executed concurrently,
+  /// each by its own copy of this filter, and the results are returned in
+  /// block order. This helps inputs with many small blocks, whose worklets
+  /// are too small to use all the cores. This filter is left unchanged by the
+  /// execution, so state needed to map fields afterwards is not kept.
+  /// Disabled by default.
+  ///
+  /// \c ArrayHandle is not thread safe, so blocks must not share arrays. The
+  /// blocks run serially when they share a field, coordinate system or cell
+  /// set object, for example when the same data set is added twice. Arrays
+  /// shared in other ways, such as one \c ArrayHandle wrapped in the fields
+  /// of two blocks, are not detected and must not be used concurrently.
+  VTKM_CONT
+  void SetRunBlocksConcurrently(bool concurrent) { this->RunBlocksConcurrently = concurrent; }
+
+  VTKM_CONT
+  bool GetRunBlocksConcurrently() const { return this->RunBlocksConcurrently; }
+
   VTKM_CONT
   Result Execute(const vtkm::cont::DataSet& input, const std::string& inFieldName);
 
@@ -107,6 +125,7 @@ private:
 
   std::string OutputFieldName;
   vtkm::cont::RuntimeDeviceTracker Tracker;
+  bool RunBlocksConcurrently;
 };
 }
 } // namespace vtkm::filter
@@ -44,6 +44,16 @@ public:
   VTKM_CONT
   vtkm::Id GetNumberOfBins() const { return this->NumberOfBins; }
 
+  //Sets the range of values to bin, for when it is already known (for
+  //example the cached range of the field) so that it is not computed
+  //again. Values outside of the range are counted in the first or last
+  //bin. An empty range, the default, computes the range of the field.
+  VTKM_CONT
+  void SetRange(const vtkm::Range& range) { this->Range = range; }
+
+  VTKM_CONT
+  const vtkm::Range& GetRange() const { return this->Range; }
+
   //Returns the bin delta of the last computed field, be it from DoExecute
   //or from MapField
   VTKM_CONT
@@ -64,6 +74,7 @@ private:
   vtkm::Id NumberOfBins;
   vtkm::Float64 BinDelta;
   vtkm::Range DataRange;
+  vtkm::Range Range;
 };
 
 template <>
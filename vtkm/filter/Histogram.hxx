@@ -31,6 +31,7 @@ inline VTKM_CONT Histogram::Histogram()
   : NumberOfBins(10)
   , BinDelta(0)
   , DataRange()
+  , Range()
 {
   this->SetOutputFieldName("histogram");
 }
@@ -48,7 +49,21 @@ inline VTKM_CONT vtkm::filter::Result Histogram::DoExecute(
   T delta;
 
   vtkm::worklet::FieldHistogram worklet;
-  worklet.Run(field, this->NumberOfBins, this->DataRange, delta, binArray, device);
+  if (this->Range.IsNonEmpty())
+  {
+    worklet.Run(field,
+                this->NumberOfBins,
+                static_cast<T>(this->Range.Min),
+                static_cast<T>(this->Range.Max),
+                delta,
+                binArray,
+                device);
+    this->DataRange = this->Range;
+  }
+  else
+  {
+    worklet.Run(field, this->NumberOfBins, this->DataRange, delta, binArray, device);
+  }
 
   this->BinDelta = static_cast<vtkm::Float64>(delta);
   return vtkm::filter::Result(inDataSet,
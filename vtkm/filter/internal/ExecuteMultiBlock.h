@@ -0,0 +1,166 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_filter_internal_ExecuteMultiBlock_h
+#define vtk_m_filter_internal_ExecuteMultiBlock_h
+
+#include <vtkm/cont/MultiBlock.h>
+#include <vtkm/cont/tbb/DeviceAdapterTBB.h>
+
+#include <vtkm/filter/Result.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace internal
+{
+
+/// Returns whether two blocks of \c input share a field array, a coordinate
+/// system or a cell set, as they do when the same data set is added twice or
+/// when fields, coordinate systems or cell sets are copied between blocks.
+/// Arrays that are only shared within a block do not count.
+VTKM_CONT inline bool BlocksShareData(const vtkm::cont::MultiBlock& input)
+{
+  std::map<const void*, vtkm::Id> owners;
+  auto shared = [&owners](const void* data, vtkm::Id block) {
+    auto owner = owners.insert(std::make_pair(data, block)).first;
+    return owner->second != block;
+  };
+  auto arrayOf = [](const vtkm::cont::Field& field) -> const void* {
+    return vtkm::cont::detail::DynamicArrayHandleCopyHelper::GetArrayHandleContainer(
+             field.GetData())
+      .get();
+  };
+
+  for (vtkm::Id j = 0; j < input.GetNumberOfBlocks(); j++)
+  {
+    const vtkm::cont::DataSet& block = input.GetBlock(j);
+    for (vtkm::IdComponent i = 0; i < block.GetNumberOfFields(); i++)
+    {
+      if (shared(arrayOf(block.GetField(i)), j))
+      {
+        return true;
+      }
+    }
+    for (vtkm::IdComponent i = 0; i < block.GetNumberOfCoordinateSystems(); i++)
+    {
+      if (shared(arrayOf(block.GetCoordinateSystem(i)), j))
+      {
+        return true;
+      }
+    }
+    for (vtkm::IdComponent i = 0; i < block.GetNumberOfCellSets(); i++)
+    {
+      if (shared(&block.GetCellSet(i).CastToBase(), j))
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// Calls \c executeBlock(index) for each block of \c input and returns the
+/// results in block order. When \c concurrent is set the blocks are
+/// executed concurrently: as TBB tasks when TBB is enabled, so the worklets
+/// of each block can use the remaining cores, and otherwise on a pool of
+/// threads. The first exception thrown by a block is rethrown. Blocks
+/// executed concurrently must not share the filter, so each is given a copy.
+///
+/// \c ArrayHandle is not thread safe, so blocks that share data (see \c
+/// BlocksShareData) are executed serially.
+template <typename ExecuteBlockFunctor>
+VTKM_CONT std::vector<vtkm::filter::Result> ExecuteMultiBlock(
+  const vtkm::cont::MultiBlock& input,
+  bool concurrent,
+  const ExecuteBlockFunctor& executeBlock)
+{
+  const vtkm::Id numberOfBlocks = input.GetNumberOfBlocks();
+  std::vector<vtkm::filter::Result> results(static_cast<std::size_t>(numberOfBlocks));
+
+  if (!concurrent || (numberOfBlocks < 2) || BlocksShareData(input))
+  {
+    for (vtkm::Id j = 0; j < numberOfBlocks; j++)
+    {
+      results[static_cast<std::size_t>(j)] = executeBlock(j);
+    }
+    return results;
+  }
+
+#ifdef VTKM_ENABLE_TBB
+  ::tbb::parallel_for(vtkm::Id(0), numberOfBlocks, [&](vtkm::Id j) {
+    results[static_cast<std::size_t>(j)] = executeBlock(j);
+  });
+#else
+  std::atomic<vtkm::Id> nextBlock(0);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    for (vtkm::Id j = nextBlock++; j < numberOfBlocks; j = nextBlock++)
+    {
+      try
+      {
+        results[static_cast<std::size_t>(j)] = executeBlock(j);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+        {
+          error = std::current_exception();
+        }
+        nextBlock = numberOfBlocks;
+      }
+    }
+  };
+
+  const vtkm::Id numberOfThreads = std::min(
+    numberOfBlocks, static_cast<vtkm::Id>(std::max(1u, std::thread::hardware_concurrency())));
+  std::vector<std::thread> threads;
+  for (vtkm::Id i = 1; i < numberOfThreads; i++)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+#endif
+
+  return results;
+}
+}
+}
+} // namespace vtkm::filter::internal
+
+#endif //vtk_m_filter_internal_ExecuteMultiBlock_h
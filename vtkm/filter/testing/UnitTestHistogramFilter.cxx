@@ -314,6 +314,23 @@ void TestHistogram()
   range = histogram.GetDataRange();
   VerifyHistogram(result, histogram.GetNumberOfBins(), range, delta);
 
+  // Reusing the computed range gives the same bins
+  vtkm::cont::ArrayHandle<vtkm::Id> bins;
+  result.FieldAs(bins);
+  histogram.SetRange(range);
+  vtkm::filter::Result rangeResult = histogram.Execute(ds, "p_poisson");
+  VTKM_TEST_ASSERT(test_equal(histogram.GetBinDelta(), delta), "Wrong bin delta for given range");
+  VerifyHistogram(rangeResult, histogram.GetNumberOfBins(), range, delta);
+  vtkm::cont::ArrayHandle<vtkm::Id> rangeBins;
+  rangeResult.FieldAs(rangeBins);
+  for (vtkm::Id i = 0; i < histogram.GetNumberOfBins(); i++)
+  {
+    VTKM_TEST_ASSERT(rangeBins.GetPortalConstControl().Get(i) ==
+                       bins.GetPortalConstControl().Get(i),
+                     "Wrong bin count for given range");
+  }
+  histogram.SetRange(vtkm::Range());
+
   histogram.SetNumberOfBins(100);
   result = histogram.Execute(ds, "p_normal");
   delta = histogram.GetBinDelta();
@@ -34,6 +34,8 @@
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/filter/CellAverage.h>
 #include <vtkm/filter/Histogram.h>
+#include <vtkm/filter/Threshold.h>
+#include <vtkm/filter/internal/ExecuteMultiBlock.h>
 
 
 template <typename T>
@@ -131,6 +133,47 @@ void TestMultiBlockFilters()
 
   Result_Verify(results, cellAverage, Blocks, std::string("pointvar"));
 
+  std::cout << "Execute blocks concurrently" << std::endl;
+  Blocks = MultiBlockBuilder<vtkm::Float64>(BlockNum, "cellvar");
+  histogram.SetRunBlocksConcurrently(true);
+  results = histogram.Execute(Blocks, std::string("cellvar"));
+  Result_Verify(results, histogram, Blocks, std::string("cellvar"));
+
+  Blocks = MultiBlockBuilder<vtkm::Id>(BlockNum, "pointvar");
+  cellAverage.SetRunBlocksConcurrently(true);
+  results = cellAverage.Execute(Blocks, std::string("pointvar"));
+  Result_Verify(results, cellAverage, Blocks, std::string("pointvar"));
+
+  std::cout << "Execute a data set filter on blocks concurrently" << std::endl;
+  Blocks = MultiBlockBuilder<vtkm::Float64>(BlockNum, "cellvar");
+  vtkm::filter::Threshold threshold;
+  threshold.SetLowerThreshold(20);
+  threshold.SetUpperThreshold(400);
+  threshold.SetRunBlocksConcurrently(true);
+  results = threshold.Execute(Blocks, std::string("cellvar"));
+  VTKM_TEST_ASSERT(results.size() == BlockNum, "result block number incorrect");
+  for (vtkm::Id j = 0; j < Blocks.GetNumberOfBlocks(); j++)
+  {
+    const vtkm::cont::DataSet& output = results[static_cast<std::size_t>(j)].GetDataSet();
+    vtkm::filter::Result blockResult = threshold.Execute(Blocks.GetBlock(j), "cellvar");
+    VTKM_TEST_ASSERT(output.GetCellSet().GetNumberOfCells() ==
+                       blockResult.GetDataSet().GetCellSet().GetNumberOfCells(),
+                     "threshold result incorrect");
+  }
+
+  std::cout << "Execute blocks that share data" << std::endl;
+  Blocks = MultiBlockBuilder<vtkm::Float64>(BlockNum, "cellvar");
+  VTKM_TEST_ASSERT(!vtkm::filter::internal::BlocksShareData(Blocks), "Blocks do not share data");
+  vtkm::cont::DataSet sharedBlock = Blocks.GetBlock(0);
+  vtkm::cont::MultiBlock sharedBlocks;
+  for (std::size_t i = 0; i < BlockNum; i++)
+  {
+    sharedBlocks.AddBlock(sharedBlock);
+  }
+  VTKM_TEST_ASSERT(vtkm::filter::internal::BlocksShareData(sharedBlocks), "Blocks share data");
+  results = histogram.Execute(sharedBlocks, std::string("cellvar"));
+  Result_Verify(results, histogram, sharedBlocks, std::string("cellvar"));
+
   return;
 }
 
@@ -40,24 +40,22 @@ inline bool IsLittleEndian()
 }
 
 template <typename T>
-inline void FlipEndianness(std::vector<T>& buffer)
+inline void FlipEndianness(T* buffer, std::size_t numValues)
 {
-  vtkm::UInt8* bytes = reinterpret_cast<vtkm::UInt8*>(&buffer[0]);
+  vtkm::UInt8* bytes = reinterpret_cast<vtkm::UInt8*>(buffer);
   const std::size_t tsize = sizeof(T);
-  const std::size_t bsize = buffer.size();
-  for (std::size_t i = 0; i < bsize; i++, bytes += tsize)
+  for (std::size_t i = 0; i < numValues; i++, bytes += tsize)
   {
     std::reverse(bytes, bytes + tsize);
   }
 }
 
 template <typename T, vtkm::IdComponent N>
-inline void FlipEndianness(std::vector<vtkm::Vec<T, N>>& buffer)
+inline void FlipEndianness(vtkm::Vec<T, N>* buffer, std::size_t numValues)
 {
-  vtkm::UInt8* bytes = reinterpret_cast<vtkm::UInt8*>(&buffer[0]);
+  vtkm::UInt8* bytes = reinterpret_cast<vtkm::UInt8*>(buffer);
   const std::size_t tsize = sizeof(T);
-  const std::size_t bsize = buffer.size();
-  for (std::size_t i = 0; i < bsize; i++)
+  for (std::size_t i = 0; i < numValues; i++)
   {
     for (vtkm::IdComponent j = 0; j < N; j++, bytes += tsize)
     {
@@ -65,6 +63,12 @@ inline void FlipEndianness(std::vector<vtkm::Vec<T, N>>& buffer)
     }
   }
 }
+
+template <typename T>
+inline void FlipEndianness(std::vector<T>& buffer)
+{
+  FlipEndianness(&buffer[0], buffer.size());
+}
 }
 }
 } // vtkm::io::internal
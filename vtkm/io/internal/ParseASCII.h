@@ -0,0 +1,428 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_io_internal_ParseASCII_h
+#define vtk_m_io_internal_ParseASCII_h
+
+#include <vtkm/Types.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/serial/DeviceAdapterSerial.h>
+#include <vtkm/cont/tbb/DeviceAdapterTBB.h>
+#include <vtkm/exec/FunctorBase.h>
+#include <vtkm/io/ErrorIO.h>
+#include <vtkm/io/internal/VTKDataSetTypes.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#include <locale.h>
+#elif defined(VTKM_POSIX)
+#include <locale.h>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+#else
+#include <locale>
+#include <sstream>
+#endif
+
+namespace vtkm
+{
+namespace io
+{
+namespace internal
+{
+
+// ASCII data sections are parsed on the host, in parallel when TBB is available.
+#ifdef VTKM_ENABLE_TBB
+using ParseASCIIDeviceAdapterTag = vtkm::cont::DeviceAdapterTagTBB;
+#else
+using ParseASCIIDeviceAdapterTag = vtkm::cont::DeviceAdapterTagSerial;
+#endif
+
+// The number of values parsed by each parallel task.
+static const std::size_t PARSE_ASCII_CHUNK_SIZE = std::size_t(1) << 14;
+
+// The number of bytes searched for tokens by each parallel task.
+static const std::size_t FIND_ASCII_CHUNK_BYTES = std::size_t(1) << 16;
+
+inline bool IsSpace(char c)
+{
+  return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') || (c == '\v') || (c == '\f');
+}
+
+// Parses an integer without going through the locale. Returns false when the
+// token is not an integer.
+template <typename T>
+inline bool ParseASCIIValue(const char*& pos, const char* end, T& value, std::true_type)
+{
+  bool negative = false;
+  if ((pos != end) && ((*pos == '-') || (*pos == '+')))
+  {
+    negative = (*pos == '-');
+    ++pos;
+  }
+  const char* digits = pos;
+  vtkm::UInt64 magnitude = 0;
+  while ((pos != end) && (*pos >= '0') && (*pos <= '9'))
+  {
+    magnitude = magnitude * 10 + static_cast<vtkm::UInt64>(*pos - '0');
+    ++pos;
+  }
+  if (pos == digits)
+  {
+    return false;
+  }
+  value = negative ? static_cast<T>(0 - magnitude) : static_cast<T>(magnitude);
+  return true;
+}
+
+// Floating point values are converted with the "C" locale rather than the
+// global one, which may use a decimal comma. The conversions are correctly
+// rounded. The data passed to the parser always ends in whitespace or a null
+// character, so a conversion stops within the token.
+#if defined(_WIN32)
+inline _locale_t GetParseASCIILocale()
+{
+  static _locale_t locale = _create_locale(LC_NUMERIC, "C");
+  return locale;
+}
+
+inline void ParseASCIIFloat(const char* pos, char** next, vtkm::Float32& value)
+{
+  value = _strtof_l(pos, next, GetParseASCIILocale());
+}
+
+inline void ParseASCIIFloat(const char* pos, char** next, vtkm::Float64& value)
+{
+  value = _strtod_l(pos, next, GetParseASCIILocale());
+}
+#elif defined(VTKM_POSIX)
+inline locale_t GetParseASCIILocale()
+{
+  static locale_t locale = newlocale(LC_NUMERIC_MASK, "C", static_cast<locale_t>(0));
+  return locale;
+}
+
+inline void ParseASCIIFloat(const char* pos, char** next, vtkm::Float32& value)
+{
+  value = strtof_l(pos, next, GetParseASCIILocale());
+}
+
+inline void ParseASCIIFloat(const char* pos, char** next, vtkm::Float64& value)
+{
+  value = strtod_l(pos, next, GetParseASCIILocale());
+}
+#else
+template <typename T>
+inline void ParseASCIIFloat(const char* pos, char** next, T& value)
+{
+  const char* end = pos;
+  while ((*end != '\0') && !IsSpace(*end))
+  {
+    ++end;
+  }
+  std::istringstream stream(std::string(pos, end));
+  stream.imbue(std::locale::classic());
+  stream >> value;
+  *next = const_cast<char*>((stream.fail() || !stream.eof()) ? pos : end);
+}
+#endif
+
+template <typename T>
+inline bool ParseASCIIValue(const char*& pos, const char*, T& value, std::false_type)
+{
+  char* next;
+  ParseASCIIFloat(pos, &next, value);
+  if (next == pos)
+  {
+    return false;
+  }
+  pos = next;
+  return true;
+}
+
+template <typename ComponentType>
+struct ParseASCIIFunctor : public vtkm::exec::FunctorBase
+{
+  using IOType = typename StreamIOType<ComponentType>::Type;
+
+  const char* Data;
+  const std::size_t* ChunkBegins;
+  std::size_t NumberOfValues;
+  ComponentType* Output;
+  char* Failed;
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT
+  void operator()(vtkm::Id chunk) const
+  {
+    const std::size_t chunkIndex = static_cast<std::size_t>(chunk);
+    const char* pos = this->Data + this->ChunkBegins[chunkIndex];
+    const char* end = this->Data + this->ChunkBegins[chunkIndex + 1];
+    const std::size_t first = chunkIndex * PARSE_ASCII_CHUNK_SIZE;
+    const std::size_t last = (first + PARSE_ASCII_CHUNK_SIZE < this->NumberOfValues)
+      ? first + PARSE_ASCII_CHUNK_SIZE
+      : this->NumberOfValues;
+
+    for (std::size_t i = first; i < last; ++i)
+    {
+      while ((pos != end) && IsSpace(*pos))
+      {
+        ++pos;
+      }
+      IOType value = IOType();
+      if (!ParseASCIIValue(pos, end, value, typename std::is_integral<IOType>::type()) ||
+          ((pos != end) && !IsSpace(*pos)))
+      {
+        this->Failed[chunkIndex] = 1;
+        return;
+      }
+      this->Output[i] = static_cast<ComponentType>(value);
+    }
+  }
+};
+
+// Counts the tokens that start in each byte chunk of [Begin, End). A token
+// starts at a character that is not whitespace and follows whitespace or
+// Begin, so tokens cut by a chunk boundary are counted once.
+struct CountASCIITokensFunctor : public vtkm::exec::FunctorBase
+{
+  const char* Data;
+  std::size_t Begin;
+  std::size_t End;
+  std::size_t* Counts;
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT
+  void operator()(vtkm::Id chunk) const
+  {
+    const std::size_t chunkBegin =
+      this->Begin + static_cast<std::size_t>(chunk) * FIND_ASCII_CHUNK_BYTES;
+    const std::size_t chunkEnd = std::min(chunkBegin + FIND_ASCII_CHUNK_BYTES, this->End);
+    bool previousIsSpace = (chunkBegin == this->Begin) || IsSpace(this->Data[chunkBegin - 1]);
+    std::size_t count = 0;
+    for (std::size_t i = chunkBegin; i < chunkEnd; ++i)
+    {
+      const bool isSpace = IsSpace(this->Data[i]);
+      count += (previousIsSpace && !isSpace) ? 1 : 0;
+      previousIsSpace = isSpace;
+    }
+    this->Counts[static_cast<std::size_t>(chunk)] = count;
+  }
+};
+
+// Records the start of every PARSE_ASCII_CHUNK_SIZE th token of each byte
+// chunk, given the index of the first token of the chunk in FirstTokens.
+struct FindASCIITokensFunctor : public vtkm::exec::FunctorBase
+{
+  const char* Data;
+  std::size_t Begin;
+  std::size_t End;
+  const std::size_t* FirstTokens;
+  std::size_t NumberOfTokens;
+  std::size_t* ChunkBegins;
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT
+  void operator()(vtkm::Id chunk) const
+  {
+    const std::size_t chunkBegin =
+      this->Begin + static_cast<std::size_t>(chunk) * FIND_ASCII_CHUNK_BYTES;
+    const std::size_t chunkEnd = std::min(chunkBegin + FIND_ASCII_CHUNK_BYTES, this->End);
+    bool previousIsSpace = (chunkBegin == this->Begin) || IsSpace(this->Data[chunkBegin - 1]);
+    std::size_t token = this->FirstTokens[static_cast<std::size_t>(chunk)];
+    for (std::size_t i = chunkBegin; (i < chunkEnd) && (token < this->NumberOfTokens); ++i)
+    {
+      const bool isSpace = IsSpace(this->Data[i]);
+      if (previousIsSpace && !isSpace)
+      {
+        if ((token % PARSE_ASCII_CHUNK_SIZE) == 0)
+        {
+          this->ChunkBegins[token / PARSE_ASCII_CHUNK_SIZE] = i;
+        }
+        ++token;
+      }
+      previousIsSpace = isSpace;
+    }
+  }
+};
+
+/// Finds the end of the \c numberOfTokens whitespace separated tokens that
+/// start at \c offset in \c data. \c chunkBegins is filled with the offset of
+/// every \c PARSE_ASCII_CHUNK_SIZE th token, followed by the end offset, which
+/// is also returned.
+///
+/// The bytes are searched in windows, each split into chunks whose tokens
+/// are counted in parallel. A scan of the counts gives the index of the first
+/// token of each chunk, and a second parallel pass records the chunk begins.
+/// The first window is sized from an estimate of the token length and later
+/// ones from the length measured so far, so the data after the tokens is
+/// rarely searched.
+///
+inline std::size_t FindASCIITokens(const std::string& data,
+                                   std::size_t offset,
+                                   std::size_t numberOfTokens,
+                                   std::vector<std::size_t>& chunkBegins)
+{
+  using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<ParseASCIIDeviceAdapterTag>;
+
+  chunkBegins.assign((numberOfTokens + PARSE_ASCII_CHUNK_SIZE - 1) / PARSE_ASCII_CHUNK_SIZE, 0);
+  if (numberOfTokens == 0)
+  {
+    chunkBegins.push_back(offset);
+    return offset;
+  }
+
+  const char* begin = data.c_str();
+  std::size_t windowBegin = offset;
+  std::size_t tokensFound = 0;
+  std::vector<std::size_t> counts;
+  for (;;)
+  {
+    if (windowBegin == data.size())
+    {
+      throw vtkm::io::ErrorIO("Unexpected end of file");
+    }
+
+    // Estimate 8 bytes per token until some have been measured. Windows end
+    // at whitespace so that no token spans two windows.
+    const std::size_t bytesPerToken =
+      (tokensFound == 0) ? 8 : ((windowBegin - offset) / tokensFound + 1);
+    const std::size_t windowBytes =
+      (numberOfTokens - tokensFound) * bytesPerToken + FIND_ASCII_CHUNK_BYTES;
+    std::size_t windowEnd = std::min(windowBegin + windowBytes, data.size());
+    while ((windowEnd != data.size()) && !IsSpace(begin[windowEnd]))
+    {
+      ++windowEnd;
+    }
+
+    const std::size_t numberOfChunks =
+      (windowEnd - windowBegin + FIND_ASCII_CHUNK_BYTES - 1) / FIND_ASCII_CHUNK_BYTES;
+    counts.resize(numberOfChunks);
+    CountASCIITokensFunctor count;
+    count.Data = begin;
+    count.Begin = windowBegin;
+    count.End = windowEnd;
+    count.Counts = &counts[0];
+    Algorithm::Schedule(count, static_cast<vtkm::Id>(numberOfChunks));
+
+    // Turn the counts into the index of the first token of each chunk.
+    std::size_t lastChunk = numberOfChunks;
+    std::size_t lastChunkFirstToken = 0;
+    for (std::size_t chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      const std::size_t chunkCount = counts[chunk];
+      counts[chunk] = tokensFound;
+      if ((lastChunk == numberOfChunks) && (tokensFound + chunkCount >= numberOfTokens))
+      {
+        lastChunk = chunk;
+        lastChunkFirstToken = tokensFound;
+      }
+      tokensFound += chunkCount;
+    }
+
+    FindASCIITokensFunctor find;
+    find.Data = begin;
+    find.Begin = windowBegin;
+    find.End = windowEnd;
+    find.FirstTokens = &counts[0];
+    find.NumberOfTokens = numberOfTokens;
+    find.ChunkBegins = &chunkBegins[0];
+    Algorithm::Schedule(find, static_cast<vtkm::Id>(std::min(lastChunk + 1, numberOfChunks)));
+
+    if (lastChunk != numberOfChunks)
+    {
+      // Walk the chunk holding the last token to the end of that token.
+      std::size_t pos = windowBegin + lastChunk * FIND_ASCII_CHUNK_BYTES;
+      bool previousIsSpace = (pos == windowBegin) || IsSpace(begin[pos - 1]);
+      std::size_t token = lastChunkFirstToken;
+      for (;; ++pos)
+      {
+        const bool isSpace = IsSpace(begin[pos]);
+        if (previousIsSpace && !isSpace)
+        {
+          ++token;
+        }
+        if ((token == numberOfTokens) && !isSpace)
+        {
+          break;
+        }
+        previousIsSpace = isSpace;
+      }
+      while ((pos != data.size()) && !IsSpace(begin[pos]))
+      {
+        ++pos;
+      }
+      chunkBegins.push_back(pos);
+      return pos;
+    }
+    windowBegin = windowEnd;
+  }
+}
+
+/// \brief Parses \c numberOfValues whitespace separated numbers.
+///
+/// The numbers start at \c offset in \c data, which is moved past the last
+/// one. The token boundaries of each chunk of values are found in parallel
+/// (see \c FindASCIITokens), then the chunks are converted in parallel.
+/// Throws \c ErrorIO when a token is not a number of the expected kind.
+///
+template <typename ComponentType>
+inline void ParseASCII(const std::string& data,
+                       std::size_t& offset,
+                       ComponentType* output,
+                       std::size_t numberOfValues)
+{
+  std::vector<std::size_t> chunkBegins;
+  offset = FindASCIITokens(data, offset, numberOfValues, chunkBegins);
+  if (numberOfValues == 0)
+  {
+    return;
+  }
+
+  const std::size_t numberOfChunks = chunkBegins.size() - 1;
+  std::vector<char> failed(numberOfChunks, 0);
+
+  ParseASCIIFunctor<ComponentType> functor;
+  functor.Data = data.c_str();
+  functor.ChunkBegins = &chunkBegins[0];
+  functor.NumberOfValues = numberOfValues;
+  functor.Output = output;
+  functor.Failed = &failed[0];
+  vtkm::cont::DeviceAdapterAlgorithm<ParseASCIIDeviceAdapterTag>::Schedule(
+    functor, static_cast<vtkm::Id>(numberOfChunks));
+
+  for (char chunkFailed : failed)
+  {
+    if (chunkFailed)
+    {
+      throw vtkm::io::ErrorIO("Parse Error");
+    }
+  }
+}
+}
+}
+} // vtkm::io::internal
+
+#endif //vtk_m_io_internal_ParseASCII_h
@@ -113,6 +113,23 @@ inline std::istream& operator>>(std::istream& in, ColorChannel8& val)
   return in;
 }
 
+// Characters are read and written as numbers rather than as text.
+template <typename T>
+struct StreamIOType
+{
+  using Type = T;
+};
+template <>
+struct StreamIOType<vtkm::Int8>
+{
+  using Type = vtkm::Int16;
+};
+template <>
+struct StreamIOType<vtkm::UInt8>
+{
+  using Type = vtkm::UInt16;
+};
+
 template <typename T>
 struct DataTypeName
 {
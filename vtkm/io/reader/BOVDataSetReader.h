@@ -21,6 +21,7 @@
 #define vtk_m_io_reader_BOVDataSetReader_h
 
 #include <fstream>
+#include <vtkm/cont/ArrayHandleMemoryMapped.h>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/DataSetBuilderUniform.h>
 #include <vtkm/cont/DataSetFieldAdd.h>
@@ -39,16 +40,26 @@ public:
   BOVDataSetReader(const char* fileName)
     : FileName(fileName)
     , Loaded(false)
+    , UseMemoryMapping(false)
     , DataSet()
   {
   }
   BOVDataSetReader(const std::string& fileName)
     : FileName(fileName)
     , Loaded(false)
+    , UseMemoryMapping(false)
     , DataSet()
   {
   }
 
+  /// When enabled, the variable is not read but mapped from the data file as
+  /// an \c ArrayHandleMemoryMapped, so only the pages touched are loaded and
+  /// no copy is made. The field then has \c StorageTagMemoryMapped storage,
+  /// and filters applied to it need a policy whose storage list includes that
+  /// tag. Disabled by default.
+  void SetUseMemoryMapping(bool useMemoryMapping) { this->UseMemoryMapping = useMemoryMapping; }
+  bool GetUseMemoryMapping() const { return this->UseMemoryMapping; }
+
   const vtkm::cont::DataSet& ReadDataSet()
   {
     try
@@ -197,7 +208,6 @@ private:
 */
 
     vtkm::cont::DataSetBuilderUniform dataSetBuilder;
-    vtkm::cont::DataSetFieldAdd dsf;
     this->DataSet = dataSetBuilder.Create(dim, origin, spacing);
 
     vtkm::Id numTuples = dim[0] * dim[1] * dim[2];
@@ -205,30 +215,22 @@ private:
     {
       if (dataFormat == FloatData)
       {
-        vtkm::cont::ArrayHandle<vtkm::Float32> var;
-        ReadScalar(fullPathDataFile, numTuples, var);
-        dsf.AddPointField(this->DataSet, variableName, var);
+        this->AddField<vtkm::Float32>(fullPathDataFile, numTuples, variableName);
       }
       else if (dataFormat == DoubleData)
       {
-        vtkm::cont::ArrayHandle<vtkm::Float64> var;
-        ReadScalar(fullPathDataFile, numTuples, var);
-        dsf.AddPointField(this->DataSet, variableName, var);
+        this->AddField<vtkm::Float64>(fullPathDataFile, numTuples, variableName);
       }
     }
     else if (numComponents == 3)
     {
       if (dataFormat == FloatData)
       {
-        vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 3>> var;
-        ReadVector(fullPathDataFile, numTuples, var);
-        dsf.AddPointField(this->DataSet, variableName, var);
+        this->AddField<vtkm::Vec<vtkm::Float32, 3>>(fullPathDataFile, numTuples, variableName);
       }
       else if (dataFormat == DoubleData)
       {
-        vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 3>> var;
-        ReadVector(fullPathDataFile, numTuples, var);
-        dsf.AddPointField(this->DataSet, variableName, var);
+        this->AddField<vtkm::Vec<vtkm::Float64, 3>>(fullPathDataFile, numTuples, variableName);
       }
     }
 
@@ -236,52 +238,46 @@ private:
   }
 
   template <typename T>
-  void ReadBuffer(const std::string& fName, const vtkm::Id& sz, std::vector<T>& buff)
+  void AddField(const std::string& fName, vtkm::Id nTuples, const std::string& variableName)
+  {
+    if (this->UseMemoryMapping)
+    {
+      try
+      {
+        vtkm::cont::ArrayHandleMemoryMapped<T> var(fName, 0, nTuples);
+        vtkm::cont::DataSetFieldAdd::AddPointField(this->DataSet, variableName, var);
+      }
+      catch (vtkm::cont::ErrorBadValue& error)
+      {
+        throw vtkm::io::ErrorIO(error.GetMessage());
+      }
+    }
+    else
+    {
+      vtkm::cont::ArrayHandle<T> var;
+      ReadBuffer(fName, nTuples, var);
+      vtkm::cont::DataSetFieldAdd::AddPointField(this->DataSet, variableName, var);
+    }
+  }
+
+  // Reads the values directly into the array, without an intermediate copy.
+  template <typename T>
+  void ReadBuffer(const std::string& fName, const vtkm::Id& sz, vtkm::cont::ArrayHandle<T>& var)
   {
     FILE* fp = fopen(fName.c_str(), "rb");
     size_t readSize = static_cast<size_t>(sz);
     if (fp == nullptr)
       throw vtkm::io::ErrorIO("Unable to open data file: " + fName);
-    buff.resize(readSize);
-    size_t nread = fread(&buff[0], sizeof(T), readSize, fp);
+    var.Allocate(sz);
+    size_t nread = fread(var.GetStorage().GetArray(), sizeof(T), readSize, fp);
+    fclose(fp);
     if (nread != readSize)
       throw vtkm::io::ErrorIO("Data file read failed: " + fName);
-    fclose(fp);
-  }
-
-  template <typename T>
-  void ReadScalar(const std::string& fName,
-                  const vtkm::Id& nTuples,
-                  vtkm::cont::ArrayHandle<T>& var)
-  {
-    std::vector<T> buff;
-    ReadBuffer(fName, nTuples, buff);
-    var.Allocate(nTuples);
-    for (vtkm::Id i = 0; i < nTuples; i++)
-      var.GetPortalControl().Set(i, buff[(size_t)i]);
-  }
-
-  template <typename T>
-  void ReadVector(const std::string& fName,
-                  const vtkm::Id& nTuples,
-                  vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>& var)
-  {
-    std::vector<T> buff;
-    ReadBuffer(fName, nTuples * 3, buff);
-
-    var.Allocate(nTuples);
-    vtkm::Vec<T, 3> v;
-    for (vtkm::Id i = 0; i < nTuples; i++)
-    {
-      v[0] = buff[static_cast<size_t>(i * 3 + 0)];
-      v[1] = buff[static_cast<size_t>(i * 3 + 1)];
-      v[2] = buff[static_cast<size_t>(i * 3 + 2)];
-      var.GetPortalControl().Set(i, v);
-    }
   }
 
   std::string FileName;
   bool Loaded;
+  bool UseMemoryMapping;
   vtkm::cont::DataSet DataSet;
 };
 }
@@ -21,6 +21,7 @@
 #define vtk_m_io_reader_VTKDataSetReaderBase_h
 
 #include <vtkm/io/internal/Endian.h>
+#include <vtkm/io/internal/ParseASCII.h>
 #include <vtkm/io/internal/VTKDataSetCells.h>
 #include <vtkm/io/internal/VTKDataSetStructures.h>
 #include <vtkm/io/internal/VTKDataSetTypes.h>
@@ -28,6 +29,7 @@
 #include <vtkm/Types.h>
 #include <vtkm/VecTraits.h>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleMemoryMapped.h>
 #include <vtkm/cont/ArrayPortalToIterators.h>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/DynamicArrayHandle.h>
@@ -36,7 +38,9 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace vtkm
@@ -57,6 +61,12 @@ struct VTKDataSetFile
   bool IsBinary;
   vtkm::io::internal::DataSetStructure Structure;
   std::ifstream Stream;
+  // The whole file, loaded when the first ASCII array is parsed.
+  std::string Contents;
+
+  bool UseMemoryMapping = false;
+  // Shared by all the arrays mapped from this file.
+  std::shared_ptr<vtkm::cont::internal::MemoryMappedFile> MappedFile;
 };
 
 inline void PrintVTKDataFileSummary(const VTKDataSetFile& df, std::ostream& out)
@@ -77,21 +87,7 @@ inline void parseAssert(bool condition)
   }
 }
 
-template <typename T>
-struct StreamIOType
-{
-  using Type = T;
-};
-template <>
-struct StreamIOType<vtkm::Int8>
-{
-  using Type = vtkm::Int16;
-};
-template <>
-struct StreamIOType<vtkm::UInt8>
-{
-  using Type = vtkm::UInt16;
-};
+using vtkm::io::internal::StreamIOType;
 
 // Since Fields and DataSets store data in the default DynamicArrayHandle, convert
 // the data to the closest type supported by default. The following will
@@ -178,6 +174,28 @@ struct ClosestFloat<vtkm::UInt64>
   using Type = vtkm::Float64;
 };
 
+// True when T is stored without conversion, so arrays of T can be read in place.
+template <typename T, vtkm::IdComponent NumComponents = vtkm::VecTraits<T>::NUM_COMPONENTS>
+struct IsClosestCommonType
+  : std::is_same<vtkm::Vec<typename ClosestFloat<typename vtkm::VecTraits<T>::ComponentType>::Type,
+                           3>,
+                 T>
+{
+};
+template <typename T>
+struct IsClosestCommonType<T, 1> : std::is_same<typename ClosestCommonType<T>::Type, T>
+{
+};
+template <>
+struct IsClosestCommonType<vtkm::io::internal::DummyBitType, 1> : std::false_type
+{
+};
+template <vtkm::IdComponent NumComponents>
+struct IsClosestCommonType<vtkm::Vec<vtkm::io::internal::DummyBitType, NumComponents>,
+                           NumComponents> : std::false_type
+{
+};
+
 template <typename T>
 vtkm::cont::DynamicArrayHandle CreateDynamicArrayHandle(const std::vector<T>& vec)
 {
@@ -315,6 +333,18 @@ public:
 
   const vtkm::cont::DataSet& GetDataSet() const { return this->DataSet; }
 
+  /// When enabled, binary point SCALARS and VECTORS that need no type
+  /// conversion are not read but mapped from the file as an \c
+  /// ArrayHandleMemoryMapped, which swaps the bytes as values are accessed.
+  /// Only the pages touched are loaded and no copy is made. Such fields have
+  /// \c StorageTagMemoryMapped storage, so filters applied to them need a
+  /// policy whose storage list includes that tag. Disabled by default.
+  void SetUseMemoryMapping(bool useMemoryMapping)
+  {
+    this->DataFile->UseMemoryMapping = useMemoryMapping;
+  }
+  bool GetUseMemoryMapping() const { return this->DataFile->UseMemoryMapping; }
+
   virtual void PrintSummary(std::ostream& out) const
   {
     out << "VTKDataSetReader" << std::endl;
@@ -419,7 +449,7 @@ protected:
         this->DataFile->Stream >> tag;
         if (tag == "SCALARS")
         {
-          this->ReadScalars(size, name, data);
+          this->ReadScalars(size, name, data, association == vtkm::cont::Field::ASSOC_POINTS);
         }
         else if (tag == "COLOR_SCALARS")
         {
@@ -431,7 +461,7 @@ protected:
         }
         else if (tag == "VECTORS" || tag == "NORMALS")
         {
-          this->ReadVectors(size, name, data);
+          this->ReadVectors(size, name, data, association == vtkm::cont::Field::ASSOC_POINTS);
         }
         else if (tag == "TEXTURE_COORDINATES")
         {
@@ -480,7 +510,11 @@ protected:
     this->DataFile.reset(nullptr);
   }
 
-  virtual void CloseFile() { this->DataFile->Stream.close(); }
+  virtual void CloseFile()
+  {
+    this->DataFile->Stream.close();
+    std::string().swap(this->DataFile->Contents);
+  }
 
 private:
   void OpenFile()
@@ -542,7 +576,8 @@ private:
 
   void ReadScalars(std::size_t numElements,
                    std::string& dataName,
-                   vtkm::cont::DynamicArrayHandle& data)
+                   vtkm::cont::DynamicArrayHandle& data,
+                   bool allowMapping = false)
   {
     std::string dataType, lookupTableName;
     vtkm::IdComponent numComponents = 1;
@@ -565,7 +600,7 @@ private:
     internal::parseAssert(tag == "LOOKUP_TABLE");
     this->DataFile->Stream >> lookupTableName >> std::ws;
 
-    this->DoReadDynamicArray(dataType, numElements, numComponents, data);
+    this->DoReadDynamicArray(dataType, numElements, numComponents, data, allowMapping);
   }
 
   void ReadColorScalars(std::size_t numElements, std::string& dataName)
@@ -599,12 +634,13 @@ private:
 
   void ReadVectors(std::size_t numElements,
                    std::string& dataName,
-                   vtkm::cont::DynamicArrayHandle& data)
+                   vtkm::cont::DynamicArrayHandle& data,
+                   bool allowMapping = false)
   {
     std::string dataType;
     this->DataFile->Stream >> dataName >> dataType >> std::ws;
 
-    this->DoReadDynamicArray(dataType, numElements, 3, data);
+    this->DoReadDynamicArray(dataType, numElements, 3, data, allowMapping);
   }
 
   void ReadTensors(std::size_t numElements,
@@ -678,18 +714,18 @@ private:
   public:
     ReadDynamicArray(VTKDataSetReaderBase* reader,
                      std::size_t numElements,
-                     vtkm::cont::DynamicArrayHandle& data)
+                     vtkm::cont::DynamicArrayHandle& data,
+                     bool allowMapping)
       : SkipDynamicArray(reader, numElements)
       , Data(&data)
+      , AllowMapping(allowMapping)
     {
     }
 
     template <typename T>
     void operator()(T) const
     {
-      std::vector<T> buffer(this->NumElements);
-      this->Reader->ReadArray(buffer);
-      *this->Data = internal::CreateDynamicArrayHandle(buffer);
+      this->Read(T(), typename internal::IsClosestCommonType<T>::type());
     }
 
     template <typename T>
@@ -701,7 +737,54 @@ private:
     }
 
   private:
+    // The values need converting to a common type.
+    template <typename T>
+    void Read(T, std::false_type) const
+    {
+      std::vector<T> buffer(this->NumElements);
+      this->Reader->ReadArray(buffer);
+      *this->Data = internal::CreateDynamicArrayHandle(buffer);
+    }
+
+    // The values can be used as stored, so read them directly into the array
+    // or map them from the file.
+    template <typename T>
+    void Read(T, std::true_type) const
+    {
+      internal::VTKDataSetFile& dataFile = *this->Reader->DataFile;
+      if (this->AllowMapping && dataFile.UseMemoryMapping && dataFile.IsBinary)
+      {
+        if (!dataFile.MappedFile)
+        {
+          dataFile.MappedFile =
+            std::make_shared<vtkm::cont::internal::MemoryMappedFile>(dataFile.FileName);
+        }
+        const vtkm::UInt64 offset = static_cast<vtkm::UInt64>(dataFile.Stream.tellg());
+        try
+        {
+          *this->Data = vtkm::cont::DynamicArrayHandle(
+            vtkm::cont::ArrayHandleMemoryMapped<T>(dataFile.MappedFile,
+                                                   offset,
+                                                   static_cast<vtkm::Id>(this->NumElements),
+                                                   vtkm::io::internal::IsLittleEndian()));
+        }
+        catch (vtkm::cont::ErrorBadValue& error)
+        {
+          throw vtkm::io::ErrorIO(error.GetMessage());
+        }
+        this->Reader->SkipArray(this->NumElements, T());
+      }
+      else
+      {
+        vtkm::cont::ArrayHandle<T> array;
+        array.Allocate(static_cast<vtkm::Id>(this->NumElements));
+        this->Reader->ReadArray(array.GetStorage().GetArray(), this->NumElements);
+        *this->Data = vtkm::cont::DynamicArrayHandle(array);
+      }
+    }
+
     vtkm::cont::DynamicArrayHandle* Data;
+    bool AllowMapping;
   };
 
   //Make the Array parsing methods protected so that derived classes
@@ -733,42 +816,74 @@ protected:
   void DoReadDynamicArray(std::string dataType,
                           std::size_t numElements,
                           vtkm::IdComponent numComponents,
-                          vtkm::cont::DynamicArrayHandle& data)
+                          vtkm::cont::DynamicArrayHandle& data,
+                          bool allowMapping = false)
   {
     vtkm::io::internal::DataType typeId = vtkm::io::internal::DataTypeId(dataType);
     vtkm::io::internal::SelectTypeAndCall(
-      typeId, numComponents, ReadDynamicArray(this, numElements, data));
+      typeId, numComponents, ReadDynamicArray(this, numElements, data, allowMapping));
   }
 
   template <typename T>
   void ReadArray(std::vector<T>& buffer)
   {
-    std::size_t numElements = buffer.size();
+    if (!buffer.empty())
+    {
+      this->ReadArray(&buffer[0], buffer.size());
+    }
+    else
+    {
+      this->DataFile->Stream >> std::ws;
+    }
+  }
+
+  template <typename T>
+  void ReadArray(T* buffer, std::size_t numElements)
+  {
     if (this->DataFile->IsBinary)
     {
-      this->DataFile->Stream.read(reinterpret_cast<char*>(&buffer[0]),
+      this->DataFile->Stream.read(reinterpret_cast<char*>(buffer),
                                   static_cast<std::streamsize>(numElements * sizeof(T)));
       if (vtkm::io::internal::IsLittleEndian())
       {
-        vtkm::io::internal::FlipEndianness(buffer);
+        vtkm::io::internal::FlipEndianness(buffer, numElements);
       }
     }
     else
     {
       using ComponentType = typename vtkm::VecTraits<T>::ComponentType;
-      const vtkm::IdComponent numComponents = vtkm::VecTraits<T>::NUM_COMPONENTS;
+      const std::size_t numComponents =
+        static_cast<std::size_t>(vtkm::VecTraits<T>::NUM_COMPONENTS);
+
+      std::size_t offset = this->GetASCIIContentsOffset();
+      vtkm::io::internal::ParseASCII(this->DataFile->Contents,
+                                     offset,
+                                     reinterpret_cast<ComponentType*>(buffer),
+                                     numElements * numComponents);
+      this->DataFile->Stream.seekg(static_cast<std::streamoff>(offset), std::ios_base::beg);
+    }
+    this->DataFile->Stream >> std::ws;
+  }
 
-      for (std::size_t i = 0; i < numElements; ++i)
+  // ASCII arrays are parsed from a copy of the file rather than through the
+  // stream. Returns the offset of the stream in that copy.
+  std::size_t GetASCIIContentsOffset()
+  {
+    std::string& contents = this->DataFile->Contents;
+    if (contents.empty())
+    {
+      std::ifstream file(this->DataFile->FileName.c_str(),
+                         std::ios_base::in | std::ios_base::binary);
+      file.seekg(0, std::ios_base::end);
+      contents.resize(static_cast<std::size_t>(file.tellg()));
+      file.seekg(0, std::ios_base::beg);
+      file.read(&contents[0], static_cast<std::streamsize>(contents.size()));
+      if (!file)
       {
-        for (vtkm::IdComponent j = 0; j < numComponents; ++j)
-        {
-          typename internal::StreamIOType<ComponentType>::Type val;
-          this->DataFile->Stream >> val;
-          vtkm::VecTraits<T>::SetComponent(buffer[i], j, static_cast<ComponentType>(val));
-        }
+        throw vtkm::io::ErrorIO("Failed to read file: " + this->DataFile->FileName);
       }
     }
-    this->DataFile->Stream >> std::ws;
+    return static_cast<std::size_t>(this->DataFile->Stream.tellg());
   }
 
   template <vtkm::IdComponent NumComponents>
@@ -796,17 +911,15 @@ protected:
     }
     else
     {
-      using ComponentType = typename vtkm::VecTraits<T>::ComponentType;
-      const vtkm::IdComponent numComponents = vtkm::VecTraits<T>::NUM_COMPONENTS;
-
-      for (std::size_t i = 0; i < numElements; ++i)
-      {
-        for (vtkm::IdComponent j = 0; j < numComponents; ++j)
-        {
-          typename internal::StreamIOType<ComponentType>::Type val;
-          this->DataFile->Stream >> val;
-        }
-      }
+      const std::size_t numComponents =
+        static_cast<std::size_t>(vtkm::VecTraits<T>::NUM_COMPONENTS);
+
+      std::vector<std::size_t> chunkBegins;
+      std::size_t offset = vtkm::io::internal::FindASCIITokens(this->DataFile->Contents,
+                                                               this->GetASCIIContentsOffset(),
+                                                               numElements * numComponents,
+                                                               chunkBegins);
+      this->DataFile->Stream.seekg(static_cast<std::streamoff>(offset), std::ios_base::beg);
     }
     this->DataFile->Stream >> std::ws;
   }
@@ -19,8 +19,12 @@
 //============================================================================
 
 #include <vtkm/cont/testing/Testing.h>
+#include <vtkm/io/internal/ParseASCII.h>
 #include <vtkm/io/reader/VTKDataSetReader.h>
 
+#include <clocale>
+
+#include <sstream>
 #include <string>
 
 namespace
@@ -593,8 +597,202 @@ void TestReadingStructuredGridBin()
                    "Incorrect cellset type");
 }
 
+// Spans several parse chunks, with varied whitespace between the values.
+void TestReadingLargeASCII()
+{
+  const vtkm::Id numPoints = 20000;
+  std::ostringstream file;
+  file << "# vtk DataFile Version 3.0\nLarge\nASCII\nDATASET POLYDATA\n";
+  file << "POINTS " << numPoints << " float\n";
+  for (vtkm::Id i = 0; i < numPoints; ++i)
+  {
+    file << i << ".5 " << -i << "\t1e-2" << ((i % 7) ? " " : "\n");
+  }
+  file << "\nVERTICES " << numPoints << " " << 2 * numPoints << "\n";
+  for (vtkm::Id i = 0; i < numPoints; ++i)
+  {
+    file << "1 " << i << "\n";
+  }
+  file << "POINT_DATA " << numPoints << "\nSCALARS ids int 1\nLOOKUP_TABLE default\n";
+  for (vtkm::Id i = 0; i < numPoints; ++i)
+  {
+    file << -i << "\r\n";
+  }
+  const std::string contents = file.str();
+  createFile(contents.c_str(), contents.size() + 1, testFileName);
+
+  vtkm::cont::DataSet ds = readVTKDataSet(testFileName);
+  VTKM_TEST_ASSERT(ds.GetCellSet().GetNumberOfCells() == numPoints, "Incorrect number of cells");
+
+  auto points = ds.GetCoordinateSystem().GetData().GetPortalConstControl();
+  vtkm::cont::ArrayHandle<vtkm::Int32> ids;
+  ds.GetField("ids").GetData().CopyTo(ids);
+  for (vtkm::Id i = 0; i < numPoints; ++i)
+  {
+    const vtkm::Float32 x = static_cast<vtkm::Float32>(i) + 0.5f;
+    const vtkm::Float32 y = -static_cast<vtkm::Float32>(i);
+    VTKM_TEST_ASSERT(test_equal(points.Get(i), vtkm::make_Vec(x, y, 0.01f)), "Incorrect point");
+    VTKM_TEST_ASSERT(ids.GetPortalConstControl().Get(i) == -i, "Incorrect scalar");
+  }
+
+  const std::string bad = "# vtk DataFile Version 3.0\nBad\nASCII\nDATASET POLYDATA\n"
+                          "POINTS 2 float\n0 0 0 1 x 0\n";
+  createFile(bad.c_str(), bad.size() + 1, testFileName);
+  try
+  {
+    vtkm::io::reader::VTKDataSetReader reader(testFileName);
+    reader.ReadDataSet();
+    VTKM_TEST_FAIL("Reading a malformed number did not fail");
+  }
+  catch (vtkm::io::ErrorIO&)
+  {
+    std::cout << "Got expected error for malformed number" << std::endl;
+  }
+}
+
+// Tokens of very different lengths, so that the tokens cross the boundaries
+// of the parallel search chunks and the first search window is too small.
+void TestParseASCIITokens()
+{
+  const std::size_t numValues = 20000;
+  std::ostringstream stream;
+  stream << "   ";
+  for (std::size_t i = 0; i < numValues; ++i)
+  {
+    stream << std::string((i * 7919) % 200, '0') << i << ((i % 5) ? " " : " \n\t");
+  }
+  stream << "TRAILER";
+  const std::string data = stream.str();
+
+  std::vector<vtkm::Int32> values(numValues);
+  std::size_t offset = 0;
+  vtkm::io::internal::ParseASCII(data, offset, &values[0], numValues);
+  for (std::size_t i = 0; i < numValues; ++i)
+  {
+    VTKM_TEST_ASSERT(values[i] == static_cast<vtkm::Int32>(i), "Incorrect parsed value");
+  }
+  VTKM_TEST_ASSERT(data.substr(offset) == " \n\tTRAILER" || data.substr(offset) == " TRAILER",
+                   "Incorrect end of tokens");
+
+  try
+  {
+    offset = 0;
+    vtkm::io::internal::ParseASCII(data, offset, &values[0], numValues + 2);
+    VTKM_TEST_FAIL("Reading past the end of the data did not fail");
+  }
+  catch (vtkm::io::ErrorIO&)
+  {
+    std::cout << "Got expected error for reading past the end" << std::endl;
+  }
+}
+
+// Floats are parsed independently of the global locale.
+// Restores the numeric locale, even when the test throws.
+struct NumericLocaleGuard
+{
+  NumericLocaleGuard()
+    : Previous(std::setlocale(LC_NUMERIC, nullptr))
+  {
+  }
+  ~NumericLocaleGuard() { std::setlocale(LC_NUMERIC, this->Previous.c_str()); }
+
+  std::string Previous;
+};
+
+void TestParseASCIILocale()
+{
+  const char* commaLocales[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "German" };
+  NumericLocaleGuard localeGuard;
+  bool haveCommaLocale = false;
+  for (const char* locale : commaLocales)
+  {
+    if (std::setlocale(LC_NUMERIC, locale) != nullptr)
+    {
+      haveCommaLocale = true;
+      break;
+    }
+  }
+  if (!haveCommaLocale)
+  {
+    std::cout << "No decimal comma locale is available, skipping" << std::endl;
+    return;
+  }
+
+  const std::string data = "1.5 -2.25e1 3\n";
+  std::vector<vtkm::Float32> floats(3);
+  std::vector<vtkm::Float64> doubles(3);
+  std::size_t offset = 0;
+  vtkm::io::internal::ParseASCII(data, offset, &floats[0], 3);
+  offset = 0;
+  vtkm::io::internal::ParseASCII(data, offset, &doubles[0], 3);
+  VTKM_TEST_ASSERT(test_equal(floats[0], 1.5f) && test_equal(floats[1], -22.5f) &&
+                     test_equal(floats[2], 3.f),
+                   "Incorrect float in a decimal comma locale");
+  VTKM_TEST_ASSERT(test_equal(doubles[0], 1.5) && test_equal(doubles[1], -22.5) &&
+                     test_equal(doubles[2], 3.),
+                   "Incorrect double in a decimal comma locale");
+}
+
+struct CheckMappedField
+{
+  template <typename T, typename Storage>
+  void operator()(const vtkm::cont::ArrayHandle<T, Storage>& mapped,
+                  const vtkm::cont::DynamicArrayHandle& expected) const
+  {
+    vtkm::cont::ArrayHandle<T> expectedValues;
+    expected.CopyTo(expectedValues);
+    VTKM_TEST_ASSERT(mapped.GetNumberOfValues() == expectedValues.GetNumberOfValues(),
+                     "Mapped field has wrong size");
+    for (vtkm::Id i = 0; i < mapped.GetNumberOfValues(); ++i)
+    {
+      VTKM_TEST_ASSERT(test_equal(mapped.GetPortalConstControl().Get(i),
+                                  expectedValues.GetPortalConstControl().Get(i)),
+                       "Mapped field has wrong value");
+    }
+  }
+};
+
+void TestReadingMemoryMapped(const char* buffer,
+                             std::size_t size,
+                             vtkm::IdComponent numPointFields)
+{
+  createFile(buffer, size, testFileName);
+
+  vtkm::cont::DataSet expected = readVTKDataSet(testFileName);
+
+  vtkm::io::reader::VTKDataSetReader reader(testFileName);
+  reader.SetUseMemoryMapping(true);
+  vtkm::cont::DataSet ds = reader.ReadDataSet();
+
+  VTKM_TEST_ASSERT(ds.GetNumberOfFields() == expected.GetNumberOfFields(),
+                   "Incorrect number of fields");
+  vtkm::IdComponent numMapped = 0;
+  for (vtkm::IdComponent i = 0; i < ds.GetNumberOfFields(); ++i)
+  {
+    const vtkm::cont::Field& field = ds.GetField(i);
+    vtkm::cont::DynamicArrayHandle data = field.GetData();
+    if (data.IsType<vtkm::cont::ArrayHandleMemoryMapped<vtkm::Float32>>() ||
+        data.IsType<vtkm::cont::ArrayHandleMemoryMapped<vtkm::Vec<vtkm::Float32, 3>>>())
+    {
+      VTKM_TEST_ASSERT(field.GetAssociation() == vtkm::cont::Field::ASSOC_POINTS,
+                       "Only point fields should be mapped");
+      ++numMapped;
+    }
+    vtkm::cont::CastAndCall(
+      data.ResetStorageList(
+        vtkm::ListTagBase<vtkm::cont::StorageTagBasic, vtkm::cont::StorageTagMemoryMapped>()),
+      CheckMappedField(),
+      expected.GetField(field.GetName()).GetData());
+  }
+  VTKM_TEST_ASSERT(numMapped == numPointFields, "Point fields were not mapped");
+}
+
 void TestReadingVTKDataSet()
 {
+  std::cout << "Test parsing ASCII tokens" << std::endl;
+  TestParseASCIITokens();
+  TestParseASCIILocale();
+
   std::cout << "Test reading VTK Polydata file in ASCII" << std::endl;
   TestReadingPolyData(FORMAT_ASCII);
   std::cout << "Test reading VTK Polydata file in BINARY" << std::endl;
@@ -622,6 +820,14 @@ void TestReadingVTKDataSet()
   TestReadingStructuredGridASCII();
   std::cout << "Test reading VTK StructuredGrid file in BINARY" << std::endl;
   TestReadingStructuredGridBin();
+
+  std::cout << "Test reading large VTK file in ASCII" << std::endl;
+  TestReadingLargeASCII();
+
+  std::cout << "Test reading VTK files in BINARY with memory mapping" << std::endl;
+  TestReadingMemoryMapped(polydataBin, sizeof(polydataBin), 1);
+  TestReadingMemoryMapped(unsturctureGridBin, sizeof(unsturctureGridBin), 2);
+  TestReadingMemoryMapped(structuredGridBin, sizeof(structuredGridBin), 1);
 }
 
 int UnitTestVTKDataSetReader(int, char* [])
@@ -32,6 +32,7 @@
 
 #include <vtkm/io/ErrorIO.h>
 
+#include <vtkm/io/internal/Endian.h>
 #include <vtkm/io/internal/VTKDataSetTypes.h>
 
 #include <algorithm>
@@ -51,40 +52,134 @@ namespace writer
 namespace detail
 {
 
+/// Writes the values of an array to a VTK legacy file. In ASCII mode values
+/// are formatted straight into the stream. In binary mode they are gathered
+/// into a buffer of \c CHUNK_SIZE values, converted to big-endian in bulk and
+/// written with a single call, so large arrays are streamed through a fixed
+/// amount of memory.
+template <typename T>
+class ArrayOutput
+{
+public:
+  static const std::size_t CHUNK_SIZE = 1 << 16;
+
+  VTKM_CONT
+  ArrayOutput(std::ostream& out, bool binary)
+    : Out(out)
+    , Binary(binary)
+    , LineStart(true)
+  {
+    if (this->Binary)
+    {
+      this->Buffer.reserve(CHUNK_SIZE);
+    }
+  }
+
+  VTKM_CONT
+  void Append(T value)
+  {
+    if (this->Binary)
+    {
+      this->Buffer.push_back(value);
+      if (this->Buffer.size() == CHUNK_SIZE)
+      {
+        this->Flush();
+      }
+    }
+    else
+    {
+      if (!this->LineStart)
+      {
+        this->Out << ' ';
+      }
+      this->Out << static_cast<typename vtkm::io::internal::StreamIOType<T>::Type>(value);
+      this->LineStart = false;
+    }
+  }
+
+  VTKM_CONT
+  void EndLine()
+  {
+    if (!this->Binary)
+    {
+      this->Out << '\n';
+      this->LineStart = true;
+    }
+  }
+
+  /// Writes any buffered values. Binary data is followed by a newline, as the
+  /// legacy format expects.
+  VTKM_CONT
+  void Finish()
+  {
+    if (this->Binary)
+    {
+      this->Flush();
+      this->Out << '\n';
+    }
+  }
+
+private:
+  VTKM_CONT
+  void Flush()
+  {
+    if (this->Buffer.empty())
+    {
+      return;
+    }
+    if (vtkm::io::internal::IsLittleEndian())
+    {
+      vtkm::io::internal::FlipEndianness(this->Buffer);
+    }
+    this->Out.write(reinterpret_cast<const char*>(&this->Buffer[0]),
+                    static_cast<std::streamsize>(this->Buffer.size() * sizeof(T)));
+    this->Buffer.clear();
+  }
+
+  std::ostream& Out;
+  bool Binary;
+  bool LineStart;
+  std::vector<T> Buffer;
+};
+
 struct OutputPointsFunctor
 {
 private:
   std::ostream& out;
+  bool binary;
 
   template <typename PortalType>
   VTKM_CONT void Output(const PortalType& portal) const
   {
-    for (vtkm::Id index = 0; index < portal.GetNumberOfValues(); index++)
-    {
-      const int VTKDims = 3; // VTK files always require 3 dims for points
+    const int VTKDims = 3; // VTK files always require 3 dims for points
 
-      using ValueType = typename PortalType::ValueType;
-      using VecType = typename vtkm::VecTraits<ValueType>;
+    using ValueType = typename PortalType::ValueType;
+    using VecType = typename vtkm::VecTraits<ValueType>;
 
+    ArrayOutput<vtkm::FloatDefault> output(out, binary);
+    for (vtkm::Id index = 0; index < portal.GetNumberOfValues(); index++)
+    {
       const ValueType& value = portal.Get(index);
 
       vtkm::IdComponent numComponents = VecType::GetNumberOfComponents(value);
       for (vtkm::IdComponent c = 0; c < numComponents && c < VTKDims; c++)
       {
-        out << (c == 0 ? "" : " ") << VecType::GetComponent(value, c);
+        output.Append(static_cast<vtkm::FloatDefault>(VecType::GetComponent(value, c)));
       }
       for (vtkm::IdComponent c = numComponents; c < VTKDims; c++)
       {
-        out << " 0";
+        output.Append(vtkm::FloatDefault(0));
       }
-      out << std::endl;
+      output.EndLine();
     }
+    output.Finish();
   }
 
 public:
   VTKM_CONT
-  OutputPointsFunctor(std::ostream& o)
+  OutputPointsFunctor(std::ostream& o, bool b = false)
     : out(o)
+    , binary(b)
   {
   }
 
@@ -99,30 +194,34 @@ struct OutputFieldFunctor
 {
 private:
   std::ostream& out;
+  bool binary;
 
   template <typename PortalType>
   VTKM_CONT void Output(const PortalType& portal) const
   {
+    using ValueType = typename PortalType::ValueType;
+    using VecType = typename vtkm::VecTraits<ValueType>;
+
+    ArrayOutput<typename VecType::ComponentType> output(out, binary);
     for (vtkm::Id index = 0; index < portal.GetNumberOfValues(); index++)
     {
-      using ValueType = typename PortalType::ValueType;
-      using VecType = typename vtkm::VecTraits<ValueType>;
-
       const ValueType& value = portal.Get(index);
 
       vtkm::IdComponent numComponents = VecType::GetNumberOfComponents(value);
       for (vtkm::IdComponent c = 0; c < numComponents; c++)
       {
-        out << (c == 0 ? "" : " ") << VecType::GetComponent(value, c);
+        output.Append(VecType::GetComponent(value, c));
       }
-      out << std::endl;
+      output.EndLine();
     }
+    output.Finish();
   }
 
 public:
   VTKM_CONT
-  OutputFieldFunctor(std::ostream& o)
+  OutputFieldFunctor(std::ostream& o, bool b = false)
     : out(o)
+    , binary(b)
   {
   }
 
@@ -156,8 +255,18 @@ private:
 
 struct VTKDataSetWriter
 {
+public:
+  /// The encoding of the array data in the file. Binary files store the
+  /// values big-endian, as the legacy VTK format requires, and are much
+  /// smaller and faster to write and read than ASCII files.
+  enum struct FileType
+  {
+    ASCII,
+    BINARY
+  };
+
 private:
-  static void WritePoints(std::ostream& out, vtkm::cont::DataSet dataSet)
+  static void WritePoints(std::ostream& out, vtkm::cont::DataSet dataSet, bool binary)
   {
     ///\todo: support other coordinate systems
     int cindex = 0;
@@ -165,61 +274,82 @@ private:
 
     vtkm::Id npoints = cdata.GetNumberOfValues();
     out << "POINTS " << npoints << " "
-        << vtkm::io::internal::DataTypeName<vtkm::FloatDefault>::Name() << " " << std::endl;
+        << vtkm::io::internal::DataTypeName<vtkm::FloatDefault>::Name() << " " << '\n';
 
-    detail::OutputPointsFunctor{ out }(cdata);
+    detail::OutputPointsFunctor{ out, binary }(cdata);
   }
 
   template <class CellSetType>
-  static void WriteExplicitCells(std::ostream& out, CellSetType cellSet)
+  static void WriteExplicitCells(std::ostream& out, CellSetType cellSet, bool binary)
   {
     vtkm::Id nCells = cellSet.GetNumberOfCells();
 
+    // Read the connectivity arrays directly instead of extracting each cell,
+    // which is what made writing large grids slow.
+    const vtkm::TopologyElementTagPoint pointTag;
+    const vtkm::TopologyElementTagCell cellTag;
+    auto shapes = cellSet.GetShapesArray(pointTag, cellTag).GetPortalConstControl();
+    auto numIndices = cellSet.GetNumIndicesArray(pointTag, cellTag).GetPortalConstControl();
+    auto connectivity = cellSet.GetConnectivityArray(pointTag, cellTag).GetPortalConstControl();
+    auto offsets = cellSet.GetIndexOffsetArray(pointTag, cellTag).GetPortalConstControl();
+
     vtkm::Id conn_length = 0;
     for (vtkm::Id i = 0; i < nCells; ++i)
     {
-      conn_length += 1 + cellSet.GetNumberOfPointsInCell(i);
+      conn_length += 1 + numIndices.Get(i);
     }
 
-    out << "CELLS " << nCells << " " << conn_length << std::endl;
-
+    // The legacy format stores cells as 32-bit integers.
+    out << "CELLS " << nCells << " " << conn_length << '\n';
+    detail::ArrayOutput<vtkm::Int32> cellOutput(out, binary);
     for (vtkm::Id i = 0; i < nCells; ++i)
     {
-      vtkm::cont::ArrayHandle<vtkm::Id> ids;
-      vtkm::Id nids = cellSet.GetNumberOfPointsInCell(i);
-      cellSet.GetIndices(i, ids);
-      out << nids;
-      auto IdPortal = ids.GetPortalConstControl();
-      for (int j = 0; j < nids; ++j)
-        out << " " << IdPortal.Get(j);
-      out << std::endl;
+      const vtkm::Id nids = numIndices.Get(i);
+      const vtkm::Id offset = offsets.Get(i);
+      cellOutput.Append(static_cast<vtkm::Int32>(nids));
+      for (vtkm::Id j = 0; j < nids; ++j)
+      {
+        cellOutput.Append(static_cast<vtkm::Int32>(connectivity.Get(offset + j)));
+      }
+      cellOutput.EndLine();
     }
+    cellOutput.Finish();
 
-    out << "CELL_TYPES " << nCells << std::endl;
+    out << "CELL_TYPES " << nCells << '\n';
+    detail::ArrayOutput<vtkm::Int32> typeOutput(out, binary);
     for (vtkm::Id i = 0; i < nCells; ++i)
     {
-      vtkm::Id shape = cellSet.GetCellShape(i);
-      out << shape << std::endl;
+      typeOutput.Append(static_cast<vtkm::Int32>(shapes.Get(i)));
+      typeOutput.EndLine();
     }
+    typeOutput.Finish();
   }
 
-  static void WriteVertexCells(std::ostream& out, vtkm::cont::DataSet dataSet)
+  static void WriteVertexCells(std::ostream& out, vtkm::cont::DataSet dataSet, bool binary)
   {
     vtkm::Id nCells = dataSet.GetCoordinateSystem(0).GetData().GetNumberOfValues();
 
-    out << "CELLS " << nCells << " " << nCells * 2 << std::endl;
-    for (int i = 0; i < nCells; i++)
+    out << "CELLS " << nCells << " " << nCells * 2 << '\n';
+    detail::ArrayOutput<vtkm::Int32> cellOutput(out, binary);
+    for (vtkm::Id i = 0; i < nCells; i++)
     {
-      out << "1 " << i << std::endl;
+      cellOutput.Append(1);
+      cellOutput.Append(static_cast<vtkm::Int32>(i));
+      cellOutput.EndLine();
     }
-    out << "CELL_TYPES " << nCells << std::endl;
-    for (int i = 0; i < nCells; i++)
+    cellOutput.Finish();
+
+    out << "CELL_TYPES " << nCells << '\n';
+    detail::ArrayOutput<vtkm::Int32> typeOutput(out, binary);
+    for (vtkm::Id i = 0; i < nCells; i++)
     {
-      out << vtkm::CELL_SHAPE_VERTEX << std::endl;
+      typeOutput.Append(vtkm::CELL_SHAPE_VERTEX);
+      typeOutput.EndLine();
     }
+    typeOutput.Finish();
   }
 
-  static void WritePointFields(std::ostream& out, vtkm::cont::DataSet dataSet)
+  static void WritePointFields(std::ostream& out, vtkm::cont::DataSet dataSet, bool binary)
   {
     bool wrote_header = false;
     for (vtkm::Id f = 0; f < dataSet.GetNumberOfFields(); f++)
@@ -240,23 +370,24 @@ private:
 
       if (!wrote_header)
       {
-        out << "POINT_DATA " << npoints << std::endl;
+        out << "POINT_DATA " << npoints << '\n';
         wrote_header = true;
       }
 
       std::string typeName;
       vtkm::cont::CastAndCall(field, detail::GetDataTypeName(typeName));
 
-      out << "SCALARS " << field.GetName() << " " << typeName << " " << ncomps << std::endl;
-      out << "LOOKUP_TABLE default" << std::endl;
+      out << "SCALARS " << field.GetName() << " " << typeName << " " << ncomps << '\n';
+      out << "LOOKUP_TABLE default" << '\n';
 
-      vtkm::cont::CastAndCall(field, detail::OutputFieldFunctor(out));
+      vtkm::cont::CastAndCall(field, detail::OutputFieldFunctor(out, binary));
     }
   }
 
   static void WriteCellFields(std::ostream& out,
                               vtkm::cont::DataSet dataSet,
-                              vtkm::cont::DynamicCellSet cellSet)
+                              vtkm::cont::DynamicCellSet cellSet,
+                              bool binary)
   {
     bool wrote_header = false;
     for (vtkm::Id f = 0; f < dataSet.GetNumberOfFields(); f++)
@@ -279,105 +410,123 @@ private:
 
       if (!wrote_header)
       {
-        out << "CELL_DATA " << ncells << std::endl;
+        out << "CELL_DATA " << ncells << '\n';
         wrote_header = true;
       }
 
       std::string typeName;
       vtkm::cont::CastAndCall(field, detail::GetDataTypeName(typeName));
 
-      out << "SCALARS " << field.GetName() << " " << typeName << " " << ncomps << std::endl;
-      out << "LOOKUP_TABLE default" << std::endl;
+      out << "SCALARS " << field.GetName() << " " << typeName << " " << ncomps << '\n';
+      out << "LOOKUP_TABLE default" << '\n';
 
-      vtkm::cont::CastAndCall(field, detail::OutputFieldFunctor(out));
+      vtkm::cont::CastAndCall(field, detail::OutputFieldFunctor(out, binary));
     }
   }
 
-  static void WriteDataSetAsPoints(std::ostream& out, vtkm::cont::DataSet dataSet)
+  static void WriteDataSetAsPoints(std::ostream& out, vtkm::cont::DataSet dataSet, bool binary)
   {
-    out << "DATASET UNSTRUCTURED_GRID" << std::endl;
-    WritePoints(out, dataSet);
-    WriteVertexCells(out, dataSet);
+    out << "DATASET UNSTRUCTURED_GRID" << '\n';
+    WritePoints(out, dataSet, binary);
+    WriteVertexCells(out, dataSet, binary);
   }
 
   template <class CellSetType>
   static void WriteDataSetAsUnstructured(std::ostream& out,
                                          vtkm::cont::DataSet dataSet,
-                                         CellSetType cellSet)
+                                         CellSetType cellSet,
+                                         bool binary)
   {
-    out << "DATASET UNSTRUCTURED_GRID" << std::endl;
-    WritePoints(out, dataSet);
-    WriteExplicitCells(out, cellSet);
+    out << "DATASET UNSTRUCTURED_GRID" << '\n';
+    WritePoints(out, dataSet, binary);
+    WriteExplicitCells(out, cellSet, binary);
   }
 
   template <vtkm::IdComponent DIM>
   static void WriteDataSetAsStructured(std::ostream& out,
                                        vtkm::cont::DataSet dataSet,
-                                       vtkm::cont::CellSetStructured<DIM> cellSet)
+                                       vtkm::cont::CellSetStructured<DIM> cellSet,
+                                       bool binary)
   {
     ///\todo: support uniform/rectilinear
-    out << "DATASET STRUCTURED_GRID" << std::endl;
+    out << "DATASET STRUCTURED_GRID" << '\n';
 
     out << "DIMENSIONS ";
     out << cellSet.GetPointDimensions()[0] << " ";
     out << (DIM > 1 ? cellSet.GetPointDimensions()[1] : 1) << " ";
-    out << (DIM > 2 ? cellSet.GetPointDimensions()[2] : 1) << std::endl;
+    out << (DIM > 2 ? cellSet.GetPointDimensions()[2] : 1) << '\n';
 
-    WritePoints(out, dataSet);
+    WritePoints(out, dataSet, binary);
   }
 
-  static void Write(std::ostream& out, vtkm::cont::DataSet dataSet, vtkm::Id csindex = 0)
+  static void Write(std::ostream& out,
+                    vtkm::cont::DataSet dataSet,
+                    vtkm::Id csindex,
+                    FileType fileType)
   {
     VTKM_ASSERT(csindex < dataSet.GetNumberOfCellSets());
+    const bool binary = (fileType == FileType::BINARY);
 
-    out << "# vtk DataFile Version 3.0" << std::endl;
-    out << "vtk output" << std::endl;
-    out << "ASCII" << std::endl;
+    out << "# vtk DataFile Version 3.0" << '\n';
+    out << "vtk output" << '\n';
+    out << (binary ? "BINARY" : "ASCII") << '\n';
 
     if (csindex < 0)
     {
-      WriteDataSetAsPoints(out, dataSet);
-      WritePointFields(out, dataSet);
+      WriteDataSetAsPoints(out, dataSet, binary);
+      WritePointFields(out, dataSet, binary);
     }
     else
     {
       vtkm::cont::DynamicCellSet cellSet = dataSet.GetCellSet(csindex);
       if (cellSet.IsType<vtkm::cont::CellSetExplicit<>>())
       {
-        WriteDataSetAsUnstructured(out, dataSet, cellSet.Cast<vtkm::cont::CellSetExplicit<>>());
+        WriteDataSetAsUnstructured(
+          out, dataSet, cellSet.Cast<vtkm::cont::CellSetExplicit<>>(), binary);
       }
       else if (cellSet.IsType<vtkm::cont::CellSetStructured<2>>())
       {
-        WriteDataSetAsStructured(out, dataSet, cellSet.Cast<vtkm::cont::CellSetStructured<2>>());
+        WriteDataSetAsStructured(
+          out, dataSet, cellSet.Cast<vtkm::cont::CellSetStructured<2>>(), binary);
       }
       else if (cellSet.IsType<vtkm::cont::CellSetStructured<3>>())
       {
-        WriteDataSetAsStructured(out, dataSet, cellSet.Cast<vtkm::cont::CellSetStructured<3>>());
+        WriteDataSetAsStructured(
+          out, dataSet, cellSet.Cast<vtkm::cont::CellSetStructured<3>>(), binary);
       }
       else if (cellSet.IsType<vtkm::cont::CellSetSingleType<>>())
       {
         // these function just like explicit cell sets
-        WriteDataSetAsUnstructured(out, dataSet, cellSet.Cast<vtkm::cont::CellSetSingleType<>>());
+        WriteDataSetAsUnstructured(
+          out, dataSet, cellSet.Cast<vtkm::cont::CellSetSingleType<>>(), binary);
       }
       else
       {
         throw vtkm::cont::ErrorBadType("Could not determine type to write out.");
       }
 
-      WritePointFields(out, dataSet);
-      WriteCellFields(out, dataSet, cellSet);
+      WritePointFields(out, dataSet, binary);
+      WriteCellFields(out, dataSet, cellSet, binary);
     }
   }
 
 public:
   VTKM_CONT
-  explicit VTKDataSetWriter(const std::string& filename)
+  explicit VTKDataSetWriter(const std::string& filename, FileType fileType = FileType::ASCII)
     : FileName(filename)
+    , Type(fileType)
   {
   }
 
   VTKM_CONT
-  void WriteDataSet(vtkm::cont::DataSet dataSet, vtkm::Id cellSetIndex = 0) const
+  FileType GetFileType() const { return this->Type; }
+  VTKM_CONT
+  void SetFileType(FileType fileType) { this->Type = fileType; }
+
+  /// Writes the data set to the given stream rather than to the file. Binary
+  /// output requires a stream opened in binary mode.
+  VTKM_CONT
+  void WriteDataSet(std::ostream& out, vtkm::cont::DataSet dataSet, vtkm::Id cellSetIndex = 0) const
   {
     if (cellSetIndex >= dataSet.GetNumberOfCellSets())
     {
@@ -399,10 +548,27 @@ public:
         "DataSet has no coordinate system, which is not supported by VTK file format.");
     }
 
+    this->Write(out, dataSet, cellSetIndex, this->Type);
+  }
+
+  VTKM_CONT
+  void WriteDataSet(vtkm::cont::DataSet dataSet, vtkm::Id cellSetIndex = 0) const
+  {
     try
     {
-      std::ofstream fileStream(this->FileName.c_str(), std::fstream::trunc);
-      this->Write(fileStream, dataSet, cellSetIndex);
+      // Data is written in large pieces, so give the stream a larger buffer
+      // than the default to reduce the number of system calls.
+      std::vector<char> streamBuffer(1 << 20);
+      std::ofstream fileStream;
+      fileStream.rdbuf()->pubsetbuf(&streamBuffer[0],
+                                    static_cast<std::streamsize>(streamBuffer.size()));
+      std::ios_base::openmode mode = std::fstream::trunc;
+      if (this->Type == FileType::BINARY)
+      {
+        mode |= std::fstream::binary;
+      }
+      fileStream.open(this->FileName.c_str(), mode);
+      this->WriteDataSet(fileStream, dataSet, cellSetIndex);
       fileStream.close();
     }
     catch (std::ofstream::failure& error)
@@ -419,6 +585,7 @@ public:
 
 private:
   std::string FileName;
+  FileType Type;
 
 }; //struct VTKDataSetWriter
 }
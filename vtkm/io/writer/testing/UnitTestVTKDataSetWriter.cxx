@@ -18,6 +18,7 @@
 //  this software.
 //============================================================================
 
+#include <vtkm/io/reader/VTKDataSetReader.h>
 #include <vtkm/io/writer/VTKDataSetWriter.h>
 
 #include <vtkm/cont/testing/MakeTestDataSet.h>
@@ -59,10 +60,95 @@ void TestVTKUniformWrite()
   writer3.WriteDataSet(tds.Make3DUniformDataSet0(), -1);
 }
 
+struct CompareArrays
+{
+  template <typename T, typename S1, typename S2>
+  void operator()(const vtkm::cont::ArrayHandle<T, S1>& expected,
+                  const vtkm::cont::ArrayHandle<T, S2>& actual) const
+  {
+    VTKM_TEST_ASSERT(expected.GetNumberOfValues() == actual.GetNumberOfValues(),
+                     "Wrong array size.");
+    auto expectedPortal = expected.GetPortalConstControl();
+    auto actualPortal = actual.GetPortalConstControl();
+    for (vtkm::Id i = 0; i < expected.GetNumberOfValues(); ++i)
+    {
+      VTKM_TEST_ASSERT(test_equal(expectedPortal.Get(i), actualPortal.Get(i)),
+                       "Binary file read back different values.");
+    }
+  }
+
+  template <typename T, typename S1, typename U, typename S2>
+  void operator()(const vtkm::cont::ArrayHandle<T, S1>&,
+                  const vtkm::cont::ArrayHandle<U, S2>&) const
+  {
+    VTKM_TEST_FAIL("Binary file read back a different value type.");
+  }
+};
+
+struct CompareWith
+{
+  template <typename T, typename S>
+  void operator()(const vtkm::cont::ArrayHandle<T, S>& expected,
+                  const vtkm::cont::DynamicArrayHandle& actual) const
+  {
+    vtkm::cont::CastAndCall(actual.ResetTypeList(vtkm::TypeListTagAll()),
+                            CompareArrays(),
+                            expected);
+  }
+};
+
+void CompareFiles(const char* asciiFileName, const char* binaryFileName)
+{
+  vtkm::io::reader::VTKDataSetReader asciiReader(asciiFileName);
+  vtkm::io::reader::VTKDataSetReader binaryReader(binaryFileName);
+  vtkm::cont::DataSet ascii = asciiReader.ReadDataSet();
+  vtkm::cont::DataSet binary = binaryReader.ReadDataSet();
+
+  VTKM_TEST_ASSERT(ascii.GetCellSet().GetNumberOfCells() ==
+                     binary.GetCellSet().GetNumberOfCells(),
+                   "Wrong number of cells.");
+  VTKM_TEST_ASSERT(ascii.GetNumberOfFields() == binary.GetNumberOfFields(),
+                   "Wrong number of fields.");
+  CompareArrays()(ascii.GetCoordinateSystem().GetData(),
+                  binary.GetCoordinateSystem().GetData());
+  for (vtkm::IdComponent f = 0; f < ascii.GetNumberOfFields(); ++f)
+  {
+    const vtkm::cont::Field& field = ascii.GetField(f);
+    vtkm::cont::CastAndCall(field.GetData().ResetTypeList(vtkm::TypeListTagAll()),
+                            CompareWith(),
+                            binary.GetField(field.GetName()).GetData());
+  }
+}
+
+void TestVTKBinaryWrite()
+{
+  using FileType = vtkm::io::writer::VTKDataSetWriter::FileType;
+  vtkm::cont::testing::MakeTestDataSet tds;
+
+  vtkm::io::writer::VTKDataSetWriter writer1("fileC1.vtk", FileType::BINARY);
+  VTKM_TEST_ASSERT(writer1.GetFileType() == FileType::BINARY, "Wrong file type.");
+  writer1.WriteDataSet(tds.Make3DExplicitDataSetCowNose());
+  CompareFiles("fileA4.vtk", "fileC1.vtk");
+
+  vtkm::io::writer::VTKDataSetWriter writer2("fileC2.vtk");
+  writer2.SetFileType(FileType::BINARY);
+  writer2.WriteDataSet(tds.Make3DUniformDataSet0());
+  CompareFiles("fileB2.vtk", "fileC2.vtk");
+
+  vtkm::io::writer::VTKDataSetWriter writer3("fileC3.vtk", FileType::BINARY);
+  writer3.WriteDataSet(tds.Make3DUniformDataSet0(), -1);
+  CompareFiles("fileB3.vtk", "fileC3.vtk");
+
+  vtkm::io::writer::VTKDataSetWriter writer4("fileC4.vtk", FileType::BINARY);
+  writer4.WriteDataSet(tds.Make3DExplicitDataSet0());
+  CompareFiles("fileA1.vtk", "fileC4.vtk");
+}
+
 void TestVTKWrite()
 {
   TestVTKExplicitWrite();
   TestVTKUniformWrite();
+  TestVTKBinaryWrite();
 }
 
 } //Anonymous namespace
@@ -21,17 +21,23 @@
 #include <vtkm/rendering/Canvas.h>
 
 #include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayPortalToIterators.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/TryExecute.h>
 #include <vtkm/rendering/BitmapFontFactory.h>
 #include <vtkm/rendering/DecodePNG.h>
+#include <vtkm/rendering/EncodePNG.h>
 #include <vtkm/rendering/LineRenderer.h>
 #include <vtkm/rendering/TextRenderer.h>
 #include <vtkm/rendering/WorldAnnotator.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 namespace vtkm
 {
@@ -324,6 +330,70 @@ struct ColorBarExecutor
   const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& ColorBuffer;
 }; // struct ColorSwatchExecutor
 
+struct ColorBufferToBytes : public vtkm::worklet::WorkletMapField
+{
+  typedef void ControlSignature(FieldIn<>, WholeArrayIn<>, FieldOut<>);
+  typedef void ExecutionSignature(_1, _2, _3);
+
+  VTKM_CONT
+  ColorBufferToBytes(vtkm::Id width, vtkm::Id height)
+    : Width(width)
+    , Height(height)
+  {
+  }
+
+  template <typename ColorBufferPortal>
+  VTKM_EXEC void operator()(const vtkm::Id& index,
+                            const ColorBufferPortal& colorBuffer,
+                            vtkm::Vec<vtkm::UInt8, 4>& pixel) const
+  {
+    // The color buffer starts with the bottom row, image files with the top row.
+    vtkm::Id x = index % Width;
+    vtkm::Id y = Height - 1 - index / Width;
+    vtkm::Vec<vtkm::Float32, 4> color = colorBuffer.Get(y * Width + x);
+    for (vtkm::IdComponent i = 0; i < 4; ++i)
+    {
+      pixel[i] = static_cast<vtkm::UInt8>(vtkm::Min(vtkm::Max(color[i], 0.f), 1.f) * 255.f);
+    }
+  }
+
+  vtkm::Id Width;
+  vtkm::Id Height;
+}; // struct ColorBufferToBytes
+
+struct ColorBufferToBytesExecutor
+{
+  VTKM_CONT
+  ColorBufferToBytesExecutor(
+    const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& colorBuffer,
+    vtkm::Id width,
+    vtkm::Id height,
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::UInt8, 4>>& pixels)
+    : ColorBuffer(colorBuffer)
+    , Width(width)
+    , Height(height)
+    , Pixels(pixels)
+  {
+  }
+
+  template <typename Device>
+  VTKM_CONT bool operator()(Device) const
+  {
+    VTKM_IS_DEVICE_ADAPTER_TAG(Device);
+
+    vtkm::cont::ArrayHandleCounting<vtkm::Id> iterator(0, 1, this->Width * this->Height);
+    vtkm::worklet::DispatcherMapField<ColorBufferToBytes, Device> dispatcher(
+      ColorBufferToBytes(this->Width, this->Height));
+    dispatcher.Invoke(iterator, this->ColorBuffer, this->Pixels);
+    return true;
+  }
+
+  const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& ColorBuffer;
+  vtkm::Id Width;
+  vtkm::Id Height;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::UInt8, 4>>& Pixels;
+}; // struct ColorBufferToBytesExecutor
+
 } // namespace internal
 
 struct Canvas::CanvasInternals
@@ -687,21 +757,64 @@ void Canvas::SetViewToScreenSpace(const vtkm::rendering::Camera& vtkmNotUsed(cam
 void Canvas::SaveAs(const std::string& fileName) const
 {
   this->RefreshColorBuffer();
-  std::ofstream of(fileName.c_str(), std::ios_base::binary | std::ios_base::out);
   vtkm::Id width = GetWidth();
   vtkm::Id height = GetHeight();
-  of << "P6" << std::endl << width << " " << height << std::endl << 255 << std::endl;
-  ColorBufferType::PortalConstControl colorPortal = GetColorBuffer().GetPortalConstControl();
-  for (vtkm::Id yIndex = height - 1; yIndex >= 0; yIndex--)
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::UInt8, 4>> pixels;
+  vtkm::cont::TryExecute(
+    internal::ColorBufferToBytesExecutor(GetColorBuffer(), width, height, pixels));
+  const unsigned char* rgba = nullptr;
+  if (width * height > 0)
+  {
+    rgba = reinterpret_cast<const unsigned char*>(
+      &*vtkm::cont::ArrayPortalToIteratorBegin(pixels.GetPortalConstControl()));
+  }
+
+  std::string extension;
+  if (fileName.size() >= 4)
   {
-    for (vtkm::Id xIndex = 0; xIndex < width; xIndex++)
+    extension = fileName.substr(fileName.size() - 4);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) {
+      return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+  }
+
+  // Build the whole file in memory and write it with one call.
+  std::vector<unsigned char> image;
+  if (extension == ".png")
+  {
+    // PNG has no representation for an image without pixels.
+    if (width * height == 0)
+    {
+      throw vtkm::cont::ErrorBadValue("Cannot save the empty canvas as the PNG image " +
+                                      fileName);
+    }
+    if (EncodePNG(image,
+                  rgba,
+                  static_cast<unsigned long>(width),
+                  static_cast<unsigned long>(height)) != 0)
     {
-      vtkm::Vec<vtkm::Float32, 4> tuple = colorPortal.Get(yIndex * width + xIndex);
-      of << (unsigned char)(tuple[0] * 255);
-      of << (unsigned char)(tuple[1] * 255);
-      of << (unsigned char)(tuple[2] * 255);
+      throw vtkm::cont::ErrorBadValue("Could not encode the PNG image " + fileName);
     }
   }
+  else
+  {
+    std::ostringstream header;
+    header << "P6" << std::endl << width << " " << height << std::endl << 255 << std::endl;
+    const std::string headerString = header.str();
+    const std::size_t numPixels = static_cast<std::size_t>(width * height);
+    image.resize(headerString.size() + 3 * numPixels);
+    std::copy(headerString.begin(), headerString.end(), image.begin());
+    unsigned char* rgb = image.data() + headerString.size();
+    for (std::size_t i = 0; i < numPixels; ++i)
+    {
+      rgb[3 * i] = rgba[4 * i];
+      rgb[3 * i + 1] = rgba[4 * i + 1];
+      rgb[3 * i + 2] = rgba[4 * i + 2];
+    }
+  }
+
+  std::ofstream of(fileName.c_str(), std::ios_base::binary | std::ios_base::out);
+  of.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
   of.close();
 }
 
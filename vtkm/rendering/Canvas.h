@@ -110,6 +110,8 @@ public:
   virtual void SetViewToScreenSpace(const vtkm::rendering::Camera& camera, bool clip);
   virtual void SetViewportClipping(const vtkm::rendering::Camera&, bool) {}
 
+  /// Saves the color buffer to an image file. A file name ending in .png
+  /// writes a PNG image, any other name writes a binary PPM image.
   virtual void SaveAs(const std::string& fileName) const;
 
   /// Creates a WorldAnnotator of a type that is paired with this Canvas. Other
@@ -0,0 +1,585 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/rendering/Compositor.h>
+
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/ErrorBadValue.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if defined(VTKM_ENABLE_MPI)
+// clang-format off
+#include <vtkm/thirdparty/diy/Configure.h>
+#include VTKM_DIY(diy/master.hpp)
+#include VTKM_DIY(diy/mpi.hpp)
+#include VTKM_DIY(diy/partners/swap.hpp)
+#include VTKM_DIY(diy/reduce.hpp)
+// clang-format on
+#endif
+
+namespace vtkm
+{
+namespace rendering
+{
+namespace
+{
+
+// The rows [RowBegin, RowEnd) of a Width x Height image, with RGBA colors
+// stored as 4 consecutive floats per pixel.
+struct Image
+{
+  vtkm::Id Width = 0;
+  vtkm::Id Height = 0;
+  vtkm::Id RowBegin = 0;
+  vtkm::Id RowEnd = 0;
+  vtkm::Id VisibilityOrder = 0;
+  std::vector<vtkm::Float32> Colors;
+  std::vector<vtkm::Float32> Depths;
+
+  vtkm::Id GetNumberOfPixels() const { return this->Width * (this->RowEnd - this->RowBegin); }
+
+  Image GetRows(vtkm::Id rowBegin, vtkm::Id rowEnd) const
+  {
+    Image rows;
+    rows.Width = this->Width;
+    rows.Height = this->Height;
+    rows.RowBegin = rowBegin;
+    rows.RowEnd = rowEnd;
+    rows.VisibilityOrder = this->VisibilityOrder;
+    const std::size_t begin = static_cast<std::size_t>((rowBegin - this->RowBegin) * this->Width);
+    const std::size_t end = static_cast<std::size_t>((rowEnd - this->RowBegin) * this->Width);
+    rows.Colors.assign(this->Colors.begin() + static_cast<std::ptrdiff_t>(begin * 4),
+                       this->Colors.begin() + static_cast<std::ptrdiff_t>(end * 4));
+    rows.Depths.assign(this->Depths.begin() + static_cast<std::ptrdiff_t>(begin),
+                       this->Depths.begin() + static_cast<std::ptrdiff_t>(end));
+    return rows;
+  }
+};
+
+// Keeps the closest fragment of each pixel of front and back.
+void ZBufferComposite(Image& front, const Image& back)
+{
+  const std::size_t numPixels = front.Depths.size();
+  for (std::size_t i = 0; i < numPixels; ++i)
+  {
+    if (back.Depths[i] < front.Depths[i])
+    {
+      front.Depths[i] = back.Depths[i];
+      std::copy(back.Colors.begin() + static_cast<std::ptrdiff_t>(i * 4),
+                back.Colors.begin() + static_cast<std::ptrdiff_t>(i * 4 + 4),
+                front.Colors.begin() + static_cast<std::ptrdiff_t>(i * 4));
+    }
+  }
+}
+
+// Blends back behind front. Canvas colors have premultiplied alpha, as in
+// Canvas::BlendBackground.
+void BlendComposite(Image& front, const Image& back)
+{
+  const std::size_t numPixels = front.Depths.size();
+  for (std::size_t i = 0; i < numPixels; ++i)
+  {
+    const vtkm::Float32 transmission = 1.f - front.Colors[i * 4 + 3];
+    for (std::size_t c = 0; c < 4; ++c)
+    {
+      front.Colors[i * 4 + c] += transmission * back.Colors[i * 4 + c];
+    }
+    front.Depths[i] = std::min(front.Depths[i], back.Depths[i]);
+  }
+}
+
+void CompositeImages(Image& front, const Image& back, Compositor::CompositeMode mode)
+{
+  if (mode == Compositor::Z_BUFFER_SURFACE)
+  {
+    ZBufferComposite(front, back);
+  }
+  else
+  {
+    BlendComposite(front, back);
+  }
+}
+
+// Groups the prime factors of the number of blocks into the group sizes of
+// the rounds of radix-k, each at most k unless a prime factor is larger.
+// diy::RegularPartners::factor drops factors when k does not divide the
+// number of blocks.
+std::vector<int> RadixKRounds(int numberOfBlocks, int k)
+{
+  std::vector<int> factors;
+  for (int factor = 2; factor * factor <= numberOfBlocks; ++factor)
+  {
+    while (numberOfBlocks % factor == 0)
+    {
+      factors.push_back(factor);
+      numberOfBlocks /= factor;
+    }
+  }
+  if (numberOfBlocks > 1)
+  {
+    factors.push_back(numberOfBlocks);
+  }
+
+  std::vector<int> rounds;
+  int groupSize = 1;
+  for (const int factor : factors)
+  {
+    if (groupSize > 1 && groupSize * factor > k)
+    {
+      rounds.push_back(groupSize);
+      groupSize = 1;
+    }
+    groupSize *= factor;
+  }
+  if (groupSize > 1)
+  {
+    rounds.push_back(groupSize);
+  }
+  return rounds;
+}
+
+// In each round, a group splits its current rows into one piece per block,
+// and the block at position j of the group keeps piece j.
+Image GetPiece(const Image& image, vtkm::Id j, vtkm::Id groupSize)
+{
+  const vtkm::Id numRows = image.RowEnd - image.RowBegin;
+  return image.GetRows(image.RowBegin + numRows * j / groupSize,
+                       image.RowBegin + numRows * (j + 1) / groupSize);
+}
+
+// Composites the pieces of the same rows sent by the blocks of a group,
+// which are ordered front to back.
+void CompositePieces(Image& image, const std::vector<Image>& pieces, Compositor::CompositeMode mode)
+{
+  image = pieces[0];
+  for (std::size_t i = 1; i < pieces.size(); ++i)
+  {
+    CompositeImages(image, pieces[i], mode);
+  }
+}
+
+// Runs radix-k over blocks held in one process, indexed by global id. The
+// groups of each round are the ones of diy::RegularSwapPartners over a
+// contiguous 1D decomposition: the blocks step apart in global id, where step
+// is the product of the group sizes of the previous rounds.
+void RadixKCompositeLocal(std::vector<Image>& blocks,
+                          Compositor::CompositeMode mode,
+                          const std::vector<int>& rounds)
+{
+  int step = 1;
+  for (const int groupSize : rounds)
+  {
+    std::vector<Image> next(blocks.size());
+    for (int gid = 0; gid < static_cast<int>(blocks.size()); ++gid)
+    {
+      const int position = gid / step % groupSize;
+      const int first = gid - position * step;
+      std::vector<Image> pieces;
+      for (int member = 0; member < groupSize; ++member)
+      {
+        pieces.push_back(
+          GetPiece(blocks[static_cast<std::size_t>(first + member * step)], position, groupSize));
+      }
+      CompositePieces(next[static_cast<std::size_t>(gid)], pieces, mode);
+    }
+    blocks.swap(next);
+    step *= groupSize;
+  }
+}
+
+// Copies the final pieces of the blocks into one image.
+void AssemblePieces(const std::vector<Image>& pieces, Image& image)
+{
+  image.RowBegin = 0;
+  image.RowEnd = image.Height;
+  image.Colors.resize(static_cast<std::size_t>(image.GetNumberOfPixels() * 4));
+  image.Depths.resize(static_cast<std::size_t>(image.GetNumberOfPixels()));
+  for (const Image& piece : pieces)
+  {
+    const std::size_t offset = static_cast<std::size_t>(piece.RowBegin * image.Width);
+    std::copy(piece.Colors.begin(),
+              piece.Colors.end(),
+              image.Colors.begin() + static_cast<std::ptrdiff_t>(offset * 4));
+    std::copy(piece.Depths.begin(),
+              piece.Depths.end(),
+              image.Depths.begin() + static_cast<std::ptrdiff_t>(offset));
+  }
+}
+
+#if defined(VTKM_ENABLE_MPI)
+// Assigns the blocks to the ranks that added their images. The global ids of
+// the blocks follow the visibility order of the images, so that the groups of
+// radix-k compositing are contiguous in visibility order.
+class AssignerVisibilityOrder : public diy::Assigner
+{
+public:
+  AssignerVisibilityOrder(int size, const std::vector<int>& blockRanks)
+    : diy::Assigner(size, static_cast<int>(blockRanks.size()))
+    , BlockRanks(blockRanks)
+  {
+  }
+
+  void local_gids(int rank, std::vector<int>& gids) const override
+  {
+    gids.clear();
+    for (std::size_t gid = 0; gid < this->BlockRanks.size(); ++gid)
+    {
+      if (this->BlockRanks[gid] == rank)
+      {
+        gids.push_back(static_cast<int>(gid));
+      }
+    }
+  }
+
+  int rank(int gid) const override { return this->BlockRanks[static_cast<std::size_t>(gid)]; }
+
+private:
+  std::vector<int> BlockRanks;
+};
+
+// Composites the images of all ranks with one DIY block per image. Only
+// rank 0 receives the result.
+void RadixKComposite(std::vector<Image>& images,
+                     Image& result,
+                     Compositor::CompositeMode mode,
+                     vtkm::IdComponent k)
+{
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+
+  // order the images of all ranks front to back, so global ids follow the
+  // visibility order
+  std::vector<vtkm::Id> orders;
+  for (const Image& image : images)
+  {
+    orders.push_back(image.VisibilityOrder);
+  }
+  std::vector<std::vector<vtkm::Id>> allOrders;
+  diy::mpi::all_gather(comm, orders, allOrders);
+  std::vector<std::pair<int, std::size_t>> blocks; // rank and local index
+  for (std::size_t rank = 0; rank < allOrders.size(); ++rank)
+  {
+    for (std::size_t i = 0; i < allOrders[rank].size(); ++i)
+    {
+      blocks.push_back(std::make_pair(static_cast<int>(rank), i));
+    }
+  }
+  if (mode == Compositor::VIS_ORDER_BLEND)
+  {
+    std::stable_sort(
+      blocks.begin(),
+      blocks.end(),
+      [&](const std::pair<int, std::size_t>& a, const std::pair<int, std::size_t>& b) {
+        return allOrders[static_cast<std::size_t>(a.first)][a.second] <
+          allOrders[static_cast<std::size_t>(b.first)][b.second];
+      });
+  }
+  std::vector<int> blockRanks;
+  for (const auto& block : blocks)
+  {
+    blockRanks.push_back(block.first);
+  }
+
+  AssignerVisibilityOrder assigner(comm.size(), blockRanks);
+  diy::Master master(comm, 1, -1);
+  for (std::size_t gid = 0; gid < blocks.size(); ++gid)
+  {
+    if (blocks[gid].first == comm.rank())
+    {
+      master.add(static_cast<int>(gid), &images[blocks[gid].second], new diy::Link());
+    }
+  }
+
+  diy::RegularPartners::KVSVector kvs;
+  for (const int groupSize : RadixKRounds(static_cast<int>(blocks.size()), k))
+  {
+    kvs.push_back(diy::RegularPartners::DimK(0, groupSize));
+  }
+  diy::RegularSwapPartners partners(
+    diy::RegularPartners::DivisionVector(1, static_cast<int>(blocks.size())), kvs);
+
+  auto callback = [mode](
+    Image* data, const diy::ReduceProxy& srp, const diy::RegularSwapPartners&) {
+    // 1. composite the pieces of our rows sent by the group of the last
+    // round. Lower global ids are in front.
+    std::vector<int> incoming;
+    for (int cc = 0; cc < srp.in_link().size(); ++cc)
+    {
+      incoming.push_back(srp.in_link().target(cc).gid);
+    }
+    std::sort(incoming.begin(), incoming.end());
+    if (!incoming.empty())
+    {
+      std::vector<Image> pieces(incoming.size());
+      for (std::size_t i = 0; i < incoming.size(); ++i)
+      {
+        pieces[i].Width = data->Width;
+        pieces[i].Height = data->Height;
+        srp.dequeue(incoming[i], pieces[i].RowBegin);
+        srp.dequeue(incoming[i], pieces[i].RowEnd);
+        srp.dequeue(incoming[i], pieces[i].Colors);
+        srp.dequeue(incoming[i], pieces[i].Depths);
+      }
+      CompositePieces(*data, pieces, mode);
+    }
+
+    // 2. split our rows among the group of this round
+    std::vector<diy::BlockID> outgoing;
+    for (int cc = 0; cc < srp.out_link().size(); ++cc)
+    {
+      outgoing.push_back(srp.out_link().target(cc));
+    }
+    std::sort(outgoing.begin(),
+              outgoing.end(),
+              [](const diy::BlockID& a, const diy::BlockID& b) { return a.gid < b.gid; });
+    const vtkm::Id groupSize = static_cast<vtkm::Id>(outgoing.size());
+    for (vtkm::Id j = 0; j < groupSize; ++j)
+    {
+      Image piece = GetPiece(*data, j, groupSize);
+      const diy::BlockID& target = outgoing[static_cast<std::size_t>(j)];
+      srp.enqueue(target, piece.RowBegin);
+      srp.enqueue(target, piece.RowEnd);
+      srp.enqueue(target, piece.Colors);
+      srp.enqueue(target, piece.Depths);
+    }
+  };
+  diy::reduce(master, assigner, partners, callback);
+
+  // gather the final pieces on rank 0
+  std::vector<vtkm::Id> rows;
+  std::vector<vtkm::Float32> colors;
+  std::vector<vtkm::Float32> depths;
+  for (const Image& image : images)
+  {
+    rows.push_back(image.RowBegin);
+    rows.push_back(image.RowEnd);
+    colors.insert(colors.end(), image.Colors.begin(), image.Colors.end());
+    depths.insert(depths.end(), image.Depths.begin(), image.Depths.end());
+  }
+  if (comm.rank() != 0)
+  {
+    diy::mpi::gather(comm, rows, 0);
+    diy::mpi::gather(comm, colors, 0);
+    diy::mpi::gather(comm, depths, 0);
+    return;
+  }
+
+  std::vector<std::vector<vtkm::Id>> allRows;
+  std::vector<std::vector<vtkm::Float32>> allColors;
+  std::vector<std::vector<vtkm::Float32>> allDepths;
+  diy::mpi::gather(comm, rows, allRows, 0);
+  diy::mpi::gather(comm, colors, allColors, 0);
+  diy::mpi::gather(comm, depths, allDepths, 0);
+
+  std::vector<Image> pieces;
+  for (std::size_t rank = 0; rank < allRows.size(); ++rank)
+  {
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i + 1 < allRows[rank].size(); i += 2)
+    {
+      Image piece;
+      piece.Width = result.Width;
+      piece.Height = result.Height;
+      piece.RowBegin = allRows[rank][i];
+      piece.RowEnd = allRows[rank][i + 1];
+      const std::size_t numPixels = static_cast<std::size_t>(piece.GetNumberOfPixels());
+      piece.Colors.assign(allColors[rank].begin() + static_cast<std::ptrdiff_t>(offset * 4),
+                          allColors[rank].begin() +
+                            static_cast<std::ptrdiff_t>((offset + numPixels) * 4));
+      piece.Depths.assign(allDepths[rank].begin() + static_cast<std::ptrdiff_t>(offset),
+                          allDepths[rank].begin() +
+                            static_cast<std::ptrdiff_t>(offset + numPixels));
+      pieces.push_back(piece);
+      offset += numPixels;
+    }
+  }
+  AssemblePieces(pieces, result);
+}
+#endif
+
+} // anonymous namespace
+
+struct Compositor::InternalsType
+{
+  CompositeMode Mode;
+  vtkm::IdComponent RadixK;
+  std::vector<Image> Images;
+
+  VTKM_CONT
+  InternalsType()
+    : Mode(Z_BUFFER_SURFACE)
+    , RadixK(2)
+  {
+  }
+};
+
+Compositor::Compositor()
+  : Internals(new InternalsType)
+{
+}
+
+Compositor::~Compositor()
+{
+}
+
+void Compositor::SetCompositeMode(CompositeMode mode)
+{
+  this->Internals->Mode = mode;
+}
+
+Compositor::CompositeMode Compositor::GetCompositeMode() const
+{
+  return this->Internals->Mode;
+}
+
+void Compositor::SetRadixK(vtkm::IdComponent k)
+{
+  if (k < 2)
+  {
+    throw vtkm::cont::ErrorBadValue("Radix-k compositing needs k >= 2.");
+  }
+  this->Internals->RadixK = k;
+}
+
+vtkm::IdComponent Compositor::GetRadixK() const
+{
+  return this->Internals->RadixK;
+}
+
+void Compositor::AddImage(const vtkm::rendering::Canvas& canvas)
+{
+  this->AddImage(canvas, 0);
+}
+
+void Compositor::AddImage(const vtkm::rendering::Canvas& canvas, vtkm::Id visibilityOrder)
+{
+  if (!this->Internals->Images.empty() &&
+      (this->Internals->Images[0].Width != canvas.GetWidth() ||
+       this->Internals->Images[0].Height != canvas.GetHeight()))
+  {
+    throw vtkm::cont::ErrorBadValue("Composited images must all have the same size.");
+  }
+
+  canvas.RefreshColorBuffer();
+  canvas.RefreshDepthBuffer();
+  auto colors = canvas.GetColorBuffer().GetPortalConstControl();
+  auto depths = canvas.GetDepthBuffer().GetPortalConstControl();
+
+  Image image;
+  image.Width = canvas.GetWidth();
+  image.Height = canvas.GetHeight();
+  image.RowBegin = 0;
+  image.RowEnd = image.Height;
+  image.VisibilityOrder = visibilityOrder;
+  const vtkm::Id numPixels = image.GetNumberOfPixels();
+  image.Colors.resize(static_cast<std::size_t>(numPixels * 4));
+  image.Depths.resize(static_cast<std::size_t>(numPixels));
+  for (vtkm::Id i = 0; i < numPixels; ++i)
+  {
+    const vtkm::Vec<vtkm::Float32, 4> color = colors.Get(i);
+    for (vtkm::IdComponent c = 0; c < 4; ++c)
+    {
+      image.Colors[static_cast<std::size_t>(i * 4 + c)] = color[c];
+    }
+    image.Depths[static_cast<std::size_t>(i)] = depths.Get(i);
+  }
+  this->Internals->Images.push_back(image);
+}
+
+void Compositor::ClearImages()
+{
+  this->Internals->Images.clear();
+}
+
+vtkm::Id Compositor::GetNumberOfImages() const
+{
+  return static_cast<vtkm::Id>(this->Internals->Images.size());
+}
+
+void Compositor::Composite(vtkm::rendering::Canvas& canvas)
+{
+  std::vector<Image> images = this->Internals->Images;
+  const CompositeMode mode = this->Internals->Mode;
+
+  vtkm::Id width = images.empty() ? 0 : images[0].Width;
+  vtkm::Id height = images.empty() ? 0 : images[0].Height;
+#if defined(VTKM_ENABLE_MPI)
+  // ranks without images still take their part in the exchange
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  const bool useMPI = (static_cast<MPI_Comm>(comm) != MPI_COMM_NULL);
+  if (useMPI)
+  {
+    vtkm::Id localWidth = width;
+    vtkm::Id localHeight = height;
+    diy::mpi::all_reduce(comm, localWidth, width, diy::mpi::maximum<vtkm::Id>());
+    diy::mpi::all_reduce(comm, localHeight, height, diy::mpi::maximum<vtkm::Id>());
+  }
+#endif
+  if (width == 0 || height == 0)
+  {
+    throw vtkm::cont::ErrorBadValue("No images to composite.");
+  }
+
+  // Every image is a block of radix-k compositing, so ranks exchange pieces
+  // of their images instead of compositing them locally first.
+  Image result;
+  result.Width = width;
+  result.Height = height;
+#if defined(VTKM_ENABLE_MPI)
+  if (useMPI)
+  {
+    RadixKComposite(images, result, mode, this->Internals->RadixK);
+    if (comm.rank() != 0)
+    {
+      return;
+    }
+  }
+  else
+#endif
+  {
+    if (mode == VIS_ORDER_BLEND)
+    {
+      std::stable_sort(images.begin(), images.end(), [](const Image& a, const Image& b) {
+        return a.VisibilityOrder < b.VisibilityOrder;
+      });
+    }
+    RadixKCompositeLocal(
+      images, mode, RadixKRounds(static_cast<int>(images.size()), this->Internals->RadixK));
+    AssemblePieces(images, result);
+  }
+
+  canvas.ResizeBuffers(width, height);
+  auto colors = canvas.GetColorBuffer().GetPortalControl();
+  auto depths = canvas.GetDepthBuffer().GetPortalControl();
+  for (vtkm::Id i = 0; i < width * height; ++i)
+  {
+    vtkm::Vec<vtkm::Float32, 4> color;
+    for (vtkm::IdComponent c = 0; c < 4; ++c)
+    {
+      color[c] = result.Colors[static_cast<std::size_t>(i * 4 + c)];
+    }
+    colors.Set(i, color);
+    depths.Set(i, result.Depths[static_cast<std::size_t>(i)]);
+  }
+}
+}
+} // namespace vtkm::rendering
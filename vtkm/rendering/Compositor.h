@@ -0,0 +1,96 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_rendering_Compositor_h
+#define vtk_m_rendering_Compositor_h
+
+#include <vtkm/rendering/Canvas.h>
+#include <vtkm/rendering/vtkm_rendering_export.h>
+
+#include <memory>
+
+namespace vtkm
+{
+namespace rendering
+{
+
+/// \brief Sort-last compositing of images rendered from pieces of a data set.
+///
+/// Every block of a data set (for example each block of a `MultiBlock`) is
+/// rendered into its own canvas with the same camera, and the canvases are
+/// added to the compositor, which combines them into one image.
+///
+/// The images are composited with radix-k compositing, with one block per
+/// image: in each round the blocks of a group of k exchange pieces of their
+/// current image region and composite the piece they keep. When VTK-m is
+/// built with MPI, the images added on all the ranks of the communicator in
+/// `vtkm::cont::EnvironmentTracker` take part, the blocks are exchanged with
+/// DIY, and only the final pieces are gathered on rank 0. With k = 2, this
+/// is binary swap.
+///
+class VTKM_RENDERING_EXPORT Compositor
+{
+public:
+  enum CompositeMode
+  {
+    /// Keeps the closest fragment of each pixel. For opaque surfaces.
+    Z_BUFFER_SURFACE,
+    /// Blends the images in visibility order with premultiplied alpha. For
+    /// volume renderings.
+    VIS_ORDER_BLEND
+  };
+
+  Compositor();
+  ~Compositor();
+
+  void SetCompositeMode(CompositeMode mode);
+  CompositeMode GetCompositeMode() const;
+
+  /// Sets the target number of ranks that exchange image pieces in each
+  /// round. The default of 2 is binary swap.
+  void SetRadixK(vtkm::IdComponent k);
+  vtkm::IdComponent GetRadixK() const;
+
+  /// Adds the color and depth buffers of a canvas for Z_BUFFER_SURFACE
+  /// compositing. All images must have the same size.
+  void AddImage(const vtkm::rendering::Canvas& canvas);
+
+  /// Adds the color and depth buffers of a canvas for VIS_ORDER_BLEND
+  /// compositing. Images with a lower visibility order are in front. The
+  /// order is global across the ranks.
+  void AddImage(const vtkm::rendering::Canvas& canvas, vtkm::Id visibilityOrder);
+
+  void ClearImages();
+
+  vtkm::Id GetNumberOfImages() const;
+
+  /// Composites the images of all ranks into canvas, which is resized to
+  /// the image size. When running with MPI, every rank must call this with
+  /// the same composite mode and k, and only the canvas of rank 0 receives
+  /// the result.
+  void Composite(vtkm::rendering::Canvas& canvas);
+
+private:
+  struct InternalsType;
+  std::shared_ptr<InternalsType> Internals;
+};
+}
+} //namespace vtkm::rendering
+
+#endif //vtk_m_rendering_Compositor_h
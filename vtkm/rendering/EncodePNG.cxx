@@ -0,0 +1,930 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/rendering/EncodePNG.h>
+
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/serial/DeviceAdapterSerial.h>
+#include <vtkm/cont/tbb/DeviceAdapterTBB.h>
+#include <vtkm/exec/FunctorBase.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace vtkm
+{
+namespace rendering
+{
+
+namespace
+{
+
+// Images are encoded on the host, in parallel when TBB is available.
+#ifdef VTKM_ENABLE_TBB
+using EncodePNGDeviceAdapterTag = vtkm::cont::DeviceAdapterTagTBB;
+#else
+using EncodePNGDeviceAdapterTag = vtkm::cont::DeviceAdapterTagSerial;
+#endif
+
+typedef std::vector<unsigned char> ByteVector;
+
+// The approximate number of filtered bytes compressed together. Matches
+// never reach across chunks, so larger chunks compress slightly better and
+// smaller chunks give more parallelism.
+const std::size_t CHUNK_BYTES = std::size_t(1) << 18;
+
+const std::size_t WINDOW_SIZE = std::size_t(1) << 15;
+const std::size_t MIN_MATCH = 3;
+const std::size_t MAX_MATCH = 258;
+// The number of earlier positions with the same hash checked for a match.
+const int MAX_CHAIN = 32;
+const unsigned int HASH_BITS = 15;
+// The number of literals and matches written in one deflate block.
+const std::size_t SYMBOLS_PER_BLOCK = std::size_t(1) << 16;
+
+const unsigned int NUM_LITLEN_CODES = 286;
+const unsigned int NUM_DIST_CODES = 30;
+const unsigned int NUM_CODELENGTH_CODES = 19;
+
+const unsigned short LENGTH_BASE[29] = { 3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                         15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                         67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const unsigned char LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                         2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const unsigned short DIST_BASE[30] = { 1,    2,    3,    4,    5,    7,     9,    13,
+                                       17,   25,   33,   49,   65,   97,    129,  193,
+                                       257,  385,  513,  769,  1025, 1537,  2049, 3073,
+                                       4097, 6145, 8193, 12289, 16385, 24577 };
+const unsigned char DIST_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                       6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+const unsigned char CODELENGTH_ORDER[19] = { 16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                             11, 4,  12, 3, 13, 2, 14, 1, 15 };
+
+struct CRCTable
+{
+  unsigned int Values[256];
+
+  CRCTable()
+  {
+    for (unsigned int n = 0; n < 256; ++n)
+    {
+      unsigned int c = n;
+      for (int k = 0; k < 8; ++k)
+      {
+        c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+      }
+      this->Values[n] = c;
+    }
+  }
+};
+
+unsigned int CRC32(const unsigned char* data, std::size_t size)
+{
+  static const CRCTable table;
+  unsigned int crc = 0xffffffffu;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    crc = table.Values[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc ^ 0xffffffffu;
+}
+
+const unsigned int ADLER_BASE = 65521;
+
+unsigned int Adler32(const unsigned char* data, std::size_t size)
+{
+  unsigned int a = 1;
+  unsigned int b = 0;
+  while (size > 0)
+  {
+    // 5552 is the most bytes that can be summed before b overflows.
+    const std::size_t count = std::min(size, std::size_t(5552));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      a += data[i];
+      b += a;
+    }
+    a %= ADLER_BASE;
+    b %= ADLER_BASE;
+    data += count;
+    size -= count;
+  }
+  return (b << 16) | a;
+}
+
+// Returns the checksum of two consecutive buffers from their own checksums.
+unsigned int CombineAdler32(unsigned int adler1, unsigned int adler2, std::size_t size2)
+{
+  const unsigned int remainder = static_cast<unsigned int>(size2 % ADLER_BASE);
+  unsigned int sum1 = adler1 & 0xffff;
+  unsigned int sum2 = (remainder * sum1) % ADLER_BASE;
+  sum1 += (adler2 & 0xffff) + ADLER_BASE - 1;
+  sum2 += (adler1 >> 16) + (adler2 >> 16) + ADLER_BASE - remainder;
+  sum1 %= ADLER_BASE;
+  sum2 %= ADLER_BASE;
+  return (sum2 << 16) | sum1;
+}
+
+void AppendUInt32(ByteVector& out, unsigned int value)
+{
+  out.push_back(static_cast<unsigned char>(value >> 24));
+  out.push_back(static_cast<unsigned char>(value >> 16));
+  out.push_back(static_cast<unsigned char>(value >> 8));
+  out.push_back(static_cast<unsigned char>(value));
+}
+
+// Appends a PNG chunk with its length, type and checksum.
+void AppendPNGChunk(ByteVector& out, const char* type, const unsigned char* data, std::size_t size)
+{
+  AppendUInt32(out, static_cast<unsigned int>(size));
+  const std::size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data, data + size);
+  AppendUInt32(out, CRC32(&out[start], size + 4));
+}
+
+// Writes the least significant bits first, as deflate requires.
+class BitWriter
+{
+public:
+  BitWriter(ByteVector& out)
+    : Out(out)
+    , Buffer(0)
+    , Count(0)
+  {
+  }
+
+  void Write(unsigned int bits, unsigned int count)
+  {
+    this->Buffer |= static_cast<unsigned long long>(bits) << this->Count;
+    this->Count += count;
+    while (this->Count >= 8)
+    {
+      this->Out.push_back(static_cast<unsigned char>(this->Buffer));
+      this->Buffer >>= 8;
+      this->Count -= 8;
+    }
+  }
+
+  void Align()
+  {
+    if (this->Count > 0)
+    {
+      this->Out.push_back(static_cast<unsigned char>(this->Buffer));
+      this->Buffer = 0;
+      this->Count = 0;
+    }
+  }
+
+  void WriteBytes(const unsigned char* data, std::size_t size)
+  {
+    this->Out.insert(this->Out.end(), data, data + size);
+  }
+
+private:
+  ByteVector& Out;
+  unsigned long long Buffer;
+  unsigned int Count;
+};
+
+// Computes the code lengths of a Huffman code for the frequencies, limited
+// to maxLength bits. At least two symbols get a code so that the code is
+// complete, as some decoders require.
+void BuildCodeLengths(const std::vector<unsigned int>& frequencies,
+                      unsigned int maxLength,
+                      std::vector<unsigned char>& lengths)
+{
+  const std::size_t numSymbols = frequencies.size();
+  std::vector<unsigned long long> weights(frequencies.begin(), frequencies.end());
+  std::size_t numUsed = 0;
+  for (std::size_t i = 0; i < numSymbols; ++i)
+  {
+    numUsed += (weights[i] > 0) ? 1 : 0;
+  }
+  for (std::size_t i = 0; (numUsed < 2) && (i < numSymbols); ++i)
+  {
+    if (weights[i] == 0)
+    {
+      weights[i] = 1;
+      ++numUsed;
+    }
+  }
+
+  lengths.assign(numSymbols, 0);
+  while (true)
+  {
+    // Nodes below numSymbols are leaves, the others are internal nodes.
+    typedef std::pair<unsigned long long, std::size_t> Node;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+    for (std::size_t i = 0; i < numSymbols; ++i)
+    {
+      if (weights[i] > 0)
+      {
+        queue.push(Node(weights[i], i));
+      }
+    }
+
+    std::vector<std::size_t> parents(numSymbols, 0);
+    while (queue.size() > 1)
+    {
+      const Node first = queue.top();
+      queue.pop();
+      const Node second = queue.top();
+      queue.pop();
+      const std::size_t internal = parents.size();
+      parents.push_back(0);
+      parents[first.second] = internal;
+      parents[second.second] = internal;
+      queue.push(Node(first.first + second.first, internal));
+    }
+
+    // Internal nodes are created after their children, so the depths can be
+    // computed from the root down.
+    const std::size_t root = parents.size() - 1;
+    std::vector<unsigned int> depths(parents.size(), 0);
+    for (std::size_t node = root; node-- > numSymbols;)
+    {
+      depths[node] = depths[parents[node]] + 1;
+    }
+
+    unsigned int longest = 0;
+    for (std::size_t i = 0; i < numSymbols; ++i)
+    {
+      if (weights[i] > 0)
+      {
+        depths[i] = depths[parents[i]] + 1;
+        longest = std::max(longest, depths[i]);
+      }
+    }
+
+    if (longest <= maxLength)
+    {
+      for (std::size_t i = 0; i < numSymbols; ++i)
+      {
+        lengths[i] = static_cast<unsigned char>((weights[i] > 0) ? depths[i] : 0);
+      }
+      return;
+    }
+
+    // Flatten the distribution and try again.
+    for (std::size_t i = 0; i < numSymbols; ++i)
+    {
+      if (weights[i] > 0)
+      {
+        weights[i] = (weights[i] >> 1) | 1;
+      }
+    }
+  }
+}
+
+// Computes the canonical codes for the code lengths, with their bits
+// reversed so they can be written least significant bit first.
+void BuildCodes(const std::vector<unsigned char>& lengths, std::vector<unsigned short>& codes)
+{
+  unsigned int lengthCounts[16] = { 0 };
+  for (unsigned char length : lengths)
+  {
+    ++lengthCounts[length];
+  }
+  lengthCounts[0] = 0;
+
+  unsigned int nextCodes[16] = { 0 };
+  unsigned int code = 0;
+  for (unsigned int bits = 1; bits < 16; ++bits)
+  {
+    code = (code + lengthCounts[bits - 1]) << 1;
+    nextCodes[bits] = code;
+  }
+
+  codes.assign(lengths.size(), 0);
+  for (std::size_t i = 0; i < lengths.size(); ++i)
+  {
+    const unsigned int length = lengths[i];
+    if (length > 0)
+    {
+      const unsigned int value = nextCodes[length]++;
+      unsigned int reversed = 0;
+      for (unsigned int bit = 0; bit < length; ++bit)
+      {
+        reversed |= ((value >> bit) & 1) << (length - 1 - bit);
+      }
+      codes[i] = static_cast<unsigned short>(reversed);
+    }
+  }
+}
+
+unsigned int GetLengthCode(unsigned int length)
+{
+  return static_cast<unsigned int>(
+    std::upper_bound(LENGTH_BASE, LENGTH_BASE + 29, length) - LENGTH_BASE - 1);
+}
+
+unsigned int GetDistanceCode(unsigned int distance)
+{
+  return static_cast<unsigned int>(
+    std::upper_bound(DIST_BASE, DIST_BASE + 30, distance) - DIST_BASE - 1);
+}
+
+// A literal when Distance is zero, otherwise a match of Length bytes.
+struct LZSymbol
+{
+  unsigned short Length;
+  unsigned short Distance;
+};
+
+// Writes the symbols as one deflate block with dynamic Huffman codes, or as
+// stored blocks of the raw bytes they encode when that is smaller.
+void WriteBlock(BitWriter& writer,
+                const std::vector<LZSymbol>& symbols,
+                const unsigned char* raw,
+                std::size_t rawSize,
+                bool final)
+{
+  std::vector<unsigned int> litLenFrequencies(NUM_LITLEN_CODES, 0);
+  std::vector<unsigned int> distFrequencies(NUM_DIST_CODES, 0);
+  for (const LZSymbol& symbol : symbols)
+  {
+    if (symbol.Distance == 0)
+    {
+      ++litLenFrequencies[symbol.Length];
+    }
+    else
+    {
+      ++litLenFrequencies[257 + GetLengthCode(symbol.Length)];
+      ++distFrequencies[GetDistanceCode(symbol.Distance)];
+    }
+  }
+  litLenFrequencies[256] = 1;
+
+  std::vector<unsigned char> litLenLengths;
+  std::vector<unsigned char> distLengths;
+  BuildCodeLengths(litLenFrequencies, 15, litLenLengths);
+  BuildCodeLengths(distFrequencies, 15, distLengths);
+
+  unsigned int numLitLen = NUM_LITLEN_CODES;
+  while ((numLitLen > 257) && (litLenLengths[numLitLen - 1] == 0))
+  {
+    --numLitLen;
+  }
+  unsigned int numDist = NUM_DIST_CODES;
+  while ((numDist > 1) && (distLengths[numDist - 1] == 0))
+  {
+    --numDist;
+  }
+
+  // Run length encode the code lengths of both codes together.
+  std::vector<unsigned char> allLengths(litLenLengths.begin(), litLenLengths.begin() + numLitLen);
+  allLengths.insert(allLengths.end(), distLengths.begin(), distLengths.begin() + numDist);
+  std::vector<std::pair<unsigned char, unsigned char>> runs; // symbol, extra bits value
+  for (std::size_t i = 0; i < allLengths.size();)
+  {
+    const unsigned char value = allLengths[i];
+    std::size_t run = 1;
+    while ((i + run < allLengths.size()) && (allLengths[i + run] == value))
+    {
+      ++run;
+    }
+    i += run;
+
+    if (value == 0)
+    {
+      while (run >= 11)
+      {
+        const std::size_t count = std::min(run, std::size_t(138));
+        runs.push_back(std::make_pair(18, static_cast<unsigned char>(count - 11)));
+        run -= count;
+      }
+      if (run >= 3)
+      {
+        runs.push_back(std::make_pair(17, static_cast<unsigned char>(run - 3)));
+        run = 0;
+      }
+    }
+    else
+    {
+      runs.push_back(std::make_pair(value, 0));
+      --run;
+      while (run >= 3)
+      {
+        const std::size_t count = std::min(run, std::size_t(6));
+        runs.push_back(std::make_pair(16, static_cast<unsigned char>(count - 3)));
+        run -= count;
+      }
+    }
+    for (; run > 0; --run)
+    {
+      runs.push_back(std::make_pair(value, 0));
+    }
+  }
+
+  std::vector<unsigned int> codeLengthFrequencies(NUM_CODELENGTH_CODES, 0);
+  for (const auto& run : runs)
+  {
+    ++codeLengthFrequencies[run.first];
+  }
+  std::vector<unsigned char> codeLengthLengths;
+  BuildCodeLengths(codeLengthFrequencies, 7, codeLengthLengths);
+  unsigned int numCodeLength = NUM_CODELENGTH_CODES;
+  while ((numCodeLength > 4) && (codeLengthLengths[CODELENGTH_ORDER[numCodeLength - 1]] == 0))
+  {
+    --numCodeLength;
+  }
+
+  // Compare the size of the compressed block with storing the bytes.
+  std::size_t dynamicBits = 3 + 14 + 3 * numCodeLength;
+  for (const auto& run : runs)
+  {
+    dynamicBits += codeLengthLengths[run.first];
+    dynamicBits += (run.first == 16) ? 2 : ((run.first == 17) ? 3 : ((run.first == 18) ? 7 : 0));
+  }
+  for (std::size_t i = 0; i < NUM_LITLEN_CODES; ++i)
+  {
+    dynamicBits += static_cast<std::size_t>(litLenFrequencies[i]) * litLenLengths[i];
+    if (i >= 257)
+    {
+      dynamicBits += static_cast<std::size_t>(litLenFrequencies[i]) * LENGTH_EXTRA[i - 257];
+    }
+  }
+  for (std::size_t i = 0; i < NUM_DIST_CODES; ++i)
+  {
+    dynamicBits += static_cast<std::size_t>(distFrequencies[i]) * (distLengths[i] + DIST_EXTRA[i]);
+  }
+  const std::size_t storedBits = 8 * (rawSize + 5 * ((rawSize + 65534) / 65535 + 1));
+
+  if (storedBits <= dynamicBits)
+  {
+    std::size_t offset = 0;
+    do
+    {
+      const std::size_t size = std::min(rawSize - offset, std::size_t(65535));
+      const bool last = final && (offset + size == rawSize);
+      writer.Write(last ? 1 : 0, 3);
+      writer.Align();
+      const unsigned char header[4] = { static_cast<unsigned char>(size),
+                                        static_cast<unsigned char>(size >> 8),
+                                        static_cast<unsigned char>(~size),
+                                        static_cast<unsigned char>(~size >> 8) };
+      writer.WriteBytes(header, 4);
+      writer.WriteBytes(raw + offset, size);
+      offset += size;
+    } while (offset < rawSize);
+    return;
+  }
+
+  std::vector<unsigned short> litLenCodes;
+  std::vector<unsigned short> distCodes;
+  std::vector<unsigned short> codeLengthCodes;
+  BuildCodes(litLenLengths, litLenCodes);
+  BuildCodes(distLengths, distCodes);
+  BuildCodes(codeLengthLengths, codeLengthCodes);
+
+  writer.Write(final ? 1 : 0, 1);
+  writer.Write(2, 2);
+  writer.Write(numLitLen - 257, 5);
+  writer.Write(numDist - 1, 5);
+  writer.Write(numCodeLength - 4, 4);
+  for (unsigned int i = 0; i < numCodeLength; ++i)
+  {
+    writer.Write(codeLengthLengths[CODELENGTH_ORDER[i]], 3);
+  }
+  for (const auto& run : runs)
+  {
+    writer.Write(codeLengthCodes[run.first], codeLengthLengths[run.first]);
+    if (run.first >= 16)
+    {
+      writer.Write(run.second, (run.first == 16) ? 2 : ((run.first == 17) ? 3 : 7));
+    }
+  }
+
+  for (const LZSymbol& symbol : symbols)
+  {
+    if (symbol.Distance == 0)
+    {
+      writer.Write(litLenCodes[symbol.Length], litLenLengths[symbol.Length]);
+    }
+    else
+    {
+      const unsigned int lengthCode = GetLengthCode(symbol.Length);
+      writer.Write(litLenCodes[257 + lengthCode], litLenLengths[257 + lengthCode]);
+      writer.Write(symbol.Length - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+      const unsigned int distCode = GetDistanceCode(symbol.Distance);
+      writer.Write(distCodes[distCode], distLengths[distCode]);
+      writer.Write(symbol.Distance - DIST_BASE[distCode], DIST_EXTRA[distCode]);
+    }
+  }
+  writer.Write(litLenCodes[256], litLenLengths[256]);
+}
+
+// Returns the number of equal bytes at the start of a and b, up to maxLength.
+inline std::size_t MatchLength(const unsigned char* a,
+                               const unsigned char* b,
+                               std::size_t maxLength)
+{
+  std::size_t length = 0;
+  while (length + 8 <= maxLength)
+  {
+    unsigned long long wordA;
+    unsigned long long wordB;
+    std::memcpy(&wordA, a + length, 8);
+    std::memcpy(&wordB, b + length, 8);
+    if (wordA != wordB)
+    {
+      break;
+    }
+    length += 8;
+  }
+  while ((length < maxLength) && (a[length] == b[length]))
+  {
+    ++length;
+  }
+  return length;
+}
+
+inline unsigned int Hash(const unsigned char* data)
+{
+  const unsigned int value = (static_cast<unsigned int>(data[0]) << 16) |
+    (static_cast<unsigned int>(data[1]) << 8) | static_cast<unsigned int>(data[2]);
+  return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Compresses the data into raw deflate blocks with a greedy hash chain
+// matcher. Unless this is the last chunk of the stream, the output ends with
+// an empty stored block so the next chunk starts on a byte boundary.
+void Deflate(const unsigned char* data, std::size_t size, bool last, ByteVector& out)
+{
+  BitWriter writer(out);
+  std::vector<int> head(std::size_t(1) << HASH_BITS, -1);
+  std::vector<int> previous(size, -1);
+  std::vector<LZSymbol> symbols;
+  symbols.reserve(std::min(size, SYMBOLS_PER_BLOCK));
+
+  std::size_t blockStart = 0;
+  std::size_t pos = 0;
+  while (pos < size)
+  {
+    std::size_t bestLength = 0;
+    std::size_t bestDistance = 0;
+    if (pos + MIN_MATCH <= size)
+    {
+      const unsigned int hash = Hash(data + pos);
+      const std::size_t maxLength = std::min(MAX_MATCH, size - pos);
+      int candidate = head[hash];
+      for (int chain = 0; (candidate >= 0) && (chain < MAX_CHAIN); ++chain)
+      {
+        const std::size_t distance = pos - static_cast<std::size_t>(candidate);
+        if (distance > WINDOW_SIZE)
+        {
+          break;
+        }
+        const unsigned char* match = data + candidate;
+        if (match[bestLength] == data[pos + bestLength])
+        {
+          const std::size_t length = MatchLength(match, data + pos, maxLength);
+          if (length > bestLength)
+          {
+            bestLength = length;
+            bestDistance = distance;
+            if (length == maxLength)
+            {
+              break;
+            }
+          }
+        }
+        candidate = previous[static_cast<std::size_t>(candidate)];
+      }
+      previous[pos] = head[hash];
+      head[hash] = static_cast<int>(pos);
+    }
+
+    if (bestLength >= MIN_MATCH)
+    {
+      symbols.push_back(LZSymbol{ static_cast<unsigned short>(bestLength),
+                                  static_cast<unsigned short>(bestDistance) });
+      const std::size_t end = pos + bestLength;
+      for (++pos; (pos < end) && (pos + MIN_MATCH <= size); ++pos)
+      {
+        const unsigned int hash = Hash(data + pos);
+        previous[pos] = head[hash];
+        head[hash] = static_cast<int>(pos);
+      }
+      pos = end;
+    }
+    else
+    {
+      symbols.push_back(LZSymbol{ data[pos], 0 });
+      ++pos;
+    }
+
+    if (symbols.size() >= SYMBOLS_PER_BLOCK)
+    {
+      WriteBlock(writer, symbols, data + blockStart, pos - blockStart, last && (pos == size));
+      symbols.clear();
+      blockStart = pos;
+    }
+  }
+  if (!symbols.empty() || (blockStart == 0))
+  {
+    WriteBlock(writer, symbols, data + blockStart, pos - blockStart, last);
+  }
+
+  if (!last)
+  {
+    writer.Write(0, 3);
+    writer.Align();
+    const unsigned char emptyStored[4] = { 0x00, 0x00, 0xff, 0xff };
+    writer.WriteBytes(emptyStored, 4);
+  }
+  writer.Align();
+}
+
+inline unsigned char Paeth(unsigned char a, unsigned char b, unsigned char c)
+{
+  const int pa = std::abs(static_cast<int>(b) - static_cast<int>(c));
+  const int pb = std::abs(static_cast<int>(a) - static_cast<int>(c));
+  const int pc = std::abs(static_cast<int>(a) + static_cast<int>(b) - 2 * static_cast<int>(c));
+  const unsigned char bc = (pb <= pc) ? b : c;
+  return ((pa <= pb) && (pa <= pc)) ? a : bc;
+}
+
+// Returns the prediction of a filter from the bytes to the left (a), above (b)
+// and above left (c).
+inline unsigned char Predict(unsigned char filter,
+                             unsigned char a,
+                             unsigned char b,
+                             unsigned char c)
+{
+  switch (filter)
+  {
+    case 1:
+      return a;
+    case 2:
+      return b;
+    case 3:
+      return static_cast<unsigned char>((a + b) >> 1);
+    case 4:
+      return Paeth(a, b, c);
+    default:
+      return 0;
+  }
+}
+
+inline unsigned int Cost(unsigned char value)
+{
+  return static_cast<unsigned int>(std::abs(static_cast<int>(static_cast<signed char>(value))));
+}
+
+inline void AddCosts(unsigned char x,
+                     unsigned char a,
+                     unsigned char b,
+                     unsigned char c,
+                     unsigned long* sums)
+{
+  sums[0] += Cost(x);
+  sums[1] += Cost(static_cast<unsigned char>(x - a));
+  sums[2] += Cost(static_cast<unsigned char>(x - b));
+  sums[3] += Cost(static_cast<unsigned char>(x - ((a + b) >> 1)));
+  sums[4] += Cost(static_cast<unsigned char>(x - Paeth(a, b, c)));
+}
+
+// Picks the PNG filter with the smallest sum of absolute differences for the
+// row, the usual heuristic of encoders, and writes the filtered row. above
+// is the previous row, all zeros for the first row of the image.
+void FilterRow(const unsigned char* row,
+               const unsigned char* above,
+               std::size_t rowBytes,
+               std::size_t pixelBytes,
+               unsigned char* out)
+{
+  unsigned long sums[5] = { 0, 0, 0, 0, 0 };
+  // The first pixel has no left neighbor.
+  for (std::size_t i = 0; i < pixelBytes; ++i)
+  {
+    AddCosts(row[i], 0, above[i], 0, sums);
+  }
+  for (std::size_t i = pixelBytes; i < rowBytes; ++i)
+  {
+    AddCosts(row[i], row[i - pixelBytes], above[i], above[i - pixelBytes], sums);
+  }
+
+  unsigned char filter = 0;
+  for (unsigned char candidate = 1; candidate < 5; ++candidate)
+  {
+    if (sums[candidate] < sums[filter])
+    {
+      filter = candidate;
+    }
+  }
+
+  out[0] = filter;
+  out += 1;
+  for (std::size_t i = 0; i < pixelBytes; ++i)
+  {
+    out[i] = static_cast<unsigned char>(row[i] - Predict(filter, 0, above[i], 0));
+  }
+  switch (filter)
+  {
+    case 0:
+      std::memcpy(out + pixelBytes, row + pixelBytes, rowBytes - pixelBytes);
+      break;
+    case 1:
+      for (std::size_t i = pixelBytes; i < rowBytes; ++i)
+      {
+        out[i] = static_cast<unsigned char>(row[i] - row[i - pixelBytes]);
+      }
+      break;
+    case 2:
+      for (std::size_t i = pixelBytes; i < rowBytes; ++i)
+      {
+        out[i] = static_cast<unsigned char>(row[i] - above[i]);
+      }
+      break;
+    case 3:
+      for (std::size_t i = pixelBytes; i < rowBytes; ++i)
+      {
+        out[i] = static_cast<unsigned char>(row[i] - ((row[i - pixelBytes] + above[i]) >> 1));
+      }
+      break;
+    default:
+      for (std::size_t i = pixelBytes; i < rowBytes; ++i)
+      {
+        out[i] = static_cast<unsigned char>(
+          row[i] - Paeth(row[i - pixelBytes], above[i], above[i - pixelBytes]));
+      }
+      break;
+  }
+}
+
+struct EncodedChunk
+{
+  // A complete IDAT chunk of the PNG file.
+  ByteVector Data;
+  unsigned int Adler;
+  std::size_t FilteredSize;
+};
+
+struct EncodePNGFunctor : public vtkm::exec::FunctorBase
+{
+  const unsigned char* Image;
+  std::size_t Width;
+  std::size_t Height;
+  std::size_t PixelBytes;
+  std::size_t RowsPerChunk;
+  std::size_t NumberOfChunks;
+  EncodedChunk* Chunks;
+
+  // Copies a row of the RGBA input, dropping the alpha channel if needed.
+  void GetRow(std::size_t y, unsigned char* out) const
+  {
+    const unsigned char* row = this->Image + y * this->Width * 4;
+    if (this->PixelBytes == 4)
+    {
+      std::memcpy(out, row, this->Width * 4);
+      return;
+    }
+    for (std::size_t x = 0; x < this->Width; ++x)
+    {
+      out[3 * x] = row[4 * x];
+      out[3 * x + 1] = row[4 * x + 1];
+      out[3 * x + 2] = row[4 * x + 2];
+    }
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT
+  void operator()(vtkm::Id index) const
+  {
+    const std::size_t chunkIndex = static_cast<std::size_t>(index);
+    const std::size_t firstRow = chunkIndex * this->RowsPerChunk;
+    const std::size_t endRow = std::min(firstRow + this->RowsPerChunk, this->Height);
+    const std::size_t rowBytes = this->Width * this->PixelBytes;
+
+    ByteVector filtered((endRow - firstRow) * (rowBytes + 1));
+    // The row above the first row of the image is taken as zeros.
+    ByteVector rows(2 * rowBytes, 0);
+    unsigned char* row = &rows[0];
+    unsigned char* above = &rows[rowBytes];
+    if (firstRow > 0)
+    {
+      this->GetRow(firstRow - 1, above);
+    }
+    for (std::size_t y = firstRow; y < endRow; ++y)
+    {
+      this->GetRow(y, row);
+      FilterRow(row, above, rowBytes, this->PixelBytes, &filtered[(y - firstRow) * (rowBytes + 1)]);
+      std::swap(row, above);
+    }
+
+    EncodedChunk& chunk = this->Chunks[chunkIndex];
+    chunk.Adler = Adler32(&filtered[0], filtered.size());
+    chunk.FilteredSize = filtered.size();
+
+    ByteVector compressed;
+    compressed.reserve(filtered.size() / 2 + 64);
+    if (chunkIndex == 0)
+    {
+      // The zlib header: deflate with a 32K window, no dictionary.
+      compressed.push_back(0x78);
+      compressed.push_back(0x01);
+    }
+    Deflate(&filtered[0], filtered.size(), chunkIndex + 1 == this->NumberOfChunks, compressed);
+
+    chunk.Data.clear();
+    chunk.Data.reserve(compressed.size() + 12);
+    AppendPNGChunk(chunk.Data, "IDAT", compressed.data(), compressed.size());
+  }
+};
+
+} // anonymous namespace
+
+int EncodePNG(std::vector<unsigned char>& out_png,
+              const unsigned char* in_image,
+              unsigned long image_width,
+              unsigned long image_height,
+              bool save_alpha)
+{
+  out_png.clear();
+  if ((in_image == nullptr) || (image_width == 0) || (image_height == 0) ||
+      (image_width > 0x7fffffff) || (image_height > 0x7fffffff))
+  {
+    return 1;
+  }
+
+  const std::size_t width = static_cast<std::size_t>(image_width);
+  const std::size_t height = static_cast<std::size_t>(image_height);
+  const std::size_t pixelBytes = save_alpha ? 4 : 3;
+  const std::size_t rowsPerChunk = std::max(std::size_t(1), CHUNK_BYTES / (width * pixelBytes + 1));
+  const std::size_t numberOfChunks = (height + rowsPerChunk - 1) / rowsPerChunk;
+
+  std::vector<EncodedChunk> chunks(numberOfChunks);
+  EncodePNGFunctor functor;
+  functor.Image = in_image;
+  functor.Width = width;
+  functor.Height = height;
+  functor.PixelBytes = pixelBytes;
+  functor.RowsPerChunk = rowsPerChunk;
+  functor.NumberOfChunks = numberOfChunks;
+  functor.Chunks = &chunks[0];
+  vtkm::cont::DeviceAdapterAlgorithm<EncodePNGDeviceAdapterTag>::Schedule(
+    functor, static_cast<vtkm::Id>(numberOfChunks));
+
+  std::size_t totalSize = 8 + 25 + 16 + 12;
+  unsigned int adler = chunks[0].Adler;
+  for (std::size_t i = 0; i < numberOfChunks; ++i)
+  {
+    totalSize += chunks[i].Data.size();
+    if (i > 0)
+    {
+      adler = CombineAdler32(adler, chunks[i].Adler, chunks[i].FilteredSize);
+    }
+  }
+  out_png.reserve(totalSize);
+
+  const unsigned char signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+  out_png.insert(out_png.end(), signature, signature + 8);
+
+  ByteVector header;
+  AppendUInt32(header, static_cast<unsigned int>(image_width));
+  AppendUInt32(header, static_cast<unsigned int>(image_height));
+  header.push_back(8);                  // bit depth
+  header.push_back(save_alpha ? 6 : 2); // color type: RGBA or RGB
+  header.push_back(0);                  // compression method
+  header.push_back(0);                  // filter method
+  header.push_back(0);                  // no interlacing
+  AppendPNGChunk(out_png, "IHDR", header.data(), header.size());
+
+  for (const EncodedChunk& chunk : chunks)
+  {
+    out_png.insert(out_png.end(), chunk.Data.begin(), chunk.Data.end());
+  }
+
+  // The zlib stream ends with the checksum of all the filtered rows.
+  ByteVector trailer;
+  AppendUInt32(trailer, adler);
+  AppendPNGChunk(out_png, "IDAT", trailer.data(), trailer.size());
+  AppendPNGChunk(out_png, "IEND", nullptr, 0);
+
+  return 0;
+}
+}
+} // vtkm::rendering
@@ -0,0 +1,58 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_rendering_EncodePNG_h
+#define vtk_m_rendering_EncodePNG_h
+
+#include <vtkm/rendering/vtkm_rendering_export.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace vtkm
+{
+namespace rendering
+{
+
+/*
+EncodePNG: The counterpart of DecodePNG. Encodes an image to an in-memory PNG file.
+
+The rows of the image are filtered and compressed in independent chunks, in
+parallel when TBB is available. Each chunk holds a few hundred kilobytes of
+filtered rows and becomes its own IDAT chunk of the file, so the compression
+ratio is within a few percent of compressing the whole image at once.
+
+out_png: output parameter, the PNG file is written here. Previous contents are discarded.
+in_image: the image as 8-bit RGBA (4 bytes per pixel), row after row from the top.
+image_width: the width of the image in pixels.
+image_height: the height of the image in pixels.
+save_alpha: set to true to write an RGBA image, or false to drop the alpha
+  channel and write an RGB image.
+return: 0 if success, not 0 if some error occurred.
+*/
+VTKM_RENDERING_EXPORT
+int EncodePNG(std::vector<unsigned char>& out_png,
+              const unsigned char* in_image,
+              unsigned long image_width,
+              unsigned long image_height,
+              bool save_alpha = false);
+}
+} // vtkm::rendering
+
+#endif //vtk_m_rendering_EncodePNG_h
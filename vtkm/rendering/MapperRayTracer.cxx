@@ -42,10 +42,19 @@ struct MapperRayTracer::InternalsType
   vtkm::rendering::raytracing::Camera RayCamera;
   vtkm::rendering::raytracing::Ray<vtkm::Float32> Rays;
   bool CompositeBackground;
+
+  // The triangles of the last cell set rendered.
+  vtkm::cont::DynamicCellSet CellSet;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> Indices;
+  vtkm::Id NumberOfTriangles;
+  bool HasTriangles;
+
   VTKM_CONT
   InternalsType()
     : Canvas(nullptr)
     , CompositeBackground(true)
+    , NumberOfTriangles(0)
+    , HasTriangles(false)
   {
   }
 };
@@ -91,10 +100,20 @@ void MapperRayTracer::RenderCells(const vtkm::cont::DynamicCellSet& cellset,
   logger->OpenLogEntry("mapper_ray_tracer");
   vtkm::cont::Timer<> tot_timer;
   vtkm::cont::Timer<> timer;
-  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> indices;
-  vtkm::Id numberOfTriangles;
 
-  vtkm::rendering::internal::RunTriangulator(cellset, indices, numberOfTriangles);
+  // Cell sets share their storage when copied, so the same storage means the
+  // same cells. Keeping a copy of the cell set keeps the storage alive.
+  if (!this->Internals->HasTriangles ||
+      &this->Internals->CellSet.CastToBase() != &cellset.CastToBase())
+  {
+    this->Internals->Indices = vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>>();
+    vtkm::rendering::internal::RunTriangulator(
+      cellset, this->Internals->Indices, this->Internals->NumberOfTriangles);
+    this->Internals->CellSet = cellset;
+    this->Internals->HasTriangles = true;
+  }
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> indices = this->Internals->Indices;
+  vtkm::Id numberOfTriangles = this->Internals->NumberOfTriangles;
   vtkm::Float64 time = timer.GetElapsedTime();
   logger->AddLogData("triangulator", time);
   vtkm::rendering::raytracing::Camera& cam = this->Internals->Tracer.GetCamera();
@@ -134,6 +153,27 @@ void MapperRayTracer::SetCompositeBackground(bool on)
   this->Internals->CompositeBackground = on;
 }
 
+void MapperRayTracer::SetUseWideBVH(bool on)
+{
+  this->Internals->Tracer.SetUseWideBVH(on);
+}
+
+void MapperRayTracer::SetUsePacketTraversal(bool on)
+{
+  this->Internals->Tracer.SetUsePacketTraversal(on);
+}
+
+void MapperRayTracer::SetAllowBVHRefit(bool on)
+{
+  this->Internals->Tracer.SetAllowBVHRefit(on);
+}
+
+void MapperRayTracer::InvalidateCache()
+{
+  this->Internals->HasTriangles = false;
+  this->Internals->Tracer.InvalidateBVH();
+}
+
 void MapperRayTracer::StartScene()
 {
   // Nothing needs to be done.
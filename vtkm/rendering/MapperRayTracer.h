@@ -51,6 +51,27 @@ public:
   virtual void StartScene() override;
   virtual void EndScene() override;
   void SetCompositeBackground(bool on);
+
+  /// Builds an SAH refined 4-wide BVH instead of the default binary one. It
+  /// takes longer to build but is faster to traverse, especially for
+  /// clustered or anisotropic geometry.
+  void SetUseWideBVH(bool on);
+
+  /// Traces the rays of 8x8 pixel tiles together, fetching each BVH node and
+  /// triangle once for all of them. This is faster on CPUs, where primary rays
+  /// are coherent, and has no effect on CUDA.
+  void SetUsePacketTraversal(bool on);
+
+  /// The triangles and BVH of the last cell set and coordinates rendered are
+  /// kept, so rendering more views of the same data does not rebuild them.
+  /// When this is on, new coordinates for the same cell set refit the boxes
+  /// of the kept BVH instead of building a new one.
+  void SetAllowBVHRefit(bool on);
+
+  /// The kept triangles and BVH are matched to the cell set and coordinates
+  /// by identity, not by their values. After modifying the cells or points of
+  /// the rendered data in place, call this so the next render rebuilds them.
+  void InvalidateCache();
   vtkm::rendering::Mapper* NewCopy() const override;
 
 private:
@@ -20,9 +20,13 @@
 
 #include <math.h>
 
+#include <cstring>
+#include <vector>
+
 #include <vtkm/Math.h>
 #include <vtkm/VectorAnalysis.h>
 
+#include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
 #include <vtkm/cont/RuntimeDeviceTracker.h>
@@ -49,6 +53,35 @@ namespace raytracing
 {
 namespace detail
 {
+// An axis aligned box for the trees built or refit on the host.
+struct HostAABB
+{
+  vtkm::Vec<vtkm::Float32, 3> Min;
+  vtkm::Vec<vtkm::Float32, 3> Max;
+
+  HostAABB()
+    : Min(vtkm::Infinity32())
+    , Max(vtkm::NegativeInfinity32())
+  {
+  }
+
+  void Include(const HostAABB& other)
+  {
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      this->Min[i] = vtkm::Min(this->Min[i], other.Min[i]);
+      this->Max[i] = vtkm::Max(this->Max[i], other.Max[i]);
+    }
+  }
+
+  // Half of the surface area, which is all the SAH needs.
+  vtkm::Float32 HalfArea() const
+  {
+    vtkm::Vec<vtkm::Float32, 3> d = this->Max - this->Min;
+    return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+  }
+};
+
 class LinearBVHBuilder
 {
 public:
@@ -69,6 +102,8 @@ public:
   template <typename Device>
   class TreeBuilder;
 
+  class WideTreeBuilder;
+
   VTKM_CONT
   LinearBVHBuilder() {}
 
@@ -598,6 +633,199 @@ public:
   }
 }; // class TreeBuilder
 
+// Builds the 4-wide tree on the host. The binary tree it is collapsed from is
+// built top down with a binned SAH over the primitives in Morton order: the
+// candidate splits of a range are the boundaries of up to NUM_BINS bins
+// holding equal numbers of primitives. The primitives never move, so the
+// leaves keep the order of the sorted Morton codes.
+class LinearBVHBuilder::WideTreeBuilder
+{
+public:
+  using AABB = HostAABB;
+
+private:
+  enum : vtkm::Int32
+  {
+    NUM_BINS = 32,
+    // Deeper ranges are split in the middle, which bounds the depth of the
+    // tree, and so the traversal stack, to MAX_SAH_DEPTH + 32.
+    MAX_SAH_DEPTH = 32
+  };
+
+  struct Node
+  {
+    AABB Box;
+    vtkm::Int32 Children[2];
+  };
+
+  std::vector<AABB> Primitives;
+  std::vector<Node> Nodes;
+
+  const AABB& GetBox(vtkm::Int32 child) const
+  {
+    return (child < 0) ? this->Primitives[static_cast<std::size_t>(-child - 1)]
+                       : this->Nodes[static_cast<std::size_t>(child)].Box;
+  }
+
+  // Returns the index of the node built for the primitives [begin, end), or
+  // -(begin + 1) for a single primitive.
+  vtkm::Int32 BuildRange(vtkm::Int32 begin, vtkm::Int32 end, vtkm::Int32 depth)
+  {
+    const vtkm::Int32 count = end - begin;
+    if (count == 1)
+    {
+      return -begin - 1;
+    }
+
+    const vtkm::Int32 numBins = vtkm::Min(count, vtkm::Int32(NUM_BINS));
+    AABB binBoxes[NUM_BINS];
+    vtkm::Int32 binEnds[NUM_BINS];
+    for (vtkm::Int32 bin = 0; bin < numBins; ++bin)
+    {
+      binEnds[bin] = begin + static_cast<vtkm::Int32>(vtkm::Int64(count) * (bin + 1) / numBins);
+      for (vtkm::Int32 i = (bin == 0) ? begin : binEnds[bin - 1]; i < binEnds[bin]; ++i)
+      {
+        binBoxes[bin].Include(this->Primitives[static_cast<std::size_t>(i)]);
+      }
+    }
+
+    AABB rightBoxes[NUM_BINS];
+    rightBoxes[numBins - 1] = binBoxes[numBins - 1];
+    for (vtkm::Int32 bin = numBins - 2; bin >= 0; --bin)
+    {
+      rightBoxes[bin] = rightBoxes[bin + 1];
+      rightBoxes[bin].Include(binBoxes[bin]);
+    }
+
+    // Split before bin 'split'. Starting from the middle makes ties, such as
+    // degenerate boxes, give balanced trees.
+    vtkm::Int32 middle = begin + count / 2;
+    if (depth < MAX_SAH_DEPTH)
+    {
+      vtkm::Int32 split = numBins / 2;
+      AABB left;
+      vtkm::Float32 costs[NUM_BINS];
+      for (vtkm::Int32 bin = 1; bin < numBins; ++bin)
+      {
+        left.Include(binBoxes[bin - 1]);
+        costs[bin] = left.HalfArea() * vtkm::Float32(binEnds[bin - 1] - begin) +
+          rightBoxes[bin].HalfArea() * vtkm::Float32(end - binEnds[bin - 1]);
+      }
+      vtkm::Float32 bestCost = costs[split];
+      for (vtkm::Int32 bin = 1; bin < numBins; ++bin)
+      {
+        if (costs[bin] < bestCost)
+        {
+          bestCost = costs[bin];
+          split = bin;
+        }
+      }
+      middle = binEnds[split - 1];
+    }
+
+    const vtkm::Int32 index = static_cast<vtkm::Int32>(this->Nodes.size());
+    this->Nodes.push_back(Node());
+    this->Nodes.back().Box = rightBoxes[0];
+    const vtkm::Int32 leftChild = this->BuildRange(begin, middle, depth + 1);
+    const vtkm::Int32 rightChild = this->BuildRange(middle, end, depth + 1);
+    this->Nodes[static_cast<std::size_t>(index)].Children[0] = leftChild;
+    this->Nodes[static_cast<std::size_t>(index)].Children[1] = rightChild;
+    return index;
+  }
+
+  // Collapses the binary subtree rooted at 'node' into wide nodes. The
+  // children of a wide node are found by repeatedly opening the inner child
+  // with the largest surface area. Returns the offset of the wide node.
+  vtkm::Int32 EmitWideNode(vtkm::Int32 node,
+                           std::vector<vtkm::Vec<vtkm::Float32, 4>>& wideNodes) const
+  {
+    const Node& binaryNode = this->Nodes[static_cast<std::size_t>(node)];
+    vtkm::Int32 children[4] = { binaryNode.Children[0],
+                                binaryNode.Children[1],
+                                LinearBVH::WIDE_EMPTY_CHILD,
+                                LinearBVH::WIDE_EMPTY_CHILD };
+    vtkm::Int32 count = 2;
+    while (count < 4)
+    {
+      vtkm::Int32 open = -1;
+      vtkm::Float32 largestArea = -1.f;
+      for (vtkm::Int32 i = 0; i < count; ++i)
+      {
+        if (children[i] >= 0 && this->GetBox(children[i]).HalfArea() > largestArea)
+        {
+          largestArea = this->GetBox(children[i]).HalfArea();
+          open = i;
+        }
+      }
+      if (open == -1)
+      {
+        break;
+      }
+      const Node& opened = this->Nodes[static_cast<std::size_t>(children[open])];
+      children[open] = opened.Children[0];
+      children[count++] = opened.Children[1];
+    }
+
+    const std::size_t offset = wideNodes.size();
+    wideNodes.resize(offset + LinearBVH::WIDE_NODE_SIZE, vtkm::Vec<vtkm::Float32, 4>(0.f));
+    for (vtkm::Int32 i = 0; i < count; ++i)
+    {
+      const AABB& box = this->GetBox(children[i]);
+      wideNodes[offset + 0][i] = box.Min[0];
+      wideNodes[offset + 1][i] = box.Min[1];
+      wideNodes[offset + 2][i] = box.Min[2];
+      wideNodes[offset + 3][i] = box.Max[0];
+      wideNodes[offset + 4][i] = box.Max[1];
+      wideNodes[offset + 5][i] = box.Max[2];
+    }
+
+    for (vtkm::Int32 i = 0; i < count; ++i)
+    {
+      if (children[i] >= 0)
+      {
+        children[i] = this->EmitWideNode(children[i], wideNodes);
+      }
+    }
+    vtkm::Vec<vtkm::Float32, 4> childIndices;
+    memcpy(&childIndices[0], children, 4 * sizeof(vtkm::Int32));
+    wideNodes[offset + 6] = childIndices;
+    return static_cast<vtkm::Int32>(offset);
+  }
+
+public:
+  template <typename PortalType>
+  VTKM_CONT WideTreeBuilder(const PortalType& xmins,
+                            const PortalType& ymins,
+                            const PortalType& zmins,
+                            const PortalType& xmaxs,
+                            const PortalType& ymaxs,
+                            const PortalType& zmaxs)
+  {
+    const vtkm::Id numPrimitives = xmins.GetNumberOfValues();
+    this->Primitives.resize(static_cast<std::size_t>(numPrimitives));
+    for (vtkm::Id i = 0; i < numPrimitives; ++i)
+    {
+      AABB& box = this->Primitives[static_cast<std::size_t>(i)];
+      box.Min = vtkm::make_Vec(xmins.Get(i), ymins.Get(i), zmins.Get(i));
+      box.Max = vtkm::make_Vec(xmaxs.Get(i), ymaxs.Get(i), zmaxs.Get(i));
+    }
+  }
+
+  VTKM_CONT void Build(std::vector<vtkm::Vec<vtkm::Float32, 4>>& wideNodes)
+  {
+    wideNodes.clear();
+    const vtkm::Int32 numPrimitives = static_cast<vtkm::Int32>(this->Primitives.size());
+    if (numPrimitives < 2)
+    {
+      return;
+    }
+    this->Nodes.clear();
+    this->Nodes.reserve(static_cast<std::size_t>(numPrimitives - 1));
+    this->BuildRange(0, numPrimitives, 0);
+    this->EmitWideNode(0, wideNodes);
+  }
+}; // class WideTreeBuilder
+
 template <typename Device>
 VTKM_CONT void LinearBVHBuilder::SortAABBS(
   BVHData& bvh,
@@ -759,6 +987,27 @@ VTKM_CONT void LinearBVHBuilder::RunOnDevice(LinearBVH& linearBVH, Device device
   logger->AddLogData("sort_aabbs", time);
   timer.Reset();
 
+  if (linearBVH.GetUseWideTree())
+  {
+    WideTreeBuilder wideBuilder(bvh.xmins->GetPortalConstControl(),
+                                bvh.ymins->GetPortalConstControl(),
+                                bvh.zmins->GetPortalConstControl(),
+                                bvh.xmaxs->GetPortalConstControl(),
+                                bvh.ymaxs->GetPortalConstControl(),
+                                bvh.zmaxs->GetPortalConstControl());
+    std::vector<vtkm::Vec<vtkm::Float32, 4>> wideNodes;
+    wideBuilder.Build(wideNodes);
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Copy(vtkm::cont::make_ArrayHandle(wideNodes),
+                                                     linearBVH.FlatBVH);
+
+    time = timer.GetElapsedTime();
+    logger->AddLogData("build_wide_tree", time);
+
+    time = constructTimer.GetElapsedTime();
+    logger->CloseLogEntry(time);
+    return;
+  }
+
   vtkm::worklet::DispatcherMapField<TreeBuilder<Device>, Device>(
     TreeBuilder<Device>(bvh.mortonCodes, bvh.parent, bvh.GetNumberOfPrimitives()))
     .Invoke(bvh.leftChild, bvh.rightChild);
@@ -788,6 +1037,128 @@ VTKM_CONT void LinearBVHBuilder::RunOnDevice(LinearBVH& linearBVH, Device device
   time = constructTimer.GetElapsedTime();
   logger->CloseLogEntry(time);
 }
+
+// Refits the boxes of a constructed tree, of either layout, to new point
+// coordinates while keeping its topology. The tree is walked on the host.
+class LinearBVHRefitter
+{
+private:
+  using NodePortal = LinearBVH::InnerNodesHandle::PortalControl;
+  using LeafPortal = LinearBVH::LeafNodesHandle::PortalConstControl;
+  using PointPortal = vtkm::cont::ArrayHandleVirtualCoordinates::PortalConstControl;
+
+  NodePortal Nodes;
+  LeafPortal Leafs;
+  PointPortal Points;
+  bool WideTree;
+
+  // Matches the boxes made by LinearBVHBuilder::FindAABBs.
+  HostAABB GetLeafBox(vtkm::Int32 leaf) const
+  {
+    vtkm::Vec<vtkm::Int32, 4> indices = this->Leafs.Get(leaf);
+    HostAABB box;
+    for (vtkm::IdComponent i = 1; i < 4; ++i)
+    {
+      vtkm::Vec<vtkm::Float32, 3> point =
+        static_cast<vtkm::Vec<vtkm::Float32, 3>>(this->Points.Get(indices[i]));
+      HostAABB pointBox;
+      pointBox.Min = point;
+      pointBox.Max = point;
+      box.Include(pointBox);
+    }
+    const vtkm::Float32 minEpsilon = 1e-6f;
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      vtkm::Float32 epsilon = vtkm::Max(minEpsilon, AABB_EPSILON * (box.Max[i] - box.Min[i]));
+      box.Min[i] -= epsilon;
+      box.Max[i] += epsilon;
+    }
+    return box;
+  }
+
+  HostAABB RefitChild(vtkm::Int32 child) const
+  {
+    if (child < 0)
+    {
+      return this->GetLeafBox(-child - 1);
+    }
+    return (this->WideTree) ? this->RefitWideNode(child) : this->RefitBinaryNode(child);
+  }
+
+  HostAABB RefitBinaryNode(vtkm::Int32 node) const
+  {
+    vtkm::Vec<vtkm::Float32, 4> children = this->Nodes.Get(node + 3);
+    vtkm::Int32 leftChild;
+    memcpy(&leftChild, &children[0], 4);
+    vtkm::Int32 rightChild;
+    memcpy(&rightChild, &children[1], 4);
+
+    HostAABB left = this->RefitChild(leftChild);
+    HostAABB right = this->RefitChild(rightChild);
+    this->Nodes.Set(
+      node, vtkm::Vec<vtkm::Float32, 4>(left.Min[0], left.Min[1], left.Min[2], left.Max[0]));
+    this->Nodes.Set(
+      node + 1,
+      vtkm::Vec<vtkm::Float32, 4>(left.Max[1], left.Max[2], right.Min[0], right.Min[1]));
+    this->Nodes.Set(
+      node + 2,
+      vtkm::Vec<vtkm::Float32, 4>(right.Min[2], right.Max[0], right.Max[1], right.Max[2]));
+    left.Include(right);
+    return left;
+  }
+
+  HostAABB RefitWideNode(vtkm::Int32 node) const
+  {
+    vtkm::Vec<vtkm::Float32, 4> childIndices = this->Nodes.Get(node + 6);
+    vtkm::Int32 children[4];
+    memcpy(children, &childIndices[0], 4 * sizeof(vtkm::Int32));
+
+    vtkm::Vec<vtkm::Float32, 4> bounds[6];
+    for (vtkm::Int32 i = 0; i < 6; ++i)
+    {
+      bounds[i] = this->Nodes.Get(node + i);
+    }
+    HostAABB nodeBox;
+    for (vtkm::Int32 i = 0; i < 4; ++i)
+    {
+      if (children[i] == LinearBVH::WIDE_EMPTY_CHILD)
+      {
+        continue;
+      }
+      HostAABB box = this->RefitChild(children[i]);
+      for (vtkm::IdComponent j = 0; j < 3; ++j)
+      {
+        bounds[j][i] = box.Min[j];
+        bounds[j + 3][i] = box.Max[j];
+      }
+      nodeBox.Include(box);
+    }
+    for (vtkm::Int32 i = 0; i < 6; ++i)
+    {
+      this->Nodes.Set(node + i, bounds[i]);
+    }
+    return nodeBox;
+  }
+
+public:
+  VTKM_CONT
+  LinearBVHRefitter(LinearBVH& bvh)
+    : Nodes(bvh.FlatBVH.GetPortalControl())
+    , Leafs(bvh.LeafNodes.GetPortalConstControl())
+    , Points(bvh.GetCoordsHandle().GetPortalConstControl())
+    , WideTree(bvh.GetUseWideTree())
+  {
+  }
+
+  VTKM_CONT
+  void Run() const
+  {
+    if (this->Nodes.GetNumberOfValues() > 0)
+    {
+      this->RefitChild(0);
+    }
+  }
+}; // class LinearBVHRefitter
 } //namespace detail
 
 struct LinearBVH::ConstructFunctor
@@ -808,7 +1179,10 @@ struct LinearBVH::ConstructFunctor
 
 LinearBVH::LinearBVH()
   : IsConstructed(false)
-  , CanConstruct(false){};
+  , CanConstruct(false)
+  , UseWideTree(false)
+  , AllowRefit(false)
+  , NeedsRefit(false){};
 
 VTKM_CONT
 LinearBVH::LinearBVH(vtkm::cont::ArrayHandleVirtualCoordinates coordsHandle,
@@ -819,6 +1193,9 @@ LinearBVH::LinearBVH(vtkm::cont::ArrayHandleVirtualCoordinates coordsHandle,
   , Triangles(triangles)
   , IsConstructed(false)
   , CanConstruct(true)
+  , UseWideTree(false)
+  , AllowRefit(false)
+  , NeedsRefit(false)
 {
 }
 
@@ -832,6 +1209,9 @@ LinearBVH::LinearBVH(const LinearBVH& other)
   , Triangles(other.Triangles)
   , IsConstructed(other.IsConstructed)
   , CanConstruct(other.CanConstruct)
+  , UseWideTree(other.UseWideTree)
+  , AllowRefit(other.AllowRefit)
+  , NeedsRefit(other.NeedsRefit)
 {
 }
 template <typename Device>
@@ -844,7 +1224,7 @@ VTKM_CONT void LinearBVH::Allocate(const vtkm::Id& leafCount, Device deviceAdapt
 
 void LinearBVH::Construct()
 {
-  if (IsConstructed)
+  if (IsConstructed && !NeedsRefit)
     return;
   if (!CanConstruct)
     throw vtkm::cont::ErrorBadValue(
@@ -861,10 +1241,24 @@ void LinearBVH::SetData(vtkm::cont::ArrayHandleVirtualCoordinates coordsHandle,
                         vtkm::Bounds coordBounds)
 {
   CoordBounds = coordBounds;
+  if (IsConstructed && Triangles == triangles)
+  {
+    if (CoordsHandle == coordsHandle)
+    {
+      return;
+    }
+    if (AllowRefit && CoordsHandle.GetNumberOfValues() == coordsHandle.GetNumberOfValues())
+    {
+      CoordsHandle = coordsHandle;
+      NeedsRefit = true;
+      return;
+    }
+  }
   CoordsHandle = coordsHandle;
   Triangles = triangles;
   IsConstructed = false;
   CanConstruct = true;
+  NeedsRefit = false;
 }
 
 template <typename Device>
@@ -893,13 +1287,22 @@ void LinearBVH::ConstructOnDevice(Device device)
     builder.RunOnDevice(*this, device);
     IsConstructed = true;
   }
+  else if (NeedsRefit)
+  {
+    detail::LinearBVHRefitter refitter(*this);
+    refitter.Run();
+    logger->AddLogData("refit", timer.GetElapsedTime());
+  }
+  NeedsRefit = false;
 
   vtkm::Float64 time = timer.GetElapsedTime();
   logger->CloseLogEntry(time);
 }
 
-// explicitly export to workaround an intel compiler bug
-#if defined(VTKM_ICC)
+// Explicitly instantiate for the devices, since the ray tracer and the mesh
+// connectivity structures call this from other files. Optimized builds may
+// otherwise inline the only instantiation made here. This also works around
+// an intel compiler bug.
 template VTKM_CONT_EXPORT void LinearBVH::ConstructOnDevice<vtkm::cont::DeviceAdapterTagSerial>(
   vtkm::cont::DeviceAdapterTagSerial);
 #ifdef VTKM_ENABLE_TBB
@@ -910,13 +1313,47 @@ template VTKM_CONT_EXPORT void LinearBVH::ConstructOnDevice<vtkm::cont::DeviceAd
 template VTKM_CONT_EXPORT void LinearBVH::ConstructOnDevice<vtkm::cont::DeviceAdapterTagCuda>(
   vtkm::cont::DeviceAdapterTagCuda);
 #endif
-#endif
 
 VTKM_CONT
 bool LinearBVH::GetIsConstructed() const
 {
   return IsConstructed;
 }
+VTKM_CONT
+void LinearBVH::SetUseWideTree(bool useWideTree)
+{
+  if (UseWideTree != useWideTree)
+  {
+    UseWideTree = useWideTree;
+    IsConstructed = false;
+  }
+}
+
+VTKM_CONT
+bool LinearBVH::GetUseWideTree() const
+{
+  return UseWideTree;
+}
+
+VTKM_CONT
+void LinearBVH::SetAllowRefit(bool allowRefit)
+{
+  AllowRefit = allowRefit;
+}
+
+VTKM_CONT
+bool LinearBVH::GetAllowRefit() const
+{
+  return AllowRefit;
+}
+
+VTKM_CONT
+void LinearBVH::Invalidate()
+{
+  IsConstructed = false;
+  NeedsRefit = false;
+}
+
 VTKM_CONT
 vtkm::cont::ArrayHandleVirtualCoordinates LinearBVH::GetCoordsHandle() const
 {
@@ -34,9 +34,34 @@ namespace raytracing
 //
 // This is the data structure that is passed to the ray tracer.
 //
+// By default the inner nodes form a binary tree built from the Morton codes
+// of the triangles, and each node is stored in FlatBVH as four Float32 Vec4s:
+// the boxes of the left and right children followed by the child indices.
+//
+// With SetUseWideTree(true), the tree is instead built on the host by a
+// binned SAH over the Morton ordered triangles and collapsed to a 4-wide
+// tree. Each node then takes WIDE_NODE_SIZE Vec4s: the xmin, ymin, zmin,
+// xmax, ymax and zmax of its four children (one child per component),
+// followed by the four child indices, so a single node fetch tests four
+// boxes. Unused child slots hold WIDE_EMPTY_CHILD. In both layouts a
+// negative child index -(i + 1) refers to the leaf i in LeafNodes.
+//
+// Once constructed, the tree is kept as long as SetData is given the same
+// coordinate and triangle arrays, so rendering many views of the same data
+// builds it only once. With SetAllowRefit(true), new coordinates for the
+// same triangles only update the boxes of the existing tree. The arrays are
+// recognized by identity only, so after changing their values in place call
+// Invalidate to have the tree built again.
+//
 class VTKM_RENDERING_EXPORT LinearBVH
 {
 public:
+  enum : vtkm::Int32
+  {
+    WIDE_NODE_SIZE = 7,
+    WIDE_EMPTY_CHILD = -2000000000
+  };
+
   typedef vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> InnerNodesHandle;
   typedef vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Int32, 4>> LeafNodesHandle;
   InnerNodesHandle FlatBVH;
@@ -50,6 +75,9 @@ protected:
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> Triangles;
   bool IsConstructed;
   bool CanConstruct;
+  bool UseWideTree;
+  bool AllowRefit;
+  bool NeedsRefit;
 
 public:
   LinearBVH();
@@ -79,6 +107,30 @@ public:
   VTKM_CONT
   bool GetIsConstructed() const;
 
+  /// Discards the constructed tree so the next construct builds it again
+  /// from the current data. Call this after modifying the values of the
+  /// coordinate or triangle arrays in place.
+  VTKM_CONT
+  void Invalidate();
+
+  /// Selects the SAH refined 4-wide tree instead of the binary Morton code
+  /// tree. Changing it causes the next construct to rebuild the tree.
+  VTKM_CONT
+  void SetUseWideTree(bool useWideTree);
+
+  VTKM_CONT
+  bool GetUseWideTree() const;
+
+  /// When the coordinates given to SetData change but the triangles do not,
+  /// refit the boxes of the existing tree to the new coordinates instead of
+  /// building a new one. This is much cheaper, but the tree degrades if the
+  /// points move far relative to each other.
+  VTKM_CONT
+  void SetAllowRefit(bool allowRefit);
+
+  VTKM_CONT
+  bool GetAllowRefit() const;
+
   VTKM_CONT
   vtkm::cont::ArrayHandleVirtualCoordinates GetCoordsHandle() const;
 
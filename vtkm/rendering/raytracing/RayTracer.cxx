@@ -22,6 +22,7 @@
 #include <iostream>
 #include <math.h>
 #include <stdio.h>
+#include <type_traits>
 #include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
 #include <vtkm/cont/Timer.h>
 #include <vtkm/cont/TryExecute.h>
@@ -388,6 +389,7 @@ public:
 } // namespace detail
 
 RayTracer::RayTracer()
+  : UsePacketTraversal(false)
 {
 }
 
@@ -412,6 +414,35 @@ void RayTracer::SetData(const vtkm::cont::ArrayHandleVirtualCoordinates& coordsH
   Bvh.SetData(coordsHandle, indices, DataBounds);
 }
 
+void RayTracer::SetUseWideBVH(bool useWideBVH)
+{
+  Bvh.SetUseWideTree(useWideBVH);
+}
+
+bool RayTracer::GetUseWideBVH() const
+{
+  return Bvh.GetUseWideTree();
+}
+
+void RayTracer::SetUsePacketTraversal(bool usePacketTraversal)
+{
+  UsePacketTraversal = usePacketTraversal;
+}
+
+bool RayTracer::GetUsePacketTraversal() const
+{
+  return UsePacketTraversal;
+}
+
+void RayTracer::SetAllowBVHRefit(bool allowRefit)
+{
+  Bvh.SetAllowRefit(allowRefit);
+}
+
+void RayTracer::InvalidateBVH()
+{
+  Bvh.Invalidate();
+}
 
 void RayTracer::SetColorMap(const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& colorMap)
 {
@@ -478,7 +509,16 @@ void RayTracer::RenderOnDevice(Ray<Precision>& rays, Device)
     vtkm::cont::Timer<Device> timer;
     // Find distance to intersection
     TriangleIntersector<Device, TriLeafIntersector<Moller>> intersector;
-    intersector.run(rays, Bvh, CoordsHandle);
+    // Packets trade GPU thread parallelism for fewer node and triangle
+    // fetches, which only pays off on CPUs.
+    if (UsePacketTraversal && !std::is_same<Device, vtkm::cont::DeviceAdapterTagCuda>::value)
+    {
+      intersector.runPackets(rays, Bvh, CoordsHandle, camera.GetWidth());
+    }
+    else
+    {
+      intersector.run(rays, Bvh, CoordsHandle);
+    }
     time = timer.GetElapsedTime();
     logger->AddLogData("intersect", time);
     timer.Reset();
@@ -47,6 +47,7 @@ protected:
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> ColorMap;
   vtkm::Range ScalarRange;
   vtkm::Bounds DataBounds;
+  bool UsePacketTraversal;
   template <typename Precision>
   struct RenderFunctor;
 
@@ -68,6 +69,30 @@ public:
                const vtkm::Range& scalarRange,
                const vtkm::Bounds& dataBounds);
 
+  /// Renders with the SAH refined 4-wide BVH (see LinearBVH::SetUseWideTree).
+  VTKM_CONT
+  void SetUseWideBVH(bool useWideBVH);
+
+  VTKM_CONT
+  bool GetUseWideBVH() const;
+
+  /// Traces the rays of 8x8 pixel tiles of the camera image as packets,
+  /// which is faster on CPUs for primary rays. It has no effect on CUDA.
+  VTKM_CONT
+  void SetUsePacketTraversal(bool usePacketTraversal);
+
+  VTKM_CONT
+  bool GetUsePacketTraversal() const;
+
+  /// Refits the BVH when only the coordinates change (see
+  /// LinearBVH::SetAllowRefit).
+  VTKM_CONT
+  void SetAllowBVHRefit(bool allowRefit);
+
+  /// Rebuilds the BVH on the next render (see LinearBVH::Invalidate).
+  VTKM_CONT
+  void InvalidateBVH();
+
   VTKM_CONT
   void SetColorMap(const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& colorMap);
 
@@ -22,6 +22,9 @@
 #include <cstring>
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/ArrayHandleCompositeVector.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
 #include <vtkm/rendering/raytracing/BoundingVolumeHierarchy.h>
 #include <vtkm/rendering/raytracing/Ray.h>
 #include <vtkm/rendering/raytracing/RayOperations.h>
@@ -40,10 +43,41 @@ namespace
 
 enum : vtkm::Int32
 {
-  END_FLAG2 = -1000000000
+  END_FLAG2 = -1000000000,
+  // A wide tree is at most 63 levels deep, and each level pushes up to 3 nodes
+  STACK_SIZE = 192,
+  // The packet traversal traces the rays of 8x8 pixel tiles together
+  TILE_SIZE = 8,
+  PACKET_SIZE = TILE_SIZE * TILE_SIZE
 };
+static_assert(PACKET_SIZE <= 64, "The rays of a packet are masked with 64 bits");
 }
 
+// The rays traced together by the packet traversal, stored as structures of
+// arrays so the loops over the rays of a packet can be vectorized.
+template <typename Precision>
+struct RayPacket
+{
+  vtkm::Int32 Size;
+  Precision OriginX[PACKET_SIZE];
+  Precision OriginY[PACKET_SIZE];
+  Precision OriginZ[PACKET_SIZE];
+  Precision DirX[PACKET_SIZE];
+  Precision DirY[PACKET_SIZE];
+  Precision DirZ[PACKET_SIZE];
+  Precision InvDirX[PACKET_SIZE];
+  Precision InvDirY[PACKET_SIZE];
+  Precision InvDirZ[PACKET_SIZE];
+  Precision OriginDirX[PACKET_SIZE];
+  Precision OriginDirY[PACKET_SIZE];
+  Precision OriginDirZ[PACKET_SIZE];
+  Precision MinDistance[PACKET_SIZE];
+  Precision ClosestDistance[PACKET_SIZE];
+  Precision U[PACKET_SIZE];
+  Precision V[PACKET_SIZE];
+  vtkm::Id HitIndex[PACKET_SIZE];
+};
+
 template <typename TriIntersector>
 class TriLeafIntersector
 {
@@ -82,6 +116,53 @@ public:
       hitIndex = currentNode;
     }
   }
+
+  // Intersects the triangle of a leaf with the rays of a packet set in
+  // rayMask, so its points are only fetched once.
+  template <typename PointPortalType, typename LeafPortalType, typename Precision>
+  VTKM_EXEC inline void IntersectLeafPacket(const vtkm::Int32& currentNode,
+                                            const PointPortalType& points,
+                                            LeafPortalType Leafs,
+                                            RayPacket<Precision>& packet,
+                                            const vtkm::UInt64& rayMask) const
+  {
+    vtkm::Vec<Int32, 4> leafnode = Leafs.Get(currentNode);
+    vtkm::Vec<Precision, 3> a = vtkm::Vec<Precision, 3>(points.Get(leafnode[1]));
+    vtkm::Vec<Precision, 3> b = vtkm::Vec<Precision, 3>(points.Get(leafnode[2]));
+    vtkm::Vec<Precision, 3> c = vtkm::Vec<Precision, 3>(points.Get(leafnode[3]));
+    TriIntersector intersector;
+
+    for (vtkm::Int32 i = 0; i < packet.Size; ++i)
+    {
+      if ((rayMask & (vtkm::UInt64(1) << i)) == 0)
+      {
+        continue;
+      }
+      Precision distance = -1.;
+      Precision u, v;
+      intersector.IntersectTri(a,
+                               b,
+                               c,
+                               packet.DirX[i],
+                               packet.DirY[i],
+                               packet.DirZ[i],
+                               distance,
+                               u,
+                               v,
+                               packet.OriginX[i],
+                               packet.OriginY[i],
+                               packet.OriginZ[i]);
+
+      if (distance != -1. && distance < packet.ClosestDistance[i] &&
+          distance > packet.MinDistance[i])
+      {
+        packet.ClosestDistance[i] = distance;
+        packet.U[i] = u;
+        packet.V[i] = v;
+        packet.HitIndex[i] = currentNode;
+      }
+    }
+  }
 };
 
 class Moller
@@ -669,6 +750,197 @@ VTKM_EXEC inline bool IntersectAABB(const BVHPortalType& bvh,
   return (min0 > min1);
 }
 
+// Intersects the four child boxes of a wide node. The children that are hit
+// are moved to the front of 'children', nearest first, and their count is
+// returned.
+template <typename BVHPortalType, typename RayPrecision>
+VTKM_EXEC inline vtkm::Int32 IntersectWideAABB(const BVHPortalType& bvh,
+                                               const vtkm::Int32& currentNode,
+                                               const RayPrecision& originDirX,
+                                               const RayPrecision& originDirY,
+                                               const RayPrecision& originDirZ,
+                                               const RayPrecision& invDirx,
+                                               const RayPrecision& invDiry,
+                                               const RayPrecision& invDirz,
+                                               const RayPrecision& closestDistance,
+                                               vtkm::Vec<vtkm::Int32, 4>& children,
+                                               const RayPrecision& minDistance)
+{
+  vtkm::Vec<vtkm::Float32, 4> xmins = bvh.Get(currentNode);
+  vtkm::Vec<vtkm::Float32, 4> ymins = bvh.Get(currentNode + 1);
+  vtkm::Vec<vtkm::Float32, 4> zmins = bvh.Get(currentNode + 2);
+  vtkm::Vec<vtkm::Float32, 4> xmaxs = bvh.Get(currentNode + 3);
+  vtkm::Vec<vtkm::Float32, 4> ymaxs = bvh.Get(currentNode + 4);
+  vtkm::Vec<vtkm::Float32, 4> zmaxs = bvh.Get(currentNode + 5);
+  vtkm::Vec<vtkm::Float32, 4> childIndices = bvh.Get(currentNode + 6);
+  vtkm::Vec<vtkm::Int32, 4> allChildren;
+  memcpy(&allChildren[0], &childIndices[0], 16);
+
+  vtkm::Vec<RayPrecision, 4> distances;
+  vtkm::Int32 hitCount = 0;
+  for (vtkm::Int32 i = 0; i < 4; ++i)
+  {
+    RayPrecision xmin = xmins[i] * invDirx - originDirX;
+    RayPrecision ymin = ymins[i] * invDiry - originDirY;
+    RayPrecision zmin = zmins[i] * invDirz - originDirZ;
+    RayPrecision xmax = xmaxs[i] * invDirx - originDirX;
+    RayPrecision ymax = ymaxs[i] * invDiry - originDirY;
+    RayPrecision zmax = zmaxs[i] * invDirz - originDirZ;
+
+    RayPrecision tmin = vtkm::Max(
+      vtkm::Max(vtkm::Max(vtkm::Min(ymin, ymax), vtkm::Min(xmin, xmax)), vtkm::Min(zmin, zmax)),
+      minDistance);
+    RayPrecision tmax = vtkm::Min(
+      vtkm::Min(vtkm::Min(vtkm::Max(ymin, ymax), vtkm::Max(xmin, xmax)), vtkm::Max(zmin, zmax)),
+      closestDistance);
+    if (tmax >= tmin && allChildren[i] != LinearBVH::WIDE_EMPTY_CHILD)
+    {
+      // insertion sort by distance
+      vtkm::Int32 j = hitCount;
+      while (j > 0 && distances[j - 1] > tmin)
+      {
+        distances[j] = distances[j - 1];
+        children[j] = children[j - 1];
+        j--;
+      }
+      distances[j] = tmin;
+      children[j] = allChildren[i];
+      hitCount++;
+    }
+  }
+  return hitCount;
+}
+
+// Returns the rays of rayMask that hit a box before their closest hit, and
+// the nearest distance at which those rays enter the box.
+template <typename Precision>
+VTKM_EXEC inline vtkm::UInt64 IntersectPacketAABB(const RayPacket<Precision>& packet,
+                                                  const vtkm::UInt64& rayMask,
+                                                  const vtkm::Float32& xmin,
+                                                  const vtkm::Float32& ymin,
+                                                  const vtkm::Float32& zmin,
+                                                  const vtkm::Float32& xmax,
+                                                  const vtkm::Float32& ymax,
+                                                  const vtkm::Float32& zmax,
+                                                  Precision& nearest)
+{
+  vtkm::UInt64 hitMask = 0;
+  nearest = vtkm::Infinity<Precision>();
+  for (vtkm::Int32 i = 0; i < packet.Size; ++i)
+  {
+    const vtkm::UInt64 rayBit = vtkm::UInt64(1) << i;
+    if ((rayMask & rayBit) == 0)
+    {
+      continue;
+    }
+    Precision x0 = xmin * packet.InvDirX[i] - packet.OriginDirX[i];
+    Precision y0 = ymin * packet.InvDirY[i] - packet.OriginDirY[i];
+    Precision z0 = zmin * packet.InvDirZ[i] - packet.OriginDirZ[i];
+    Precision x1 = xmax * packet.InvDirX[i] - packet.OriginDirX[i];
+    Precision y1 = ymax * packet.InvDirY[i] - packet.OriginDirY[i];
+    Precision z1 = zmax * packet.InvDirZ[i] - packet.OriginDirZ[i];
+
+    Precision tmin =
+      vtkm::Max(vtkm::Max(vtkm::Max(vtkm::Min(y0, y1), vtkm::Min(x0, x1)), vtkm::Min(z0, z1)),
+                packet.MinDistance[i]);
+    Precision tmax =
+      vtkm::Min(vtkm::Min(vtkm::Min(vtkm::Max(y0, y1), vtkm::Max(x0, x1)), vtkm::Max(z0, z1)),
+                packet.ClosestDistance[i]);
+    if (tmax >= tmin)
+    {
+      hitMask |= rayBit;
+      nearest = vtkm::Min(nearest, tmin);
+    }
+  }
+  return hitMask;
+}
+
+// Packet version of IntersectAABB. The masks of the children hold the rays of
+// rayMask that hit them.
+template <typename BVHPortalType, typename Precision>
+VTKM_EXEC inline bool IntersectAABBPacket(const BVHPortalType& bvh,
+                                          const vtkm::Int32& currentNode,
+                                          const RayPacket<Precision>& packet,
+                                          const vtkm::UInt64& rayMask,
+                                          vtkm::UInt64& leftMask,
+                                          vtkm::UInt64& rightMask)
+{
+  vtkm::Vec<vtkm::Float32, 4> first4 = bvh.Get(currentNode);
+  vtkm::Vec<vtkm::Float32, 4> second4 = bvh.Get(currentNode + 1);
+  vtkm::Vec<vtkm::Float32, 4> third4 = bvh.Get(currentNode + 2);
+
+  Precision nearest0, nearest1;
+  leftMask = IntersectPacketAABB(packet,
+                                 rayMask,
+                                 first4[0],
+                                 first4[1],
+                                 first4[2],
+                                 first4[3],
+                                 second4[0],
+                                 second4[1],
+                                 nearest0);
+  rightMask = IntersectPacketAABB(packet,
+                                  rayMask,
+                                  second4[2],
+                                  second4[3],
+                                  third4[0],
+                                  third4[1],
+                                  third4[2],
+                                  third4[3],
+                                  nearest1);
+  return (nearest0 > nearest1);
+}
+
+// Packet version of IntersectWideAABB.
+template <typename BVHPortalType, typename Precision>
+VTKM_EXEC inline vtkm::Int32 IntersectWideAABBPacket(const BVHPortalType& bvh,
+                                                     const vtkm::Int32& currentNode,
+                                                     const RayPacket<Precision>& packet,
+                                                     const vtkm::UInt64& rayMask,
+                                                     vtkm::Vec<vtkm::Int32, 4>& children,
+                                                     vtkm::Vec<vtkm::UInt64, 4>& childMasks)
+{
+  vtkm::Vec<vtkm::Float32, 4> xmins = bvh.Get(currentNode);
+  vtkm::Vec<vtkm::Float32, 4> ymins = bvh.Get(currentNode + 1);
+  vtkm::Vec<vtkm::Float32, 4> zmins = bvh.Get(currentNode + 2);
+  vtkm::Vec<vtkm::Float32, 4> xmaxs = bvh.Get(currentNode + 3);
+  vtkm::Vec<vtkm::Float32, 4> ymaxs = bvh.Get(currentNode + 4);
+  vtkm::Vec<vtkm::Float32, 4> zmaxs = bvh.Get(currentNode + 5);
+  vtkm::Vec<vtkm::Float32, 4> childIndices = bvh.Get(currentNode + 6);
+  vtkm::Vec<vtkm::Int32, 4> allChildren;
+  memcpy(&allChildren[0], &childIndices[0], 16);
+
+  vtkm::Vec<Precision, 4> distances;
+  vtkm::Int32 hitCount = 0;
+  for (vtkm::Int32 i = 0; i < 4; ++i)
+  {
+    if (allChildren[i] == LinearBVH::WIDE_EMPTY_CHILD)
+    {
+      continue;
+    }
+    Precision nearest;
+    vtkm::UInt64 hitMask = IntersectPacketAABB(
+      packet, rayMask, xmins[i], ymins[i], zmins[i], xmaxs[i], ymaxs[i], zmaxs[i], nearest);
+    if (hitMask != 0)
+    {
+      // insertion sort by distance
+      vtkm::Int32 j = hitCount;
+      while (j > 0 && distances[j - 1] > nearest)
+      {
+        distances[j] = distances[j - 1];
+        children[j] = children[j - 1];
+        childMasks[j] = childMasks[j - 1];
+        j--;
+      }
+      distances[j] = nearest;
+      children[j] = allChildren[i];
+      childMasks[j] = hitMask;
+      hitCount++;
+    }
+  }
+  return hitCount;
+}
+
 template <typename T>
 VTKM_EXEC inline void swap(T& a, T& b)
 {
@@ -717,6 +989,7 @@ public:
   private:
     LeafIntesectorType LeafIntersector;
     bool Occlusion;
+    bool WideTree;
     Float4ArrayPortal FlatBVH;
     Int4ArrayPortal Leafs;
     VTKM_EXEC
@@ -737,6 +1010,7 @@ public:
     VTKM_CONT
     Intersector(bool occlusion, LinearBVH& bvh)
       : Occlusion(occlusion)
+      , WideTree(bvh.GetUseWideTree())
       , FlatBVH(bvh.FlatBVH.PrepareForInput(Device()))
       , Leafs(bvh.LeafNodes.PrepareForInput(Device()))
     {
@@ -776,7 +1050,7 @@ public:
       Precision invDirz = rcp_safe(dirz);
       vtkm::Int32 currentNode;
 
-      vtkm::Int32 todo[64];
+      vtkm::Int32 todo[STACK_SIZE];
       vtkm::Int32 stackptr = 0;
       vtkm::Int32 barrier = END_FLAG2;
       currentNode = 0;
@@ -791,7 +1065,37 @@ public:
       Precision originDirZ = originZ * invDirz;
       while (currentNode != END_FLAG2)
       {
-        if (currentNode > -1)
+        if (currentNode > -1 && WideTree)
+        {
+          vtkm::Vec<vtkm::Int32, 4> children;
+          vtkm::Int32 hitCount = IntersectWideAABB(FlatBVH,
+                                                   currentNode,
+                                                   originDirX,
+                                                   originDirY,
+                                                   originDirZ,
+                                                   invDirx,
+                                                   invDiry,
+                                                   invDirz,
+                                                   closestDistance,
+                                                   children,
+                                                   minDistance);
+          if (hitCount == 0)
+          {
+            currentNode = todo[stackptr];
+            stackptr--;
+          }
+          else
+          {
+            // visit the nearest child next and the others in order after it
+            for (vtkm::Int32 i = hitCount - 1; i > 0; --i)
+            {
+              stackptr++;
+              todo[stackptr] = children[i];
+            }
+            currentNode = children[0];
+          }
+        }
+        else if (currentNode > -1)
         {
 
 
@@ -871,6 +1175,7 @@ public:
   {
   private:
     bool Occlusion;
+    bool WideTree;
     Float4ArrayPortal FlatBVH;
     Int4ArrayPortal Leafs;
     LeafIntesectorType LeafIntersector;
@@ -893,6 +1198,7 @@ public:
     VTKM_CONT
     IntersectorHitIndex(bool occlusion, LinearBVH& bvh)
       : Occlusion(occlusion)
+      , WideTree(bvh.GetUseWideTree())
       , FlatBVH(bvh.FlatBVH.PrepareForInput(Device()))
       , Leafs(bvh.LeafNodes.PrepareForInput(Device()))
     {
@@ -925,7 +1231,7 @@ public:
       Precision invDirz = rcp_safe(dirz);
       int currentNode;
 
-      vtkm::Int32 todo[64];
+      vtkm::Int32 todo[STACK_SIZE];
       vtkm::Int32 stackptr = 0;
       vtkm::Int32 barrier = END_FLAG2;
       currentNode = 0;
@@ -940,7 +1246,37 @@ public:
       Precision originDirZ = originZ * invDirz;
       while (currentNode != END_FLAG2)
       {
-        if (currentNode > -1)
+        if (currentNode > -1 && WideTree)
+        {
+          vtkm::Vec<vtkm::Int32, 4> children;
+          vtkm::Int32 hitCount = IntersectWideAABB(FlatBVH,
+                                                   currentNode,
+                                                   originDirX,
+                                                   originDirY,
+                                                   originDirZ,
+                                                   invDirx,
+                                                   invDiry,
+                                                   invDirz,
+                                                   closestDistance,
+                                                   children,
+                                                   minDistance);
+          if (hitCount == 0)
+          {
+            currentNode = todo[stackptr];
+            stackptr--;
+          }
+          else
+          {
+            // visit the nearest child next and the others in order after it
+            for (vtkm::Int32 i = hitCount - 1; i > 0; --i)
+            {
+              stackptr++;
+              todo[stackptr] = children[i];
+            }
+            currentNode = children[0];
+          }
+        }
+        else if (currentNode > -1)
         {
           bool hitLeftChild, hitRightChild;
           bool rightCloser = IntersectAABB(FlatBVH,
@@ -1018,6 +1354,223 @@ public:
 
   }; //class Intersector
 
+  // Traces the rays of a packet together: a node is visited when any ray of
+  // the packet hits it, and each node and triangle is fetched once for all
+  // the rays. This pays off on CPUs for coherent rays, such as the primary
+  // rays of a tile of pixels. A mask of the rays that hit each node is kept
+  // with it, so a ray only tests the boxes and triangles that per-ray
+  // traversal would and finds the same hits.
+  template <typename Precision>
+  class PacketIntersector : public vtkm::worklet::WorkletMapField
+  {
+  private:
+    bool WideTree;
+    Float4ArrayPortal FlatBVH;
+    Int4ArrayPortal Leafs;
+    LeafIntesectorType LeafIntersector;
+
+    VTKM_EXEC
+    inline Precision rcp_safe(Precision f) const
+    {
+      return Precision(1) / ((vtkm::Abs(f) < 1e-8f) ? Precision(1e-8f) : f);
+    }
+
+  public:
+    VTKM_CONT
+    PacketIntersector(LinearBVH& bvh)
+      : WideTree(bvh.GetUseWideTree())
+      , FlatBVH(bvh.FlatBVH.PrepareForInput(Device()))
+      , Leafs(bvh.LeafNodes.PrepareForInput(Device()))
+    {
+    }
+    typedef void ControlSignature(FieldIn<>,
+                                  WholeArrayIn<>,
+                                  WholeArrayIn<>,
+                                  WholeArrayIn<>,
+                                  WholeArrayIn<>,
+                                  WholeArrayIn<>,
+                                  WholeArrayOut<>,
+                                  WholeArrayOut<>,
+                                  WholeArrayOut<>,
+                                  WholeArrayOut<>,
+                                  WholeArrayIn<Vec3RenderingTypes>);
+    typedef void ExecutionSignature(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11);
+
+    template <typename RayIdPortalType,
+              typename VecPortalType,
+              typename InPortalType,
+              typename OutPortalType,
+              typename HitPortalType,
+              typename PointPortalType>
+    VTKM_EXEC void operator()(const vtkm::Id& packetStart,
+                              const RayIdPortalType& rayIds,
+                              const VecPortalType& rayDirs,
+                              const VecPortalType& rayOrigins,
+                              const InPortalType& minDistances,
+                              const InPortalType& maxDistances,
+                              const OutPortalType& distances,
+                              const OutPortalType& minUs,
+                              const OutPortalType& minVs,
+                              const HitPortalType& hitIndices,
+                              const PointPortalType& points) const
+    {
+      RayPacket<Precision> packet;
+      packet.Size = static_cast<vtkm::Int32>(
+        vtkm::Min(vtkm::Id(PACKET_SIZE), rayIds.GetNumberOfValues() - packetStart));
+      for (vtkm::Int32 i = 0; i < packet.Size; ++i)
+      {
+        vtkm::Id rayId = rayIds.Get(packetStart + i);
+        vtkm::Vec<Precision, 3> dir = rayDirs.Get(rayId);
+        vtkm::Vec<Precision, 3> origin = rayOrigins.Get(rayId);
+        packet.DirX[i] = dir[0];
+        packet.DirY[i] = dir[1];
+        packet.DirZ[i] = dir[2];
+        packet.OriginX[i] = origin[0];
+        packet.OriginY[i] = origin[1];
+        packet.OriginZ[i] = origin[2];
+        packet.InvDirX[i] = rcp_safe(dir[0]);
+        packet.InvDirY[i] = rcp_safe(dir[1]);
+        packet.InvDirZ[i] = rcp_safe(dir[2]);
+        packet.OriginDirX[i] = origin[0] * packet.InvDirX[i];
+        packet.OriginDirY[i] = origin[1] * packet.InvDirY[i];
+        packet.OriginDirZ[i] = origin[2] * packet.InvDirZ[i];
+        packet.MinDistance[i] = minDistances.Get(rayId);
+        packet.ClosestDistance[i] = maxDistances.Get(rayId);
+        packet.U[i] = 0.f;
+        packet.V[i] = 0.f;
+        packet.HitIndex[i] = -1;
+      }
+
+      vtkm::Int32 todo[STACK_SIZE];
+      vtkm::UInt64 todoMask[STACK_SIZE];
+      vtkm::Int32 stackptr = 0;
+      vtkm::Int32 barrier = END_FLAG2;
+      vtkm::Int32 currentNode = 0;
+      vtkm::UInt64 currentMask = (packet.Size == PACKET_SIZE)
+        ? ~vtkm::UInt64(0)
+        : (vtkm::UInt64(1) << packet.Size) - 1;
+
+      todo[stackptr] = barrier;
+      todoMask[stackptr] = 0;
+
+      while (currentNode != END_FLAG2)
+      {
+        if (currentNode > -1 && WideTree)
+        {
+          vtkm::Vec<vtkm::Int32, 4> children;
+          vtkm::Vec<vtkm::UInt64, 4> childMasks;
+          vtkm::Int32 hitCount = IntersectWideAABBPacket(
+            FlatBVH, currentNode, packet, currentMask, children, childMasks);
+          if (hitCount == 0)
+          {
+            currentNode = todo[stackptr];
+            currentMask = todoMask[stackptr];
+            stackptr--;
+          }
+          else
+          {
+            // visit the nearest child next and the others in order after it
+            for (vtkm::Int32 i = hitCount - 1; i > 0; --i)
+            {
+              stackptr++;
+              todo[stackptr] = children[i];
+              todoMask[stackptr] = childMasks[i];
+            }
+            currentNode = children[0];
+            currentMask = childMasks[0];
+          }
+        }
+        else if (currentNode > -1)
+        {
+          vtkm::UInt64 leftMask, rightMask;
+          bool rightCloser =
+            IntersectAABBPacket(FlatBVH, currentNode, packet, currentMask, leftMask, rightMask);
+          bool hitLeftChild = (leftMask != 0);
+          bool hitRightChild = (rightMask != 0);
+
+          if (!hitLeftChild && !hitRightChild)
+          {
+            currentNode = todo[stackptr];
+            currentMask = todoMask[stackptr];
+            stackptr--;
+          }
+          else
+          {
+            vtkm::Vec<vtkm::Float32, 4> children = FlatBVH.Get(currentNode + 3);
+            vtkm::Int32 leftChild;
+            memcpy(&leftChild, &children[0], 4);
+            vtkm::Int32 rightChild;
+            memcpy(&rightChild, &children[1], 4);
+            currentNode = (hitLeftChild) ? leftChild : rightChild;
+            currentMask = (hitLeftChild) ? leftMask : rightMask;
+            if (hitLeftChild && hitRightChild)
+            {
+              if (rightCloser)
+              {
+                currentNode = rightChild;
+                currentMask = rightMask;
+                stackptr++;
+                todo[stackptr] = leftChild;
+                todoMask[stackptr] = leftMask;
+              }
+              else
+              {
+                stackptr++;
+                todo[stackptr] = rightChild;
+                todoMask[stackptr] = rightMask;
+              }
+            }
+          }
+        } // if inner node
+
+        if (currentNode < 0 && currentNode != barrier)
+        {
+          currentNode = -currentNode - 1; //swap the neg address
+          LeafIntersector.IntersectLeafPacket(currentNode, points, Leafs, packet, currentMask);
+          currentNode = todo[stackptr];
+          currentMask = todoMask[stackptr];
+          stackptr--;
+        } // if leaf node
+
+      } //while
+
+      for (vtkm::Int32 i = 0; i < packet.Size; ++i)
+      {
+        vtkm::Id rayId = rayIds.Get(packetStart + i);
+        distances.Set(rayId, packet.ClosestDistance[i]);
+        minUs.Set(rayId, packet.U[i]);
+        minVs.Set(rayId, packet.V[i]);
+        hitIndices.Set(rayId, packet.HitIndex[i]);
+      }
+    } // ()
+  };  //class PacketIntersector
+
+  // Sorts the rays of the same tile of pixels next to each other.
+  class TileKey : public vtkm::worklet::WorkletMapField
+  {
+  private:
+    vtkm::Id Width;
+    vtkm::Id TilesPerRow;
+
+  public:
+    VTKM_CONT
+    TileKey(vtkm::Id width)
+      : Width(width)
+      , TilesPerRow((width + TILE_SIZE - 1) / TILE_SIZE)
+    {
+    }
+    typedef void ControlSignature(FieldIn<>, FieldOut<>);
+    typedef void ExecutionSignature(_1, _2);
+    VTKM_EXEC
+    void operator()(const vtkm::Id& pixelIndex, vtkm::Id& key) const
+    {
+      vtkm::Id x = pixelIndex % Width;
+      vtkm::Id y = pixelIndex / Width;
+      vtkm::Id tile = (y / TILE_SIZE) * TilesPerRow + x / TILE_SIZE;
+      key = tile * PACKET_SIZE + (y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE;
+    }
+  }; //class TileKey
+
   class CellIndexFilter : public vtkm::worklet::WorkletMapField
   {
   protected:
@@ -1059,6 +1612,51 @@ public:
               coordsHandle);
   }
 
+  // Same as run, but traces the rays in packets of 8x8 pixel tiles of an
+  // image imageWidth pixels wide. If imageWidth is 0, the rays are traced in
+  // packets of consecutive rays.
+  template <typename DynamicCoordType, typename Precision>
+  VTKM_CONT void runPackets(Ray<Precision>& rays,
+                            LinearBVH& bvh,
+                            DynamicCoordType coordsHandle,
+                            vtkm::Id imageWidth)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<Device>;
+
+    vtkm::cont::ArrayHandle<vtkm::Id> rayIds;
+    Algorithm::Copy(vtkm::cont::ArrayHandleIndex(rays.NumRays), rayIds);
+    if (imageWidth > 0)
+    {
+      vtkm::cont::ArrayHandle<vtkm::Id> tileKeys;
+      vtkm::worklet::DispatcherMapField<TileKey, Device>(TileKey(imageWidth))
+        .Invoke(rays.PixelIdx, tileKeys);
+      Algorithm::SortByKey(tileKeys, rayIds);
+    }
+
+    // the results are scattered back by ray id, so the outputs must already
+    // be allocated (U and V are not unless intersection data is enabled)
+    rays.Distance.PrepareForOutput(rays.NumRays, Device());
+    rays.U.PrepareForOutput(rays.NumRays, Device());
+    rays.V.PrepareForOutput(rays.NumRays, Device());
+    rays.HitIdx.PrepareForOutput(rays.NumRays, Device());
+
+    vtkm::Id numberOfPackets = (rays.NumRays + PACKET_SIZE - 1) / PACKET_SIZE;
+    vtkm::cont::ArrayHandleCounting<vtkm::Id> packetStarts(0, PACKET_SIZE, numberOfPackets);
+    vtkm::worklet::DispatcherMapField<PacketIntersector<Precision>, Device>(
+      PacketIntersector<Precision>(bvh))
+      .Invoke(packetStarts,
+              rayIds,
+              rays.Dir,
+              rays.Origin,
+              rays.MinDistance,
+              rays.MaxDistance,
+              rays.Distance,
+              rays.U,
+              rays.V,
+              rays.HitIdx,
+              coordsHandle);
+  }
+
   template <typename DynamicCoordType, typename Precision>
   VTKM_CONT void runHitOnly(Ray<Precision>& rays,
                             LinearBVH& bvh,
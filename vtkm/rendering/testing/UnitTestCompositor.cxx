@@ -0,0 +1,379 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/MultiBlock.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/rendering/CanvasRayTracer.h>
+#include <vtkm/rendering/Compositor.h>
+#include <vtkm/rendering/MapperRayTracer.h>
+
+#include <vector>
+
+#if defined(VTKM_ENABLE_MPI)
+// clang-format off
+#include <vtkm/thirdparty/diy/Configure.h>
+#include VTKM_DIY(diy/mpi.hpp)
+// clang-format on
+#endif
+
+namespace
+{
+
+// With MPI, every rank adds the same images and rank 0 checks the result.
+int GetRank()
+{
+#if defined(VTKM_ENABLE_MPI)
+  return vtkm::cont::EnvironmentTracker::GetCommunicator().rank();
+#else
+  return 0;
+#endif
+}
+
+int GetNumberOfRanks()
+{
+#if defined(VTKM_ENABLE_MPI)
+  return vtkm::cont::EnvironmentTracker::GetCommunicator().size();
+#else
+  return 1;
+#endif
+}
+
+const vtkm::Id WIDTH = 8;
+const vtkm::Id HEIGHT = 6;
+
+// Fills a canvas with one color, and a depth that is near on the columns
+// below nearColumns and far elsewhere.
+void FillCanvas(vtkm::rendering::Canvas& canvas,
+                const vtkm::Vec<vtkm::Float32, 4>& color,
+                vtkm::Id nearColumns,
+                vtkm::Float32 nearDepth)
+{
+  auto colors = canvas.GetColorBuffer().GetPortalControl();
+  auto depths = canvas.GetDepthBuffer().GetPortalControl();
+  for (vtkm::Id i = 0; i < WIDTH * HEIGHT; ++i)
+  {
+    colors.Set(i, color);
+    depths.Set(i, (i % WIDTH < nearColumns) ? nearDepth : 1.f);
+  }
+}
+
+void TestZBuffer()
+{
+  std::cout << "Testing z-buffer compositing" << std::endl;
+  const vtkm::Vec<vtkm::Float32, 4> red(1.f, 0.f, 0.f, 1.f);
+  const vtkm::Vec<vtkm::Float32, 4> green(0.f, 1.f, 0.f, 1.f);
+  const vtkm::Vec<vtkm::Float32, 4> blue(0.f, 0.f, 1.f, 1.f);
+  vtkm::rendering::Canvas canvas0(WIDTH, HEIGHT);
+  vtkm::rendering::Canvas canvas1(WIDTH, HEIGHT);
+  vtkm::rendering::Canvas canvas2(WIDTH, HEIGHT);
+  FillCanvas(canvas0, red, 2, 0.5f);
+  FillCanvas(canvas1, green, 4, 0.25f);
+  FillCanvas(canvas2, blue, 0, 0.f);
+
+  vtkm::rendering::Compositor compositor;
+  compositor.AddImage(canvas0);
+  compositor.AddImage(canvas1);
+  compositor.AddImage(canvas2);
+  VTKM_TEST_ASSERT(compositor.GetNumberOfImages() == 3, "Wrong number of images");
+
+  vtkm::rendering::Canvas result(1, 1);
+  compositor.Composite(result);
+  if (GetRank() == 0)
+  {
+    VTKM_TEST_ASSERT(result.GetWidth() == WIDTH && result.GetHeight() == HEIGHT,
+                     "Result was not resized");
+    auto colors = result.GetColorBuffer().GetPortalConstControl();
+    auto depths = result.GetDepthBuffer().GetPortalConstControl();
+    for (vtkm::Id i = 0; i < WIDTH * HEIGHT; ++i)
+    {
+      // ties keep the first image
+      const bool near = i % WIDTH < 4;
+      VTKM_TEST_ASSERT(test_equal(depths.Get(i), near ? 0.25f : 1.f), "Wrong composited depth");
+      VTKM_TEST_ASSERT(test_equal(colors.Get(i), near ? green : red), "Wrong composited color");
+    }
+  }
+
+  vtkm::rendering::Canvas wrongSize(WIDTH + 1, HEIGHT);
+  try
+  {
+    compositor.AddImage(wrongSize);
+    VTKM_TEST_FAIL("Images of different sizes were accepted");
+  }
+  catch (const vtkm::cont::ErrorBadValue&)
+  {
+    std::cout << "Got expected error for an image of a different size" << std::endl;
+  }
+
+  compositor.ClearImages();
+  try
+  {
+    compositor.Composite(result);
+    VTKM_TEST_FAIL("Compositing without images did not fail");
+  }
+  catch (const vtkm::cont::ErrorBadValue&)
+  {
+    std::cout << "Got expected error for compositing no images" << std::endl;
+  }
+}
+
+void TestVisibilityOrderBlend()
+{
+  std::cout << "Testing visibility order blending" << std::endl;
+  // premultiplied colors
+  const vtkm::Vec<vtkm::Float32, 4> front(0.5f, 0.f, 0.f, 0.5f);
+  const vtkm::Vec<vtkm::Float32, 4> middle(0.f, 0.25f, 0.f, 0.25f);
+  const vtkm::Vec<vtkm::Float32, 4> back(0.f, 0.f, 1.f, 1.f);
+  vtkm::rendering::Canvas canvas0(WIDTH, HEIGHT);
+  vtkm::rendering::Canvas canvas1(WIDTH, HEIGHT);
+  vtkm::rendering::Canvas canvas2(WIDTH, HEIGHT);
+  FillCanvas(canvas0, back, 0, 0.f);
+  FillCanvas(canvas1, front, WIDTH, 0.5f);
+  FillCanvas(canvas2, middle, 0, 0.f);
+
+  vtkm::rendering::Compositor compositor;
+  compositor.SetCompositeMode(vtkm::rendering::Compositor::VIS_ORDER_BLEND);
+  const vtkm::Id firstOrder = 3 * GetRank();
+  compositor.AddImage(canvas0, firstOrder + 2);
+  compositor.AddImage(canvas1, firstOrder);
+  compositor.AddImage(canvas2, firstOrder + 1);
+
+  vtkm::rendering::Canvas result(WIDTH, HEIGHT);
+  compositor.Composite(result);
+  if (GetRank() != 0)
+  {
+    return;
+  }
+
+  // front over middle over back, which is opaque and hides the images of
+  // the other ranks
+  vtkm::Vec<vtkm::Float32, 4> expected = front;
+  expected = expected + (1.f - expected[3]) * middle;
+  expected = expected + (1.f - expected[3]) * back;
+  auto colors = result.GetColorBuffer().GetPortalConstControl();
+  auto depths = result.GetDepthBuffer().GetPortalConstControl();
+  for (vtkm::Id i = 0; i < WIDTH * HEIGHT; ++i)
+  {
+    VTKM_TEST_ASSERT(test_equal(colors.Get(i), expected), "Wrong blended color");
+    VTKM_TEST_ASSERT(test_equal(depths.Get(i), 0.5f), "Wrong blended depth");
+  }
+}
+
+const vtkm::Id SWAP_WIDTH = 5;
+const vtkm::Id SWAP_HEIGHT = 50;
+const vtkm::Id IMAGES_PER_RANK = 12;
+
+// The premultiplied color of a pixel of the image with a visibility order.
+// It varies with the row, so pieces composited into the wrong rows show.
+vtkm::Vec<vtkm::Float32, 4> GetSwapColor(vtkm::Id order, vtkm::Id x, vtkm::Id y)
+{
+  const vtkm::Float32 alpha = 0.1f + 0.08f * static_cast<vtkm::Float32>((order + y + 2 * x) % 10);
+  const vtkm::Vec<vtkm::Float32, 4> color(
+    static_cast<vtkm::Float32>((order * 3 + y) % 7) / 6.f,
+    static_cast<vtkm::Float32>((order + 2 * y + x) % 5) / 4.f,
+    static_cast<vtkm::Float32>((order * 5 + 3 * y) % 11) / 10.f,
+    1.f);
+  return alpha * color;
+}
+
+// No two images have the same depth at a pixel.
+vtkm::Float32 GetSwapDepth(vtkm::Id order, vtkm::Id x, vtkm::Id y)
+{
+  return static_cast<vtkm::Float32>((order * 37 + y * 11 + x * 5) % 101 + 1) / 103.f;
+}
+
+// Every rank adds several images, so radix-k exchanges pieces between the
+// blocks of one process as well as between ranks.
+void TestRadixK(vtkm::rendering::Compositor::CompositeMode mode, vtkm::IdComponent k)
+{
+  std::cout << "Testing radix-k compositing with k = " << k << " in mode " << mode << std::endl;
+  const vtkm::Id numRanks = GetNumberOfRanks();
+  const vtkm::Id numImages = IMAGES_PER_RANK * numRanks;
+
+  vtkm::rendering::Compositor compositor;
+  compositor.SetCompositeMode(mode);
+  compositor.SetRadixK(k);
+  // The images of the ranks interleave in the visibility order, and are
+  // added back to front.
+  for (vtkm::Id i = IMAGES_PER_RANK - 1; i >= 0; --i)
+  {
+    const vtkm::Id order = i * numRanks + GetRank();
+    vtkm::rendering::Canvas canvas(SWAP_WIDTH, SWAP_HEIGHT);
+    auto colors = canvas.GetColorBuffer().GetPortalControl();
+    auto depths = canvas.GetDepthBuffer().GetPortalControl();
+    for (vtkm::Id p = 0; p < SWAP_WIDTH * SWAP_HEIGHT; ++p)
+    {
+      colors.Set(p, GetSwapColor(order, p % SWAP_WIDTH, p / SWAP_WIDTH));
+      depths.Set(p, GetSwapDepth(order, p % SWAP_WIDTH, p / SWAP_WIDTH));
+    }
+    compositor.AddImage(canvas, order);
+  }
+
+  vtkm::rendering::Canvas result(SWAP_WIDTH, SWAP_HEIGHT);
+  compositor.Composite(result);
+  if (GetRank() != 0)
+  {
+    return;
+  }
+
+  // composite the images of all ranks front to back in turn
+  auto colors = result.GetColorBuffer().GetPortalConstControl();
+  auto depths = result.GetDepthBuffer().GetPortalConstControl();
+  for (vtkm::Id p = 0; p < SWAP_WIDTH * SWAP_HEIGHT; ++p)
+  {
+    const vtkm::Id x = p % SWAP_WIDTH;
+    const vtkm::Id y = p / SWAP_WIDTH;
+    vtkm::Vec<vtkm::Float32, 4> expectedColor = GetSwapColor(0, x, y);
+    vtkm::Float32 expectedDepth = GetSwapDepth(0, x, y);
+    for (vtkm::Id order = 1; order < numImages; ++order)
+    {
+      const vtkm::Float32 depth = GetSwapDepth(order, x, y);
+      if (mode == vtkm::rendering::Compositor::VIS_ORDER_BLEND)
+      {
+        expectedColor = expectedColor + (1.f - expectedColor[3]) * GetSwapColor(order, x, y);
+      }
+      else if (depth < expectedDepth)
+      {
+        expectedColor = GetSwapColor(order, x, y);
+      }
+      expectedDepth = vtkm::Min(expectedDepth, depth);
+    }
+    VTKM_TEST_ASSERT(test_equal(colors.Get(p), expectedColor), "Wrong composited color");
+    VTKM_TEST_ASSERT(test_equal(depths.Get(p), expectedDepth), "Wrong composited depth");
+  }
+}
+
+vtkm::cont::DataSet MakeBlock(vtkm::Float32 originX)
+{
+  const vtkm::Id3 dims(4, 4, 4);
+  vtkm::cont::DataSet ds = vtkm::cont::DataSetBuilderUniform::Create(
+    dims, vtkm::Vec<vtkm::Float32, 3>(originX, 0.f, 0.f), vtkm::Vec<vtkm::Float32, 3>(1.f));
+  std::vector<vtkm::Float32> pointvar;
+  for (vtkm::Id i = 0; i < dims[0] * dims[1] * dims[2]; ++i)
+  {
+    pointvar.push_back(originX + static_cast<vtkm::Float32>(i % dims[0]));
+  }
+  vtkm::cont::DataSetFieldAdd::AddPointField(ds, "pointvar", pointvar);
+  return ds;
+}
+
+void RenderBlock(const vtkm::cont::DataSet& block,
+                 const vtkm::rendering::Camera& camera,
+                 const vtkm::Range& scalarRange,
+                 vtkm::rendering::CanvasRayTracer& canvas)
+{
+  vtkm::rendering::MapperRayTracer mapper;
+  mapper.SetCanvas(&canvas);
+  mapper.SetActiveColorTable(vtkm::rendering::ColorTable("thermal"));
+  mapper.RenderCells(block.GetCellSet(),
+                     block.GetCoordinateSystem(),
+                     block.GetField("pointvar"),
+                     vtkm::rendering::ColorTable("thermal"),
+                     camera,
+                     scalarRange);
+}
+
+// Each block of a MultiBlock stands in for the piece of a rank.
+void TestMultiBlock()
+{
+  std::cout << "Testing compositing the blocks of a MultiBlock" << std::endl;
+  vtkm::cont::MultiBlock multiblock;
+  for (vtkm::Float32 originX : { 0.f, 2.f, 4.f })
+  {
+    vtkm::cont::DataSet block = MakeBlock(originX);
+    multiblock.AddBlock(block);
+  }
+
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(multiblock.GetBounds());
+  camera.Azimuth(30.f);
+  camera.Elevation(30.f);
+  vtkm::Range scalarRange =
+    multiblock.GetGlobalRange("pointvar").GetPortalConstControl().Get(0);
+
+  // rendering all the blocks into one canvas in turn depth tests them
+  vtkm::rendering::CanvasRayTracer expected(64, 64);
+  expected.Clear();
+  vtkm::rendering::Compositor compositor;
+  for (vtkm::Id b = 0; b < multiblock.GetNumberOfBlocks(); ++b)
+  {
+    vtkm::rendering::CanvasRayTracer canvas(64, 64);
+    canvas.Clear();
+    RenderBlock(multiblock.GetBlock(b), camera, scalarRange, canvas);
+    RenderBlock(multiblock.GetBlock(b), camera, scalarRange, expected);
+    compositor.AddImage(canvas);
+  }
+
+  vtkm::rendering::CanvasRayTracer result(64, 64);
+  compositor.Composite(result);
+  if (GetRank() != 0)
+  {
+    return;
+  }
+
+  // Depths go through a round trip to ray distances when blocks are
+  // rendered in turn, so allow a few pixels to differ.
+  auto expectedColors = expected.GetColorBuffer().GetPortalConstControl();
+  auto expectedDepths = expected.GetDepthBuffer().GetPortalConstControl();
+  auto colors = result.GetColorBuffer().GetPortalConstControl();
+  auto depths = result.GetDepthBuffer().GetPortalConstControl();
+  vtkm::Id numHits = 0;
+  vtkm::Id numDifferent = 0;
+  for (vtkm::Id i = 0; i < expectedDepths.GetNumberOfValues(); ++i)
+  {
+    if (expectedDepths.Get(i) < 1.f)
+    {
+      numHits++;
+    }
+    if (!test_equal(expectedDepths.Get(i), depths.Get(i), 0.001) ||
+        !test_equal(expectedColors.Get(i), colors.Get(i), 0.01))
+    {
+      numDifferent++;
+    }
+  }
+  VTKM_TEST_ASSERT(numHits > 0, "Nothing was rendered");
+  VTKM_TEST_ASSERT(numDifferent * 100 < numHits, "Composited image differs");
+}
+
+void TestCompositor()
+{
+  TestZBuffer();
+  TestVisibilityOrderBlend();
+  TestRadixK(vtkm::rendering::Compositor::VIS_ORDER_BLEND, 2);
+  TestRadixK(vtkm::rendering::Compositor::VIS_ORDER_BLEND, 4);
+  TestRadixK(vtkm::rendering::Compositor::Z_BUFFER_SURFACE, 2);
+  TestMultiBlock();
+}
+
+} //namespace
+
+int UnitTestCompositor(int argc, char* argv[])
+{
+  (void)argc;
+  (void)argv;
+#if defined(VTKM_ENABLE_MPI)
+  diy::mpi::environment env(argc, argv);
+  vtkm::cont::EnvironmentTracker::SetCommunicator(diy::mpi::communicator(MPI_COMM_WORLD));
+#endif
+  return vtkm::cont::testing::Testing::Run(TestCompositor);
+}
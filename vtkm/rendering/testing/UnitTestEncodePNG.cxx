@@ -0,0 +1,178 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/rendering/Canvas.h>
+#include <vtkm/rendering/DecodePNG.h>
+#include <vtkm/rendering/EncodePNG.h>
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+enum ImageContents
+{
+  FLAT,
+  GRADIENT,
+  NOISE
+};
+
+std::vector<unsigned char> MakeImage(unsigned long width,
+                                     unsigned long height,
+                                     ImageContents contents)
+{
+  std::mt19937 rng;
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<unsigned char> image(width * height * 4);
+  for (unsigned long y = 0; y < height; ++y)
+  {
+    for (unsigned long x = 0; x < width; ++x)
+    {
+      unsigned char* pixel = &image[(y * width + x) * 4];
+      for (int c = 0; c < 4; ++c)
+      {
+        switch (contents)
+        {
+          case FLAT:
+            pixel[c] = static_cast<unsigned char>((x < width / 2) ? 40 * c : 255 - 40 * c);
+            break;
+          case GRADIENT:
+            pixel[c] = static_cast<unsigned char>((x * (c + 1) + y * (3 - c)) % 256);
+            break;
+          case NOISE:
+            pixel[c] = static_cast<unsigned char>(distribution(rng));
+            break;
+        }
+      }
+    }
+  }
+  return image;
+}
+
+void TestRoundTrip(unsigned long width, unsigned long height, ImageContents contents, bool alpha)
+{
+  std::cout << "Encoding a " << width << "x" << height << (alpha ? " RGBA" : " RGB")
+            << " image of type " << contents << std::endl;
+  const std::vector<unsigned char> image = MakeImage(width, height, contents);
+
+  std::vector<unsigned char> png;
+  VTKM_TEST_ASSERT(vtkm::rendering::EncodePNG(png, image.data(), width, height, alpha) == 0,
+                   "Encoding failed.");
+
+  std::vector<unsigned char> decoded;
+  unsigned long decodedWidth = 0;
+  unsigned long decodedHeight = 0;
+  VTKM_TEST_ASSERT(
+    vtkm::rendering::DecodePNG(decoded, decodedWidth, decodedHeight, png.data(), png.size()) == 0,
+    "Could not decode the encoded image.");
+  VTKM_TEST_ASSERT(decodedWidth == width && decodedHeight == height, "Wrong image size.");
+  VTKM_TEST_ASSERT(decoded.size() == image.size(), "Wrong decoded size.");
+
+  for (std::size_t i = 0; i < image.size(); ++i)
+  {
+    // Without alpha the decoder reports opaque pixels.
+    const unsigned char expected = (alpha || (i % 4 != 3)) ? image[i] : 255;
+    VTKM_TEST_ASSERT(decoded[i] == expected, "Wrong decoded pixel.");
+  }
+
+  if ((contents != NOISE) && (width * height > 10000))
+  {
+    VTKM_TEST_ASSERT(png.size() < image.size() / 4, "Image was not compressed.");
+  }
+}
+
+void TestCanvasSaveAs()
+{
+  std::cout << "Saving a canvas as PNG" << std::endl;
+  vtkm::rendering::Canvas canvas(64, 48);
+  canvas.SetBackgroundColor(vtkm::rendering::Color::white);
+  canvas.Initialize();
+  canvas.Activate();
+  canvas.Clear();
+  canvas.AddLine(-0.8, -0.8, 0.8, 0.8, 1.0f, vtkm::rendering::Color::black);
+  canvas.BlendBackground();
+  canvas.SaveAs("encode-png-test.png");
+  canvas.SaveAs("encode-png-test.pnm");
+
+  std::ifstream pngFile("encode-png-test.png", std::ios_base::binary);
+  std::vector<unsigned char> png((std::istreambuf_iterator<char>(pngFile)),
+                                 std::istreambuf_iterator<char>());
+  std::vector<unsigned char> decoded;
+  unsigned long width = 0;
+  unsigned long height = 0;
+  VTKM_TEST_ASSERT(
+    vtkm::rendering::DecodePNG(decoded, width, height, png.data(), png.size()) == 0,
+    "Could not decode the saved image.");
+  VTKM_TEST_ASSERT(width == 64 && height == 48, "Wrong saved image size.");
+
+  // The PNM file has the same pixels after its header.
+  std::ifstream pnmFile("encode-png-test.pnm", std::ios_base::binary);
+  std::vector<unsigned char> pnm((std::istreambuf_iterator<char>(pnmFile)),
+                                 std::istreambuf_iterator<char>());
+  const std::size_t headerSize = pnm.size() - width * height * 3;
+  for (std::size_t i = 0; i < width * height; ++i)
+  {
+    for (std::size_t c = 0; c < 3; ++c)
+    {
+      VTKM_TEST_ASSERT(decoded[4 * i + c] == pnm[headerSize + 3 * i + c],
+                       "PNG and PNM images differ.");
+    }
+  }
+
+  std::cout << "Saving an empty canvas" << std::endl;
+  vtkm::rendering::Canvas empty(0, 0);
+  empty.SaveAs("encode-png-test-empty.pnm");
+  try
+  {
+    empty.SaveAs("encode-png-test-empty.png");
+    VTKM_TEST_FAIL("Saving an empty canvas as PNG did not fail.");
+  }
+  catch (const vtkm::cont::ErrorBadValue&)
+  {
+    std::cout << "Got expected error for an empty PNG image" << std::endl;
+  }
+}
+
+void TestEncodePNG()
+{
+  TestRoundTrip(1, 1, FLAT, false);
+  TestRoundTrip(3, 2, GRADIENT, true);
+  TestRoundTrip(700, 500, FLAT, false);
+  TestRoundTrip(700, 500, GRADIENT, true);
+  TestRoundTrip(257, 300, NOISE, true);
+
+  std::vector<unsigned char> png;
+  VTKM_TEST_ASSERT(vtkm::rendering::EncodePNG(png, nullptr, 4, 4) != 0,
+                   "Encoding a missing image should fail.");
+
+  TestCanvasSaveAs();
+}
+
+} //namespace
+
+int UnitTestEncodePNG(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestEncodePNG);
+}
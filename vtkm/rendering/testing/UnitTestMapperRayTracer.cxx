@@ -18,6 +18,9 @@
 //  this software.
 //============================================================================
 
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
@@ -26,11 +29,186 @@
 #include <vtkm/rendering/MapperRayTracer.h>
 #include <vtkm/rendering/Scene.h>
 #include <vtkm/rendering/View3D.h>
+#include <vtkm/rendering/internal/RunTriangulator.h>
+#include <vtkm/rendering/raytracing/BoundingVolumeHierarchy.h>
 #include <vtkm/rendering/testing/RenderTest.h>
 
 namespace
 {
 
+vtkm::cont::DataSet MakeAnisotropicDataSet()
+{
+  // A thin slab of many cells, which gives a badly shaped Morton code tree.
+  vtkm::cont::DataSetBuilderUniform builder;
+  vtkm::cont::DataSet dataSet = builder.Create(vtkm::Id3(64, 4, 32),
+                                               vtkm::Vec<vtkm::Float32, 3>(0.f, 0.f, 0.f),
+                                               vtkm::Vec<vtkm::Float32, 3>(1.f, 0.05f, 0.5f));
+  vtkm::Id numValues = dataSet.GetCoordinateSystem().GetData().GetNumberOfValues();
+  std::vector<vtkm::Float32> values(static_cast<std::size_t>(numValues));
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    values[i] = static_cast<vtkm::Float32>(i % 97);
+  }
+  vtkm::cont::DataSetFieldAdd().AddPointField(dataSet, "pointvar", values);
+  return dataSet;
+}
+
+vtkm::cont::DataSet MakeDisplacedDataSet(const vtkm::cont::DataSet& ds)
+{
+  // Moves the points of ds but keeps its cells.
+  auto points = ds.GetCoordinateSystem().GetData().GetPortalConstControl();
+  std::vector<vtkm::Vec<vtkm::Float32, 3>> displaced;
+  for (vtkm::Id i = 0; i < points.GetNumberOfValues(); ++i)
+  {
+    vtkm::Vec<vtkm::Float32, 3> point = points.Get(i);
+    point[1] += 0.5f * vtkm::Sin(point[0]) * vtkm::Cos(point[2]);
+    displaced.push_back(point);
+  }
+  vtkm::cont::DataSet result;
+  result.AddCellSet(ds.GetCellSet());
+  result.AddCoordinateSystem(
+    vtkm::cont::make_CoordinateSystem("coordinates", displaced, vtkm::CopyFlag::On));
+  result.AddField(ds.GetField("pointvar"));
+  return result;
+}
+
+void RenderToCanvas(vtkm::rendering::MapperRayTracer& mapper,
+                    const vtkm::cont::DataSet& ds,
+                    vtkm::rendering::CanvasRayTracer& canvas)
+{
+  mapper.SetCanvas(&canvas);
+  mapper.SetActiveColorTable(vtkm::rendering::ColorTable("thermal"));
+
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(ds.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.f);
+  camera.Elevation(30.f);
+
+  vtkm::Range scalarRange;
+  ds.GetField("pointvar").GetRange(&scalarRange);
+  canvas.Clear();
+  mapper.RenderCells(ds.GetCellSet(),
+                     ds.GetCoordinateSystem(),
+                     ds.GetField("pointvar"),
+                     vtkm::rendering::ColorTable("thermal"),
+                     camera,
+                     scalarRange);
+}
+
+void CompareCanvases(const vtkm::rendering::CanvasRayTracer& expected,
+                     const vtkm::rendering::CanvasRayTracer& canvas,
+                     const std::string& message)
+{
+  // Rays through shared edges may hit either triangle, so allow a few
+  // pixels to differ.
+  auto expectedDepth = expected.GetDepthBuffer().GetPortalConstControl();
+  auto depth = canvas.GetDepthBuffer().GetPortalConstControl();
+  auto expectedColor = expected.GetColorBuffer().GetPortalConstControl();
+  auto color = canvas.GetColorBuffer().GetPortalConstControl();
+  vtkm::Id numHits = 0;
+  vtkm::Id numDifferent = 0;
+  for (vtkm::Id i = 0; i < expectedDepth.GetNumberOfValues(); ++i)
+  {
+    VTKM_TEST_ASSERT(test_equal(expectedDepth.Get(i), depth.Get(i), 0.001), message);
+    if (expectedDepth.Get(i) < 1.f)
+    {
+      numHits++;
+    }
+    if (!test_equal(expectedColor.Get(i), color.Get(i), 0.01))
+    {
+      numDifferent++;
+    }
+  }
+  VTKM_TEST_ASSERT(numHits > 0, "Nothing was rendered");
+  VTKM_TEST_ASSERT(numDifferent * 100 < numHits, message);
+}
+
+void TestWideBVH(const vtkm::cont::DataSet& ds)
+{
+  vtkm::rendering::MapperRayTracer binaryMapper;
+  vtkm::rendering::MapperRayTracer wideMapper;
+  wideMapper.SetUseWideBVH(true);
+  vtkm::rendering::CanvasRayTracer binaryCanvas(256, 256);
+  vtkm::rendering::CanvasRayTracer wideCanvas(256, 256);
+  RenderToCanvas(binaryMapper, ds, binaryCanvas);
+  RenderToCanvas(wideMapper, ds, wideCanvas);
+  CompareCanvases(binaryCanvas, wideCanvas, "Wide BVH rendered a different image");
+}
+
+void TestPacketTraversal(const vtkm::cont::DataSet& ds, bool useWideBVH)
+{
+  vtkm::rendering::MapperRayTracer mapper;
+  vtkm::rendering::MapperRayTracer packetMapper;
+  mapper.SetUseWideBVH(useWideBVH);
+  packetMapper.SetUseWideBVH(useWideBVH);
+  packetMapper.SetUsePacketTraversal(true);
+  // A size that is not a multiple of the tile size gives partial packets.
+  vtkm::rendering::CanvasRayTracer canvas(250, 190);
+  vtkm::rendering::CanvasRayTracer packetCanvas(250, 190);
+  RenderToCanvas(mapper, ds, canvas);
+  RenderToCanvas(packetMapper, ds, packetCanvas);
+  CompareCanvases(canvas, packetCanvas, "Packet traversal rendered a different image");
+}
+
+void TestBVHReuse(bool useWideBVH)
+{
+  using vtkm::rendering::raytracing::LinearBVH;
+
+  vtkm::cont::DataSet ds = MakeAnisotropicDataSet();
+  vtkm::cont::DataSet displaced = MakeDisplacedDataSet(ds);
+
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> triangles;
+  vtkm::Id numberOfTriangles;
+  vtkm::rendering::internal::RunTriangulator(ds.GetCellSet(), triangles, numberOfTriangles);
+  vtkm::cont::CoordinateSystem coords = ds.GetCoordinateSystem();
+  vtkm::cont::CoordinateSystem displacedCoords = displaced.GetCoordinateSystem();
+
+  LinearBVH bvh(coords.GetData(), triangles, coords.GetBounds());
+  bvh.SetUseWideTree(useWideBVH);
+  bvh.Construct();
+  bvh.SetData(coords.GetData(), triangles, coords.GetBounds());
+  VTKM_TEST_ASSERT(bvh.GetIsConstructed(), "BVH was not kept for the same data");
+  bvh.SetData(displacedCoords.GetData(), triangles, displacedCoords.GetBounds());
+  VTKM_TEST_ASSERT(!bvh.GetIsConstructed(), "BVH was kept for new coordinates");
+
+  // Refitting to the displaced points must find the same surfaces as a new
+  // tree built for them.
+  vtkm::rendering::MapperRayTracer refitMapper;
+  refitMapper.SetUseWideBVH(useWideBVH);
+  refitMapper.SetAllowBVHRefit(true);
+  vtkm::rendering::MapperRayTracer mapper;
+  mapper.SetUseWideBVH(useWideBVH);
+  vtkm::rendering::CanvasRayTracer refitCanvas(256, 256);
+  vtkm::rendering::CanvasRayTracer canvas(256, 256);
+  RenderToCanvas(refitMapper, ds, refitCanvas);
+  RenderToCanvas(refitMapper, displaced, refitCanvas);
+  RenderToCanvas(mapper, displaced, canvas);
+  CompareCanvases(canvas, refitCanvas, "Refit BVH rendered a different image");
+
+  // Moving the points in place keeps the same arrays, so the mapper has to
+  // be told to rebuild. The bounds cached by the coordinate system are not
+  // updated, so the moved points get a new one over the same coordinates.
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 3>> points;
+  vtkm::cont::ArrayCopy(coords.GetData(), points);
+  vtkm::cont::DataSet edited;
+  edited.AddCellSet(ds.GetCellSet());
+  edited.AddCoordinateSystem(vtkm::cont::CoordinateSystem("coordinates", points));
+  edited.AddField(ds.GetField("pointvar"));
+  vtkm::rendering::MapperRayTracer editMapper;
+  editMapper.SetUseWideBVH(useWideBVH);
+  vtkm::rendering::CanvasRayTracer editCanvas(256, 256);
+  RenderToCanvas(editMapper, edited, editCanvas);
+  vtkm::cont::ArrayCopy(displacedCoords.GetData(), points);
+  vtkm::cont::DataSet moved;
+  moved.AddCellSet(ds.GetCellSet());
+  moved.AddCoordinateSystem(
+    vtkm::cont::CoordinateSystem("coordinates", edited.GetCoordinateSystem().GetData()));
+  moved.AddField(ds.GetField("pointvar"));
+  editMapper.InvalidateCache();
+  RenderToCanvas(editMapper, moved, editCanvas);
+  CompareCanvases(canvas, editCanvas, "Invalidated BVH rendered a different image");
+}
+
 void RenderTests()
 {
   typedef vtkm::rendering::MapperRayTracer M;
@@ -50,6 +228,16 @@ void RenderTests()
 
   vtkm::rendering::testing::Render<M, C, V2>(
     maker.Make2DUniformDataSet1(), "pointvar", colorTable, "uni2D.pnm");
+
+  TestWideBVH(maker.Make3DExplicitDataSet4());
+  TestWideBVH(MakeAnisotropicDataSet());
+
+  TestPacketTraversal(maker.Make3DExplicitDataSet4(), false);
+  TestPacketTraversal(MakeAnisotropicDataSet(), false);
+  TestPacketTraversal(MakeAnisotropicDataSet(), true);
+
+  TestBVHReuse(false);
+  TestBVHReuse(true);
 }
 
 } //namespace
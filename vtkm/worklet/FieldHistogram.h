@@ -23,10 +23,10 @@
 
 #include <vtkm/Math.h>
 #include <vtkm/cont/ArrayHandle.h>
-#include <vtkm/cont/ArrayHandleCounting.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/histogram/ComputeBinCounts.h>
 
 #include <vtkm/cont/Field.h>
 
@@ -62,6 +62,26 @@ namespace worklet
 class FieldHistogram
 {
 public:
+  // Maps a value to the bin it should be in
+  template <typename FieldType>
+  struct BinMapper
+  {
+    vtkm::Id NumberOfBins;
+    FieldType MinValue;
+    FieldType Delta;
+
+    VTKM_EXEC
+    vtkm::Id operator()(const FieldType& value) const
+    {
+      vtkm::Id binIndex = static_cast<vtkm::Id>((value - this->MinValue) / this->Delta);
+      if (binIndex < 0)
+        binIndex = 0;
+      else if (binIndex >= this->NumberOfBins)
+        binIndex = this->NumberOfBins - 1;
+      return binIndex;
+    }
+  };
+
   // For each value set the bin it should be in
   template <typename FieldType>
   class SetHistogramBin : public vtkm::worklet::WorkletMapField
@@ -86,11 +106,8 @@ public:
     VTKM_EXEC
     void operator()(const FieldType& value, vtkm::Id& binIndex) const
     {
-      binIndex = static_cast<vtkm::Id>((value - minValue) / delta);
-      if (binIndex < 0)
-        binIndex = 0;
-      else if (binIndex >= numberOfBins)
-        binIndex = numberOfBins - 1;
+      const BinMapper<FieldType> binMapper = { numberOfBins, minValue, delta };
+      binIndex = binMapper(value);
     }
   };
 
@@ -127,48 +144,44 @@ public:
            vtkm::Range& rangeOfValues,
            FieldType& binDelta,
            vtkm::cont::ArrayHandle<vtkm::Id>& binArray,
-           DeviceAdapter vtkmNotUsed(device))
+           DeviceAdapter device)
   {
     typedef typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter> DeviceAlgorithms;
 
-    //todo: need to have a signature that can use an input range so we can
-    //leverage fields that have already computed there range
-
-    const vtkm::Id numberOfValues = fieldArray.GetNumberOfValues();
-
     const vtkm::Vec<FieldType, 2> initValue(fieldArray.GetPortalConstControl().Get(0));
 
     vtkm::Vec<FieldType, 2> result =
       DeviceAlgorithms::Reduce(fieldArray, initValue, vtkm::MinAndMax<FieldType>());
 
-    const FieldType& fieldMinValue = result[0];
-    const FieldType& fieldMaxValue = result[1];
-    const FieldType fieldDelta = compute_delta(fieldMinValue, fieldMaxValue, numberOfBins);
+    this->Run(fieldArray, numberOfBins, result[0], result[1], binDelta, binArray, device);
 
-    // Worklet fills in the bin belonging to each value
-    vtkm::cont::ArrayHandle<vtkm::Id> binIndex;
-    binIndex.Allocate(numberOfValues);
-
-    // Worklet to set the bin number for each data value
-    SetHistogramBin<FieldType> binWorklet(numberOfBins, fieldMinValue, fieldDelta);
-    vtkm::worklet::DispatcherMapField<SetHistogramBin<FieldType>> setHistogramBinDispatcher(
-      binWorklet);
-    setHistogramBinDispatcher.Invoke(fieldArray, binIndex);
-
-    // Sort the resulting bin array for counting
-    DeviceAlgorithms::Sort(binIndex);
+    //update the users data
+    rangeOfValues = vtkm::Range(result[0], result[1]);
+  }
 
-    // Get the upper bound of each bin number
-    vtkm::cont::ArrayHandle<vtkm::Id> totalCount;
-    vtkm::cont::ArrayHandleCounting<vtkm::Id> binCounter(0, 1, numberOfBins);
-    DeviceAlgorithms::UpperBounds(binIndex, binCounter, totalCount);
+  // Execute the histogram binning filter given data, number of bins and the
+  // min and max values to bin, for when the range of the data is already
+  // known. Values outside of the range are counted in the first or last bin.
+  // Returns:
+  // delta/range of each bin
+  // number of values in each bin
+  template <typename FieldType, typename Storage, typename DeviceAdapter>
+  void Run(vtkm::cont::ArrayHandle<FieldType, Storage> fieldArray,
+           vtkm::Id numberOfBins,
+           FieldType fieldMinValue,
+           FieldType fieldMaxValue,
+           FieldType& binDelta,
+           vtkm::cont::ArrayHandle<vtkm::Id>& binArray,
+           DeviceAdapter device)
+  {
+    const FieldType fieldDelta = compute_delta(fieldMinValue, fieldMaxValue, numberOfBins);
 
-    // Difference between adjacent items is the bin count
-    vtkm::worklet::DispatcherMapField<AdjacentDifference, DeviceAdapter> dispatcher;
-    dispatcher.Invoke(binCounter, totalCount, binArray);
+    // Count the values of each bin in a single pass over the data
+    BinMapper<FieldType> binMapper = { numberOfBins, fieldMinValue, fieldDelta };
+    vtkm::worklet::histogram::ComputeBinCounts(
+      fieldArray, binMapper, numberOfBins, binArray, device);
 
     //update the users data
-    rangeOfValues = vtkm::Range(fieldMinValue, fieldMaxValue);
     binDelta = fieldDelta;
   }
 };
@@ -22,6 +22,7 @@
 
 #include <vtkm/worklet/spatialstructure/KdTree3DConstruction.h>
 #include <vtkm/worklet/spatialstructure/KdTree3DNNSearch.h>
+#include <vtkm/worklet/spatialstructure/KdTree3DNeighborSearch.h>
 
 namespace vtkm
 {
@@ -79,9 +80,94 @@ public:
       coords, this->PointIds, this->SplitIds, queryPoints, nearestNeighborIds, distances, device);
   }
 
+  /// \brief K nearest neighbors search using KD-Tree
+  ///
+  /// Parallel search of the \c k nearest neighbors of each point in the \c queryPoints in the set
+  /// of \c coords. The neighbors of query point \c i are entries <tt>offsets[i]</tt> to
+  /// <tt>offsets[i + 1] - 1</tt> of \c neighborIds and \c distances, sorted by increasing
+  /// distance. Every query point has \c k neighbors, unless there are fewer than \c k points in
+  /// \c coords.
+  ///
+  /// \param coords Point coordinates for training data set (haystack)
+  /// \param queryPoints Point coordinates to query for nearest neighbors (needles).
+  /// \param k Number of neighbors to find for each query point.
+  /// \param offsets Start of the neighbors of each query point, and the total at the end.
+  /// \param neighborIds Neighbors in the training data set of each query point.
+  /// \param distances Distances between query points and their neighbors.
+  /// \param device Tag for selecting device adapter.
+  template <typename CoordType,
+            typename CoordStorageTag1,
+            typename CoordStorageTag2,
+            typename DeviceAdapter>
+  void KNearestNeighbors(
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag1>& coords,
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag2>& queryPoints,
+    vtkm::IdComponent k,
+    vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+    vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+    vtkm::cont::ArrayHandle<CoordType>& distances,
+    DeviceAdapter device)
+  {
+    vtkm::worklet::spatialstructure::KdTree3DNeighborSearch().RunKNearest(coords,
+                                                                         this->PointIds,
+                                                                         this->SplitIds,
+                                                                         queryPoints,
+                                                                         k,
+                                                                         this->ReorderQueries,
+                                                                         offsets,
+                                                                         neighborIds,
+                                                                         distances,
+                                                                         device);
+  }
+
+  /// \brief Fixed radius neighbors search using KD-Tree
+  ///
+  /// Parallel search of all the points in \c coords within \c radius of each point in the
+  /// \c queryPoints. The neighbors of query point \c i are entries <tt>offsets[i]</tt> to
+  /// <tt>offsets[i + 1] - 1</tt> of \c neighborIds and \c distances, sorted by distance.
+  ///
+  /// \param coords Point coordinates for training data set (haystack)
+  /// \param queryPoints Point coordinates to query for neighbors (needles).
+  /// \param radius Largest distance of a neighbor, inclusive.
+  /// \param offsets Start of the neighbors of each query point, and the total at the end.
+  /// \param neighborIds Neighbors in the training data set of each query point.
+  /// \param distances Distances between query points and their neighbors.
+  /// \param device Tag for selecting device adapter.
+  template <typename CoordType,
+            typename CoordStorageTag1,
+            typename CoordStorageTag2,
+            typename DeviceAdapter>
+  void RadiusNeighbors(
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag1>& coords,
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag2>& queryPoints,
+    CoordType radius,
+    vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+    vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+    vtkm::cont::ArrayHandle<CoordType>& distances,
+    DeviceAdapter device)
+  {
+    vtkm::worklet::spatialstructure::KdTree3DNeighborSearch().RunRadius(coords,
+                                                                       this->PointIds,
+                                                                       this->SplitIds,
+                                                                       queryPoints,
+                                                                       radius,
+                                                                       this->ReorderQueries,
+                                                                       offsets,
+                                                                       neighborIds,
+                                                                       distances,
+                                                                       device);
+  }
+
+  /// Whether the k nearest and radius searches process the query points along a Morton curve,
+  /// so that query points searched together are close and walk similar paths through the tree.
+  /// This does not change the results. On by default.
+  void SetReorderQueries(bool reorder) { this->ReorderQueries = reorder; }
+  bool GetReorderQueries() const { return this->ReorderQueries; }
+
 private:
   vtkm::cont::ArrayHandle<vtkm::Id> PointIds;
   vtkm::cont::ArrayHandle<vtkm::Id> SplitIds;
+  bool ReorderQueries = true;
 };
 }
 } // namespace vtkm::worklet
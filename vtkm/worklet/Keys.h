@@ -37,6 +37,7 @@
 #include <vtkm/cont/arg/TypeCheckTagKeys.h>
 
 #include <vtkm/worklet/StableSortIndices.h>
+#include <vtkm/worklet/internal/KeysHashBuilder.h>
 
 #include <vtkm/BinaryOperators.h>
 
@@ -71,11 +72,15 @@ public:
 
   /// Select the type of sort for BuildArrays calls. Unstable sorting is faster
   /// but will not produce consistent ordering for equal keys. Stable sorting
-  /// is slower, but keeps equal keys in their original order.
+  /// is slower, but keeps equal keys in their original order. Hash does not
+  /// sort at all; it groups equal keys with a concurrent hash table in linear
+  /// time. The unique keys are then in no particular order (rather than
+  /// sorted) and equal keys are not kept in their original order.
   enum class SortType
   {
     Unstable = 0,
-    Stable = 1
+    Stable = 1,
+    Hash = 2
   };
 
   VTKM_CONT
@@ -117,12 +122,15 @@ public:
       case SortType::Stable:
         this->BuildArraysInternalStable(keys, Device());
         break;
+      case SortType::Hash:
+        this->BuildArraysInternalHash(keys, Device());
+        break;
     }
   }
 
   /// Build the internal arrays and also sort the input keys. This is more
   /// efficient for unstable sorting, but requires an extra copy for stable
-  /// sorting.
+  /// sorting and hash grouping.
   template <typename KeyArrayType, typename Device>
   VTKM_CONT void BuildArraysInPlace(KeyArrayType& keys, SortType sort, Device)
   {
@@ -143,6 +151,14 @@ public:
         Algorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(this->SortedValuesMap, tmp), keys);
       }
       break;
+      case SortType::Hash:
+      {
+        this->BuildArraysInternalHash(keys, Device());
+        KeyArrayHandleType tmp;
+        Algorithm::Copy(keys, tmp);
+        Algorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(this->SortedValuesMap, tmp), keys);
+      }
+      break;
     }
   }
 
@@ -252,6 +268,13 @@ private:
     VTKM_ASSERT(offsetsTotal == numKeys); // Sanity check
     (void)offsetsTotal;                   // Shut up, compiler
   }
+
+  template <typename KeyArrayType, typename Device>
+  VTKM_CONT void BuildArraysInternalHash(const KeyArrayType& keys, Device)
+  {
+    vtkm::worklet::internal::KeysHashBuilder<Device>::Run(
+      keys, this->UniqueKeys, this->SortedValuesMap, this->Offsets, this->Counts);
+  }
 };
 }
 } // namespace vtkm::worklet
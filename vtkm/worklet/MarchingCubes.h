@@ -51,6 +51,7 @@
 #include <vtkm/worklet/WorkletReduceByKey.h>
 
 #include <vtkm/worklet/contour/DataTables.h>
+#include <vtkm/worklet/contour/FlyingEdges.h>
 #include <vtkm/worklet/gradient/PointGradient.h>
 #include <vtkm/worklet/gradient/StructuredPointGradient.h>
 
@@ -939,6 +940,51 @@ private:
     const DeviceAdapter&)
   {
     using vtkm::worklet::marchingcubes::MapPointField;
+
+    vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
+    this->GenerateTriangles(
+      isovalues, numIsoValues, cells, inputField, connectivity, DeviceAdapter());
+
+    //generate the vertices's
+    MapPointField applyToField;
+    vtkm::worklet::DispatcherMapField<MapPointField, DeviceAdapter> applyFieldDispatcher(
+      applyToField);
+
+    applyFieldDispatcher.Invoke(
+      this->InterpolationEdgeIds, this->InterpolationWeights, coordinateSystem, vertices);
+
+    //assign the connectivity to the cell set
+    vtkm::cont::CellSetSingleType<> outputCells("contour");
+    outputCells.Fill(vertices.GetNumberOfValues(), vtkm::CELL_SHAPE_TRIANGLE, 3, connectivity);
+
+    //now that the vertices have been generated we can generate the normals
+    if (withNormals)
+    {
+      marchingcubes::GenerateNormals(normals,
+                                     inputField,
+                                     cells,
+                                     coordinateSystem,
+                                     this->InterpolationEdgeIds,
+                                     this->InterpolationWeights);
+    }
+
+    return outputCells;
+  }
+
+  //----------------------------------------------------------------------------
+  // Computes the interpolation edge ids and weights of the output points, the
+  // triangle connectivity and the cell id map.
+  template <typename ValueType,
+            typename CellSetType,
+            typename StorageTagField,
+            typename DeviceAdapter>
+  void GenerateTriangles(const ValueType* isovalues,
+                         const vtkm::Id numIsoValues,
+                         const CellSetType& cells,
+                         const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
+                         vtkm::cont::ArrayHandle<vtkm::Id>& connectivity,
+                         const DeviceAdapter&)
+  {
     using vtkm::worklet::marchingcubes::EdgeWeightGenerate;
     using vtkm::worklet::marchingcubes::EdgeWeightGenerateMetaData;
     using vtkm::worklet::marchingcubes::ClassifyCell;
@@ -999,7 +1045,6 @@ private:
       contourIds.ReleaseResources();
     }
 
-    vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
     if (this->MergeDuplicatePoints)
     {
       // In all the below cases you will notice that only interpolation ids
@@ -1035,31 +1080,43 @@ private:
       vtkm::cont::ArrayHandleIndex temp(this->InterpolationEdgeIds.GetNumberOfValues());
       Algorithm::Copy(temp, connectivity);
     }
+  }
 
-    //generate the vertices's
-    MapPointField applyToField;
-    vtkm::worklet::DispatcherMapField<MapPointField, DeviceAdapter> applyFieldDispatcher(
-      applyToField);
-
-    applyFieldDispatcher.Invoke(
-      this->InterpolationEdgeIds, this->InterpolationWeights, coordinateSystem, vertices);
-
-    //assign the connectivity to the cell set
-    vtkm::cont::CellSetSingleType<> outputCells("contour");
-    outputCells.Fill(vertices.GetNumberOfValues(), vtkm::CELL_SHAPE_TRIANGLE, 3, connectivity);
-
-    //now that the vertices have been generated we can generate the normals
-    if (withNormals)
+  //----------------------------------------------------------------------------
+  // Merged points of a single iso-value on a structured grid are numbered
+  // directly by Flying Edges rather than by sorting the edge ids.
+  template <typename ValueType, typename StorageTagField, typename DeviceAdapter>
+  void GenerateTriangles(const ValueType* isovalues,
+                         const vtkm::Id numIsoValues,
+                         const vtkm::cont::CellSetStructured<3>& cells,
+                         const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
+                         vtkm::cont::ArrayHandle<vtkm::Id>& connectivity,
+                         const DeviceAdapter& device)
+  {
+    const vtkm::Id3 pointDims = cells.GetPointDimensions();
+    if (numIsoValues != 1 || !this->MergeDuplicatePoints || pointDims[0] < 2 ||
+        pointDims[1] < 2 || pointDims[2] < 2)
     {
-      marchingcubes::GenerateNormals(normals,
-                                     inputField,
-                                     cells,
-                                     coordinateSystem,
-                                     this->InterpolationEdgeIds,
-                                     this->InterpolationWeights);
+      // The explicit template arguments select the sort based path above.
+      this->GenerateTriangles<ValueType,
+                              vtkm::cont::CellSetStructured<3>,
+                              StorageTagField,
+                              DeviceAdapter>(
+        isovalues, numIsoValues, cells, inputField, connectivity, device);
+      return;
     }
 
-    return outputCells;
+    flyingedges::GenerateTriangles(isovalues[0],
+                                   cells,
+                                   inputField,
+                                   this->EdgeTable,
+                                   this->NumTrianglesTable,
+                                   this->TriangleTable,
+                                   this->InterpolationWeights,
+                                   this->InterpolationEdgeIds,
+                                   connectivity,
+                                   this->CellIdMap,
+                                   device);
   }
 
   bool MergeDuplicatePoints;
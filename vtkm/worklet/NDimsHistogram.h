@@ -29,8 +29,7 @@
 #include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
-#include <vtkm/worklet/histogram/ComputeNDHistogram.h>
-#include <vtkm/worklet/histogram/ComputeNDHistogram.h>
+#include <vtkm/worklet/histogram/ComputeBinCounts.h>
 #include <vtkm/worklet/histogram/ComputeNDHistogram.h>
 
 #include <vtkm/cont/Field.h>
@@ -63,6 +62,23 @@ public:
                 vtkm::Id numberOfBins,
                 vtkm::Range& rangeOfValues,
                 vtkm::Float64& binDelta,
+                DeviceAdapter device)
+  {
+    this->AddField(fieldArray, numberOfBins, rangeOfValues, binDelta, false, device);
+  }
+
+  // Add a field and the bin number for this field
+  // If rangeProvided is true, rangeOfValues is the range to bin (for example
+  // the cached range of the field) and is not computed from the array again.
+  // Values outside of the range are counted in the first or last bin.
+  // Return: rangeOfRange is min max value of this array, if not provided
+  //         binDelta is delta of a bin
+  template <typename HandleType, typename DeviceAdapter>
+  void AddField(const HandleType& fieldArray,
+                vtkm::Id numberOfBins,
+                vtkm::Range& rangeOfValues,
+                vtkm::Float64& binDelta,
+                bool rangeProvided,
                 DeviceAdapter vtkmNotUsed(device))
   {
     NumberOfBins.push_back(numberOfBins);
@@ -75,7 +91,7 @@ public:
     {
       CastAndCall(fieldArray.ResetTypeList(vtkm::TypeListTagScalarAll()),
                   vtkm::worklet::histogram::ComputeBins<DeviceAdapter>(
-                    Bin1DIndex, numberOfBins, rangeOfValues, binDelta));
+                    Bin1DIndex, numberOfBins, rangeOfValues, binDelta, rangeProvided));
     }
   }
 
@@ -91,18 +107,45 @@ public:
   template <typename DeviceAdapter>
   void Run(std::vector<vtkm::cont::ArrayHandle<vtkm::Id>>& binId,
            vtkm::cont::ArrayHandle<vtkm::Id>& freqs,
-           DeviceAdapter vtkmNotUsed(device))
+           DeviceAdapter device)
   {
     typedef typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter> DeviceAlgorithms;
 
     binId.resize(NumberOfBins.size());
 
-    // Sort the resulting bin(1D) array for counting
-    DeviceAlgorithms::Sort(Bin1DIndex);
+    // Count the frequency of each bin. When the bins of all the fields are
+    // not many more than the data points, they are counted in a single pass
+    // and the empty bins are removed. Otherwise the sparse bins are found by
+    // sorting the bin ids.
+    vtkm::Id totalNumberOfBins = 1;
+    for (vtkm::Id nFieldBins : NumberOfBins)
+    {
+      if (totalNumberOfBins > MAX_COUNTED_BINS_PER_POINT * NumDataPoints / nFieldBins)
+      {
+        totalNumberOfBins = -1;
+        break;
+      }
+      totalNumberOfBins *= nFieldBins;
+    }
 
-    // Count frequency of each bin
-    vtkm::cont::ArrayHandleConstant<vtkm::Id> constArray(1, NumDataPoints);
-    DeviceAlgorithms::ReduceByKey(Bin1DIndex, constArray, Bin1DIndex, freqs, vtkm::Add());
+    if (totalNumberOfBins > 0)
+    {
+      vtkm::cont::ArrayHandle<vtkm::Id> counts;
+      vtkm::worklet::histogram::ComputeBinCounts(
+        Bin1DIndex, vtkm::worklet::histogram::IdentityBin(), totalNumberOfBins, counts, device);
+
+      vtkm::cont::ArrayHandleCounting<vtkm::Id> allBins(0, 1, totalNumberOfBins);
+      DeviceAlgorithms::CopyIf(allBins, counts, Bin1DIndex);
+      DeviceAlgorithms::CopyIf(counts, counts, freqs);
+    }
+    else
+    {
+      // Sort the resulting bin(1D) array for counting
+      DeviceAlgorithms::Sort(Bin1DIndex);
+
+      vtkm::cont::ArrayHandleConstant<vtkm::Id> constArray(1, NumDataPoints);
+      DeviceAlgorithms::ReduceByKey(Bin1DIndex, constArray, Bin1DIndex, freqs, vtkm::Add());
+    }
 
     //convert back to multi variate binId
     for (vtkm::Id i = static_cast<vtkm::Id>(NumberOfBins.size()) - 1; i >= 0; i--)
@@ -117,6 +160,9 @@ public:
   }
 
 private:
+  // Bins are counted densely up to this many bins per data point.
+  static const vtkm::Id MAX_COUNTED_BINS_PER_POINT = 4;
+
   std::vector<vtkm::Id> NumberOfBins;
   vtkm::cont::ArrayHandle<vtkm::Id> Bin1DIndex;
   vtkm::Id NumDataPoints;
@@ -0,0 +1,439 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+//============================================================================
+#ifndef vtk_m_worklet_contour_FlyingEdges_h
+#define vtk_m_worklet_contour_FlyingEdges_h
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+
+/// Flying Edges variant of the marching cubes edge generation for structured
+/// grids with a single iso-value.
+///
+/// The sort based point merging of \c MarchingCubes needs to sort an edge
+/// key for every triangle vertex. On a structured grid every edge can instead
+/// be named by its lower point and its axis, so the output points can be
+/// numbered directly: each row of points along x is classified independently
+/// to count the edges it owns that cross the iso-value and the triangles of
+/// its row of cells, a prefix sum over the rows gives every row its output
+/// offsets, and a second pass over the rows writes the points and the
+/// triangles. No sort or search is needed and every pass streams through the
+/// field along x.
+///
+/// The points are numbered by their lower point and then x, y, z axis, which
+/// is the order of the sorted edge keys, so the output is identical to the
+/// merged output of the sort based path.
+namespace flyingedges
+{
+
+// Offsets of the hexahedron vertices from its lower point, in the vertex
+// order of the case tables.
+VTKM_EXEC inline vtkm::IdComponent VertexOffsetX(vtkm::IdComponent vertex)
+{
+  return ((vertex + 1) >> 1) & 1;
+}
+VTKM_EXEC inline vtkm::IdComponent VertexOffsetY(vtkm::IdComponent vertex)
+{
+  return (vertex >> 1) & 1;
+}
+VTKM_EXEC inline vtkm::IdComponent VertexOffsetZ(vtkm::IdComponent vertex)
+{
+  return vertex >> 2;
+}
+
+/// Returns a bit mask of the +x (1), +y (2) and +z (4) edges starting at the
+/// point (i, j, k) that cross the iso-value.
+template <typename FieldPortalType, typename T>
+VTKM_EXEC inline vtkm::IdComponent EdgeCrossings(const FieldPortalType& field,
+                                                 const vtkm::Id3& pointDims,
+                                                 vtkm::Id i,
+                                                 vtkm::Id j,
+                                                 vtkm::Id k,
+                                                 const T& isovalue)
+{
+  const vtkm::Id pointId = i + pointDims[0] * (j + pointDims[1] * k);
+  const bool above = field.Get(pointId) > isovalue;
+
+  vtkm::IdComponent crossings = 0;
+  if ((i + 1 < pointDims[0]) && ((field.Get(pointId + 1) > isovalue) != above))
+  {
+    crossings |= 1;
+  }
+  if ((j + 1 < pointDims[1]) && ((field.Get(pointId + pointDims[0]) > isovalue) != above))
+  {
+    crossings |= 2;
+  }
+  if ((k + 1 < pointDims[2]) &&
+      ((field.Get(pointId + pointDims[0] * pointDims[1]) > isovalue) != above))
+  {
+    crossings |= 4;
+  }
+  return crossings;
+}
+
+VTKM_EXEC inline vtkm::IdComponent NumberOfCrossings(vtkm::IdComponent crossings)
+{
+  return (crossings & 1) + ((crossings >> 1) & 1) + ((crossings >> 2) & 1);
+}
+
+/// Returns the marching cubes case of the cell (i, j, k).
+template <typename FieldPortalType, typename T>
+VTKM_EXEC inline vtkm::IdComponent CaseNumber(const FieldPortalType& field,
+                                              const vtkm::Id3& pointDims,
+                                              vtkm::Id i,
+                                              vtkm::Id j,
+                                              vtkm::Id k,
+                                              const T& isovalue)
+{
+  const vtkm::Id pointId = i + pointDims[0] * (j + pointDims[1] * k);
+  vtkm::IdComponent caseNumber = 0;
+  for (vtkm::IdComponent vertex = 0; vertex < 8; ++vertex)
+  {
+    const vtkm::Id vertexId = pointId + VertexOffsetX(vertex) +
+      pointDims[0] * (VertexOffsetY(vertex) + pointDims[1] * VertexOffsetZ(vertex));
+    caseNumber |= (field.Get(vertexId) > isovalue) << vertex;
+  }
+  return caseNumber;
+}
+
+/// \brief Counts the output points and triangles of a row
+///
+/// A row is the line of points along x at (j, k). It owns the points of the
+/// edges starting at its points and the triangles of the cells between it
+/// and the rows at j + 1 and k + 1.
+// -----------------------------------------------------------------------------
+template <typename T>
+class ClassifyRows : public vtkm::worklet::WorkletMapField
+{
+public:
+  struct FieldTagType : vtkm::ListTagBase<T>
+  {
+  };
+
+  typedef void ControlSignature(FieldIn<IdType> rowIds,
+                                WholeArrayIn<FieldTagType> field,
+                                WholeArrayIn<IdComponentType> numTrianglesTable,
+                                FieldOut<IdType> numPoints,
+                                FieldOut<IdType> numTriangles);
+  typedef void ExecutionSignature(_1, _2, _3, _4, _5);
+  typedef _1 InputDomain;
+
+  VTKM_CONT
+  ClassifyRows(const vtkm::Id3& pointDims, const T& isovalue)
+    : PointDims(pointDims)
+    , IsoValue(isovalue)
+  {
+  }
+
+  template <typename FieldPortalType, typename NumTrianglesTablePortalType>
+  VTKM_EXEC void operator()(vtkm::Id rowId,
+                            const FieldPortalType& field,
+                            const NumTrianglesTablePortalType& numTrianglesTable,
+                            vtkm::Id& numPoints,
+                            vtkm::Id& numTriangles) const
+  {
+    const vtkm::Id j = rowId % this->PointDims[1];
+    const vtkm::Id k = rowId / this->PointDims[1];
+
+    numPoints = 0;
+    for (vtkm::Id i = 0; i < this->PointDims[0]; ++i)
+    {
+      numPoints +=
+        NumberOfCrossings(EdgeCrossings(field, this->PointDims, i, j, k, this->IsoValue));
+    }
+
+    numTriangles = 0;
+    if ((j + 1 < this->PointDims[1]) && (k + 1 < this->PointDims[2]))
+    {
+      for (vtkm::Id i = 0; i + 1 < this->PointDims[0]; ++i)
+      {
+        numTriangles +=
+          numTrianglesTable.Get(CaseNumber(field, this->PointDims, i, j, k, this->IsoValue));
+      }
+    }
+  }
+
+private:
+  vtkm::Id3 PointDims;
+  T IsoValue;
+};
+
+/// \brief Used to store data need for the GenerateRows worklet.
+/// This information is not passed as part of the arguments to the worklet to
+/// keep the compile time down, as is done for EdgeWeightGenerate.
+// -----------------------------------------------------------------------------
+template <typename DeviceAdapter>
+class GenerateRowsMetaData
+{
+  template <typename FieldType>
+  struct PortalTypes
+  {
+    typedef vtkm::cont::ArrayHandle<FieldType> HandleType;
+    typedef typename HandleType::template ExecutionTypes<DeviceAdapter> ExecutionTypes;
+
+    typedef typename ExecutionTypes::Portal Portal;
+    typedef typename ExecutionTypes::PortalConst PortalConst;
+  };
+
+public:
+  VTKM_CONT
+  GenerateRowsMetaData(vtkm::Id numPoints,
+                       vtkm::Id numTriangles,
+                       const vtkm::cont::ArrayHandle<vtkm::Id>& pointOffsets,
+                       vtkm::cont::ArrayHandle<vtkm::FloatDefault>& interpWeights,
+                       vtkm::cont::ArrayHandle<vtkm::Id2>& interpIds,
+                       vtkm::cont::ArrayHandle<vtkm::Id>& connectivity,
+                       vtkm::cont::ArrayHandle<vtkm::Id>& cellIds,
+                       const vtkm::cont::ArrayHandle<vtkm::IdComponent>& edgeTable,
+                       const vtkm::cont::ArrayHandle<vtkm::IdComponent>& numTriTable,
+                       const vtkm::cont::ArrayHandle<vtkm::IdComponent>& triTable)
+    : PointOffsets(pointOffsets.PrepareForInput(DeviceAdapter()))
+    , InterpWeightsPortal(interpWeights.PrepareForOutput(numPoints, DeviceAdapter()))
+    , InterpIdPortal(interpIds.PrepareForOutput(numPoints, DeviceAdapter()))
+    , ConnectivityPortal(connectivity.PrepareForOutput(3 * numTriangles, DeviceAdapter()))
+    , CellIdPortal(cellIds.PrepareForOutput(numTriangles, DeviceAdapter()))
+    , EdgeTable(edgeTable.PrepareForInput(DeviceAdapter()))
+    , NumTriTable(numTriTable.PrepareForInput(DeviceAdapter()))
+    , TriTable(triTable.PrepareForInput(DeviceAdapter()))
+  {
+  }
+  typename PortalTypes<vtkm::Id>::PortalConst PointOffsets;
+  typename PortalTypes<vtkm::FloatDefault>::Portal InterpWeightsPortal;
+  typename PortalTypes<vtkm::Id2>::Portal InterpIdPortal;
+  typename PortalTypes<vtkm::Id>::Portal ConnectivityPortal;
+  typename PortalTypes<vtkm::Id>::Portal CellIdPortal;
+  typename PortalTypes<vtkm::IdComponent>::PortalConst EdgeTable;
+  typename PortalTypes<vtkm::IdComponent>::PortalConst NumTriTable;
+  typename PortalTypes<vtkm::IdComponent>::PortalConst TriTable;
+};
+
+/// \brief Writes the output points and triangles of a row
+///
+/// The points of a row are written from the row's point offset. The
+/// triangles of its cells refer to points owned by the four rows around
+/// the cells, which are tracked with a running point id per row.
+// -----------------------------------------------------------------------------
+template <typename T, typename DeviceAdapter>
+class GenerateRows : public vtkm::worklet::WorkletMapField
+{
+public:
+  struct FieldTagType : vtkm::ListTagBase<T>
+  {
+  };
+
+  typedef void ControlSignature(FieldIn<IdType> rowIds,
+                                FieldIn<IdType> triangleOffsets,
+                                WholeArrayIn<FieldTagType> field);
+  typedef void ExecutionSignature(_1, _2, _3);
+  typedef _1 InputDomain;
+
+  VTKM_CONT
+  GenerateRows(const vtkm::Id3& pointDims,
+               const T& isovalue,
+               const GenerateRowsMetaData<DeviceAdapter>& meta)
+    : PointDims(pointDims)
+    , IsoValue(isovalue)
+    , MetaData(meta)
+  {
+  }
+
+  template <typename FieldPortalType>
+  VTKM_EXEC void operator()(vtkm::Id rowId,
+                            vtkm::Id triangleOffset,
+                            const FieldPortalType& field) const
+  {
+    const vtkm::Id j = rowId % this->PointDims[1];
+    const vtkm::Id k = rowId / this->PointDims[1];
+    const vtkm::Id axisStep[3] = { 1, this->PointDims[0], this->PointDims[0] * this->PointDims[1] };
+
+    vtkm::Id outputPointId = this->MetaData.PointOffsets.Get(rowId);
+    for (vtkm::Id i = 0; i < this->PointDims[0]; ++i)
+    {
+      const vtkm::IdComponent crossings =
+        EdgeCrossings(field, this->PointDims, i, j, k, this->IsoValue);
+      const vtkm::Id pointId = i + this->PointDims[0] * rowId;
+      for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+      {
+        if (crossings & (1 << axis))
+        {
+          const vtkm::Id otherPointId = pointId + axisStep[axis];
+          const T fieldValue0 = field.Get(pointId);
+          const T fieldValue1 = field.Get(otherPointId);
+          this->MetaData.InterpIdPortal.Set(outputPointId, vtkm::Id2(pointId, otherPointId));
+          this->MetaData.InterpWeightsPortal.Set(
+            outputPointId,
+            static_cast<vtkm::FloatDefault>(this->IsoValue - fieldValue0) /
+              static_cast<vtkm::FloatDefault>(fieldValue1 - fieldValue0));
+          ++outputPointId;
+        }
+      }
+    }
+
+    if ((j + 1 >= this->PointDims[1]) || (k + 1 >= this->PointDims[2]))
+    {
+      return;
+    }
+
+    // The four rows around the cells, indexed by y offset + 2 * z offset.
+    // For each, the first output point of the current column and the edges
+    // crossing at the current and the next column.
+    vtkm::Id rowPointIds[4];
+    vtkm::IdComponent crossings0[4];
+    vtkm::IdComponent crossings1[4];
+    for (vtkm::IdComponent row = 0; row < 4; ++row)
+    {
+      const vtkm::Id rowJ = j + (row & 1);
+      const vtkm::Id rowK = k + (row >> 1);
+      rowPointIds[row] = this->MetaData.PointOffsets.Get(rowJ + this->PointDims[1] * rowK);
+      crossings0[row] = EdgeCrossings(field, this->PointDims, 0, rowJ, rowK, this->IsoValue);
+    }
+
+    vtkm::Id outputCellId = triangleOffset;
+    for (vtkm::Id i = 0; i + 1 < this->PointDims[0]; ++i)
+    {
+      for (vtkm::IdComponent row = 0; row < 4; ++row)
+      {
+        crossings1[row] = EdgeCrossings(
+          field, this->PointDims, i + 1, j + (row & 1), k + (row >> 1), this->IsoValue);
+      }
+
+      const vtkm::IdComponent caseNumber =
+        CaseNumber(field, this->PointDims, i, j, k, this->IsoValue);
+      const vtkm::IdComponent numTriangles = this->MetaData.NumTriTable.Get(caseNumber);
+      const vtkm::Id inputCellId =
+        i + (this->PointDims[0] - 1) * (j + (this->PointDims[1] - 1) * k);
+
+      // Triangles are emitted in the same order as EdgeWeightGenerate.
+      for (vtkm::IdComponent triangle = numTriangles - 1; triangle >= 0; --triangle)
+      {
+        const vtkm::Id triTableOffset = static_cast<vtkm::Id>(caseNumber * 16 + triangle * 3);
+        for (vtkm::IdComponent triVertex = 0; triVertex < 3; ++triVertex)
+        {
+          const vtkm::IdComponent edgeIndex =
+            this->MetaData.TriTable.Get(triTableOffset + triVertex);
+          const vtkm::IdComponent vertex0 = this->MetaData.EdgeTable.Get(2 * edgeIndex + 0);
+          const vtkm::IdComponent vertex1 = this->MetaData.EdgeTable.Get(2 * edgeIndex + 1);
+          const vtkm::IdComponent axis = (VertexOffsetX(vertex0) != VertexOffsetX(vertex1))
+            ? 0
+            : ((VertexOffsetY(vertex0) != VertexOffsetY(vertex1)) ? 1 : 2);
+
+          const vtkm::IdComponent row = VertexOffsetY(vertex0) + 2 * VertexOffsetZ(vertex0);
+          vtkm::Id edgePointId = rowPointIds[row];
+          vtkm::IdComponent crossings = crossings0[row];
+          if (VertexOffsetX(vertex0) == 1)
+          {
+            edgePointId += NumberOfCrossings(crossings0[row]);
+            crossings = crossings1[row];
+          }
+          // The points of a lower point are ordered by the axis of their edge.
+          edgePointId += NumberOfCrossings(crossings & ((1 << axis) - 1));
+
+          this->MetaData.ConnectivityPortal.Set(3 * outputCellId + triVertex, edgePointId);
+        }
+        this->MetaData.CellIdPortal.Set(outputCellId, inputCellId);
+        ++outputCellId;
+      }
+
+      for (vtkm::IdComponent row = 0; row < 4; ++row)
+      {
+        rowPointIds[row] += NumberOfCrossings(crossings0[row]);
+        crossings0[row] = crossings1[row];
+      }
+    }
+  }
+
+private:
+  vtkm::Id3 PointDims;
+  T IsoValue;
+  GenerateRowsMetaData<DeviceAdapter> MetaData;
+
+  void operator=(const GenerateRows<T, DeviceAdapter>&) = delete;
+};
+
+/// \brief Generates the triangles of the iso-surface of a structured grid.
+///
+/// Fills the merged interpolation edge ids and weights of the output points,
+/// the triangle connectivity and the input cell of each triangle, as the
+/// merged sort based path of \c MarchingCubes does.
+// -----------------------------------------------------------------------------
+template <typename ValueType, typename StorageTagField, typename DeviceAdapter>
+void GenerateTriangles(const ValueType& isovalue,
+                       const vtkm::cont::CellSetStructured<3>& cells,
+                       const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
+                       const vtkm::cont::ArrayHandle<vtkm::IdComponent>& edgeTable,
+                       const vtkm::cont::ArrayHandle<vtkm::IdComponent>& numTriTable,
+                       const vtkm::cont::ArrayHandle<vtkm::IdComponent>& triTable,
+                       vtkm::cont::ArrayHandle<vtkm::FloatDefault>& interpWeights,
+                       vtkm::cont::ArrayHandle<vtkm::Id2>& interpIds,
+                       vtkm::cont::ArrayHandle<vtkm::Id>& connectivity,
+                       vtkm::cont::ArrayHandle<vtkm::Id>& cellIds,
+                       DeviceAdapter)
+{
+  using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+  const vtkm::Id3 pointDims = cells.GetPointDimensions();
+  vtkm::cont::ArrayHandleIndex rowIds(pointDims[1] * pointDims[2]);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> numPointsPerRow;
+  vtkm::cont::ArrayHandle<vtkm::Id> numTrianglesPerRow;
+  {
+    ClassifyRows<ValueType> classifyRows(pointDims, isovalue);
+    vtkm::worklet::DispatcherMapField<ClassifyRows<ValueType>, DeviceAdapter> dispatcher(
+      classifyRows);
+    dispatcher.Invoke(rowIds, inputField, numTriTable, numPointsPerRow, numTrianglesPerRow);
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> pointOffsets;
+  vtkm::cont::ArrayHandle<vtkm::Id> triangleOffsets;
+  const vtkm::Id numPoints = Algorithm::ScanExclusive(numPointsPerRow, pointOffsets);
+  const vtkm::Id numTriangles = Algorithm::ScanExclusive(numTrianglesPerRow, triangleOffsets);
+  numPointsPerRow.ReleaseResources();
+  numTrianglesPerRow.ReleaseResources();
+
+  GenerateRowsMetaData<DeviceAdapter> metaData(numPoints,
+                                               numTriangles,
+                                               pointOffsets,
+                                               interpWeights,
+                                               interpIds,
+                                               connectivity,
+                                               cellIds,
+                                               edgeTable,
+                                               numTriTable,
+                                               triTable);
+  GenerateRows<ValueType, DeviceAdapter> generateRows(pointDims, isovalue, metaData);
+  vtkm::worklet::DispatcherMapField<GenerateRows<ValueType, DeviceAdapter>, DeviceAdapter>
+    dispatcher(generateRows);
+  dispatcher.Invoke(rowIds, triangleOffsets, inputField);
+}
+}
+}
+} // namespace vtkm::worklet::flyingedges
+
+#endif // vtk_m_worklet_contour_FlyingEdges_h
@@ -86,6 +86,7 @@
 #include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ArrayHandleReverse.h>
 #include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/cont/ArrayHandleZip.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/ScatterCounting.h>
 
@@ -158,6 +159,27 @@ private:
   ScatterType Scatter;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// Move each value to the position given by a permutation. Passing zipped
+// value and output arrays reorders several arrays with one permutation in a
+// single pass, instead of sorting each of them by the same keys.
+//
+///////////////////////////////////////////////////////////////////////////////
+struct PermuteWorklet : public vtkm::worklet::WorkletMapField
+{
+  typedef void ControlSignature(FieldIn<IdType> permutation,
+                                FieldIn<vtkm::ListTagUniversal> values,
+                                WholeArrayOut<vtkm::ListTagUniversal> output);
+  typedef void ExecutionSignature(_1, _2, _3);
+
+  template <typename T, typename OutPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& index, const T& value, OutPortalType& output) const
+  {
+    output.Set(index, value);
+  }
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // Scale or offset values of an array
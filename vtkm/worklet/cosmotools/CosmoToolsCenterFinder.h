@@ -144,14 +144,14 @@ vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderMxN(T* mxnPot
   std::cout << "Number of worstEstPotential " << worstEstPotential.GetNumberOfValues() << std::endl;
 #endif
 
-  // Sort everything by the best estimated potential per bin
-  vtkm::cont::ArrayHandle<T> tempBest;
-  DeviceAlgorithm::Copy(bestEstPotential, tempBest);
-  DeviceAlgorithm::SortByKey(tempBest, worstEstPotential);
-
-  // Use the worst estimate for the first selected bin to compare to best of all others
-  // Any bin that passes is a candidate for having the MBP
-  T cutoffPotential = worstEstPotential.GetPortalControl().Get(0);
+  // Find the bin with the lowest best estimated potential. Its worst estimate
+  // is compared to the best of all others, and any bin that passes is a
+  // candidate for having the MBP. Only the minimum is needed, so reduce the
+  // (best, worst) pairs rather than sorting them.
+  auto estPotential = vtkm::cont::make_ArrayHandleZip(bestEstPotential, worstEstPotential);
+  vtkm::Pair<T, T> lowestBin = estPotential.GetPortalConstControl().Get(0);
+  lowestBin = DeviceAlgorithm::Reduce(estPotential, lowestBin, vtkm::Minimum());
+  T cutoffPotential = lowestBin.second;
 
   vtkm::cont::ArrayHandle<vtkm::Id> candidate;
   DeviceAlgorithm::Copy(vtkm::cont::ArrayHandleConstant<vtkm::Id>(0, nParticles), candidate);
@@ -180,16 +180,19 @@ vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderMxN(T* mxnPot
                                                 zLoc,        // input (whole array)
                                                 mpotential); // output
 
-  // Of the M candidate particles which has the minimum potential
-  DeviceAlgorithm::SortByKey(mpotential, mparticles);
 #ifdef DEBUG_PRINT
   DebugPrint("mparticles", mparticles);
   DebugPrint("mpotential", mpotential);
 #endif
 
+  // Of the M candidate particles which has the minimum potential
+  auto candidates = vtkm::cont::make_ArrayHandleZip(mpotential, mparticles);
+  vtkm::Pair<T, vtkm::Id> minimum = candidates.GetPortalConstControl().Get(0);
+  minimum = DeviceAlgorithm::Reduce(candidates, minimum, vtkm::Minimum());
+
   // Return the found MBP particle and its potential
-  vtkm::Id mxnMBP = mparticles.GetPortalControl().Get(0);
-  *mxnPotential = mpotential.GetPortalControl().Get(0);
+  vtkm::Id mxnMBP = minimum.second;
+  *mxnPotential = minimum.first;
 
   return mxnMBP;
 }
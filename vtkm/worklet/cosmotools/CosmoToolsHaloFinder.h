@@ -391,15 +391,23 @@ void CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFindingByHalo(
   DeviceAlgorithm::ReduceByKey(haloId, mbpId, uniqueHaloIds, minIndx, vtkm::Maximum());
   scatterWorkletIdDispatcher.Invoke(minIndx, mbpId);
 
-  // Resort particle ids and mbpId to starting order
-  vtkm::cont::ArrayHandle<vtkm::Id> savePartId;
-  DeviceAlgorithm::Copy(partId, savePartId);
-
-  DeviceAlgorithm::SortByKey(partId, haloId);
-  DeviceAlgorithm::Copy(savePartId, partId);
-  DeviceAlgorithm::SortByKey(partId, mbpId);
-  DeviceAlgorithm::Copy(savePartId, partId);
-  DeviceAlgorithm::SortByKey(partId, minPotential);
+  // Return haloId, mbpId and minPotential to the starting particle order.
+  // partId holds the starting position of each sorted particle, so one pass
+  // moves all three arrays there.
+  vtkm::cont::ArrayHandle<vtkm::Id> startHaloId;
+  vtkm::cont::ArrayHandle<vtkm::Id> startMbpId;
+  vtkm::cont::ArrayHandle<T> startMinPotential;
+  auto startOrder = vtkm::cont::make_ArrayHandleZip(
+    startHaloId, vtkm::cont::make_ArrayHandleZip(startMbpId, startMinPotential));
+  startOrder.Allocate(nParticles);
+  vtkm::worklet::DispatcherMapField<PermuteWorklet>().Invoke(
+    partId,
+    vtkm::cont::make_ArrayHandleZip(haloId, vtkm::cont::make_ArrayHandleZip(mbpId, minPotential)),
+    startOrder);
+  haloId = startHaloId;
+  mbpId = startMbpId;
+  minPotential = startMinPotential;
+  DeviceAlgorithm::Copy(indexArray, partId);
 
 #ifdef DEBUG_PRINT
   std::cout << std::endl;
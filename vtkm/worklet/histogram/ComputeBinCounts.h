@@ -0,0 +1,247 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_histogram_ComputeBinCounts_h
+#define vtk_m_worklet_histogram_ComputeBinCounts_h
+
+#include <vtkm/Math.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/cuda/internal/DeviceAdapterTagCuda.h>
+#include <vtkm/cont/serial/internal/DeviceAdapterTagSerial.h>
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace histogram
+{
+
+/// Bin counts above this are counted with atomic increments into a single
+/// array rather than with private bins per block of values.
+static const vtkm::Id MAX_PRIVATE_BINS = vtkm::Id(1) << 16;
+
+/// Lower bound on the number of values counted by a block.
+static const vtkm::Id MIN_VALUES_PER_BLOCK = 4096;
+
+/// Upper bound on the number of blocks, and so of private copies of the bins,
+/// on a device. Host threads are kept busy by a few blocks each, while a GPU
+/// needs many more blocks to be filled. The number of values and bins bounds
+/// the number of blocks further (see ComputeBinCounts).
+template <typename DeviceAdapter>
+inline vtkm::Id GetMaximumNumberOfBlocks(DeviceAdapter)
+{
+  return 4 * static_cast<vtkm::Id>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+inline vtkm::Id GetMaximumNumberOfBlocks(vtkm::cont::DeviceAdapterTagSerial)
+{
+  return 1;
+}
+
+inline vtkm::Id GetMaximumNumberOfBlocks(vtkm::cont::DeviceAdapterTagCuda)
+{
+  return vtkm::Id(1) << 16;
+}
+
+// Bins of values that already are bin ids.
+struct IdentityBin
+{
+  VTKM_EXEC
+  vtkm::Id operator()(vtkm::Id binId) const { return binId; }
+};
+
+// Counts a contiguous block of the values into the block's own bins.
+template <typename BinMapperType>
+class CountBlockBins : public vtkm::worklet::WorkletMapField
+{
+public:
+  typedef void ControlSignature(FieldIn<IdType> blockIds,
+                                WholeArrayIn<vtkm::ListTagUniversal> values,
+                                WholeArrayInOut<IdType> blockBins);
+  typedef void ExecutionSignature(_1, _2, _3);
+  typedef _1 InputDomain;
+
+  VTKM_CONT
+  CountBlockBins(const BinMapperType& binMapper,
+                 vtkm::Id numberOfValues,
+                 vtkm::Id numberOfBlocks,
+                 vtkm::Id numberOfBins)
+    : BinMapper(binMapper)
+    , NumberOfValues(numberOfValues)
+    , NumberOfBlocks(numberOfBlocks)
+    , NumberOfBins(numberOfBins)
+  {
+  }
+
+  template <typename ValuesPortalType, typename BinsPortalType>
+  VTKM_EXEC void operator()(vtkm::Id blockId,
+                            const ValuesPortalType& values,
+                            const BinsPortalType& blockBins) const
+  {
+    const vtkm::Id begin = (blockId * this->NumberOfValues) / this->NumberOfBlocks;
+    const vtkm::Id end = ((blockId + 1) * this->NumberOfValues) / this->NumberOfBlocks;
+    const vtkm::Id offset = blockId * this->NumberOfBins;
+    for (vtkm::Id index = begin; index < end; ++index)
+    {
+      const vtkm::Id binId = offset + this->BinMapper(values.Get(index));
+      blockBins.Set(binId, blockBins.Get(binId) + 1);
+    }
+  }
+
+private:
+  BinMapperType BinMapper;
+  vtkm::Id NumberOfValues;
+  vtkm::Id NumberOfBlocks;
+  vtkm::Id NumberOfBins;
+};
+
+// Sums the private bins of all the blocks.
+class MergeBlockBins : public vtkm::worklet::WorkletMapField
+{
+public:
+  typedef void ControlSignature(FieldIn<IdType> binIds,
+                                WholeArrayIn<IdType> blockBins,
+                                FieldOut<IdType> counts);
+  typedef void ExecutionSignature(_1, _2, _3);
+  typedef _1 InputDomain;
+
+  VTKM_CONT
+  MergeBlockBins(vtkm::Id numberOfBlocks, vtkm::Id numberOfBins)
+    : NumberOfBlocks(numberOfBlocks)
+    , NumberOfBins(numberOfBins)
+  {
+  }
+
+  template <typename BinsPortalType>
+  VTKM_EXEC void operator()(vtkm::Id binId,
+                            const BinsPortalType& blockBins,
+                            vtkm::Id& count) const
+  {
+    count = 0;
+    for (vtkm::Id blockId = 0; blockId < this->NumberOfBlocks; ++blockId)
+    {
+      count += blockBins.Get(blockId * this->NumberOfBins + binId);
+    }
+  }
+
+private:
+  vtkm::Id NumberOfBlocks;
+  vtkm::Id NumberOfBins;
+};
+
+// Counts each value with an atomic increment of its bin.
+template <typename BinMapperType>
+class CountBinsAtomic : public vtkm::worklet::WorkletMapField
+{
+public:
+  typedef void ControlSignature(FieldIn<vtkm::ListTagUniversal> values,
+                                AtomicArrayInOut<IdType> counts);
+  typedef void ExecutionSignature(_1, _2);
+  typedef _1 InputDomain;
+
+  VTKM_CONT
+  CountBinsAtomic(const BinMapperType& binMapper)
+    : BinMapper(binMapper)
+  {
+  }
+
+  template <typename ValueType, typename AtomicArrayType>
+  VTKM_EXEC void operator()(const ValueType& value, const AtomicArrayType& counts) const
+  {
+    counts.Add(this->BinMapper(value), 1);
+  }
+
+private:
+  BinMapperType BinMapper;
+};
+
+/// \brief Counts the number of values in each bin in a single pass.
+///
+/// \c binMapper maps a value to its bin, in [0, numberOfBins). The values
+/// are split in contiguous blocks which are counted into private bins per
+/// block, and the private bins are summed at the end. The number of blocks
+/// is chosen so that each block counts at least as many values as there are
+/// bins, which keeps the merge cheaper than the counting, and there are at
+/// most \c maximumNumberOfBlocks blocks. Large numbers of bins are instead
+/// counted with atomic increments into one array.
+template <typename ValueType, typename Storage, typename BinMapperType, typename DeviceAdapter>
+void ComputeBinCounts(const vtkm::cont::ArrayHandle<ValueType, Storage>& values,
+                      const BinMapperType& binMapper,
+                      vtkm::Id numberOfBins,
+                      vtkm::cont::ArrayHandle<vtkm::Id>& counts,
+                      vtkm::Id maximumNumberOfBlocks,
+                      DeviceAdapter)
+{
+  using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+  const vtkm::Id numberOfValues = values.GetNumberOfValues();
+  if (numberOfBins > MAX_PRIVATE_BINS)
+  {
+    Algorithm::Copy(vtkm::cont::ArrayHandleConstant<vtkm::Id>(0, numberOfBins), counts);
+    CountBinsAtomic<BinMapperType> countWorklet(binMapper);
+    vtkm::worklet::DispatcherMapField<CountBinsAtomic<BinMapperType>, DeviceAdapter> dispatcher(
+      countWorklet);
+    dispatcher.Invoke(values, counts);
+    return;
+  }
+
+  vtkm::Id numberOfBlocks = numberOfValues / vtkm::Max(numberOfBins, MIN_VALUES_PER_BLOCK);
+  numberOfBlocks = vtkm::Max(vtkm::Id(1), vtkm::Min(numberOfBlocks, maximumNumberOfBlocks));
+
+  vtkm::cont::ArrayHandle<vtkm::Id> blockBins;
+  Algorithm::Copy(vtkm::cont::ArrayHandleConstant<vtkm::Id>(0, numberOfBlocks * numberOfBins),
+                  blockBins);
+  {
+    CountBlockBins<BinMapperType> countWorklet(
+      binMapper, numberOfValues, numberOfBlocks, numberOfBins);
+    vtkm::worklet::DispatcherMapField<CountBlockBins<BinMapperType>, DeviceAdapter> dispatcher(
+      countWorklet);
+    dispatcher.Invoke(vtkm::cont::ArrayHandleIndex(numberOfBlocks), values, blockBins);
+  }
+
+  MergeBlockBins mergeWorklet(numberOfBlocks, numberOfBins);
+  vtkm::worklet::DispatcherMapField<MergeBlockBins, DeviceAdapter> dispatcher(mergeWorklet);
+  dispatcher.Invoke(vtkm::cont::ArrayHandleIndex(numberOfBins), blockBins, counts);
+}
+
+/// Counts the number of values in each bin with at most as many blocks as
+/// suit \c device (see GetMaximumNumberOfBlocks).
+template <typename ValueType, typename Storage, typename BinMapperType, typename DeviceAdapter>
+void ComputeBinCounts(const vtkm::cont::ArrayHandle<ValueType, Storage>& values,
+                      const BinMapperType& binMapper,
+                      vtkm::Id numberOfBins,
+                      vtkm::cont::ArrayHandle<vtkm::Id>& counts,
+                      DeviceAdapter device)
+{
+  ComputeBinCounts(
+    values, binMapper, numberOfBins, counts, GetMaximumNumberOfBlocks(device), device);
+}
+}
+}
+} // namespace vtkm::worklet::histogram
+
+#endif // vtk_m_worklet_histogram_ComputeBinCounts_h
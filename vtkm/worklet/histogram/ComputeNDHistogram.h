@@ -91,11 +91,13 @@ public:
   ComputeBins(vtkm::cont::ArrayHandle<vtkm::Id>& _bin1DIdx,
               vtkm::Id& _numOfBins,
               vtkm::Range& _minMax,
-              vtkm::Float64& _binDelta)
+              vtkm::Float64& _binDelta,
+              bool _rangeProvided = false)
     : Bin1DIdx(_bin1DIdx)
     , NumOfBins(_numOfBins)
     , MinMax(_minMax)
     , BinDelta(_binDelta)
+    , RangeProvided(_rangeProvided)
   {
   }
 
@@ -104,10 +106,13 @@ public:
   {
     typedef vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter> Algorithm;
 
-    const vtkm::Vec<T, 2> initValue(field.GetPortalConstControl().Get(0));
-    vtkm::Vec<T, 2> minMax = Algorithm::Reduce(field, initValue, vtkm::MinAndMax<T>());
-    MinMax.Min = static_cast<vtkm::Float64>(minMax[0]);
-    MinMax.Max = static_cast<vtkm::Float64>(minMax[1]);
+    if (!RangeProvided)
+    {
+      const vtkm::Vec<T, 2> initValue(field.GetPortalConstControl().Get(0));
+      vtkm::Vec<T, 2> minMax = Algorithm::Reduce(field, initValue, vtkm::MinAndMax<T>());
+      MinMax.Min = static_cast<vtkm::Float64>(minMax[0]);
+      MinMax.Max = static_cast<vtkm::Float64>(minMax[1]);
+    }
     BinDelta = compute_delta(MinMax.Min, MinMax.Max, NumOfBins);
 
     SetHistogramBin<T> binWorklet(NumOfBins, MinMax.Min, BinDelta);
@@ -121,6 +126,7 @@ private:
   vtkm::Id& NumOfBins;
   vtkm::Range& MinMax;
   vtkm::Float64& BinDelta;
+  bool RangeProvided;
 };
 
 // Convert N-dims bin index into 1D index
@@ -0,0 +1,318 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_internal_KeysHashBuilder_h
+#define vtk_m_worklet_internal_KeysHashBuilder_h
+
+#include <vtkm/Math.h>
+#include <vtkm/Pair.h>
+#include <vtkm/TypeTraits.h>
+#include <vtkm/VecTraits.h>
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCast.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace internal
+{
+
+/// \brief Hashes an arbitrary key for the \c KeysHashBuilder table.
+///
+/// Every component of the key is converted to its bit pattern and combined
+/// with a 64-bit FNV-1a hash followed by a final avalanche step so that
+/// consecutive integer keys spread across the whole table. Unlike \c
+/// vtkm::Hash, this works for integers of any width as well as floating point
+/// components.
+///
+struct KeysHashFunctor
+{
+  template <typename T>
+  VTKM_EXEC_CONT static vtkm::UInt64 ComponentBits(const T& value, vtkm::TypeTraitsIntegerTag)
+  {
+    return static_cast<vtkm::UInt64>(value);
+  }
+
+  VTKM_EXEC_CONT
+  static vtkm::UInt64 ComponentBits(vtkm::Float32 value, vtkm::TypeTraitsRealTag)
+  {
+    vtkm::detail::IEEE754Bits32 bits;
+    // Adding zero turns -0 into +0 so that equal keys hash equally.
+    bits.scalar = value + 0.0f;
+    return static_cast<vtkm::UInt64>(bits.bits);
+  }
+
+  VTKM_EXEC_CONT
+  static vtkm::UInt64 ComponentBits(vtkm::Float64 value, vtkm::TypeTraitsRealTag)
+  {
+    vtkm::detail::IEEE754Bits64 bits;
+    bits.scalar = value + 0.0;
+    return bits.bits;
+  }
+
+  template <typename T>
+  VTKM_EXEC_CONT static void Combine(vtkm::UInt64& hash,
+                                     const T& value,
+                                     vtkm::TypeTraitsScalarTag)
+  {
+    hash ^= ComponentBits(value, typename vtkm::TypeTraits<T>::NumericTag());
+    hash *= 1099511628211ULL;
+  }
+
+  template <typename T>
+  VTKM_EXEC_CONT static void Combine(vtkm::UInt64& hash,
+                                     const T& value,
+                                     vtkm::TypeTraitsVectorTag)
+  {
+    using Traits = vtkm::VecTraits<T>;
+    const vtkm::IdComponent numComponents = Traits::GetNumberOfComponents(value);
+    for (vtkm::IdComponent index = 0; index < numComponents; ++index)
+    {
+      Combine(hash, Traits::GetComponent(value, index));
+    }
+  }
+
+  template <typename T>
+  VTKM_EXEC_CONT static void Combine(vtkm::UInt64& hash, const T& value)
+  {
+    Combine(hash, value, typename vtkm::TypeTraits<T>::DimensionalityTag());
+  }
+
+  // Pairs (for example the edge keys of some worklets) hash both members.
+  template <typename T, typename U>
+  VTKM_EXEC_CONT static void Combine(vtkm::UInt64& hash, const vtkm::Pair<T, U>& value)
+  {
+    Combine(hash, value.first);
+    Combine(hash, value.second);
+  }
+
+  template <typename KeyType>
+  VTKM_EXEC_CONT vtkm::UInt64 operator()(const KeyType& key) const
+  {
+    vtkm::UInt64 hash = 14695981039346656037ULL;
+    Combine(hash, key);
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+};
+
+/// \brief Groups keys with a concurrent open-addressing hash table.
+///
+/// \c KeysHashBuilder produces the same arrays as the sort-based build in \c
+/// vtkm::worklet::Keys (unique keys, a map from grouped order to original
+/// value index, and the offset and count of each group) without sorting the
+/// keys. Each key is inserted into a table of value indices with an atomic
+/// compare-and-swap and linear probing, so the whole build runs in a handful
+/// of linear passes over the keys.
+///
+/// The unique keys are ordered by the input index of their first inserted
+/// occurrence, not by value, and the order of values within a group is not
+/// deterministic.
+///
+template <typename DeviceAdapter>
+struct KeysHashBuilder
+{
+  using IdArrayType = vtkm::cont::ArrayHandle<vtkm::Id>;
+  using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+  /// Each key is inserted into the table. The output is the index of the
+  /// first value inserted with the same key, which owns the table entry.
+  class InsertKeys : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    typedef void ControlSignature(FieldIn<vtkm::ListTagUniversal> key,
+                                  WholeArrayIn<vtkm::ListTagUniversal> allKeys,
+                                  AtomicArrayInOut<IdType> table,
+                                  FieldOut<IdType> owner);
+    typedef _4 ExecutionSignature(_1, _2, _3, WorkIndex);
+
+    VTKM_CONT
+    InsertKeys(vtkm::Id tableSize)
+      : Mask(static_cast<vtkm::UInt64>(tableSize - 1))
+    {
+    }
+
+    template <typename KeyType, typename KeyPortalType, typename TableType>
+    VTKM_EXEC vtkm::Id operator()(const KeyType& key,
+                                  const KeyPortalType& allKeys,
+                                  const TableType& table,
+                                  vtkm::Id index) const
+    {
+      vtkm::UInt64 slot = KeysHashFunctor()(key) & this->Mask;
+      while (true)
+      {
+        const vtkm::Id entry = table.CompareAndSwap(static_cast<vtkm::Id>(slot), index, -1);
+        if (entry == -1)
+        {
+          return index;
+        }
+        if (allKeys.Get(entry) == key)
+        {
+          return entry;
+        }
+        slot = (slot + 1) & this->Mask;
+      }
+    }
+
+  private:
+    vtkm::UInt64 Mask;
+  };
+
+  class MarkOwners : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    typedef void ControlSignature(FieldIn<IdType> owner, FieldOut<IdType> isOwner);
+    typedef _2 ExecutionSignature(_1, WorkIndex);
+
+    VTKM_EXEC
+    vtkm::Id operator()(vtkm::Id owner, vtkm::Id index) const { return (owner == index) ? 1 : 0; }
+  };
+
+  /// Converts owners to group ids and counts the values in each group. The
+  /// value returned by the atomic add doubles as the position of the value
+  /// within its group.
+  class CountGroups : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    typedef void ControlSignature(FieldIn<IdType> owner,
+                                  WholeArrayIn<IdType> ownerToGroup,
+                                  AtomicArrayInOut<IdComponentType> counts,
+                                  FieldOut<IdType> group,
+                                  FieldOut<IdComponentType> rank);
+    typedef void ExecutionSignature(_1, _2, _3, _4, _5);
+
+    template <typename OwnerToGroupPortal, typename CountsType>
+    VTKM_EXEC void operator()(vtkm::Id owner,
+                              const OwnerToGroupPortal& ownerToGroup,
+                              const CountsType& counts,
+                              vtkm::Id& group,
+                              vtkm::IdComponent& rank) const
+    {
+      group = ownerToGroup.Get(owner);
+      rank = counts.Add(group, 1);
+    }
+  };
+
+  class ScatterGroups : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    typedef void ControlSignature(FieldIn<vtkm::ListTagUniversal> key,
+                                  FieldIn<IdType> owner,
+                                  FieldIn<IdType> group,
+                                  FieldIn<IdComponentType> rank,
+                                  WholeArrayIn<IdType> offsets,
+                                  WholeArrayOut<IdType> sortedValuesMap,
+                                  WholeArrayOut<vtkm::ListTagUniversal> uniqueKeys);
+    typedef void ExecutionSignature(_1, _2, _3, _4, _5, _6, _7, WorkIndex);
+
+    template <typename KeyType,
+              typename OffsetsPortal,
+              typename SortedValuesMapPortal,
+              typename UniqueKeysPortal>
+    VTKM_EXEC void operator()(const KeyType& key,
+                              vtkm::Id owner,
+                              vtkm::Id group,
+                              vtkm::IdComponent rank,
+                              const OffsetsPortal& offsets,
+                              const SortedValuesMapPortal& sortedValuesMap,
+                              const UniqueKeysPortal& uniqueKeys,
+                              vtkm::Id index) const
+    {
+      sortedValuesMap.Set(offsets.Get(group) + rank, index);
+      if (owner == index)
+      {
+        uniqueKeys.Set(group, key);
+      }
+    }
+  };
+
+  /// Returns the table size used for \c numKeys keys: the smallest power of
+  /// two that keeps the load factor at or below one half.
+  VTKM_CONT
+  static vtkm::Id TableSize(vtkm::Id numKeys)
+  {
+    vtkm::Id tableSize = 16;
+    while (tableSize < 2 * numKeys)
+    {
+      tableSize *= 2;
+    }
+    return tableSize;
+  }
+
+  template <typename KeyArrayType, typename KeyType>
+  VTKM_CONT static void Run(const KeyArrayType& keys,
+                            vtkm::cont::ArrayHandle<KeyType>& uniqueKeys,
+                            IdArrayType& sortedValuesMap,
+                            IdArrayType& offsets,
+                            vtkm::cont::ArrayHandle<vtkm::IdComponent>& counts)
+  {
+    const vtkm::Id numKeys = keys.GetNumberOfValues();
+    const vtkm::Id tableSize = TableSize(numKeys);
+
+    IdArrayType owners;
+    {
+      IdArrayType table;
+      Algorithm::Copy(vtkm::cont::ArrayHandleConstant<vtkm::Id>(-1, tableSize), table);
+
+      vtkm::worklet::DispatcherMapField<InsertKeys, DeviceAdapter> dispatcher(
+        InsertKeys{ tableSize });
+      dispatcher.Invoke(keys, keys, table, owners);
+    }
+
+    // Number the owners in input order to get the group of each key.
+    IdArrayType ownerToGroup;
+    vtkm::Id numUnique;
+    {
+      IdArrayType ownerFlags;
+      vtkm::worklet::DispatcherMapField<MarkOwners, DeviceAdapter>().Invoke(owners, ownerFlags);
+      numUnique = Algorithm::ScanExclusive(ownerFlags, ownerToGroup);
+    }
+
+    IdArrayType groups;
+    vtkm::cont::ArrayHandle<vtkm::IdComponent> ranks;
+    Algorithm::Copy(vtkm::cont::ArrayHandleConstant<vtkm::IdComponent>(0, numUnique), counts);
+    vtkm::worklet::DispatcherMapField<CountGroups, DeviceAdapter>().Invoke(
+      owners, ownerToGroup, counts, groups, ranks);
+
+    vtkm::Id offsetsTotal =
+      Algorithm::ScanExclusive(vtkm::cont::make_ArrayHandleCast(counts, vtkm::Id()), offsets);
+    VTKM_ASSERT(offsetsTotal == numKeys); // Sanity check
+    (void)offsetsTotal;                   // Shut up, compiler
+
+    sortedValuesMap.Allocate(numKeys);
+    uniqueKeys.Allocate(numUnique);
+    vtkm::worklet::DispatcherMapField<ScatterGroups, DeviceAdapter>().Invoke(
+      keys, owners, groups, ranks, offsets, sortedValuesMap, uniqueKeys);
+  }
+};
+}
+}
+} // namespace vtkm::worklet::internal
+
+#endif //vtk_m_worklet_internal_KeysHashBuilder_h
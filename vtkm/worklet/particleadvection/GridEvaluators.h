@@ -22,12 +22,17 @@
 #define vtk_m_worklet_particleadvection_GridEvaluators_h
 
 #include <vtkm/Types.h>
+#include <vtkm/VecFromPortalPermute.h>
 #include <vtkm/VectorAnalysis.h>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/CellLocatorTwoLevelUniformGrid.h>
+#include <vtkm/cont/CellSetExplicit.h>
 #include <vtkm/cont/CellSetStructured.h>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/cont/DynamicArrayHandle.h>
+#include <vtkm/exec/CellInterpolate.h>
+#include <vtkm/exec/FunctorBase.h>
 
 namespace vtkm
 {
@@ -41,6 +46,9 @@ template <typename FieldType>
 class ConstantField
 {
 public:
+  VTKM_CONT
+  ConstantField() {}
+
   VTKM_CONT
   ConstantField(const vtkm::Bounds& bb, const vtkm::Vec<FieldType, 3>& v)
     : bounds{ bb }
@@ -86,6 +94,9 @@ template <typename FieldType>
 class AnalyticalOrbitEvaluate
 {
 public:
+  VTKM_CONT
+  AnalyticalOrbitEvaluate() {}
+
   VTKM_CONT
   AnalyticalOrbitEvaluate(const vtkm::Bounds& bb)
     : bounds{ bb }
@@ -508,6 +519,110 @@ private:
 
 }; //RectilinearGridEvaluate
 
+//Unstructured Grid Evaluator
+//
+// Evaluates a point field on the cells of an explicit cell set (CellSetExplicit
+// or CellSetSingleType) located by a CellLocatorTwoLevelUniformGrid. The
+// locator must be built for DeviceAdapterTag and, like the vector field, must
+// outlive the evaluator.
+//
+// Consecutive positions of a particle usually fall in the same cell, so the
+// evaluator remembers the last cell it found and tests it before searching the
+// locator. The advection worklets give every particle its own copy of the
+// integrator, and therefore of this cache.
+template <typename PortalType,
+          typename FieldType,
+          typename DeviceAdapterTag,
+          typename CellSetType = vtkm::cont::CellSetExplicit<>>
+class UnstructuredGridEvaluate
+{
+  typedef vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>> FieldHandle;
+
+public:
+  VTKM_CONT
+  UnstructuredGridEvaluate()
+    : lastCell(-1)
+  {
+  }
+
+  VTKM_CONT
+  UnstructuredGridEvaluate(const vtkm::cont::CellLocatorTwoLevelUniformGrid& locator,
+                           const FieldHandle& vectorField)
+    : lastCell(-1)
+  {
+    const vtkm::cont::CoordinateSystem& coords = locator.GetCoordinates();
+    if (!coords.GetData().IsType<FieldHandle>())
+      throw vtkm::cont::ErrorInternal("Coordinates are not an explicit array of the field type.");
+    if (!locator.GetCellSet().IsSameType(CellSetType()))
+      throw vtkm::cont::ErrorInternal("Cells are not of the evaluated cell set type.");
+
+    bounds = coords.GetBounds();
+    points = coords.GetData().Cast<FieldHandle>().PrepareForInput(DeviceAdapterTag());
+    cells = locator.GetCellSet().Cast<CellSetType>().PrepareForInput(
+      DeviceAdapterTag(), vtkm::TopologyElementTagPoint(), vtkm::TopologyElementTagCell());
+    lookup = locator.PrepareForDevice(DeviceAdapterTag());
+    vectors = vectorField.PrepareForInput(DeviceAdapterTag());
+  }
+
+  VTKM_EXEC_CONT
+  bool IsWithinBoundary(const vtkm::Vec<FieldType, 3>& position) const
+  {
+    if (!bounds.Contains(position))
+      return false;
+    return true;
+  }
+
+  VTKM_EXEC_CONT
+  void GetBoundary(vtkm::Vec<FieldType, 3>& dir, vtkm::Vec<FieldType, 3>& dirBounds) const
+  {
+    dirBounds[0] = static_cast<FieldType>(dir[0] > 0 ? bounds.X.Max : bounds.X.Min);
+    dirBounds[1] = static_cast<FieldType>(dir[1] > 0 ? bounds.Y.Max : bounds.Y.Min);
+    dirBounds[2] = static_cast<FieldType>(dir[2] > 0 ? bounds.Z.Max : bounds.Z.Min);
+  }
+
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& pos, vtkm::Vec<FieldType, 3>& out) const
+  {
+    if (!bounds.Contains(pos))
+      return false;
+
+    vtkm::Vec<vtkm::FloatDefault, 3> point(pos);
+    vtkm::Vec<vtkm::FloatDefault, 3> pcoords;
+    if (lastCell < 0 || !lookup.IsPointInCell(point, lastCell, cells, points, worklet, pcoords))
+    {
+      lastCell = lookup.FindCell(point, cells, points, worklet, pcoords);
+      if (lastCell < 0)
+        return false;
+    }
+
+    auto indices = cells.GetIndices(lastCell);
+    vtkm::VecFromPortalPermute<decltype(indices), PortalType> cellVectors(&indices, vectors);
+    out = vtkm::exec::CellInterpolate(cellVectors, pcoords, cells.GetCellShape(lastCell), worklet);
+    return true;
+  }
+
+private:
+  typedef typename FieldHandle::template ExecutionTypes<DeviceAdapterTag>::PortalConst
+    PointsPortal;
+  typedef typename CellSetType::template ExecutionTypes<
+    DeviceAdapterTag,
+    vtkm::TopologyElementTagPoint,
+    vtkm::TopologyElementTagCell>::ExecObjectType CellsExec;
+  typedef vtkm::cont::CellLocatorTwoLevelUniformGrid::TwoLevelUniformGridExecution<
+    DeviceAdapterTag>
+    LookupExec;
+  vtkm::Bounds bounds;
+  PointsPortal points;
+  CellsExec cells;
+  LookupExec lookup;
+  PortalType vectors;
+  // Has no error buffer, so errors raised while locating a point in or
+  // interpolating on a degenerate cell are ignored.
+  vtkm::exec::FunctorBase worklet;
+  mutable vtkm::Id lastCell;
+
+}; //UnstructuredGridEvaluate
+
 } //namespace particleadvection
 } //namespace worklet
 } //namespace vtkm
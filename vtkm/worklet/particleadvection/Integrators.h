@@ -24,6 +24,7 @@
 #include <vtkm/Types.h>
 #include <vtkm/VectorAnalysis.h>
 #include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/worklet/particleadvection/Particles.h>
 
 namespace vtkm
@@ -69,6 +70,18 @@ public:
     return status;
   }
 
+  /// Takes a step of the particle \c idx of \c particles. Integrators with
+  /// per particle state, such as the step length of the adaptive ones, keep it
+  /// in \c particles; the others just take a step from \c inpos.
+  template <typename ParticlesType>
+  VTKM_EXEC ParticleStatus Step(ParticlesType& vtkmNotUsed(particles),
+                                const vtkm::Id& vtkmNotUsed(idx),
+                                const vtkm::Vec<FieldType, 3>& inpos,
+                                vtkm::Vec<FieldType, 3>& outpos) const
+  {
+    return this->Step(inpos, outpos);
+  }
+
   VTKM_EXEC
   ParticleStatus CheckStep(const vtkm::Vec<FieldType, 3>& inpos,
                            FieldType stepLength,
@@ -188,6 +201,225 @@ public:
   }
 };
 
+/// \brief Adaptive fifth order Runge-Kutta integrator (Dormand-Prince).
+///
+/// Each step estimates its local error from the embedded fourth order
+/// solution. A step whose error is above the error tolerance is retried with
+/// a shorter step, and the length of the next step is chosen from the error of
+/// the last one, within the minimum and maximum step lengths. The last stage
+/// of a step is the first stage of the next one, so an accepted step costs six
+/// evaluations of the field.
+///
+/// The step length of each particle is kept in the particles (see
+/// Particles::GetStepLength), so it carries over from one dispatch to the
+/// next, such as the chunks of StreamlineWorklet. The last stage is only a
+/// cache in the integrator: the advection worklets give every particle its own
+/// copy of the integrator, and a stage that does not match the position of the
+/// step is evaluated again.
+///
+template <typename FieldEvaluateType, typename FieldType>
+class DormandPrinceIntegrator
+  : public Integrator<FieldEvaluateType, FieldType, DormandPrinceIntegrator>
+{
+  using Superclass = Integrator<FieldEvaluateType,
+                                FieldType,
+                                vtkm::worklet::particleadvection::DormandPrinceIntegrator>;
+  using VecType = vtkm::Vec<FieldType, 3>;
+
+public:
+  VTKM_EXEC_CONT
+  DormandPrinceIntegrator()
+    : Superclass()
+    , ErrorTolerance(0)
+    , MinStepLength(0)
+    , MaxStepLength(0)
+    , InitialStepLength(0)
+    , HasLastStage(false)
+  {
+    this->ShortStepsSupported = true;
+  }
+
+  /// \c stepLength is the length of the first step. \c errorTolerance bounds
+  /// the estimated position error of each step, unless the step is already as
+  /// short as \c minStepLength. Throws \c ErrorBadValue unless
+  /// 0 < \c minStepLength <= \c maxStepLength and \c errorTolerance > 0.
+  VTKM_CONT
+  DormandPrinceIntegrator(const FieldEvaluateType& evaluator,
+                          FieldType stepLength,
+                          FieldType errorTolerance,
+                          FieldType minStepLength,
+                          FieldType maxStepLength)
+    : Superclass(evaluator, stepLength)
+    , ErrorTolerance(errorTolerance)
+    , MinStepLength(minStepLength)
+    , MaxStepLength(maxStepLength)
+    , InitialStepLength(vtkm::Max(minStepLength, vtkm::Min(maxStepLength, stepLength)))
+    , HasLastStage(false)
+  {
+    if (!(minStepLength > 0 && minStepLength <= maxStepLength))
+    {
+      throw vtkm::cont::ErrorBadValue("Step lengths must be 0 < minimum <= maximum.");
+    }
+    if (!(errorTolerance > 0))
+    {
+      throw vtkm::cont::ErrorBadValue("Error tolerance must be positive.");
+    }
+    this->ShortStepsSupported = true;
+  }
+
+  /// Takes a step of the particle \c idx with the step length kept for it in
+  /// \c particles, and keeps the length chosen for its next step there.
+  template <typename ParticlesType>
+  VTKM_EXEC ParticleStatus Step(ParticlesType& particles,
+                                const vtkm::Id& idx,
+                                const VecType& inpos,
+                                VecType& outpos) const
+  {
+    FieldType stepLength = particles.GetStepLength(idx);
+    if (stepLength <= 0)
+    {
+      stepLength = this->InitialStepLength;
+    }
+    ParticleStatus status = this->Step(inpos, stepLength, outpos);
+    particles.SetStepLength(idx, stepLength);
+    return status;
+  }
+
+  /// Takes a step of length \c stepLength, or shorter if its error is too
+  /// large, and sets \c stepLength to the length of the next step. Returns
+  /// \c STATUS_ERROR if the error is not finite, as no step would pass.
+  VTKM_EXEC
+  ParticleStatus Step(const VecType& inpos, FieldType& stepLength, VecType& outpos) const
+  {
+    outpos = inpos;
+    if (!this->Evaluator.IsWithinBoundary(inpos))
+    {
+      return ParticleStatus::EXITED_SPATIAL_BOUNDARY;
+    }
+
+    VecType k1;
+    if (this->HasLastStage && this->LastPosition == inpos)
+    {
+      k1 = this->LastStage;
+    }
+    else if (!this->Evaluator.Evaluate(inpos, k1))
+    {
+      return ParticleStatus::AT_SPATIAL_BOUNDARY;
+    }
+    this->HasLastStage = false;
+
+    while (true)
+    {
+      FieldType h = stepLength;
+      VecType velocity, error, k7;
+      if (!this->Stages(inpos, k1, h, velocity, &error, &k7))
+      {
+        return ParticleStatus::AT_SPATIAL_BOUNDARY;
+      }
+
+      // Scale the step by 0.9 (tolerance / error)^(1/5), by at most 5 times.
+      FieldType errorNorm = vtkm::Magnitude(error);
+      if (!vtkm::IsFinite(errorNorm))
+      {
+        return ParticleStatus::STATUS_ERROR;
+      }
+      FieldType scale = 5;
+      if (errorNorm > 0)
+      {
+        scale = static_cast<FieldType>(0.9) *
+          vtkm::Pow(this->ErrorTolerance / errorNorm, static_cast<FieldType>(0.2));
+        scale = vtkm::Max(static_cast<FieldType>(0.2), vtkm::Min(static_cast<FieldType>(5), scale));
+      }
+      stepLength = vtkm::Max(this->MinStepLength, vtkm::Min(this->MaxStepLength, h * scale));
+
+      if (errorNorm <= this->ErrorTolerance || h <= this->MinStepLength)
+      {
+        outpos = inpos + h * velocity;
+        this->LastPosition = outpos;
+        this->LastStage = k7;
+        this->HasLastStage = true;
+        return ParticleStatus::STATUS_OK;
+      }
+    }
+  }
+
+  VTKM_EXEC
+  ParticleStatus CheckStep(const VecType& inpos, FieldType stepLength, VecType& velocity) const
+  {
+    if (!this->Evaluator.IsWithinBoundary(inpos))
+    {
+      return ParticleStatus::EXITED_SPATIAL_BOUNDARY;
+    }
+    VecType k1;
+    if (this->Evaluator.Evaluate(inpos, k1) &&
+        this->Stages(inpos, k1, stepLength, velocity, nullptr, nullptr))
+    {
+      return ParticleStatus::STATUS_OK;
+    }
+    return ParticleStatus::AT_SPATIAL_BOUNDARY;
+  }
+
+  VTKM_EXEC_CONT
+  FieldType GetInitialStepLength() const { return this->InitialStepLength; }
+
+private:
+  // Computes the fifth order velocity of a step of length h. If error is
+  // given, also evaluates the last stage and the error of the step.
+  VTKM_EXEC
+  bool Stages(const VecType& y,
+              const VecType& k1,
+              FieldType h,
+              VecType& velocity,
+              VecType* error,
+              VecType* k7) const
+  {
+    using F = FieldType;
+    VecType k2, k3, k4, k5, k6;
+    bool valid = this->Evaluator.Evaluate(y + h * (F(1.0 / 5.0) * k1), k2);
+    valid = valid &&
+      this->Evaluator.Evaluate(y + h * (F(3.0 / 40.0) * k1 + F(9.0 / 40.0) * k2), k3);
+    valid = valid &&
+      this->Evaluator.Evaluate(
+        y + h * (F(44.0 / 45.0) * k1 + F(-56.0 / 15.0) * k2 + F(32.0 / 9.0) * k3), k4);
+    valid = valid &&
+      this->Evaluator.Evaluate(y + h * (F(19372.0 / 6561.0) * k1 + F(-25360.0 / 2187.0) * k2 +
+                                        F(64448.0 / 6561.0) * k3 + F(-212.0 / 729.0) * k4),
+                               k5);
+    valid = valid &&
+      this->Evaluator.Evaluate(y + h * (F(9017.0 / 3168.0) * k1 + F(-355.0 / 33.0) * k2 +
+                                        F(46732.0 / 5247.0) * k3 + F(49.0 / 176.0) * k4 +
+                                        F(-5103.0 / 18656.0) * k5),
+                               k6);
+    if (!valid)
+    {
+      return false;
+    }
+    velocity = F(35.0 / 384.0) * k1 + F(500.0 / 1113.0) * k3 + F(125.0 / 192.0) * k4 +
+      F(-2187.0 / 6784.0) * k5 + F(11.0 / 84.0) * k6;
+    if (error == nullptr)
+    {
+      return true;
+    }
+
+    if (!this->Evaluator.Evaluate(y + h * velocity, *k7))
+    {
+      return false;
+    }
+    *error = h *
+      (F(71.0 / 57600.0) * k1 + F(-71.0 / 16695.0) * k3 + F(71.0 / 1920.0) * k4 +
+       F(-17253.0 / 339200.0) * k5 + F(22.0 / 525.0) * k6 + F(-1.0 / 40.0) * (*k7));
+    return true;
+  }
+
+  FieldType ErrorTolerance;
+  FieldType MinStepLength;
+  FieldType MaxStepLength;
+  FieldType InitialStepLength;
+  mutable VecType LastPosition;
+  mutable VecType LastStage;
+  mutable bool HasLastStage;
+}; //DormandPrinceIntegrator
+
 template <typename FieldEvaluateType, typename FieldType>
 class EulerIntegrator : public Integrator<FieldEvaluateType, FieldType, EulerIntegrator>
 {
@@ -24,13 +24,18 @@
 #include <vtkm/Types.h>
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/ArrayHandleCast.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
 #include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
 #include <vtkm/cont/CellSetExplicit.h>
 #include <vtkm/exec/ExecutionObjectBase.h>
 
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/particleadvection/Particles.h>
 
+#include <vector>
+
 namespace vtkm
 {
 namespace worklet
@@ -49,12 +54,17 @@ public:
   template <typename IntegralCurveType>
   VTKM_EXEC void operator()(const vtkm::Id& idx, IntegralCurveType& ic) const
   {
+    // Each particle advects with its own copy of the integrator, so that
+    // evaluators can cache per particle state such as the last cell found.
+    // State that must outlive the dispatch, such as the step length of the
+    // adaptive integrators, is kept in ic.
+    IntegratorType particleIntegrator(this->integrator);
     vtkm::Vec<FieldType, 3> inpos = ic.GetPos(idx);
     vtkm::Vec<FieldType, 3> outpos;
 
     while (!ic.Done(idx))
     {
-      ParticleStatus status = integrator.Step(inpos, outpos);
+      ParticleStatus status = particleIntegrator.Step(ic, idx, inpos, outpos);
       if (status == ParticleStatus::STATUS_OK)
       {
         ic.TakeStep(idx, outpos, status);
@@ -63,13 +73,17 @@ public:
       if (status == ParticleStatus::AT_SPATIAL_BOUNDARY)
       {
         vtkm::Id numSteps = ic.GetStep(idx);
-        status = integrator.PushOutOfDomain(inpos, numSteps, outpos);
+        status = particleIntegrator.PushOutOfDomain(inpos, numSteps, outpos);
       }
       if (status == ParticleStatus::EXITED_SPATIAL_BOUNDARY)
       {
         ic.TakeStep(idx, outpos, status);
         ic.SetExitedSpatialBoundary(idx);
       }
+      if (status == ParticleStatus::STATUS_ERROR)
+      {
+        ic.SetError(idx);
+      }
     }
   }
 
@@ -121,7 +135,10 @@ private:
     vtkm::Id numSeeds = static_cast<vtkm::Id>(seedArray.GetNumberOfValues());
     //Create and invoke the particle advection.
     vtkm::cont::ArrayHandleIndex idxArray(numSeeds);
-    ParticleType particles(seedArray, stepsTaken, statusArray, maxSteps);
+    vtkm::cont::ArrayHandle<FieldType> stepLengths;
+    DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandleConstant(FieldType(0), numSeeds),
+                          stepLengths);
+    ParticleType particles(seedArray, stepsTaken, statusArray, stepLengths, maxSteps);
 
     //Invoke particle advection worklet
     ParticleAdvectWorkletType particleWorklet(integrator);
@@ -135,6 +152,132 @@ private:
 };
 
 
+namespace detail
+{
+
+class StepCount : public vtkm::worklet::WorkletMapField
+{
+public:
+  typedef void ControlSignature(FieldIn<IdType> steps,
+                                FieldIn<IdType> start,
+                                FieldOut<IdType> count);
+  typedef _3 ExecutionSignature(_1, _2);
+
+  VTKM_EXEC vtkm::Id operator()(const vtkm::Id& steps, const vtkm::Id& start) const
+  {
+    return steps - start;
+  }
+};
+
+// Moves the steps recorded for each particle during a chunk to the front of
+// the chunk's output, tagged with the seed and step they belong to.
+class CompactHistory : public vtkm::worklet::WorkletMapField
+{
+public:
+  typedef void ControlSignature(FieldIn<IdType> seedId,
+                                FieldIn<IdType> start,
+                                FieldIn<IdType> count,
+                                FieldIn<IdType> offset,
+                                WholeArrayIn<> history,
+                                WholeArrayOut<> points,
+                                WholeArrayOut<Id2Type> pointIds);
+  typedef void ExecutionSignature(WorkIndex, _1, _2, _3, _4, _5, _6, _7);
+
+  CompactHistory(vtkm::Id histSize)
+    : HistSize(histSize)
+  {
+  }
+
+  template <typename HistoryPortal, typename PointsPortal, typename PointIdsPortal>
+  VTKM_EXEC void operator()(const vtkm::Id& idx,
+                            const vtkm::Id& seedId,
+                            const vtkm::Id& start,
+                            const vtkm::Id& count,
+                            const vtkm::Id& offset,
+                            const HistoryPortal& history,
+                            PointsPortal& points,
+                            PointIdsPortal& pointIds) const
+  {
+    for (vtkm::Id i = 0; i < count; i++)
+    {
+      points.Set(offset + i, history.Get(idx * this->HistSize + i));
+      pointIds.Set(offset + i, vtkm::Id2(seedId, start + i));
+    }
+  }
+
+private:
+  vtkm::Id HistSize;
+};
+
+// Writes the state of the particles advanced in a chunk back to all particles.
+class ScatterParticles : public vtkm::worklet::WorkletMapField
+{
+public:
+  typedef void ControlSignature(FieldIn<IdType> seedId,
+                                FieldIn<> pos,
+                                FieldIn<IdType> steps,
+                                FieldIn<IdType> status,
+                                FieldIn<> stepLength,
+                                WholeArrayOut<> allPos,
+                                WholeArrayOut<IdType> allSteps,
+                                WholeArrayOut<IdType> allStatus,
+                                WholeArrayOut<> allStepLengths);
+  typedef void ExecutionSignature(_1, _2, _3, _4, _5, _6, _7, _8, _9);
+
+  template <typename PosType,
+            typename StepLengthType,
+            typename PosPortal,
+            typename IdPortal,
+            typename StepLengthPortal>
+  VTKM_EXEC void operator()(const vtkm::Id& seedId,
+                            const PosType& pos,
+                            const vtkm::Id& steps,
+                            const vtkm::Id& status,
+                            const StepLengthType& stepLength,
+                            PosPortal& allPos,
+                            IdPortal& allSteps,
+                            IdPortal& allStatus,
+                            StepLengthPortal& allStepLengths) const
+  {
+    allPos.Set(seedId, pos);
+    allSteps.Set(seedId, steps);
+    allStatus.Set(seedId, status);
+    allStepLengths.Set(seedId, stepLength);
+  }
+};
+
+// Places the points of a chunk in their streamline.
+class PlacePoints : public vtkm::worklet::WorkletMapField
+{
+public:
+  typedef void ControlSignature(FieldIn<> point,
+                                FieldIn<Id2Type> pointId,
+                                WholeArrayIn<IdType> offsets,
+                                WholeArrayIn<IdType> firstSteps,
+                                WholeArrayOut<> positions);
+  typedef void ExecutionSignature(_1, _2, _3, _4, _5);
+
+  template <typename PointType, typename IdPortal, typename PosPortal>
+  VTKM_EXEC void operator()(const PointType& point,
+                            const vtkm::Id2& pointId,
+                            const IdPortal& offsets,
+                            const IdPortal& firstSteps,
+                            PosPortal& positions) const
+  {
+    positions.Set(offsets.Get(pointId[0]) + pointId[1] - firstSteps.Get(pointId[0]), point);
+  }
+};
+
+} // namespace detail
+
+/// Advects particles and records the path of each as a polyline.
+///
+/// Particles are advected in chunks of steps, and the steps of a chunk are
+/// recorded in a history buffer holding at most \c MaximumHistorySize points.
+/// After each chunk the recorded points are compacted into an array of their
+/// own, so memory grows with the number of steps actually taken rather than
+/// with the number of seeds times the maximum number of steps. Once all
+/// particles are done, the chunks are placed into the final positions array.
 template <typename IntegratorType, typename FieldType, typename DeviceAdapterTag>
 class StreamlineWorklet
 {
@@ -148,7 +291,13 @@ public:
                                                                   DeviceAdapterTag>
     ParticleAdvectWorkletType;
 
-  StreamlineWorklet() {}
+  /// The default bound on the number of points in the history buffer.
+  static const vtkm::Id DEFAULT_MAXIMUM_HISTORY_SIZE = vtkm::Id(1) << 23;
+
+  StreamlineWorklet()
+    : maximumHistorySize(DEFAULT_MAXIMUM_HISTORY_SIZE)
+  {
+  }
 
   template <typename PointStorage, typename FieldStorage>
   void Run(const IntegratorType& it,
@@ -168,6 +317,11 @@ public:
 
   ~StreamlineWorklet() {}
 
+  vtkm::Id GetMaximumHistorySize() const { return maximumHistorySize; }
+  /// Sets the bound on the number of points recorded per chunk. Smaller
+  /// values use less memory but advect the particles in more chunks.
+  void SetMaximumHistorySize(vtkm::Id size) { maximumHistorySize = size; }
+
   struct IsOne
   {
     template <typename T>
@@ -177,39 +331,120 @@ public:
     }
   };
 
+  struct IsActive
+  {
+    VTKM_EXEC_CONT bool operator()(const vtkm::Id& status) const
+    {
+      const vtkm::Id done = ParticleStatus::TERMINATED | ParticleStatus::EXITED_SPATIAL_BOUNDARY |
+        ParticleStatus::EXITED_TEMPORAL_BOUNDARY;
+      return ((status & ParticleStatus::STATUS_OK) != 0) && ((status & done) == 0);
+    }
+  };
+
 private:
   void run(vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>>& positions,
            vtkm::cont::CellSetExplicit<>& polyLines,
            vtkm::cont::ArrayHandle<vtkm::Id>& status,
            vtkm::cont::ArrayHandle<vtkm::Id>& stepsTaken)
   {
-    typedef typename vtkm::worklet::DispatcherMapField<ParticleAdvectWorkletType>
+    typedef typename vtkm::worklet::DispatcherMapField<ParticleAdvectWorkletType, DeviceAdapterTag>
       ParticleWorkletDispatchType;
-    typedef vtkm::worklet::particleadvection::StateRecordingParticles<FieldType, DeviceAdapterTag>
+    typedef vtkm::worklet::particleadvection::ChunkedStateRecordingParticles<FieldType,
+                                                                            DeviceAdapterTag>
       StreamlineType;
+    typedef vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>> PositionHandle;
 
     vtkm::Id numSeeds = static_cast<vtkm::Id>(seedArray.GetNumberOfValues());
 
     ParticleAdvectWorkletType particleWorklet(integrator);
     ParticleWorkletDispatchType particleWorkletDispatch(particleWorklet);
 
-    vtkm::cont::ArrayHandleIndex idxArray(numSeeds);
+    vtkm::cont::ArrayHandle<vtkm::Id> firstSteps;
+    DeviceAlgorithm::Copy(stepsTaken, firstSteps);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> activeIds;
+    DeviceAlgorithm::CopyIf(vtkm::cont::ArrayHandleIndex(numSeeds), status, activeIds, IsActive());
+
+    // The points recorded in each chunk, and the seed and step of each point.
+    std::vector<PositionHandle> chunkPoints;
+    std::vector<vtkm::cont::ArrayHandle<vtkm::Id2>> chunkPointIds;
+
+    PositionHandle particlePositions, history;
+    DeviceAlgorithm::Copy(seedArray, particlePositions);
+    vtkm::cont::ArrayHandle<FieldType> particleStepLengths;
+    DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandleConstant(FieldType(0), numSeeds),
+                          particleStepLengths);
+    while (activeIds.GetNumberOfValues() > 0)
+    {
+      vtkm::Id numActive = activeIds.GetNumberOfValues();
+      vtkm::Id histSize =
+        vtkm::Max(vtkm::Id(1), vtkm::Min(maximumHistorySize / numActive, maxSteps));
+
+      PositionHandle pos;
+      vtkm::cont::ArrayHandle<vtkm::Id> steps, stat, start;
+      vtkm::cont::ArrayHandle<FieldType> stepLengths;
+      DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(activeIds, particlePositions),
+                            pos);
+      DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(activeIds, stepsTaken), steps);
+      DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(activeIds, status), stat);
+      DeviceAlgorithm::Copy(
+        vtkm::cont::make_ArrayHandlePermutation(activeIds, particleStepLengths), stepLengths);
+      DeviceAlgorithm::Copy(steps, start);
+
+      StreamlineType streamlines(
+        pos, history, steps, stat, stepLengths, start, maxSteps, histSize);
+      particleWorkletDispatch.Invoke(vtkm::cont::ArrayHandleIndex(numActive), streamlines);
+
+      vtkm::cont::ArrayHandle<vtkm::Id> counts, offsets;
+      vtkm::worklet::DispatcherMapField<detail::StepCount, DeviceAdapterTag>().Invoke(
+        steps, start, counts);
+      vtkm::Id numPoints = DeviceAlgorithm::ScanExclusive(counts, offsets);
+      if (numPoints > 0)
+      {
+        PositionHandle points;
+        vtkm::cont::ArrayHandle<vtkm::Id2> pointIds;
+        points.Allocate(numPoints);
+        pointIds.Allocate(numPoints);
+        vtkm::worklet::DispatcherMapField<detail::CompactHistory, DeviceAdapterTag>(
+          detail::CompactHistory(histSize))
+          .Invoke(activeIds, start, counts, offsets, history, points, pointIds);
+        chunkPoints.push_back(points);
+        chunkPointIds.push_back(pointIds);
+      }
 
-    vtkm::cont::ArrayHandle<vtkm::Id> validPoint;
-    std::vector<vtkm::Id> vpa(static_cast<std::size_t>(numSeeds * maxSteps), 0);
-    validPoint = vtkm::cont::make_ArrayHandle(vpa);
+      vtkm::worklet::DispatcherMapField<detail::ScatterParticles, DeviceAdapterTag>().Invoke(
+        activeIds,
+        pos,
+        steps,
+        stat,
+        stepLengths,
+        particlePositions,
+        stepsTaken,
+        status,
+        particleStepLengths);
+
+      vtkm::cont::ArrayHandle<vtkm::Id> stillActive;
+      DeviceAlgorithm::CopyIf(activeIds, stat, stillActive, IsActive());
+      activeIds = stillActive;
+    }
+    history.ReleaseResources();
 
-    //Compact history into positions.
-    vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>> history;
-    StreamlineType streamlines(seedArray, history, stepsTaken, status, validPoint, maxSteps);
+    //Place the chunks into positions.
+    vtkm::cont::ArrayHandle<vtkm::Id> counts, cellIndex;
+    vtkm::worklet::DispatcherMapField<detail::StepCount, DeviceAdapterTag>().Invoke(
+      stepsTaken, firstSteps, counts);
+    vtkm::Id connectivityLen = DeviceAlgorithm::ScanExclusive(counts, cellIndex);
 
-    particleWorkletDispatch.Invoke(idxArray, streamlines);
-    DeviceAlgorithm::CopyIf(history, validPoint, positions, IsOne());
+    positions.Allocate(connectivityLen);
+    for (std::size_t i = 0; i < chunkPoints.size(); i++)
+    {
+      vtkm::worklet::DispatcherMapField<detail::PlacePoints, DeviceAdapterTag>().Invoke(
+        chunkPoints[i], chunkPointIds[i], cellIndex, firstSteps, positions);
+      chunkPoints[i].ReleaseResources();
+      chunkPointIds[i].ReleaseResources();
+    }
 
     //Create cells.
-    vtkm::cont::ArrayHandle<vtkm::Id> cellIndex;
-    vtkm::Id connectivityLen = DeviceAlgorithm::ScanExclusive(stepsTaken, cellIndex);
-
     vtkm::cont::ArrayHandleCounting<vtkm::Id> connCount(0, 1, connectivityLen);
     vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
     DeviceAlgorithm::Copy(connCount, connectivity);
@@ -220,7 +455,7 @@ private:
     DeviceAlgorithm::Copy(polyLineShape, cellTypes);
 
     vtkm::cont::ArrayHandle<vtkm::IdComponent> cellCounts;
-    DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandleCast(stepsTaken, vtkm::IdComponent()),
+    DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandleCast(counts, vtkm::IdComponent()),
                           cellCounts);
 
     polyLines.Fill(positions.GetNumberOfValues(), cellTypes, cellCounts, connectivity);
@@ -229,6 +464,7 @@ private:
   IntegratorType integrator;
   vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>> seedArray;
   vtkm::Id maxSteps;
+  vtkm::Id maximumHistorySize;
 };
 }
 }
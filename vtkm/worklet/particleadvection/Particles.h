@@ -43,6 +43,11 @@ enum ParticleStatus
   STATUS_ERROR = 1 << 6
 };
 
+/// The state of the particles being advected. Besides the position, number
+/// of steps and status of each particle, it keeps the length of the next step
+/// of each particle for the adaptive integrators, so that it carries over from
+/// one dispatch to the next. A step length of 0 means that the particle has
+/// not been advanced by an adaptive integrator yet.
 template <typename T, typename DeviceAdapterTag>
 class Particles : public vtkm::exec::ExecutionObjectBase
 {
@@ -53,6 +58,8 @@ private:
       IdPortal;
   typedef typename vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>::template ExecutionTypes<
     DeviceAdapterTag>::Portal PosPortal;
+  typedef typename vtkm::cont::ArrayHandle<T>::template ExecutionTypes<DeviceAdapterTag>::Portal
+    StepLengthPortal;
 
 public:
   VTKM_EXEC_CONT
@@ -60,6 +67,7 @@ public:
     : Pos()
     , Steps()
     , Status()
+    , StepLength()
     , MaxSteps(0)
   {
   }
@@ -69,6 +77,7 @@ public:
     : Pos(ic.Pos)
     , Steps(ic.Steps)
     , Status(ic.Status)
+    , StepLength(ic.StepLength)
     , MaxSteps(ic.MaxSteps)
   {
   }
@@ -77,10 +86,12 @@ public:
   Particles(const PosPortal& _pos,
             const IdPortal& _steps,
             const IdPortal& _status,
+            const StepLengthPortal& _stepLength,
             const vtkm::Id& _maxSteps)
     : Pos(_pos)
     , Steps(_steps)
     , Status(_status)
+    , StepLength(_stepLength)
     , MaxSteps(_maxSteps)
   {
   }
@@ -89,12 +100,14 @@ public:
   Particles(vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>& posArray,
             vtkm::cont::ArrayHandle<vtkm::Id>& stepsArray,
             vtkm::cont::ArrayHandle<vtkm::Id>& statusArray,
+            vtkm::cont::ArrayHandle<T>& stepLengthArray,
             const vtkm::Id& _maxSteps)
     : MaxSteps(_maxSteps)
   {
     Pos = posArray.PrepareForInPlace(DeviceAdapterTag());
     Steps = stepsArray.PrepareForInPlace(DeviceAdapterTag());
     Status = statusArray.PrepareForInPlace(DeviceAdapterTag());
+    StepLength = stepLengthArray.PrepareForInPlace(DeviceAdapterTag());
   }
 
   VTKM_EXEC
@@ -196,10 +209,15 @@ public:
   vtkm::Id GetStep(const vtkm::Id& idx) const { return Steps.Get(idx); }
   VTKM_EXEC
   vtkm::Id GetStatus(const vtkm::Id& idx) const { return Status.Get(idx); }
+  VTKM_EXEC
+  T GetStepLength(const vtkm::Id& idx) const { return StepLength.Get(idx); }
+  VTKM_EXEC
+  void SetStepLength(const vtkm::Id& idx, const T& stepLength) { StepLength.Set(idx, stepLength); }
 
 protected:
   PosPortal Pos;
   IdPortal Steps, Status;
+  StepLengthPortal StepLength;
   vtkm::Id MaxSteps;
 };
 
@@ -215,11 +233,13 @@ private:
     DeviceAdapterTag>::Portal IdComponentPortal;
   typedef typename vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>::template ExecutionTypes<
     DeviceAdapterTag>::Portal PosPortal;
+  typedef typename vtkm::cont::ArrayHandle<T>::template ExecutionTypes<DeviceAdapterTag>::Portal
+    StepLengthPortal;
 
 public:
   VTKM_EXEC_CONT
   StateRecordingParticles(const StateRecordingParticles& s)
-    : Particles<T, DeviceAdapterTag>(s.Pos, s.Steps, s.Status, s.MaxSteps)
+    : Particles<T, DeviceAdapterTag>(s.Pos, s.Steps, s.Status, s.StepLength, s.MaxSteps)
     , ValidPoint(s.ValidPoint)
     , History(s.History)
     , HistSize(s.HistSize)
@@ -239,9 +259,10 @@ public:
   StateRecordingParticles(const PosPortal& _pos,
                           const IdPortal& _steps,
                           const IdPortal& _status,
+                          const StepLengthPortal& _stepLength,
                           const IdPortal& _validPoint,
                           const vtkm::Id& _maxSteps)
-    : Particles<T, DeviceAdapterTag>(_pos, _steps, _status, _maxSteps)
+    : Particles<T, DeviceAdapterTag>(_pos, _steps, _status, _stepLength, _maxSteps)
     , ValidPoint(_validPoint)
     , History()
     , HistSize()
@@ -253,12 +274,14 @@ public:
                           vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>& historyArray,
                           vtkm::cont::ArrayHandle<vtkm::Id>& stepsArray,
                           vtkm::cont::ArrayHandle<vtkm::Id>& statusArray,
+                          vtkm::cont::ArrayHandle<T>& stepLengthArray,
                           vtkm::cont::ArrayHandle<vtkm::Id>& validPointArray,
                           const vtkm::Id& _maxSteps)
   {
     this->Pos = posArray.PrepareForInPlace(DeviceAdapterTag());
     this->Steps = stepsArray.PrepareForInPlace(DeviceAdapterTag());
     this->Status = statusArray.PrepareForInPlace(DeviceAdapterTag());
+    this->StepLength = stepLengthArray.PrepareForInPlace(DeviceAdapterTag());
     this->ValidPoint = validPointArray.PrepareForInPlace(DeviceAdapterTag());
     this->MaxSteps = _maxSteps;
     HistSize = _maxSteps;
@@ -271,6 +294,7 @@ public:
                           vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>& historyArray,
                           vtkm::cont::ArrayHandle<vtkm::Id>& stepsArray,
                           vtkm::cont::ArrayHandle<vtkm::Id>& statusArray,
+                          vtkm::cont::ArrayHandle<T>& stepLengthArray,
                           vtkm::cont::ArrayHandle<vtkm::Id>& validPointArray,
                           const vtkm::Id& _maxSteps,
                           vtkm::Id& _histSize)
@@ -279,6 +303,7 @@ public:
     this->Pos = posArray.PrepareForInPlace(DeviceAdapterTag());
     this->Steps = stepsArray.PrepareForInPlace(DeviceAdapterTag());
     this->Status = statusArray.PrepareForInPlace(DeviceAdapterTag());
+    this->StepLength = stepLengthArray.PrepareForInPlace(DeviceAdapterTag());
     this->ValidPoint = validPointArray.PrepareForInPlace(DeviceAdapterTag());
     this->MaxSteps = _maxSteps;
     HistSize = _histSize;
@@ -315,6 +340,75 @@ private:
   vtkm::Id HistSize;
 };
 
+/// Records the positions of a chunk of at most \c HistSize steps per
+/// particle, and keeps the current position of each particle. Particles stop
+/// once they have taken \c HistSize steps since the start of the chunk, given
+/// in \c RoundStart, and can then be advanced again for another chunk. The
+/// history of each particle starts at \c idx * \c HistSize.
+template <typename T, typename DeviceAdapterTag>
+class ChunkedStateRecordingParticles : public Particles<T, DeviceAdapterTag>
+{
+
+private:
+  typedef typename vtkm::cont::ArrayHandle<vtkm::Id>::template ExecutionTypes<
+    DeviceAdapterTag>::PortalConst IdConstPortal;
+  typedef typename vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>::template ExecutionTypes<
+    DeviceAdapterTag>::Portal PosPortal;
+
+public:
+  VTKM_EXEC_CONT
+  ChunkedStateRecordingParticles()
+    : Particles<T, DeviceAdapterTag>()
+    , RoundStart()
+    , History()
+    , HistSize(0)
+  {
+  }
+
+  VTKM_CONT
+  ChunkedStateRecordingParticles(vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>& posArray,
+                                 vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>& historyArray,
+                                 vtkm::cont::ArrayHandle<vtkm::Id>& stepsArray,
+                                 vtkm::cont::ArrayHandle<vtkm::Id>& statusArray,
+                                 vtkm::cont::ArrayHandle<T>& stepLengthArray,
+                                 const vtkm::cont::ArrayHandle<vtkm::Id>& roundStartArray,
+                                 const vtkm::Id& _maxSteps,
+                                 const vtkm::Id& _histSize)
+    : Particles<T, DeviceAdapterTag>(posArray, stepsArray, statusArray, stepLengthArray, _maxSteps)
+    , HistSize(_histSize)
+  {
+    RoundStart = roundStartArray.PrepareForInput(DeviceAdapterTag());
+    vtkm::Id NumPos = posArray.GetNumberOfValues();
+    History = historyArray.PrepareForOutput(NumPos * HistSize, DeviceAdapterTag());
+  }
+
+  VTKM_EXEC
+  void TakeStep(const vtkm::Id& idx, const vtkm::Vec<T, 3>& pt, ParticleStatus status)
+  {
+    if (status != ParticleStatus::STATUS_OK)
+      return;
+    vtkm::Id nSteps = this->Steps.Get(idx);
+    vtkm::Id loc = idx * HistSize + nSteps - RoundStart.Get(idx);
+    this->History.Set(loc, pt);
+    this->Pos.Set(idx, pt);
+    nSteps = nSteps + 1;
+    this->Steps.Set(idx, nSteps);
+    if (nSteps == this->MaxSteps)
+      this->SetTerminated(idx);
+  }
+
+  VTKM_EXEC
+  bool Done(const vtkm::Id& idx)
+  {
+    return !this->Integrateable(idx) || (this->Steps.Get(idx) - RoundStart.Get(idx) == HistSize);
+  }
+
+private:
+  IdConstPortal RoundStart;
+  PosPortal History;
+  vtkm::Id HistSize;
+};
+
 } //namespace particleadvection
 } //namespace worklet
 } //namespace vtkm
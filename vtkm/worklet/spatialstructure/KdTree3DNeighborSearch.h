@@ -0,0 +1,633 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_KdTree3DNeighborSearch_h
+#define vtk_m_worklet_KdTree3DNeighborSearch_h
+
+#include <vtkm/BinaryOperators.h>
+#include <vtkm/Math.h>
+#include <vtkm/VectorAnalysis.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <limits>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace spatialstructure
+{
+
+/// \brief k nearest neighbor and fixed radius searches on a 3D KD-tree
+///
+/// Both searches return their results in a compressed sparse row layout: the
+/// neighbors of query \c i are entries <tt>offsets[i]</tt> to
+/// <tt>offsets[i + 1] - 1</tt> of the neighbor ids and distances arrays.
+///
+/// The queries can be searched in the order of a Morton curve through their
+/// bounds rather than in the order given, so that queries searched together
+/// are close in space and walk similar paths through the tree. The results
+/// are in the order of the given queries either way.
+class KdTree3DNeighborSearch
+{
+public:
+  /// Descends the tree from the nodes of points [sIdx, tIdx), visiting only
+  /// the subtrees within \c result.GetRadius() of the query point and adding
+  /// their points to \c result.
+  template <typename CoordVecType,
+            typename IdPortalType,
+            typename CoordPortalType,
+            typename ResultType>
+  VTKM_EXEC static void SearchNeighbors3D(const CoordVecType& qc,
+                                          vtkm::Int32 level,
+                                          vtkm::Id sIdx,
+                                          vtkm::Id tIdx,
+                                          const IdPortalType& treePortal,
+                                          const IdPortalType& splitIdPortal,
+                                          const CoordPortalType& coordPortal,
+                                          ResultType& result)
+  {
+    if (tIdx - sIdx == 1)
+    { ///// leaf node
+      const vtkm::Id leafNodeIdx = treePortal.Get(sIdx);
+      const CoordVecType leaf = coordPortal.Get(leafNodeIdx);
+      result.Add(leafNodeIdx, vtkm::Magnitude(leaf - qc));
+    }
+    else
+    { //normal Node
+      const vtkm::Id splitNodeLoc = (sIdx + tIdx + 1) / 2;
+      const vtkm::IdComponent axis = level % 3;
+      const auto splitAxis = coordPortal.Get(splitIdPortal.Get(splitNodeLoc))[axis];
+      const auto queryCoord = qc[axis];
+
+      // The radius may shrink while searching the first subtree, so it is
+      // checked again before the second.
+      if (queryCoord <= splitAxis)
+      { //left tree first
+        if (queryCoord - result.GetRadius() <= splitAxis)
+        {
+          SearchNeighbors3D(
+            qc, level + 1, sIdx, splitNodeLoc, treePortal, splitIdPortal, coordPortal, result);
+        }
+        if (queryCoord + result.GetRadius() >= splitAxis)
+        {
+          SearchNeighbors3D(
+            qc, level + 1, splitNodeLoc, tIdx, treePortal, splitIdPortal, coordPortal, result);
+        }
+      }
+      else
+      { //right tree first
+        if (queryCoord + result.GetRadius() >= splitAxis)
+        {
+          SearchNeighbors3D(
+            qc, level + 1, splitNodeLoc, tIdx, treePortal, splitIdPortal, coordPortal, result);
+        }
+        if (queryCoord - result.GetRadius() <= splitAxis)
+        {
+          SearchNeighbors3D(
+            qc, level + 1, sIdx, splitNodeLoc, treePortal, splitIdPortal, coordPortal, result);
+        }
+      }
+    }
+  }
+
+  /// The k nearest points found so far, kept as a max-heap on the distance
+  /// in the query's own range of the output arrays.
+  template <typename IdPortalType, typename DistancePortalType>
+  class KNearestResult
+  {
+  public:
+    using DistanceType = typename DistancePortalType::ValueType;
+
+    VTKM_EXEC
+    KNearestResult(const IdPortalType& ids,
+                   const DistancePortalType& distances,
+                   vtkm::Id offset,
+                   vtkm::IdComponent k)
+      : Ids(ids)
+      , Distances(distances)
+      , Offset(offset)
+      , K(k)
+      , Size(0)
+      , Radius(std::numeric_limits<DistanceType>::max())
+    {
+    }
+
+    VTKM_EXEC
+    DistanceType GetRadius() const { return this->Radius; }
+
+    VTKM_EXEC
+    void Add(vtkm::Id id, DistanceType distance)
+    {
+      if (this->Size < this->K)
+      {
+        // Sift the new point up from the end of the heap.
+        vtkm::IdComponent child = this->Size++;
+        while (child > 0)
+        {
+          const vtkm::IdComponent parent = (child - 1) / 2;
+          if (this->Distances.Get(this->Offset + parent) >= distance)
+          {
+            break;
+          }
+          this->Set(child, this->Ids.Get(this->Offset + parent), this->GetDistance(parent));
+          child = parent;
+        }
+        this->Set(child, id, distance);
+        if (this->Size == this->K)
+        {
+          this->Radius = this->GetDistance(0);
+        }
+      }
+      else if (distance < this->Radius)
+      {
+        this->SiftDown(id, distance, this->K);
+        this->Radius = this->GetDistance(0);
+      }
+    }
+
+    /// Sorts the points found by increasing distance.
+    VTKM_EXEC
+    void Finish()
+    {
+      for (vtkm::IdComponent last = this->Size - 1; last > 0; --last)
+      {
+        const vtkm::Id lastId = this->Ids.Get(this->Offset + last);
+        const DistanceType lastDistance = this->GetDistance(last);
+        this->Set(last, this->Ids.Get(this->Offset), this->GetDistance(0));
+        this->SiftDown(lastId, lastDistance, last);
+      }
+    }
+
+  private:
+    VTKM_EXEC
+    DistanceType GetDistance(vtkm::IdComponent index) const
+    {
+      return this->Distances.Get(this->Offset + index);
+    }
+
+    VTKM_EXEC
+    void Set(vtkm::IdComponent index, vtkm::Id id, DistanceType distance) const
+    {
+      this->Ids.Set(this->Offset + index, id);
+      this->Distances.Set(this->Offset + index, distance);
+    }
+
+    // Replaces the top of the heap of the given size and restores the heap.
+    VTKM_EXEC
+    void SiftDown(vtkm::Id id, DistanceType distance, vtkm::IdComponent size) const
+    {
+      vtkm::IdComponent parent = 0;
+      while (2 * parent + 1 < size)
+      {
+        vtkm::IdComponent child = 2 * parent + 1;
+        if ((child + 1 < size) && (this->GetDistance(child + 1) > this->GetDistance(child)))
+        {
+          ++child;
+        }
+        if (this->GetDistance(child) <= distance)
+        {
+          break;
+        }
+        this->Set(parent, this->Ids.Get(this->Offset + child), this->GetDistance(child));
+        parent = child;
+      }
+      this->Set(parent, id, distance);
+    }
+
+    IdPortalType Ids;
+    DistancePortalType Distances;
+    vtkm::Id Offset;
+    vtkm::IdComponent K;
+    vtkm::IdComponent Size;
+    DistanceType Radius;
+  };
+
+  /// Counts the points within a radius.
+  template <typename DistanceType>
+  struct RadiusCountResult
+  {
+    DistanceType Radius;
+    vtkm::Id Count;
+
+    VTKM_EXEC
+    DistanceType GetRadius() const { return this->Radius; }
+
+    VTKM_EXEC
+    void Add(vtkm::Id, DistanceType distance)
+    {
+      if (distance <= this->Radius)
+      {
+        ++this->Count;
+      }
+    }
+  };
+
+  /// Writes the points within a radius from an offset of the output arrays.
+  template <typename IdPortalType, typename DistancePortalType>
+  struct RadiusResult
+  {
+    using DistanceType = typename DistancePortalType::ValueType;
+
+    IdPortalType Ids;
+    DistancePortalType Distances;
+    DistanceType Radius;
+    vtkm::Id Begin;
+    vtkm::Id Index;
+
+    VTKM_EXEC
+    DistanceType GetRadius() const { return this->Radius; }
+
+    VTKM_EXEC
+    void Add(vtkm::Id id, DistanceType distance)
+    {
+      if (distance <= this->Radius)
+      {
+        this->Ids.Set(this->Index, id);
+        this->Distances.Set(this->Index, distance);
+        ++this->Index;
+      }
+    }
+
+    /// Sorts the points found by increasing distance, by making a heap of
+    /// them all and sorting it as the k nearest are.
+    VTKM_EXEC
+    void Finish() const
+    {
+      const vtkm::IdComponent size = static_cast<vtkm::IdComponent>(this->Index - this->Begin);
+      KNearestResult<IdPortalType, DistancePortalType> heap(
+        this->Ids, this->Distances, this->Begin, size);
+      for (vtkm::IdComponent i = 0; i < size; ++i)
+      {
+        heap.Add(this->Ids.Get(this->Begin + i), this->Distances.Get(this->Begin + i));
+      }
+      heap.Finish();
+    }
+  };
+
+  class KNearestNeighborSearch3DWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    typedef void ControlSignature(FieldIn<IdType> queryIds,
+                                  WholeArrayIn<> queryPoints,
+                                  WholeArrayIn<IdType> treeIdIn,
+                                  WholeArrayIn<IdType> treeSplitIdIn,
+                                  WholeArrayIn<> treeCoordiIn,
+                                  WholeArrayOut<IdType> neighborIds,
+                                  WholeArrayOut<> distances);
+    typedef void ExecutionSignature(_1, _2, _3, _4, _5, _6, _7);
+
+    VTKM_CONT
+    KNearestNeighborSearch3DWorklet(vtkm::IdComponent k)
+      : K(k)
+    {
+    }
+
+    template <typename QueryPortalType,
+              typename IdPortalType,
+              typename CoordPortalType,
+              typename OutIdPortalType,
+              typename DistancePortalType>
+    VTKM_EXEC void operator()(vtkm::Id queryId,
+                              const QueryPortalType& queryPortal,
+                              const IdPortalType& treeIdPortal,
+                              const IdPortalType& treeSplitIdPortal,
+                              const CoordPortalType& treeCoordiPortal,
+                              const OutIdPortalType& neighborIds,
+                              const DistancePortalType& distances) const
+    {
+      KNearestResult<OutIdPortalType, DistancePortalType> result(
+        neighborIds, distances, queryId * this->K, this->K);
+      SearchNeighbors3D(queryPortal.Get(queryId),
+                        0,
+                        0,
+                        treeIdPortal.GetNumberOfValues(),
+                        treeIdPortal,
+                        treeSplitIdPortal,
+                        treeCoordiPortal,
+                        result);
+      result.Finish();
+    }
+
+  private:
+    vtkm::IdComponent K;
+  };
+
+  template <typename DistanceType>
+  class CountRadiusNeighbors3DWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    typedef void ControlSignature(FieldIn<IdType> queryIds,
+                                  WholeArrayIn<> queryPoints,
+                                  WholeArrayIn<IdType> treeIdIn,
+                                  WholeArrayIn<IdType> treeSplitIdIn,
+                                  WholeArrayIn<> treeCoordiIn,
+                                  WholeArrayOut<IdType> counts);
+    typedef void ExecutionSignature(_1, _2, _3, _4, _5, _6);
+
+    VTKM_CONT
+    CountRadiusNeighbors3DWorklet(DistanceType radius)
+      : Radius(radius)
+    {
+    }
+
+    template <typename QueryPortalType,
+              typename IdPortalType,
+              typename CoordPortalType,
+              typename CountPortalType>
+    VTKM_EXEC void operator()(vtkm::Id queryId,
+                              const QueryPortalType& queryPortal,
+                              const IdPortalType& treeIdPortal,
+                              const IdPortalType& treeSplitIdPortal,
+                              const CoordPortalType& treeCoordiPortal,
+                              const CountPortalType& counts) const
+    {
+      RadiusCountResult<DistanceType> result = { this->Radius, 0 };
+      SearchNeighbors3D(queryPortal.Get(queryId),
+                        0,
+                        0,
+                        treeIdPortal.GetNumberOfValues(),
+                        treeIdPortal,
+                        treeSplitIdPortal,
+                        treeCoordiPortal,
+                        result);
+      counts.Set(queryId, result.Count);
+    }
+
+  private:
+    DistanceType Radius;
+  };
+
+  template <typename DistanceType>
+  class RadiusNeighborSearch3DWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    typedef void ControlSignature(FieldIn<IdType> queryIds,
+                                  WholeArrayIn<> queryPoints,
+                                  WholeArrayIn<IdType> offsets,
+                                  WholeArrayIn<IdType> treeIdIn,
+                                  WholeArrayIn<IdType> treeSplitIdIn,
+                                  WholeArrayIn<> treeCoordiIn,
+                                  WholeArrayOut<IdType> neighborIds,
+                                  WholeArrayOut<> distances);
+    typedef void ExecutionSignature(_1, _2, _3, _4, _5, _6, _7, _8);
+
+    VTKM_CONT
+    RadiusNeighborSearch3DWorklet(DistanceType radius)
+      : Radius(radius)
+    {
+    }
+
+    template <typename QueryPortalType,
+              typename OffsetPortalType,
+              typename IdPortalType,
+              typename CoordPortalType,
+              typename OutIdPortalType,
+              typename DistancePortalType>
+    VTKM_EXEC void operator()(vtkm::Id queryId,
+                              const QueryPortalType& queryPortal,
+                              const OffsetPortalType& offsets,
+                              const IdPortalType& treeIdPortal,
+                              const IdPortalType& treeSplitIdPortal,
+                              const CoordPortalType& treeCoordiPortal,
+                              const OutIdPortalType& neighborIds,
+                              const DistancePortalType& distances) const
+    {
+      const vtkm::Id begin = offsets.Get(queryId);
+      RadiusResult<OutIdPortalType, DistancePortalType> result = {
+        neighborIds, distances, this->Radius, begin, begin
+      };
+      SearchNeighbors3D(queryPortal.Get(queryId),
+                        0,
+                        0,
+                        treeIdPortal.GetNumberOfValues(),
+                        treeIdPortal,
+                        treeSplitIdPortal,
+                        treeCoordiPortal,
+                        result);
+      result.Finish();
+    }
+
+  private:
+    DistanceType Radius;
+  };
+
+  /// Computes a 30 bit Morton code of each point within the given bounds.
+  template <typename CoordType>
+  class MortonCode3DWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    typedef void ControlSignature(FieldIn<> points, FieldOut<> codes);
+    typedef _2 ExecutionSignature(_1);
+
+    VTKM_CONT
+    MortonCode3DWorklet(const vtkm::Vec<CoordType, 3>& minPoint,
+                        const vtkm::Vec<CoordType, 3>& maxPoint)
+      : MinPoint(minPoint)
+    {
+      for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+      {
+        const CoordType extent = maxPoint[axis] - minPoint[axis];
+        this->Scale[axis] = (extent > 0) ? CoordType(1023) / extent : CoordType(0);
+      }
+    }
+
+    VTKM_EXEC
+    vtkm::UInt32 operator()(const vtkm::Vec<CoordType, 3>& point) const
+    {
+      vtkm::UInt32 code = 0;
+      for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+      {
+        vtkm::UInt32 cell = static_cast<vtkm::UInt32>(
+          vtkm::Min(vtkm::Max((point[axis] - this->MinPoint[axis]) * this->Scale[axis],
+                              CoordType(0)),
+                    CoordType(1023)));
+        // Spread the 10 bits of the cell to every third bit.
+        cell = (cell | (cell << 16)) & 0x030000FFu;
+        cell = (cell | (cell << 8)) & 0x0300F00Fu;
+        cell = (cell | (cell << 4)) & 0x030C30C3u;
+        cell = (cell | (cell << 2)) & 0x09249249u;
+        code |= cell << (2 - axis);
+      }
+      return code;
+    }
+
+  private:
+    vtkm::Vec<CoordType, 3> MinPoint;
+    vtkm::Vec<CoordType, 3> Scale;
+  };
+
+  /// \brief Execute the k nearest neighbor search given kdtree and search points
+  ///
+  /// Finds the \c k nearest training points of each of the query points in
+  /// \c qc_Handle, sorted by increasing distance. A query has fewer than \c k
+  /// neighbors only if there are fewer than \c k training points.
+  template <typename CoordType,
+            typename CoordStorageTag1,
+            typename CoordStorageTag2,
+            typename DeviceAdapter>
+  void RunKNearest(
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag1>& coordi_Handle,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& pointId_Handle,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& splitId_Handle,
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag2>& qc_Handle,
+    vtkm::IdComponent k,
+    bool reorderQueries,
+    vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+    vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+    vtkm::cont::ArrayHandle<CoordType>& distances,
+    DeviceAdapter device)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    const vtkm::Id numberOfQueries = qc_Handle.GetNumberOfValues();
+    const vtkm::IdComponent numberOfNeighbors = static_cast<vtkm::IdComponent>(
+      vtkm::Min(static_cast<vtkm::Id>(k), pointId_Handle.GetNumberOfValues()));
+
+    Algorithm::Copy(vtkm::cont::ArrayHandleCounting<vtkm::Id>(
+                      0, numberOfNeighbors, numberOfQueries + 1),
+                    offsets);
+    neighborIds.Allocate(numberOfQueries * numberOfNeighbors);
+    distances.Allocate(numberOfQueries * numberOfNeighbors);
+    if (numberOfNeighbors == 0)
+    {
+      return;
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::Id> queryIds;
+    this->OrderQueries(qc_Handle, reorderQueries, queryIds, device);
+
+    KNearestNeighborSearch3DWorklet worklet(numberOfNeighbors);
+    vtkm::worklet::DispatcherMapField<KNearestNeighborSearch3DWorklet, DeviceAdapter> dispatcher(
+      worklet);
+    dispatcher.Invoke(queryIds,
+                      qc_Handle,
+                      pointId_Handle,
+                      splitId_Handle,
+                      coordi_Handle,
+                      neighborIds,
+                      distances);
+  }
+
+  /// \brief Execute the fixed radius neighbor search given kdtree and search points
+  ///
+  /// Finds all the training points within \c radius of each of the query
+  /// points in \c qc_Handle, sorted by distance.
+  template <typename CoordType,
+            typename CoordStorageTag1,
+            typename CoordStorageTag2,
+            typename DeviceAdapter>
+  void RunRadius(
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag1>& coordi_Handle,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& pointId_Handle,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& splitId_Handle,
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag2>& qc_Handle,
+    CoordType radius,
+    bool reorderQueries,
+    vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+    vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+    vtkm::cont::ArrayHandle<CoordType>& distances,
+    DeviceAdapter device)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    const vtkm::Id numberOfQueries = qc_Handle.GetNumberOfValues();
+    if (pointId_Handle.GetNumberOfValues() == 0)
+    {
+      Algorithm::Copy(vtkm::cont::make_ArrayHandleConstant(vtkm::Id(0), numberOfQueries + 1),
+                      offsets);
+      neighborIds.Allocate(0);
+      distances.Allocate(0);
+      return;
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::Id> queryIds;
+    this->OrderQueries(qc_Handle, reorderQueries, queryIds, device);
+
+    // Count the neighbors of each query, with one more entry for the total.
+    offsets.Allocate(numberOfQueries + 1);
+    {
+      CountRadiusNeighbors3DWorklet<CoordType> worklet(radius);
+      vtkm::worklet::DispatcherMapField<CountRadiusNeighbors3DWorklet<CoordType>, DeviceAdapter>
+        dispatcher(worklet);
+      dispatcher.Invoke(
+        queryIds, qc_Handle, pointId_Handle, splitId_Handle, coordi_Handle, offsets);
+    }
+    offsets.GetPortalControl().Set(numberOfQueries, 0);
+    const vtkm::Id numberOfNeighbors = Algorithm::ScanExclusive(offsets, offsets);
+
+    neighborIds.Allocate(numberOfNeighbors);
+    distances.Allocate(numberOfNeighbors);
+    RadiusNeighborSearch3DWorklet<CoordType> worklet(radius);
+    vtkm::worklet::DispatcherMapField<RadiusNeighborSearch3DWorklet<CoordType>, DeviceAdapter>
+      dispatcher(worklet);
+    dispatcher.Invoke(queryIds,
+                      qc_Handle,
+                      offsets,
+                      pointId_Handle,
+                      splitId_Handle,
+                      coordi_Handle,
+                      neighborIds,
+                      distances);
+  }
+
+private:
+  // The order in which the queries are searched: along a Morton curve
+  // through their bounds, or as given.
+  template <typename CoordType, typename CoordStorageTag, typename DeviceAdapter>
+  void OrderQueries(const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag>& qc,
+                    bool reorderQueries,
+                    vtkm::cont::ArrayHandle<vtkm::Id>& queryIds,
+                    DeviceAdapter)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    const vtkm::Id numberOfQueries = qc.GetNumberOfValues();
+    Algorithm::Copy(vtkm::cont::ArrayHandleIndex(numberOfQueries), queryIds);
+    if (!reorderQueries || numberOfQueries < 2)
+    {
+      return;
+    }
+
+    using VecType = vtkm::Vec<CoordType, 3>;
+    const vtkm::Vec<VecType, 2> initValue(qc.GetPortalConstControl().Get(0));
+    const vtkm::Vec<VecType, 2> bounds =
+      Algorithm::Reduce(qc, initValue, vtkm::MinAndMax<VecType>());
+
+    vtkm::cont::ArrayHandle<vtkm::UInt32> codes;
+    MortonCode3DWorklet<CoordType> worklet(bounds[0], bounds[1]);
+    vtkm::worklet::DispatcherMapField<MortonCode3DWorklet<CoordType>, DeviceAdapter> dispatcher(
+      worklet);
+    dispatcher.Invoke(qc, codes);
+
+    Algorithm::SortByKey(codes, queryIds);
+  }
+};
+}
+}
+} // namespace vtkm::worklet
+
+#endif // vtk_m_worklet_KdTree3DNeighborSearch_h
@@ -23,6 +23,9 @@
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 
+#include <algorithm>
+#include <vector>
+
 //
 // Make a simple 2D, 1000 point dataset populated with stat distributions
 //
@@ -328,7 +331,87 @@ void TestFieldHistogram()
   PrintHistogram(bins, numberOfBins, range, delta);
 } // TestFieldHistogram
 
+//
+// Compare the bin counts with counts computed one value at a time, for bin
+// counts counted with private blocks and with atomics, both for a computed
+// and for a given range, and for bin counts merged from several blocks
+//
+void TestFieldHistogramCounts()
+{
+  const vtkm::Id numberOfValues = 50000;
+  std::vector<vtkm::Float32> values(static_cast<std::size_t>(numberOfValues));
+  vtkm::UInt32 state = 1;
+  for (std::size_t i = 0; i < values.size(); i++)
+  {
+    state = state * 1664525u + 1013904223u;
+    values[i] = static_cast<vtkm::Float32>(state >> 8) / static_cast<vtkm::Float32>(1 << 24);
+  }
+  vtkm::cont::ArrayHandle<vtkm::Float32> valuesArray = vtkm::cont::make_ArrayHandle(values);
+
+  const vtkm::Id binCounts[4] = { 1, 10, 1000, 100000 };
+  for (vtkm::Id numberOfBins : binCounts)
+  {
+    for (int givenRange = 0; givenRange < 2; givenRange++)
+    {
+      vtkm::worklet::FieldHistogram histogram;
+      vtkm::cont::ArrayHandle<vtkm::Id> bins;
+      vtkm::Float32 delta;
+      vtkm::Float32 minValue;
+      if (givenRange)
+      {
+        minValue = 0.25f;
+        histogram.Run(
+          valuesArray, numberOfBins, 0.25f, 0.75f, delta, bins, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+      }
+      else
+      {
+        vtkm::Range range;
+        histogram.Run(
+          valuesArray, numberOfBins, range, delta, bins, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+        minValue = static_cast<vtkm::Float32>(range.Min);
+      }
+
+      std::vector<vtkm::Id> expected(static_cast<std::size_t>(numberOfBins), 0);
+      for (vtkm::Float32 value : values)
+      {
+        vtkm::Id bin = static_cast<vtkm::Id>((value - minValue) / delta);
+        bin = std::min(std::max(bin, vtkm::Id(0)), numberOfBins - 1);
+        expected[static_cast<std::size_t>(bin)]++;
+      }
+
+      VTKM_TEST_ASSERT(bins.GetNumberOfValues() == numberOfBins, "Wrong number of bins");
+      for (vtkm::Id i = 0; i < numberOfBins; i++)
+      {
+        VTKM_TEST_ASSERT(bins.GetPortalConstControl().Get(i) ==
+                           expected[static_cast<std::size_t>(i)],
+                         "Wrong bin count");
+      }
+
+      // The serial device counts all values in one block, so also ask for
+      // several blocks.
+      vtkm::worklet::FieldHistogram::BinMapper<vtkm::Float32> binMapper = { numberOfBins,
+                                                                             minValue,
+                                                                             delta };
+      vtkm::cont::ArrayHandle<vtkm::Id> blockBins;
+      vtkm::worklet::histogram::ComputeBinCounts(
+        valuesArray, binMapper, numberOfBins, blockBins, 16, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+      for (vtkm::Id i = 0; i < numberOfBins; i++)
+      {
+        VTKM_TEST_ASSERT(blockBins.GetPortalConstControl().Get(i) ==
+                           expected[static_cast<std::size_t>(i)],
+                         "Wrong bin count from several blocks");
+      }
+    }
+  }
+} // TestFieldHistogramCounts
+
+void TestFieldHistograms()
+{
+  TestFieldHistogram();
+  TestFieldHistogramCounts();
+}
+
 int UnitTestFieldHistogram(int, char* [])
 {
-  return vtkm::cont::testing::Testing::Run(TestFieldHistogram);
+  return vtkm::cont::testing::Testing::Run(TestFieldHistograms);
 }
@@ -18,7 +18,11 @@
 //  this software.
 //============================================================================
 
+#include <algorithm>
 #include <random>
+#include <utility>
+#include <vector>
+#include <vtkm/VectorAnalysis.h>
 #include <vtkm/worklet/KdTree3D.h>
 
 namespace
@@ -138,9 +142,143 @@ void TestKdTreeBuildNNS()
   VTKM_TEST_ASSERT(passTest, "Kd tree NN search result incorrect.");
 }
 
+void TestKdTreeNeighborQueries(bool reorderQueries)
+{
+  std::cout << "Testing k nearest and radius neighbors, reordering queries: " << reorderQueries
+            << std::endl;
+
+  const vtkm::Int32 nTrainingPoints = 2000;
+  const vtkm::Int32 nTestingPoint = 500;
+  const vtkm::IdComponent k = 16;
+  const vtkm::Float32 radius = 1.0f;
+
+  std::default_random_engine dre;
+  std::uniform_real_distribution<vtkm::Float32> dr(0.0f, 10.0f);
+  std::vector<vtkm::Vec<vtkm::Float32, 3>> coordi;
+  for (vtkm::Int32 i = 0; i < nTrainingPoints; i++)
+  {
+    coordi.push_back(vtkm::make_Vec(dr(dre), dr(dre), dr(dre)));
+  }
+  std::vector<vtkm::Vec<vtkm::Float32, 3>> qcVec;
+  for (vtkm::Int32 i = 0; i < nTestingPoint; i++)
+  {
+    qcVec.push_back(vtkm::make_Vec(dr(dre), dr(dre), dr(dre)));
+  }
+  auto coordi_Handle = vtkm::cont::make_ArrayHandle(coordi);
+  auto qc_Handle = vtkm::cont::make_ArrayHandle(qcVec);
+
+  vtkm::worklet::KdTree3D kdtree3d;
+  kdtree3d.SetReorderQueries(reorderQueries);
+  kdtree3d.Build(coordi_Handle, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  vtkm::cont::ArrayHandle<vtkm::Id> knnOffsets;
+  vtkm::cont::ArrayHandle<vtkm::Id> knnIds;
+  vtkm::cont::ArrayHandle<vtkm::Float32> knnDistances;
+  kdtree3d.KNearestNeighbors(coordi_Handle,
+                             qc_Handle,
+                             k,
+                             knnOffsets,
+                             knnIds,
+                             knnDistances,
+                             VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  vtkm::cont::ArrayHandle<vtkm::Id> radiusOffsets;
+  vtkm::cont::ArrayHandle<vtkm::Id> radiusIds;
+  vtkm::cont::ArrayHandle<vtkm::Float32> radiusDistances;
+  kdtree3d.RadiusNeighbors(coordi_Handle,
+                           qc_Handle,
+                           radius,
+                           radiusOffsets,
+                           radiusIds,
+                           radiusDistances,
+                           VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  VTKM_TEST_ASSERT(knnOffsets.GetNumberOfValues() == nTestingPoint + 1, "Wrong k-NN offsets");
+  VTKM_TEST_ASSERT(knnIds.GetNumberOfValues() == nTestingPoint * k, "Wrong number of k-NN");
+  VTKM_TEST_ASSERT(radiusOffsets.GetNumberOfValues() == nTestingPoint + 1, "Wrong radius offsets");
+  VTKM_TEST_ASSERT(radiusOffsets.GetPortalConstControl().Get(nTestingPoint) ==
+                     radiusIds.GetNumberOfValues(),
+                   "Wrong radius neighbors total");
+
+  ///// verify against all the distances, sorted /////
+  for (vtkm::Int32 i = 0; i < nTestingPoint; i++)
+  {
+    std::vector<std::pair<vtkm::Float32, vtkm::Id>> bruteForce;
+    for (vtkm::Int32 j = 0; j < nTrainingPoints; j++)
+    {
+      bruteForce.push_back(std::make_pair(vtkm::Magnitude(coordi[static_cast<std::size_t>(j)] -
+                                                          qcVec[static_cast<std::size_t>(i)]),
+                                          static_cast<vtkm::Id>(j)));
+    }
+    std::sort(bruteForce.begin(), bruteForce.end());
+
+    const vtkm::Id knnStart = knnOffsets.GetPortalConstControl().Get(i);
+    VTKM_TEST_ASSERT(knnStart == i * k, "Wrong k-NN offset");
+    for (vtkm::IdComponent n = 0; n < k; n++)
+    {
+      const std::pair<vtkm::Float32, vtkm::Id>& expected = bruteForce[static_cast<std::size_t>(n)];
+      VTKM_TEST_ASSERT(knnIds.GetPortalConstControl().Get(knnStart + n) == expected.second,
+                       "Kd tree k-NN search result incorrect.");
+      VTKM_TEST_ASSERT(
+        test_equal(knnDistances.GetPortalConstControl().Get(knnStart + n), expected.first),
+        "Kd tree k-NN distance incorrect.");
+    }
+
+    const vtkm::Id radiusStart = radiusOffsets.GetPortalConstControl().Get(i);
+    const vtkm::Id radiusEnd = radiusOffsets.GetPortalConstControl().Get(i + 1);
+    std::size_t numberInRadius = 0;
+    while (numberInRadius < bruteForce.size() && bruteForce[numberInRadius].first <= radius)
+    {
+      numberInRadius++;
+    }
+    VTKM_TEST_ASSERT(radiusEnd - radiusStart == static_cast<vtkm::Id>(numberInRadius),
+                     "Wrong number of radius neighbors.");
+    for (vtkm::Id n = radiusStart; n < radiusEnd; n++)
+    {
+      const std::pair<vtkm::Float32, vtkm::Id>& expected =
+        bruteForce[static_cast<std::size_t>(n - radiusStart)];
+      VTKM_TEST_ASSERT(radiusIds.GetPortalConstControl().Get(n) == expected.second,
+                       "Kd tree radius search result incorrect.");
+      VTKM_TEST_ASSERT(test_equal(radiusDistances.GetPortalConstControl().Get(n), expected.first),
+                       "Kd tree radius distance incorrect.");
+    }
+  }
+
+  ///// fewer training points than k /////
+  std::vector<vtkm::Vec<vtkm::Float32, 3>> fewCoordi(coordi.begin(), coordi.begin() + 5);
+  auto fewCoordi_Handle = vtkm::cont::make_ArrayHandle(fewCoordi);
+  vtkm::worklet::KdTree3D smallTree;
+  smallTree.SetReorderQueries(reorderQueries);
+  smallTree.Build(fewCoordi_Handle, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  smallTree.KNearestNeighbors(fewCoordi_Handle,
+                              qc_Handle,
+                              k,
+                              knnOffsets,
+                              knnIds,
+                              knnDistances,
+                              VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  VTKM_TEST_ASSERT(knnIds.GetNumberOfValues() == nTestingPoint * 5, "Wrong number of k-NN");
+  for (vtkm::Int32 i = 0; i < nTestingPoint; i++)
+  {
+    for (vtkm::IdComponent n = 1; n < 5; n++)
+    {
+      VTKM_TEST_ASSERT(knnDistances.GetPortalConstControl().Get(5 * i + n - 1) <=
+                         knnDistances.GetPortalConstControl().Get(5 * i + n),
+                       "k-NN not sorted by distance");
+    }
+  }
+}
+
+void TestKdTree()
+{
+  TestKdTreeBuildNNS();
+  TestKdTreeNeighborQueries(false);
+  TestKdTreeNeighborQueries(true);
+}
+
 } // anonymous namespace
 
 int UnitTestKdTreeBuildNNS(int, char* [])
 {
-  return vtkm::cont::testing::Testing::Run(TestKdTreeBuildNNS);
+  return vtkm::cont::testing::Testing::Run(TestKdTree);
 }
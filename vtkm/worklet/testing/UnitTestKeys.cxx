@@ -82,6 +82,17 @@ void TryKeyType(KeyType)
                  keys.GetSortedValuesMap().GetPortalConstControl(),
                  keys.GetOffsets().GetPortalConstControl(),
                  keys.GetCounts().GetPortalConstControl());
+
+  vtkm::worklet::Keys<KeyType> hashKeys;
+  hashKeys.BuildArrays(
+    keyArray, vtkm::worklet::Keys<KeyType>::SortType::Hash, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  VTKM_TEST_ASSERT(hashKeys.GetInputRange() == NUM_UNIQUE, "Hash keys has bad input range.");
+
+  CheckKeyReduce(keyArray.GetPortalConstControl(),
+                 hashKeys.GetUniqueKeys().GetPortalConstControl(),
+                 hashKeys.GetSortedValuesMap().GetPortalConstControl(),
+                 hashKeys.GetOffsets().GetPortalConstControl(),
+                 hashKeys.GetCounts().GetPortalConstControl());
 }
 
 void TestKeys()
@@ -97,6 +108,9 @@ void TestKeys()
 
   std::cout << "Testing vtkm::Id3 keys." << std::endl;
   TryKeyType(vtkm::Id3());
+
+  std::cout << "Testing vtkm::Pair<vtkm::Id, vtkm::Id2> keys." << std::endl;
+  TryKeyType(vtkm::Pair<vtkm::Id, vtkm::Id2>());
 }
 
 } // anonymous namespace
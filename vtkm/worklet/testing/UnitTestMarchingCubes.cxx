@@ -28,6 +28,8 @@
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/MarchingCubes.h>
 
+#include <vector>
+
 namespace
 {
 
@@ -409,9 +411,144 @@ void TestMarchingCubesExplicit()
                    "Wrong scalars result for MarchingCubes filter");
 }
 
+void TestMarchingCubesFlyingEdges()
+{
+  std::cout << "Testing MarchingCubes Flying Edges path against the unstructured path" << std::endl;
+
+  typedef VTKM_DEFAULT_DEVICE_ADAPTER_TAG DeviceAdapter;
+  typedef vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 3>> Vec3Handle;
+
+  vtkm::Id3 dims(8, 6, 5);
+  vtkm::cont::DataSet dataSet = MakeIsosurfaceTestDataSet(dims);
+
+  vtkm::cont::CellSetStructured<3> structuredCells;
+  dataSet.GetCellSet().CopyTo(structuredCells);
+  vtkm::cont::ArrayHandle<vtkm::Float32> pointFieldArray;
+  dataSet.GetField("nodevar").GetData().CopyTo(pointFieldArray);
+  vtkm::cont::ArrayHandleCounting<vtkm::Id> cellFieldArray;
+  dataSet.GetField("cellvar").GetData().CopyTo(cellFieldArray);
+
+  // The same hexahedra as an unstructured cell set, which takes the sort based
+  // path of the merge.
+  const vtkm::Id3 pdims(dims[0] + 1, dims[1] + 1, dims[2] + 1);
+  std::vector<vtkm::Id> hexConnectivity;
+  for (vtkm::Id k = 0; k < dims[2]; ++k)
+  {
+    for (vtkm::Id j = 0; j < dims[1]; ++j)
+    {
+      for (vtkm::Id i = 0; i < dims[0]; ++i)
+      {
+        const vtkm::Id p = i + pdims[0] * (j + pdims[1] * k);
+        const vtkm::Id layer = pdims[0] * pdims[1];
+        const vtkm::Id hex[8] = { p,
+                                  p + 1,
+                                  p + 1 + pdims[0],
+                                  p + pdims[0],
+                                  p + layer,
+                                  p + 1 + layer,
+                                  p + 1 + pdims[0] + layer,
+                                  p + pdims[0] + layer };
+        hexConnectivity.insert(hexConnectivity.end(), hex, hex + 8);
+      }
+    }
+  }
+  vtkm::cont::ArrayHandle<vtkm::Id> hexConnectivityArray;
+  vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>::Copy(
+    vtkm::cont::make_ArrayHandle(hexConnectivity), hexConnectivityArray);
+  vtkm::cont::CellSetSingleType<> unstructuredCells("cells");
+  unstructuredCells.Fill(
+    pdims[0] * pdims[1] * pdims[2], vtkm::CELL_SHAPE_HEXAHEDRON, 8, hexConnectivityArray);
+
+  vtkm::Float32 contourValue = 0.5f;
+
+  vtkm::worklet::MarchingCubes structuredFilter;
+  Vec3Handle structuredVertices;
+  Vec3Handle structuredNormals;
+  auto structuredResult = structuredFilter.Run(&contourValue,
+                                               1,
+                                               structuredCells,
+                                               dataSet.GetCoordinateSystem(),
+                                               pointFieldArray,
+                                               structuredVertices,
+                                               structuredNormals,
+                                               DeviceAdapter());
+
+  vtkm::worklet::MarchingCubes unstructuredFilter;
+  Vec3Handle unstructuredVertices;
+  Vec3Handle unstructuredNormals;
+  auto unstructuredResult = unstructuredFilter.Run(&contourValue,
+                                                   1,
+                                                   unstructuredCells,
+                                                   dataSet.GetCoordinateSystem(),
+                                                   pointFieldArray,
+                                                   unstructuredVertices,
+                                                   unstructuredNormals,
+                                                   DeviceAdapter());
+
+  VTKM_TEST_ASSERT(structuredVertices.GetNumberOfValues() > 0, "No output points");
+  VTKM_TEST_ASSERT(structuredVertices.GetNumberOfValues() ==
+                     unstructuredVertices.GetNumberOfValues(),
+                   "Wrong number of output points");
+  VTKM_TEST_ASSERT(structuredNormals.GetNumberOfValues() ==
+                     structuredVertices.GetNumberOfValues(),
+                   "Wrong number of normals");
+  VTKM_TEST_ASSERT(structuredResult.GetNumberOfCells() == unstructuredResult.GetNumberOfCells(),
+                   "Wrong number of output triangles");
+
+  auto structuredVerticesPortal = structuredVertices.GetPortalConstControl();
+  auto unstructuredVerticesPortal = unstructuredVertices.GetPortalConstControl();
+  for (vtkm::Id index = 0; index < structuredVertices.GetNumberOfValues(); ++index)
+  {
+    VTKM_TEST_ASSERT(test_equal(structuredVerticesPortal.Get(index),
+                                unstructuredVerticesPortal.Get(index)),
+                     "Output points differ");
+  }
+
+  auto structuredConnectivity = structuredResult.GetConnectivityArray(
+    vtkm::TopologyElementTagPoint(), vtkm::TopologyElementTagCell());
+  auto unstructuredConnectivity = unstructuredResult.GetConnectivityArray(
+    vtkm::TopologyElementTagPoint(), vtkm::TopologyElementTagCell());
+  VTKM_TEST_ASSERT(structuredConnectivity.GetNumberOfValues() ==
+                     unstructuredConnectivity.GetNumberOfValues(),
+                   "Wrong connectivity size");
+  for (vtkm::Id index = 0; index < structuredConnectivity.GetNumberOfValues(); ++index)
+  {
+    VTKM_TEST_ASSERT(structuredConnectivity.GetPortalConstControl().Get(index) ==
+                       unstructuredConnectivity.GetPortalConstControl().Get(index),
+                     "Output triangles differ");
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Float32> structuredScalars =
+    structuredFilter.ProcessPointField(pointFieldArray, DeviceAdapter());
+  vtkm::cont::ArrayHandle<vtkm::Float32> unstructuredScalars =
+    unstructuredFilter.ProcessPointField(pointFieldArray, DeviceAdapter());
+  for (vtkm::Id index = 0; index < structuredScalars.GetNumberOfValues(); ++index)
+  {
+    VTKM_TEST_ASSERT(test_equal(structuredScalars.GetPortalConstControl().Get(index), 0.5f),
+                     "Interpolated scalar is not the iso-value");
+    VTKM_TEST_ASSERT(test_equal(structuredScalars.GetPortalConstControl().Get(index),
+                                unstructuredScalars.GetPortalConstControl().Get(index)),
+                     "Interpolated scalars differ");
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> structuredCellField =
+    structuredFilter.ProcessCellField(cellFieldArray, DeviceAdapter());
+  vtkm::cont::ArrayHandle<vtkm::Id> unstructuredCellField =
+    unstructuredFilter.ProcessCellField(cellFieldArray, DeviceAdapter());
+  VTKM_TEST_ASSERT(structuredCellField.GetNumberOfValues() == structuredResult.GetNumberOfCells(),
+                   "Output cell data invalid");
+  for (vtkm::Id index = 0; index < structuredCellField.GetNumberOfValues(); ++index)
+  {
+    VTKM_TEST_ASSERT(structuredCellField.GetPortalConstControl().Get(index) ==
+                       unstructuredCellField.GetPortalConstControl().Get(index),
+                     "Mapped cell fields differ");
+  }
+}
+
 int UnitTestMarchingCubes(int, char* [])
 {
   int result1 = vtkm::cont::testing::Testing::Run(TestMarchingCubesUniformGrid);
   int result2 = vtkm::cont::testing::Testing::Run(TestMarchingCubesExplicit);
-  return result1 == 0 && result2 == 0;
+  int result3 = vtkm::cont::testing::Testing::Run(TestMarchingCubesFlyingEdges);
+  return result1 == 0 && result2 == 0 && result3 == 0;
 }
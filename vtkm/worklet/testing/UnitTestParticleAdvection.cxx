@@ -20,7 +20,9 @@
 
 #include <typeinfo>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/CellLocatorTwoLevelUniformGrid.h>
 #include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/DataSetBuilderExplicit.h>
 #include <vtkm/cont/DataSetBuilderRectilinear.h>
 #include <vtkm/cont/DataSetBuilderUniform.h>
 #include <vtkm/cont/DeviceAdapter.h>
@@ -157,6 +159,66 @@ vtkm::cont::DataSet CreateRectilinearDataSet(const vtkm::Bounds& bounds, const v
   return ds;
 }
 
+template <typename FieldType>
+vtkm::cont::DataSet CreateExplicitDataSet(const vtkm::Bounds& bounds,
+                                          const vtkm::Id3& dims,
+                                          bool tetrahedra)
+{
+  vtkm::Vec<FieldType, 3> spacing(
+    static_cast<FieldType>(bounds.X.Length()) / static_cast<FieldType>((dims[0] - 1)),
+    static_cast<FieldType>(bounds.Y.Length()) / static_cast<FieldType>((dims[1] - 1)),
+    static_cast<FieldType>(bounds.Z.Length()) / static_cast<FieldType>((dims[2] - 1)));
+
+  std::vector<vtkm::Vec<FieldType, 3>> coords;
+  for (vtkm::Id k = 0; k < dims[2]; k++)
+    for (vtkm::Id j = 0; j < dims[1]; j++)
+      for (vtkm::Id i = 0; i < dims[0]; i++)
+        coords.push_back(vtkm::Vec<FieldType, 3>(
+          static_cast<FieldType>(bounds.X.Min) + spacing[0] * static_cast<FieldType>(i),
+          static_cast<FieldType>(bounds.Y.Min) + spacing[1] * static_cast<FieldType>(j),
+          static_cast<FieldType>(bounds.Z.Min) + spacing[2] * static_cast<FieldType>(k)));
+
+  //Split each hexahedron in six tetrahedra around its 0-6 diagonal.
+  const vtkm::IdComponent tets[6][4] = { { 0, 1, 2, 6 }, { 0, 2, 3, 6 }, { 0, 3, 7, 6 },
+                                         { 0, 7, 4, 6 }, { 0, 4, 5, 6 }, { 0, 5, 1, 6 } };
+  std::vector<vtkm::Id> connectivity;
+  for (vtkm::Id k = 0; k < dims[2] - 1; k++)
+    for (vtkm::Id j = 0; j < dims[1] - 1; j++)
+      for (vtkm::Id i = 0; i < dims[0] - 1; i++)
+      {
+        vtkm::Id p0 = (k * dims[1] + j) * dims[0] + i;
+        vtkm::Id plane = dims[0] * dims[1];
+        vtkm::Id hex[8] = { p0,
+                            p0 + 1,
+                            p0 + dims[0] + 1,
+                            p0 + dims[0],
+                            p0 + plane,
+                            p0 + plane + 1,
+                            p0 + plane + dims[0] + 1,
+                            p0 + plane + dims[0] };
+        if (tetrahedra)
+        {
+          for (int t = 0; t < 6; t++)
+            for (int v = 0; v < 4; v++)
+              connectivity.push_back(hex[tets[t][v]]);
+        }
+        else
+        {
+          connectivity.insert(connectivity.end(), hex, hex + 8);
+        }
+      }
+
+  if (tetrahedra)
+  {
+    return vtkm::cont::DataSetBuilderExplicit::Create(
+      coords, vtkm::CellShapeTagTetra(), 4, connectivity);
+  }
+  std::size_t numCells = connectivity.size() / 8;
+  std::vector<vtkm::UInt8> shapes(numCells, vtkm::CELL_SHAPE_HEXAHEDRON);
+  std::vector<vtkm::IdComponent> numIndices(numCells, 8);
+  return vtkm::cont::DataSetBuilderExplicit::Create(coords, shapes, numIndices, connectivity);
+}
+
 template <typename FieldType>
 void CreateConstantVectorField(vtkm::Id num,
                                const vtkm::Vec<FieldType, 3>& vec,
@@ -408,6 +470,296 @@ void TestEvaluators()
   }
 }
 
+template <typename FieldType>
+vtkm::Vec<FieldType, 3> LinearVectorField(const vtkm::Vec<FieldType, 3>& p)
+{
+  return vtkm::Vec<FieldType, 3>(
+    0.5f + 0.1f * p[0], 0.3f - 0.2f * p[1], 0.1f * p[2] + 0.05f * p[0]);
+}
+
+template <typename CellSetType>
+void TestUnstructuredEvaluator(bool tetrahedra, const std::string& msg)
+{
+  typedef VTKM_DEFAULT_DEVICE_ADAPTER_TAG DeviceAdapter;
+  typedef vtkm::Float32 FieldType;
+  typedef vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>> FieldHandle;
+  typedef FieldHandle::template ExecutionTypes<DeviceAdapter>::PortalConst FieldPortalConstType;
+
+  typedef vtkm::worklet::particleadvection::ConstantField<FieldType> CEvalType;
+  typedef vtkm::worklet::particleadvection::RK4Integrator<CEvalType, FieldType> RK4CType;
+  typedef vtkm::worklet::particleadvection::UnstructuredGridEvaluate<FieldPortalConstType,
+                                                                     FieldType,
+                                                                     DeviceAdapter,
+                                                                     CellSetType>
+    UnstructuredEvalType;
+  typedef vtkm::worklet::particleadvection::RK4Integrator<UnstructuredEvalType, FieldType>
+    RK4UnstructuredType;
+
+  std::vector<vtkm::Bounds> bounds;
+  bounds.push_back(vtkm::Bounds(0, 1, 0, 1, 0, 1));
+  bounds.push_back(vtkm::Bounds(-1, 1, -1, 1, -1, 1));
+  bounds.push_back(vtkm::Bounds(0, 10, 0, 10, 0, 10));
+
+  std::vector<vtkm::Id3> dims;
+  dims.push_back(vtkm::Id3(5, 5, 5));
+  dims.push_back(vtkm::Id3(10, 5, 7));
+
+  srand(314);
+  for (std::size_t d = 0; d < dims.size(); d++)
+  {
+    for (std::size_t j = 0; j < bounds.size(); j++)
+    {
+      vtkm::cont::DataSet ds = CreateExplicitDataSet<FieldType>(bounds[j], dims[d], tetrahedra);
+      VTKM_TEST_ASSERT(ds.GetCellSet().IsSameType(CellSetType()), "Wrong cell set type.");
+
+      vtkm::cont::CellLocatorTwoLevelUniformGrid locator;
+      locator.SetCellSet(ds.GetCellSet());
+      locator.SetCoordinates(ds.GetCoordinateSystem());
+      locator.Build(DeviceAdapter());
+
+      //Linear fields are interpolated exactly by the cells.
+      FieldHandle coords = ds.GetCoordinateSystem().GetData().Cast<FieldHandle>();
+      std::vector<vtkm::Vec<FieldType, 3>> linearField;
+      for (vtkm::Id i = 0; i < coords.GetNumberOfValues(); i++)
+        linearField.push_back(LinearVectorField(coords.GetPortalConstControl().Get(i)));
+      FieldHandle linearFieldArray = vtkm::cont::make_ArrayHandle(linearField);
+      UnstructuredEvalType linearEval(locator, linearFieldArray);
+
+      std::vector<vtkm::Vec<FieldType, 3>> pointIns;
+      for (int k = 0; k < 64; k++)
+      {
+        vtkm::Vec<FieldType, 3> p;
+        RandomPoint<FieldType>(bounds[j], p);
+        pointIns.push_back(p);
+      }
+      //Points outside of the cells.
+      vtkm::Vec<FieldType, 3> outside(static_cast<FieldType>(bounds[j].X.Max + 1), 0, 0);
+      pointIns.push_back(outside);
+      pointIns.push_back(-outside);
+
+      typedef TestEvaluatorWorklet<FieldType, UnstructuredEvalType> EvalTester;
+      EvalTester evalTester(linearEval);
+      vtkm::worklet::DispatcherMapField<EvalTester> evalTesterDispatcher(evalTester);
+      FieldHandle pointsHandle = vtkm::cont::make_ArrayHandle(pointIns);
+      vtkm::cont::ArrayHandle<bool> evalStatus;
+      FieldHandle evalResults;
+      evalTesterDispatcher.Invoke(pointsHandle, evalStatus, evalResults);
+      for (std::size_t k = 0; k < pointIns.size(); k++)
+      {
+        bool status = evalStatus.GetPortalConstControl().Get(static_cast<vtkm::Id>(k));
+        vtkm::Vec<FieldType, 3> result =
+          evalResults.GetPortalConstControl().Get(static_cast<vtkm::Id>(k));
+        if (k + 2 < pointIns.size())
+        {
+          VTKM_TEST_ASSERT(status, "Error in evaluator for " + msg);
+          VTKM_TEST_ASSERT(test_equal(result, LinearVectorField(pointIns[k]), 0.001),
+                           "Error in evaluator result for " + msg);
+        }
+        else
+        {
+          VTKM_TEST_ASSERT(!status, "Evaluator found a point outside of the cells for " + msg);
+        }
+      }
+
+      //Advecting through a constant field must match the constant evaluator.
+      vtkm::Vec<FieldType, 3> vec(1, 1, 0);
+      FieldType stepSize = static_cast<FieldType>(bounds[j].X.Length() / 200);
+      FieldHandle vecField;
+      CreateConstantVectorField(coords.GetNumberOfValues(), vec, vecField);
+      CEvalType constEval(bounds[j], vec);
+      RK4CType constRK4(constEval, stepSize);
+      UnstructuredEvalType unstructuredEval(locator, vecField);
+      RK4UnstructuredType unstructuredRK4(unstructuredEval, stepSize);
+
+      vtkm::Bounds seedBounds = bounds[j];
+      seedBounds.X.Min += 0.35 * bounds[j].X.Length();
+      seedBounds.X.Max -= 0.35 * bounds[j].X.Length();
+      seedBounds.Y.Min += 0.35 * bounds[j].Y.Length();
+      seedBounds.Y.Max -= 0.35 * bounds[j].Y.Length();
+      std::vector<vtkm::Vec<FieldType, 3>> seedPoints;
+      for (int k = 0; k < 16; k++)
+      {
+        vtkm::Vec<FieldType, 3> p;
+        RandomPoint<FieldType>(seedBounds, p);
+        seedPoints.push_back(p);
+      }
+
+      vtkm::Id maxSteps = 40;
+      vtkm::worklet::ParticleAdvection particleAdvection;
+      vtkm::worklet::ParticleAdvectionResult<FieldType> constRes, unstructuredRes;
+      FieldHandle seeds;
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(seedPoints), seeds, DeviceAdapter());
+      constRes = particleAdvection.Run(constRK4, seeds, maxSteps, DeviceAdapter());
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(seedPoints), seeds, DeviceAdapter());
+      unstructuredRes = particleAdvection.Run(unstructuredRK4, seeds, maxSteps, DeviceAdapter());
+      for (vtkm::Id k = 0; k < static_cast<vtkm::Id>(seedPoints.size()); k++)
+      {
+        VTKM_TEST_ASSERT(test_equal(constRes.positions.GetPortalConstControl().Get(k),
+                                    unstructuredRes.positions.GetPortalConstControl().Get(k),
+                                    0.001),
+                         "Error in advected particles for " + msg);
+        VTKM_TEST_ASSERT(unstructuredRes.stepsTaken.GetPortalConstControl().Get(k) == maxSteps,
+                         "Wrong number of steps for " + msg);
+      }
+    }
+  }
+}
+
+// A constant field whose velocity is not a number everywhere, even out of
+// its bounds, so that only the error of the steps can stop the particles.
+template <typename FieldType>
+class NanField : public vtkm::worklet::particleadvection::ConstantField<FieldType>
+{
+public:
+  VTKM_CONT
+  NanField() {}
+
+  VTKM_CONT
+  NanField(const vtkm::Bounds& bb)
+    : vtkm::worklet::particleadvection::ConstantField<FieldType>(bb, vtkm::Vec<FieldType, 3>(0))
+  {
+  }
+
+  VTKM_EXEC bool Evaluate(const vtkm::Vec<FieldType, 3>&, vtkm::Vec<FieldType, 3>& out) const
+  {
+    out = vtkm::Vec<FieldType, 3>(vtkm::Nan<FieldType>());
+    return true;
+  }
+};
+
+void TestDormandPrinceIntegrator()
+{
+  typedef VTKM_DEFAULT_DEVICE_ADAPTER_TAG DeviceAdapter;
+  typedef vtkm::Float32 FieldType;
+  typedef vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>> FieldHandle;
+
+  typedef vtkm::worklet::particleadvection::ConstantField<FieldType> CEvalType;
+  typedef vtkm::worklet::particleadvection::DormandPrinceIntegrator<CEvalType, FieldType>
+    DPCType;
+  typedef vtkm::worklet::particleadvection::AnalyticalOrbitEvaluate<FieldType> OrbitEvalType;
+  typedef vtkm::worklet::particleadvection::DormandPrinceIntegrator<OrbitEvalType, FieldType>
+    DPOrbitType;
+  typedef vtkm::worklet::particleadvection::DormandPrinceIntegrator<NanField<FieldType>, FieldType>
+    DPNanType;
+
+  vtkm::worklet::ParticleAdvection particleAdvection;
+  vtkm::worklet::ParticleAdvectionResult<FieldType> res;
+  FieldHandle seeds;
+
+  //A constant field has no error, so the steps grow up to the maximum length.
+  vtkm::Bounds bounds(0, 10, 0, 10, 0, 10);
+  vtkm::Vec<FieldType, 3> vec(1, 1, 0);
+  CEvalType constEval(bounds, vec);
+  DPCType constDP(constEval, 0.01f, 1e-5f, 0.001f, 0.05f);
+  std::vector<vtkm::Vec<FieldType, 3>> pts;
+  pts.push_back(vtkm::Vec<FieldType, 3>(1, 1, 1));
+  pts.push_back(vtkm::Vec<FieldType, 3>(5, 2, 7));
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(pts), seeds, DeviceAdapter());
+  res = particleAdvection.Run(constDP, seeds, 10, DeviceAdapter());
+  for (vtkm::Id i = 0; i < 2; i++)
+  {
+    vtkm::Vec<FieldType, 3> expected = pts[static_cast<std::size_t>(i)] + 0.46f * vec;
+    VTKM_TEST_ASSERT(test_equal(res.positions.GetPortalConstControl().Get(i), expected),
+                     "Wrong adaptive steps in constant field.");
+  }
+
+  //A field without a finite error stops the particles with an error.
+  DPNanType nanDP(NanField<FieldType>(bounds), 0.01f, 1e-5f, 0.001f, 0.05f);
+  res = particleAdvection.Run(nanDP, seeds, 10, DeviceAdapter());
+  for (vtkm::Id i = 0; i < 2; i++)
+  {
+    VTKM_TEST_ASSERT(res.status.GetPortalConstControl().Get(i) ==
+                         vtkm::worklet::particleadvection::STATUS_ERROR &&
+                       res.stepsTaken.GetPortalConstControl().Get(i) == 0,
+                     "Non-finite error did not stop the particle.");
+  }
+
+  //Step lengths out of order and non-positive tolerances are rejected.
+  typedef vtkm::Vec<FieldType, 4> SettingsType;
+  const SettingsType badSettings[3] = { SettingsType(0.01f, 1e-5f, 0, 0.05f),
+                                        SettingsType(0.01f, 1e-5f, 0.1f, 0.05f),
+                                        SettingsType(0.01f, 0, 0.001f, 0.05f) };
+  for (const SettingsType& settings : badSettings)
+  {
+    bool thrown = false;
+    try
+    {
+      DPCType(constEval, settings[0], settings[1], settings[2], settings[3]);
+    }
+    catch (vtkm::cont::ErrorBadValue&)
+    {
+      thrown = true;
+    }
+    VTKM_TEST_ASSERT(thrown, "Bad adaptive step settings not rejected.");
+  }
+
+  //Steps on a circular orbit must stay on the circle. The steps on the small
+  //orbit are too long for the tolerance at first, and must be rejected. The
+  //steps on the larger orbits must grow, yet not go around the orbit.
+  OrbitEvalType orbitEval(vtkm::Bounds(-2, 2, -2, 2, -1, 1));
+  std::vector<DPOrbitType> orbitDPs;
+  std::vector<vtkm::Id> orbitSteps;
+  orbitDPs.push_back(DPOrbitType(orbitEval, 0.01f, 1e-6f, 0.0001f, 0.1f));
+  orbitSteps.push_back(20);
+  orbitDPs.push_back(DPOrbitType(orbitEval, 0.5f, 1e-6f, 0.0001f, 0.5f));
+  orbitSteps.push_back(6);
+  for (std::size_t i = 0; i < orbitDPs.size(); i++)
+  {
+    pts.clear();
+    pts.push_back(vtkm::Vec<FieldType, 3>(1, 0, 0));
+    pts.push_back(vtkm::Vec<FieldType, 3>(0, -1.5f, 0));
+    pts.push_back(vtkm::Vec<FieldType, 3>(0.2f, 0, 0));
+    vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(pts), seeds, DeviceAdapter());
+    res = particleAdvection.Run(orbitDPs[i], seeds, orbitSteps[i], DeviceAdapter());
+    for (vtkm::Id j = 0; j < 3; j++)
+    {
+      vtkm::Vec<FieldType, 3> start = pts[static_cast<std::size_t>(j)];
+      vtkm::Vec<FieldType, 3> end = res.positions.GetPortalConstControl().Get(j);
+      VTKM_TEST_ASSERT(res.stepsTaken.GetPortalConstControl().Get(j) == orbitSteps[i],
+                       "Wrong number of steps on orbit.");
+      VTKM_TEST_ASSERT(test_equal(vtkm::Magnitude(end), vtkm::Magnitude(start), 1e-4),
+                       "Adaptive steps left the orbit.");
+      VTKM_TEST_ASSERT(j == 2 || vtkm::Magnitude(end - start) > 0.5f * vtkm::Magnitude(start),
+                       "Adaptive steps did not grow on orbit.");
+    }
+  }
+
+  //The step lengths are kept with the particles, so recording the streamlines
+  //in chunks of one step must give the same points as a single chunk.
+  typedef vtkm::worklet::particleadvection::StreamlineWorklet<DPOrbitType, FieldType, DeviceAdapter>
+    StreamlineWorkletType;
+  vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>> positions[2];
+  for (int i = 0; i < 2; i++)
+  {
+    vtkm::cont::ArrayHandle<vtkm::Id> status, steps;
+    vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(pts), seeds, DeviceAdapter());
+    vtkm::cont::ArrayCopy(
+      vtkm::cont::make_ArrayHandleConstant(vtkm::Id(vtkm::worklet::particleadvection::STATUS_OK),
+                                           3),
+      status,
+      DeviceAdapter());
+    vtkm::cont::ArrayCopy(
+      vtkm::cont::make_ArrayHandleConstant(vtkm::Id(0), 3), steps, DeviceAdapter());
+    vtkm::cont::CellSetExplicit<> polyLines;
+    StreamlineWorkletType worklet;
+    if (i == 1)
+    {
+      worklet.SetMaximumHistorySize(3);
+    }
+    worklet.Run(orbitDPs[0], seeds, orbitSteps[0], positions[i], polyLines, status, steps);
+  }
+  VTKM_TEST_ASSERT(positions[0].GetNumberOfValues() == 3 * orbitSteps[0],
+                   "Wrong number of adaptive streamline points.");
+  VTKM_TEST_ASSERT(positions[1].GetNumberOfValues() == 3 * orbitSteps[0],
+                   "Wrong number of chunked adaptive streamline points.");
+  for (vtkm::Id j = 0; j < positions[0].GetNumberOfValues(); j++)
+  {
+    VTKM_TEST_ASSERT(test_equal(positions[0].GetPortalConstControl().Get(j),
+                                positions[1].GetPortalConstControl().Get(j)),
+                     "Chunked adaptive streamlines have wrong points.");
+  }
+}
+
 void TestParticleWorklets()
 {
   typedef VTKM_DEFAULT_DEVICE_ADAPTER_TAG DeviceAdapter;
@@ -445,7 +797,7 @@ void TestParticleWorklets()
   RGEvalType eval(ds.GetCoordinateSystem(), ds.GetCellSet(0), fieldArray);
   RK4RGType rk4(eval, stepSize);
 
-  for (int i = 0; i < 2; i++)
+  for (int i = 0; i < 3; i++)
   {
     std::vector<vtkm::Vec<FieldType, 3>> pts;
     pts.push_back(vtkm::Vec<FieldType, 3>(1, 1, 1));
@@ -483,12 +835,62 @@ void TestParticleWorklets()
         VTKM_TEST_ASSERT(numPoints == numSteps, "Invalid number of points in streamline.");
       }
     }
+    else if (i == 2)
+    {
+      //Recording the streamlines in small chunks must give the same result.
+      typedef vtkm::worklet::particleadvection::StreamlineWorklet<RK4RGType,
+                                                                  FieldType,
+                                                                  DeviceAdapter>
+        StreamlineWorkletType;
+      vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>> positions[2];
+      vtkm::cont::CellSetExplicit<> polyLines[2];
+      vtkm::cont::ArrayHandle<vtkm::Id> status[2], steps[2];
+      for (int j = 0; j < 2; j++)
+      {
+        vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>> seedCopy;
+        vtkm::cont::ArrayCopy(seeds, seedCopy, DeviceAdapter());
+        vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(
+                                vtkm::Id(vtkm::worklet::particleadvection::STATUS_OK), 3),
+                              status[j],
+                              DeviceAdapter());
+        vtkm::cont::ArrayCopy(
+          vtkm::cont::make_ArrayHandleConstant(vtkm::Id(0), 3), steps[j], DeviceAdapter());
+
+        StreamlineWorkletType worklet;
+        if (j == 1)
+        {
+          worklet.SetMaximumHistorySize(5);
+        }
+        worklet.Run(rk4, seedCopy, maxSteps, positions[j], polyLines[j], status[j], steps[j]);
+      }
+
+      VTKM_TEST_ASSERT(positions[0].GetNumberOfValues() == positions[1].GetNumberOfValues(),
+                       "Chunked streamlines have wrong number of points.");
+      for (vtkm::Id j = 0; j < positions[0].GetNumberOfValues(); j++)
+      {
+        VTKM_TEST_ASSERT(test_equal(positions[0].GetPortalConstControl().Get(j),
+                                    positions[1].GetPortalConstControl().Get(j)),
+                         "Chunked streamlines have wrong points.");
+      }
+      for (vtkm::Id j = 0; j < 3; j++)
+      {
+        VTKM_TEST_ASSERT(polyLines[0].GetNumberOfPointsInCell(j) ==
+                           polyLines[1].GetNumberOfPointsInCell(j),
+                         "Chunked streamlines have wrong number of points in cell.");
+        VTKM_TEST_ASSERT(status[0].GetPortalConstControl().Get(j) ==
+                           status[1].GetPortalConstControl().Get(j),
+                         "Chunked streamlines have wrong status.");
+      }
+    }
   }
 }
 
 void TestParticleAdvection()
 {
   TestEvaluators();
+  TestUnstructuredEvaluator<vtkm::cont::CellSetExplicit<>>(false, "hexahedra");
+  TestUnstructuredEvaluator<vtkm::cont::CellSetSingleType<>>(true, "tetrahedra");
+  TestDormandPrinceIntegrator();
   TestParticleWorklets();
 }
 